@@ -297,6 +297,11 @@ vtkMRMLAbstractLogic* qSlicerAbstractCoreModule::logic()
                                        this->name().toStdString(), this->path().toStdString()));
       }
     d->Logic->SetMRMLScene(this->mrmlScene());
+    // Make the logic available to other logics and displayable managers
+    if (d->AppLogic)
+      {
+      d->AppLogic->SetModuleLogic(this->name().toUtf8(), d->Logic);
+      }
     }
   return d->Logic;
 }
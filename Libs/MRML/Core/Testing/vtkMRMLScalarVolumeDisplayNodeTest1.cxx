@@ -13,9 +13,95 @@
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLScalarVolumeDisplayNode.h"
 
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkTrivialProducer.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void FillRamp(vtkImageData* image, int zMin, int zMax, int constantValue)
+{
+  int* extent = image->GetExtent();
+  for (int z = extent[4]; z <= extent[5]; ++z)
+    {
+    for (int y = extent[2]; y <= extent[3]; ++y)
+      {
+      for (int x = extent[0]; x <= extent[1]; ++x)
+        {
+        short* voxel = static_cast<short*>(image->GetScalarPointer(x, y, z));
+        *voxel = static_cast<short>((z >= zMin && z <= zMax) ? constantValue : x);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int TestAutoLevelsHistogramModes()
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(64, 64, 64);
+  image->AllocateScalars(VTK_SHORT, 1);
+  // Values 0..63 along x, the same number of voxels for each value
+  FillRamp(image.GetPointer(), 1, 0, 0);
+  vtkNew<vtkTrivialProducer> producer;
+  producer->SetOutput(image.GetPointer());
+
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  displayNode->SetAutoLevelsHistogramMode(vtkMRMLScalarVolumeDisplayNode::AutoLevelsHistogramCached);
+  displayNode->SetInputImageDataConnection(producer->GetOutputPort());
+  displayNode->SetAutoWindowLevel(1);
+  displayNode->Modified();
+  CHECK_DOUBLE_TOLERANCE(displayNode->GetWindowLevelMin(), 0.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(displayNode->GetWindowLevelMax(), 63.0, 1e-6);
+
+  // Only the first 63 slices change: 4 is the value at the 0.1%, 59 at the 99.9% percentile
+  int modifiedExtent[6] = { 0, 63, 0, 63, 0, 62 };
+  FillRamp(image.GetPointer(), 0, 62, 5);
+  displayNode->NotifyImageDataModifiedExtent(modifiedExtent);
+  image->Modified();
+  displayNode->Modified();
+  CHECK_DOUBLE_TOLERANCE(displayNode->GetWindowLevelMin(), 4.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(displayNode->GetWindowLevelMax(), 59.0, 1e-6);
+
+  // Values outside of the histogram range are detected
+  int voxelExtent[6] = { 0, 0, 0, 0, 10, 10 };
+  *static_cast<short*>(image->GetScalarPointer(0, 0, 10)) = 1000;
+  displayNode->NotifyImageDataModifiedExtent(voxelExtent);
+  image->Modified();
+  displayNode->Modified();
+  CHECK_DOUBLE_TOLERANCE(displayNode->GetWindowLevelMin(), 4.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(displayNode->GetWindowLevelMax(), 59.0, 1e-6);
+
+  // Sampled histogram: the sampling grid is every 6th voxel for this tolerance,
+  // so the percentiles may be off by the grid spacing
+  FillRamp(image.GetPointer(), 1, 0, 0);
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> sampledDisplayNode;
+  sampledDisplayNode->SetAutoLevelsHistogramMode(vtkMRMLScalarVolumeDisplayNode::AutoLevelsHistogramSampled);
+  sampledDisplayNode->SetAutoLevelsSamplingTolerance(1e-3);
+  sampledDisplayNode->SetInputImageDataConnection(producer->GetOutputPort());
+  sampledDisplayNode->SetAutoWindowLevel(1);
+  sampledDisplayNode->Modified();
+  CHECK_DOUBLE_TOLERANCE(sampledDisplayNode->GetWindowLevelMin(), 0.0, 6.0);
+  CHECK_DOUBLE_TOLERANCE(sampledDisplayNode->GetWindowLevelMax(), 63.0, 6.0);
+
+  CHECK_INT(vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsHistogramModeFromString(
+    vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsHistogramModeAsString(
+    vtkMRMLScalarVolumeDisplayNode::AutoLevelsHistogramSampled)),
+    vtkMRMLScalarVolumeDisplayNode::AutoLevelsHistogramSampled);
+  CHECK_INT(vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsHistogramModeFromString("invalid"), -1);
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
 int vtkMRMLScalarVolumeDisplayNodeTest1(int , char * [] )
 {
   vtkNew<vtkMRMLScalarVolumeDisplayNode> node1;
   EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+  CHECK_EXIT_SUCCESS(TestAutoLevelsHistogramModes());
   return EXIT_SUCCESS;
 }
@@ -23,6 +23,32 @@ Care Ontario.
 #include "vtkMRMLScene.h"
 #include "vtkMRMLStreamingVolumeNode.h"
 
+// VTK includes
+#include <vtkCallbackCommand.h>
+
+// STD includes
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+void CountEventsCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+  void* clientData, void* vtkNotUsed(callData))
+{
+  std::atomic<int>* count = reinterpret_cast<std::atomic<int>*>(clientData);
+  ++(*count);
+}
+
+//----------------------------------------------------------------------------
+void CountDecodedFramesCallback(void* clientData)
+{
+  std::atomic<int>* count = reinterpret_cast<std::atomic<int>*>(clientData);
+  ++(*count);
+}
+}
+
 int vtkMRMLStreamingVolumeNodeTest1(int , char * [] )
 {
   vtkNew<vtkMRMLStreamingVolumeNode> node1;
@@ -98,5 +124,82 @@ int vtkMRMLStreamingVolumeNodeTest1(int , char * [] )
       }
     }
 
+  // Encode a sequence of frames, delta frames refer to the previous frame
+  const int numberOfFrames = 4;
+  std::vector<vtkSmartPointer<vtkImageData> > images;
+  std::vector<vtkSmartPointer<vtkStreamingVolumeFrame> > frames;
+  vtkNew<vtkMRMLStreamingVolumeNode> encoderNode;
+  encoderNode->SetCodecFourCC("DZLB");
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+    image->SetDimensions(width, height, 2);
+    image->AllocateScalars(VTK_SHORT, 1);
+    short* imagePointer = static_cast<short*>(image->GetScalarPointer());
+    for (int i = 0; i < width * height * 2; ++i)
+      {
+      imagePointer[i] = static_cast<short>(i * (frameIndex + 1) - 50);
+      }
+    encoderNode->SetAndObserveImageData(image);
+    CHECK_BOOL(encoderNode->EncodeImageData(), true);
+    images.push_back(image);
+    frames.push_back(encoderNode->GetFrame());
+    }
+  CHECK_BOOL(frames[0]->IsKeyFrame(), true);
+  CHECK_BOOL(frames[2]->IsKeyFrame(), false);
+
+  // Frames decoded ahead in the background are swapped in without decoding
+  vtkNew<vtkMRMLStreamingVolumeNode> playbackNode;
+  playbackNode->SetDecodedFrameCacheSize(3);
+  CHECK_INT(playbackNode->GetDecodedFrameCacheSize(), 3);
+  for (int frameIndex = 1; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    playbackNode->QueueFrameForDecoding(frames[frameIndex]);
+    }
+  playbackNode->WaitForDecoding();
+  playbackNode->SetAndObserveFrame(frames[2]);
+  vtkImageData* playbackImage = playbackNode->GetImageData();
+  CHECK_NOT_NULL(playbackImage);
+  CHECK_BOOL(playbackNode->GetFrameDecodingInProgress(), false);
+  CHECK_INT(memcmp(playbackImage->GetScalarPointer(), images[2]->GetScalarPointer(), width * height * 2 * sizeof(short)), 0);
+
+  // A frame that has not been decoded ahead is queued for decoding in the background as soon as it is set,
+  // the previous image is kept until it is ready. The callback is called from the decoding thread when
+  // the frame is ready and observers are notified from the main thread when the decoded frame is swapped in.
+  std::atomic<int> decodedFrameReadyCount(0);
+  std::atomic<int> imageDataModifiedCount(0);
+  playbackNode->SetDecodedFrameReadyCallback(CountDecodedFramesCallback, &decodedFrameReadyCount);
+  vtkNew<vtkCallbackCommand> imageDataModifiedCallback;
+  imageDataModifiedCallback->SetClientData(&imageDataModifiedCount);
+  imageDataModifiedCallback->SetCallback(CountEventsCallback);
+  playbackNode->AddObserver(vtkMRMLVolumeNode::ImageDataModifiedEvent, imageDataModifiedCallback);
+
+  playbackNode->SetAndObserveFrame(frames[0]);
+  CHECK_BOOL(playbackNode->GetFrameDecodingInProgress(), true);
+  CHECK_INT(memcmp(playbackImage->GetScalarPointer(), images[2]->GetScalarPointer(), width * height * 2 * sizeof(short)), 0);
+  playbackNode->WaitForDecoding();
+  CHECK_BOOL(decodedFrameReadyCount > 0, true);
+  CHECK_BOOL(playbackNode->IsDecodedFrameReady(), true);
+  CHECK_INT(imageDataModifiedCount, 0);
+  CHECK_BOOL(playbackNode->ProcessDecodedFrames(), true);
+  CHECK_BOOL(playbackNode->IsDecodedFrameReady(), false);
+  CHECK_BOOL(playbackNode->GetFrameDecodingInProgress(), false);
+  CHECK_BOOL(imageDataModifiedCount > 0, true);
+  int imageDataModifiedCountAfterProcessing = imageDataModifiedCount;
+  CHECK_POINTER(playbackNode->GetImageData(), playbackImage);
+  CHECK_INT(memcmp(playbackNode->GetImageData()->GetScalarPointer(), images[0]->GetScalarPointer(), width * height * 2 * sizeof(short)), 0);
+  // Nothing new to process
+  CHECK_BOOL(playbackNode->ProcessDecodedFrames(), false);
+  CHECK_INT(imageDataModifiedCount, imageDataModifiedCountAfterProcessing);
+  playbackNode->SetDecodedFrameReadyCallback(nullptr, nullptr);
+  playbackNode->RemoveObserver(imageDataModifiedCallback);
+
+  // Disabling background decoding decodes the current frame synchronously
+  playbackNode->SetDecodedFrameCacheSize(0);
+  playbackNode->SetAndObserveFrame(frames[3]);
+  CHECK_BOOL(playbackNode->DecodeFrame(), true);
+  CHECK_BOOL(playbackNode->GetFrameDecodingInProgress(), false);
+  CHECK_INT(memcmp(playbackNode->GetImageData()->GetScalarPointer(), images[3]->GetScalarPointer(), width * height * 2 * sizeof(short)), 0);
+
   return EXIT_SUCCESS;
 }
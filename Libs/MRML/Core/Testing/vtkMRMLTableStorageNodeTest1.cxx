@@ -28,12 +28,20 @@
 #include "vtkStringArray.h"
 #include "vtkTable.h"
 
+#include <vtkByteSwap.h>
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
 //---------------------------------------------------------------------------
 int TestReadWriteWithoutSchema(vtkMRMLScene* scene);
 int TestReadWriteWithSchema(vtkMRMLScene* scene);
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected);
+int TestColumnarModifyAndRewrite(vtkMRMLScene* scene);
+int TestColumnarInvalidFile(vtkMRMLScene* scene);
 
 int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 {
@@ -52,6 +60,8 @@ int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 
   CHECK_EXIT_SUCCESS(TestReadWriteWithoutSchema(scene.GetPointer()));
   CHECK_EXIT_SUCCESS(TestReadWriteWithSchema(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestColumnarModifyAndRewrite(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestColumnarInvalidFile(scene.GetPointer()));
 
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
@@ -76,6 +86,7 @@ int TestReadWriteWithoutSchema(vtkMRMLScene* scene)
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".csv", table.GetPointer(), false));
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".tsv", table.GetPointer(), false));
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".txt", table.GetPointer(), false));
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".ctbl", table.GetPointer(), false));
 
   return EXIT_SUCCESS;
 }
@@ -109,6 +120,8 @@ int TestReadWriteWithSchema(vtkMRMLScene* scene)
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".csv", table.GetPointer(), true));
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".tsv", table.GetPointer(), true));
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".txt", table.GetPointer(), true));
+  // Column types and schema are stored in the columnar file itself
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".ctbl", table.GetPointer(), false));
 
   return EXIT_SUCCESS;
 }
@@ -186,3 +199,127 @@ int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* tabl
     }
   return EXIT_SUCCESS;
 }
+
+//---------------------------------------------------------------------------
+int TestColumnarModifyAndRewrite(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) +
+    std::string("/vtkMRMLTableStorageNodeTest1Rewrite.ctbl");
+  vtksys::SystemTools::RemoveFile(fileName);
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  CHECK_NOT_NULL(scene->AddNode(tableNode.GetPointer()));
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("values");
+  values->SetNumberOfTuples(1000);
+  for (vtkIdType row = 0; row < values->GetNumberOfTuples(); ++row)
+    {
+    values->SetValue(row, row * 0.5);
+    }
+  CHECK_NOT_NULL(tableNode->AddColumn(values.GetPointer()));
+  tableNode->SetColumnDescription("values", "half of the row index");
+
+  tableNode->AddDefaultStorageNode();
+  vtkMRMLStorageNode* storageNode = tableNode->GetStorageNode();
+  CHECK_NOT_NULL(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()), true);
+
+  // Read back, the schema is restored from the same file
+  tableNode->SetAndObserveTable(nullptr);
+  tableNode->SetAndObserveSchema(nullptr);
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+  CHECK_STD_STRING(tableNode->GetColumnDescription("values"), "half of the row index");
+  vtkDoubleArray* readValues = vtkDoubleArray::SafeDownCast(tableNode->GetTable()->GetColumnByName("values"));
+  CHECK_NOT_NULL(readValues);
+  CHECK_INT(readValues->GetNumberOfTuples(), 1000);
+  CHECK_DOUBLE(readValues->GetValue(999), 499.5);
+
+  // Modify the mapped column and the number of rows, then overwrite the file it is mapped from
+  readValues->SetValue(10, -1.0);
+  readValues->InsertNextValue(2000.0);
+  CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()), true);
+  tableNode->SetAndObserveTable(nullptr);
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+  readValues = vtkDoubleArray::SafeDownCast(tableNode->GetTable()->GetColumnByName("values"));
+  CHECK_NOT_NULL(readValues);
+  CHECK_INT(readValues->GetNumberOfTuples(), 1001);
+  CHECK_DOUBLE(readValues->GetValue(10), -1.0);
+  CHECK_DOUBLE(readValues->GetValue(11), 5.5);
+  CHECK_DOUBLE(readValues->GetValue(1000), 2000.0);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestColumnarInvalidFile(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) +
+    std::string("/vtkMRMLTableStorageNodeTest1Invalid.ctbl");
+  vtksys::SystemTools::RemoveFile(fileName);
+
+  vtkNew<vtkMRMLTableNode> tableNode;
+  CHECK_NOT_NULL(scene->AddNode(tableNode.GetPointer()));
+  vtkNew<vtkStringArray> names;
+  names->SetName("names");
+  names->InsertNextValue("first");
+  names->InsertNextValue("second");
+  names->InsertNextValue("third");
+  CHECK_NOT_NULL(tableNode->AddColumn(names.GetPointer()));
+  tableNode->AddDefaultStorageNode();
+  vtkMRMLStorageNode* storageNode = tableNode->GetStorageNode();
+  CHECK_NOT_NULL(storageNode);
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_BOOL(storageNode->WriteData(tableNode.GetPointer()), true);
+
+  std::string content;
+  {
+  std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::ostringstream contentStream;
+  contentStream << in.rdbuf();
+  content = contentStream.str();
+  }
+  vtkTypeUInt64 directoryOffset = 0;
+  CHECK_BOOL(content.size() > 24, true);
+  memcpy(&directoryOffset, &content[16], sizeof(directoryOffset));
+  vtkByteSwap::SwapLE(&directoryOffset);
+  CHECK_BOOL(directoryOffset + sizeof(vtkTypeUInt64) <= content.size(), true);
+
+  // Number of rows that the file cannot hold, more rows than the columns contain, truncated file:
+  // all are reported as errors without allocating the columns.
+  vtkTypeUInt64 invalidNumbersOfRows[2] = { static_cast<vtkTypeUInt64>(1) << 60, 1000 };
+  for (vtkTypeUInt64 invalidNumberOfRows : invalidNumbersOfRows)
+    {
+    std::string invalidContent = content;
+    vtkByteSwap::SwapLE(&invalidNumberOfRows);
+    memcpy(&invalidContent[static_cast<size_t>(directoryOffset)], &invalidNumberOfRows, sizeof(invalidNumberOfRows));
+    {
+    std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(invalidContent.c_str(), invalidContent.size());
+    }
+    TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+    CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), false);
+    TESTING_OUTPUT_ASSERT_ERRORS_END();
+    }
+
+  {
+  std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  out.write(content.c_str(), static_cast<std::streamsize>(directoryOffset + 4));
+  }
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // The original file is still valid
+  {
+  std::ofstream out(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  out.write(content.c_str(), content.size());
+  }
+  CHECK_BOOL(storageNode->ReadData(tableNode.GetPointer()), true);
+  vtkStringArray* readNames = vtkStringArray::SafeDownCast(tableNode->GetTable()->GetColumnByName("names"));
+  CHECK_NOT_NULL(readNames);
+  CHECK_INT(readNames->GetNumberOfValues(), 3);
+  CHECK_STD_STRING(readNames->GetValue(2), "third");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTimeSeriesDatabaseStorageNode.h"
+#include "vtkMRMLVolumeArchetypeStorageNode.h"
+
+// vtkITK includes
+#include <vtkITKTimeSeriesDatabase.h>
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <sstream>
+
+//---------------------------------------------------------------------------
+int vtkMRMLTimeSeriesDatabaseStorageNodeTest1(int argc, char * argv[] )
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkNew<vtkMRMLTimeSeriesDatabaseStorageNode> node1;
+  EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+
+  vtkNew<vtkMRMLScene> scene;
+  const char* tempDir = argv[1];
+  scene->SetRootDirectory(tempDir);
+
+  // Write a series of frames, the size is not a multiple of the block size
+  // so that partial blocks are exercised too.
+  const int numberOfFrames = 3;
+  std::string firstFrameFileName;
+  for (int frame = 0; frame < numberOfFrames; ++frame)
+    {
+    vtkNew<vtkImageData> imageData;
+    imageData->SetDimensions(20, 18, 17);
+    imageData->AllocateScalars(VTK_SHORT, 1);
+    imageData->GetPointData()->GetScalars()->Fill(10 * (frame + 1));
+
+    vtkNew<vtkMRMLScalarVolumeNode> frameNode;
+    frameNode->SetAndObserveImageData(imageData.GetPointer());
+    frameNode->SetSpacing(1.5, 2.0, 2.5);
+    frameNode->SetOrigin(10.0, 20.0, 30.0);
+
+    std::stringstream fileName;
+    fileName << tempDir << "/vtkMRMLTimeSeriesDatabaseStorageNodeTest1_" << frame << ".nrrd";
+    if (frame == 0)
+      {
+      firstFrameFileName = fileName.str();
+      }
+    vtkNew<vtkMRMLVolumeArchetypeStorageNode> frameStorageNode;
+    frameStorageNode->SetFileName(fileName.str().c_str());
+    CHECK_BOOL(frameStorageNode->WriteData(frameNode.GetPointer()), true);
+    }
+
+  std::string databaseFileName = std::string(tempDir) + "/vtkMRMLTimeSeriesDatabaseStorageNodeTest1.tsd";
+  vtkITKTimeSeriesDatabase::CreateFromFileArchetype(databaseFileName.c_str(), firstFrameFileName.c_str());
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode.GetPointer());
+  vtkNew<vtkMRMLTimeSeriesDatabaseStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  volumeNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  storageNode->SetFileName(databaseFileName.c_str());
+  storageNode->SetNumberOfPrefetchedFrames(1);
+
+  CHECK_INT(storageNode->GetNumberOfFrames(), 0);
+  CHECK_INT(storageNode->ReadData(volumeNode.GetPointer()), 1);
+  CHECK_INT(storageNode->GetNumberOfFrames(), numberOfFrames);
+  CHECK_NOT_NULL(volumeNode->GetImageData());
+  int* dimensions = volumeNode->GetImageData()->GetDimensions();
+  CHECK_INT(dimensions[0], 20);
+  CHECK_INT(dimensions[1], 18);
+  CHECK_INT(dimensions[2], 17);
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetSpacing()[2], 2.5, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetOrigin()[0], 10.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetImageData()->GetScalarComponentAsDouble(19, 17, 16, 0), 10.0, 0.0);
+
+  // Browse the frames, going back to the first one must be served from the cache
+  for (int frame = 1; frame < numberOfFrames; ++frame)
+    {
+    CHECK_INT(storageNode->ReadFrame(volumeNode.GetPointer(), frame), 1);
+    CHECK_DOUBLE_TOLERANCE(volumeNode->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0), 10.0 * (frame + 1), 0.0);
+    }
+  CHECK_INT(storageNode->ReadFrame(volumeNode.GetPointer(), 0), 1);
+  CHECK_DOUBLE_TOLERANCE(volumeNode->GetImageData()->GetScalarComponentAsDouble(5, 6, 7, 0), 10.0, 0.0);
+  CHECK_BOOL(storageNode->GetCacheHitRate() > 0.0, true);
+
+  // Out of range frames are rejected
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_INT(storageNode->ReadFrame(volumeNode.GetPointer(), numberOfFrames), 0);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  storageNode->CloseDatabase();
+  CHECK_INT(storageNode->GetNumberOfFrames(), 0);
+
+  return EXIT_SUCCESS;
+}
@@ -19,6 +19,7 @@
 
 class vtkImageAlgorithm;
 class vtkImageMapToColors;
+class vtkScalarsToColors;
 
 /// \brief MRML node for representing a volume display attributes.
 ///
@@ -56,6 +57,11 @@ class VTK_MRML_EXPORT vtkMRMLLabelMapVolumeDisplayNode : public vtkMRMLVolumeDis
 
   void UpdateImageDataPipeline() override;
 
+  /// Lookup table used to map the labels to colors, the table range is
+  /// adjusted for a 1:1 mapping of the label values.
+  /// It is updated by UpdateImageDataPipeline().
+  vtkScalarsToColors* GetLookupTable();
+
 protected:
   vtkMRMLLabelMapVolumeDisplayNode();
   ~vtkMRMLLabelMapVolumeDisplayNode() override;
@@ -0,0 +1,135 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLMappedFile.h"
+
+// STD includes
+#include <fstream>
+#include <limits>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+vtkMRMLMappedFile::vtkMRMLMappedFile() = default;
+
+//----------------------------------------------------------------------------
+vtkMRMLMappedFile::~vtkMRMLMappedFile()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMappedFile::Open(const std::string& fileName, bool copyOnWrite/*=false*/)
+{
+  this->Close();
+
+#if defined(_WIN32)
+  HANDLE fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ,
+    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (fileHandle != INVALID_HANDLE_VALUE)
+    {
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0
+      && static_cast<unsigned long long>(fileSize.QuadPart) <= std::numeric_limits<size_t>::max())
+      {
+      // The view keeps a reference to the mapping, which keeps the file open
+      HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr,
+        copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+      if (mappingHandle)
+        {
+        this->Data = static_cast<char*>(MapViewOfFile(mappingHandle,
+          copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+        if (this->Data)
+          {
+          this->Size = static_cast<size_t>(fileSize.QuadPart);
+          this->Mapped = true;
+          }
+        CloseHandle(mappingHandle);
+        }
+      }
+    CloseHandle(fileHandle);
+    }
+#else
+  int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+  if (fileDescriptor >= 0)
+    {
+    struct stat fileStat;
+    if (fstat(fileDescriptor, &fileStat) == 0 && fileStat.st_size > 0
+      && static_cast<unsigned long long>(fileStat.st_size) <= std::numeric_limits<size_t>::max())
+      {
+      void* mapped = mmap(nullptr, static_cast<size_t>(fileStat.st_size),
+        copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+      if (mapped != MAP_FAILED)
+        {
+        this->Data = static_cast<char*>(mapped);
+        this->Size = static_cast<size_t>(fileStat.st_size);
+        this->Mapped = true;
+        }
+      }
+    // The mapping stays valid after the file is closed
+    close(fileDescriptor);
+    }
+#endif
+  if (this->Mapped)
+    {
+    return true;
+    }
+
+  // Memory mapping is not available, read the whole file
+  std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!in.is_open())
+    {
+    return false;
+    }
+  in.seekg(0, std::ios::end);
+  std::streamoff fileSize = in.tellg();
+  if (fileSize <= 0 || static_cast<unsigned long long>(fileSize) > std::numeric_limits<size_t>::max())
+    {
+    return false;
+    }
+  in.seekg(0, std::ios::beg);
+  this->Buffer.resize(static_cast<size_t>(fileSize));
+  in.read(&this->Buffer[0], fileSize);
+  if (!in)
+    {
+    this->Buffer.clear();
+    return false;
+    }
+  this->Data = &this->Buffer[0];
+  this->Size = this->Buffer.size();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLMappedFile::Close()
+{
+  if (this->Mapped)
+    {
+#if defined(_WIN32)
+    UnmapViewOfFile(this->Data);
+#else
+    munmap(this->Data, this->Size);
+#endif
+    }
+  std::vector<char>().swap(this->Buffer);
+  this->Data = nullptr;
+  this->Size = 0;
+  this->Mapped = false;
+}
@@ -0,0 +1,52 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLMappedFile_h
+#define __vtkMRMLMappedFile_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// STD includes
+#include <string>
+#include <vector>
+
+/// \brief View of the whole content of a file, used by storage nodes for reading.
+///
+/// The file is memory-mapped if the platform supports it, otherwise it is read
+/// into memory. The file is released as soon as it is mapped, so that it can be
+/// replaced while the view is open (except on Windows).
+/// A view opened with copy-on-write can be modified without changing the file,
+/// the content of other views must not be modified.
+class VTK_MRML_EXPORT vtkMRMLMappedFile
+{
+public:
+  vtkMRMLMappedFile();
+  ~vtkMRMLMappedFile();
+
+  /// Map or read the whole file. Returns false if the file cannot be read or is empty.
+  bool Open(const std::string& fileName, bool copyOnWrite = false);
+  void Close();
+
+  char* GetData() const { return this->Data; }
+  size_t GetSize() const { return this->Size; }
+  /// Returns true if the file is memory-mapped, false if it was read into memory
+  bool IsMapped() const { return this->Mapped; }
+
+private:
+  vtkMRMLMappedFile(const vtkMRMLMappedFile&) = delete;
+  void operator=(const vtkMRMLMappedFile&) = delete;
+
+  char* Data{nullptr};
+  size_t Size{0};
+  bool Mapped{false};
+  std::vector<char> Buffer;
+};
+
+#endif
@@ -36,10 +36,308 @@ Version:   $Revision: 1.2 $
 #include <vtkLookupTable.h>
 #include <vtkPointData.h>
 #include <vtkVersion.h>
+#include <vtkWeakPointer.h>
 
 
 // STD includes
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+
+namespace
+{
+// Same percentiles as used with vtkImageHistogramStatistics in AutoLevelsHistogramFull mode
+const double AUTO_LEVELS_LOWER_PERCENTILE = 0.1;
+const double AUTO_LEVELS_UPPER_PERCENTILE = 99.9;
+// Integer images with a smaller range get one bin per value
+const int AUTO_LEVELS_MAXIMUM_NUMBER_OF_BINS = 16384;
+const int AUTO_LEVELS_MAXIMUM_NUMBER_OF_SLABS = 16;
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkMRMLScalarVolumeDisplayNodeSampleRange(vtkImageData* image, const int stride[3],
+  int zMin, int zMax, double range[2])
+{
+  int* extent = image->GetExtent();
+  vtkIdType increments[3];
+  image->GetIncrements(increments);
+  T* basePtr = static_cast<T*>(image->GetScalarPointer());
+  for (int z = zMin; z <= zMax; z += stride[2])
+    {
+    for (int y = extent[2]; y <= extent[3]; y += stride[1])
+      {
+      T* ptr = basePtr + (z - extent[4]) * increments[2] + (y - extent[2]) * increments[1];
+      for (int x = extent[0]; x <= extent[1]; x += stride[0], ptr += stride[0] * increments[0])
+        {
+        double value = static_cast<double>(*ptr);
+        range[0] = std::min(range[0], value);
+        range[1] = std::max(range[1], value);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkMRMLScalarVolumeDisplayNodeSampleHistogram(vtkImageData* image, const int stride[3],
+  int zMin, int zMax, double binOrigin, double binSpacing, std::vector<unsigned int>& bins)
+{
+  int* extent = image->GetExtent();
+  vtkIdType increments[3];
+  image->GetIncrements(increments);
+  T* basePtr = static_cast<T*>(image->GetScalarPointer());
+  const int lastBin = static_cast<int>(bins.size()) - 1;
+  const double binScale = 1.0 / binSpacing;
+  for (int z = zMin; z <= zMax; z += stride[2])
+    {
+    for (int y = extent[2]; y <= extent[3]; y += stride[1])
+      {
+      T* ptr = basePtr + (z - extent[4]) * increments[2] + (y - extent[2]) * increments[1];
+      for (int x = extent[0]; x <= extent[1]; x += stride[0], ptr += stride[0] * increments[0])
+        {
+        int bin = static_cast<int>((static_cast<double>(*ptr) - binOrigin) * binScale + 0.5);
+        bins[std::max(0, std::min(bin, lastBin))]++;
+        }
+      }
+    }
+}
+}
+
+//----------------------------------------------------------------------------
+/// Histogram of the input image kept between auto level computations.
+/// Sampled voxels are counted per slab of slices so that a change limited
+/// to some slices only requires counting these slices again.
+class vtkMRMLScalarVolumeDisplayNode::vtkInternal
+{
+public:
+  vtkInternal()
+    {
+    this->ImageMTime = 0;
+    this->Stride[0] = this->Stride[1] = this->Stride[2] = 1;
+    this->SlabThickness = 1;
+    this->BinOrigin = 0.0;
+    this->BinSpacing = 1.0;
+    this->TotalCount = 0;
+    this->ModifiedExtentValid = false;
+    }
+
+  void ComputeStride(vtkImageData* image, double tolerance, int stride[3]);
+  bool UpdateHistogram(vtkImageData* image, const int stride[3]);
+  void Rebuild(vtkImageData* image, const int stride[3]);
+  bool UpdateSlabs(vtkImageData* image, int firstSlab, int lastSlab);
+  void CountSlab(vtkImageData* image, int slab);
+  void GetPercentiles(double lowerPercentile, double upperPercentile, double range[2]);
+  int GetSlabZMin(int slab) { return this->Extent[4] + slab * this->SlabThickness; }
+  int GetSlabZMax(int slab) { return std::min(this->Extent[5], this->GetSlabZMin(slab) + this->SlabThickness - 1); }
+
+  vtkWeakPointer<vtkImageData> Image;
+  vtkMTimeType ImageMTime;
+  int Extent[6];
+  int ScalarType;
+  int Stride[3];
+  int SlabThickness;
+  double BinOrigin;
+  double BinSpacing;
+  std::vector< std::vector<unsigned int> > SlabHistograms;
+  std::vector<vtkIdType> Histogram;
+  vtkIdType TotalCount;
+
+  bool ModifiedExtentValid;
+  int ModifiedExtent[6];
+};
+
+//----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::vtkInternal::ComputeStride(vtkImageData* image, double tolerance, int stride[3])
+{
+  stride[0] = stride[1] = stride[2] = 1;
+  if (tolerance <= 0.0)
+    {
+    return;
+    }
+  // Standard error of the rank of percentile p estimated from n samples is
+  // sqrt(p(1-p)/n), find the number of samples that keeps it below tolerance.
+  double p = AUTO_LEVELS_LOWER_PERCENTILE / 100.0;
+  double requiredNumberOfSamples = p * (1.0 - p) / (tolerance * tolerance);
+  int* dimensions = image->GetDimensions();
+  double numberOfVoxels = static_cast<double>(dimensions[0]) * dimensions[1] * dimensions[2];
+  if (numberOfVoxels <= requiredNumberOfSamples)
+    {
+    return;
+    }
+  int numberOfSampledAxes = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+    numberOfSampledAxes += (dimensions[i] > 1 ? 1 : 0);
+    }
+  int axisStride = static_cast<int>(floor(pow(numberOfVoxels / requiredNumberOfSamples, 1.0 / numberOfSampledAxes)));
+  for (int i = 0; i < 3; ++i)
+    {
+    stride[i] = (dimensions[i] > 1 ? std::max(1, std::min(axisStride, dimensions[i])) : 1);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScalarVolumeDisplayNode::vtkInternal::UpdateHistogram(vtkImageData* image, const int stride[3])
+{
+  bool sameLayout = (this->Image == image && this->TotalCount > 0
+    && this->ScalarType == image->GetScalarType()
+    && std::equal(this->Stride, this->Stride + 3, stride)
+    && std::equal(this->Extent, this->Extent + 6, image->GetExtent()));
+  if (sameLayout && this->ImageMTime == image->GetMTime())
+    {
+    // Image has not changed since the histogram was computed
+    return true;
+    }
+  bool updated = false;
+  if (sameLayout && this->ModifiedExtentValid)
+    {
+    int zMin = std::max(this->ModifiedExtent[4], this->Extent[4]);
+    int zMax = std::min(this->ModifiedExtent[5], this->Extent[5]);
+    updated = (zMin > zMax ||
+      this->UpdateSlabs(image, (zMin - this->Extent[4]) / this->SlabThickness,
+                               (zMax - this->Extent[4]) / this->SlabThickness));
+    }
+  if (!updated)
+    {
+    this->Rebuild(image, stride);
+    }
+  this->ImageMTime = image->GetMTime();
+  this->ModifiedExtentValid = false;
+  return this->TotalCount > 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::vtkInternal::Rebuild(vtkImageData* image, const int stride[3])
+{
+  this->Image = image;
+  image->GetExtent(this->Extent);
+  this->ScalarType = image->GetScalarType();
+  std::copy(stride, stride + 3, this->Stride);
+  this->SlabHistograms.clear();
+  this->Histogram.clear();
+  this->TotalCount = 0;
+
+  int numberOfSampledSlices = (this->Extent[5] - this->Extent[4]) / stride[2] + 1;
+  if (this->Extent[5] < this->Extent[4] || this->Extent[3] < this->Extent[2] || this->Extent[1] < this->Extent[0])
+    {
+    return;
+    }
+  int slicesPerSlab = (numberOfSampledSlices + AUTO_LEVELS_MAXIMUM_NUMBER_OF_SLABS - 1) / AUTO_LEVELS_MAXIMUM_NUMBER_OF_SLABS;
+  // slabs start on a sampled slice
+  this->SlabThickness = slicesPerSlab * stride[2];
+  int numberOfSlabs = (this->Extent[5] - this->Extent[4]) / this->SlabThickness + 1;
+
+  double range[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  switch (this->ScalarType)
+    {
+    vtkTemplateMacro(vtkMRMLScalarVolumeDisplayNodeSampleRange<VTK_TT>(
+      image, this->Stride, this->Extent[4], this->Extent[5], range));
+    default:
+      return;
+    }
+
+  int numberOfBins = AUTO_LEVELS_MAXIMUM_NUMBER_OF_BINS;
+  this->BinOrigin = range[0];
+  this->BinSpacing = 1.0;
+  double valueRange = range[1] - range[0];
+  if (this->ScalarType != VTK_FLOAT && this->ScalarType != VTK_DOUBLE &&
+      valueRange < AUTO_LEVELS_MAXIMUM_NUMBER_OF_BINS)
+    {
+    // One bin per integer value: percentiles are exact
+    numberOfBins = static_cast<int>(valueRange) + 1;
+    }
+  else if (valueRange > 0.0)
+    {
+    this->BinSpacing = valueRange / (numberOfBins - 1);
+    }
+  else
+    {
+    numberOfBins = 1;
+    }
+
+  this->Histogram.assign(numberOfBins, 0);
+  this->SlabHistograms.assign(numberOfSlabs, std::vector<unsigned int>(numberOfBins, 0));
+  for (int slab = 0; slab < numberOfSlabs; ++slab)
+    {
+    this->CountSlab(image, slab);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLScalarVolumeDisplayNode::vtkInternal::UpdateSlabs(vtkImageData* image, int firstSlab, int lastSlab)
+{
+  // New values outside of the binned range require new bins
+  double range[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+  switch (this->ScalarType)
+    {
+    vtkTemplateMacro(vtkMRMLScalarVolumeDisplayNodeSampleRange<VTK_TT>(
+      image, this->Stride, this->GetSlabZMin(firstSlab), this->GetSlabZMax(lastSlab), range));
+    default:
+      return false;
+    }
+  double binMax = this->BinOrigin + (this->Histogram.size() - 1) * this->BinSpacing;
+  if (range[0] < this->BinOrigin - 0.5 * this->BinSpacing || range[1] > binMax + 0.5 * this->BinSpacing)
+    {
+    return false;
+    }
+  for (int slab = firstSlab; slab <= lastSlab; ++slab)
+    {
+    std::vector<unsigned int>& slabHistogram = this->SlabHistograms[slab];
+    for (size_t bin = 0; bin < slabHistogram.size(); ++bin)
+      {
+      this->Histogram[bin] -= slabHistogram[bin];
+      this->TotalCount -= slabHistogram[bin];
+      }
+    std::fill(slabHistogram.begin(), slabHistogram.end(), 0);
+    this->CountSlab(image, slab);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::vtkInternal::CountSlab(vtkImageData* image, int slab)
+{
+  std::vector<unsigned int>& slabHistogram = this->SlabHistograms[slab];
+  switch (this->ScalarType)
+    {
+    vtkTemplateMacro(vtkMRMLScalarVolumeDisplayNodeSampleHistogram<VTK_TT>(
+      image, this->Stride, this->GetSlabZMin(slab), this->GetSlabZMax(slab),
+      this->BinOrigin, this->BinSpacing, slabHistogram));
+    }
+  for (size_t bin = 0; bin < slabHistogram.size(); ++bin)
+    {
+    this->Histogram[bin] += slabHistogram[bin];
+    this->TotalCount += slabHistogram[bin];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::vtkInternal::GetPercentiles(
+  double lowerPercentile, double upperPercentile, double range[2])
+{
+  double lowerCount = this->TotalCount * lowerPercentile / 100.0;
+  double upperCount = this->TotalCount * upperPercentile / 100.0;
+  size_t lowerBin = 0;
+  size_t upperBin = this->Histogram.size() - 1;
+  vtkIdType cumulativeCount = 0;
+  bool lowerFound = false;
+  for (size_t bin = 0; bin < this->Histogram.size(); ++bin)
+    {
+    cumulativeCount += this->Histogram[bin];
+    if (!lowerFound && cumulativeCount > lowerCount)
+      {
+      lowerBin = bin;
+      lowerFound = true;
+      }
+    if (cumulativeCount >= upperCount)
+      {
+      upperBin = bin;
+      break;
+      }
+    }
+  range[0] = this->BinOrigin + lowerBin * this->BinSpacing;
+  range[1] = this->BinOrigin + upperBin * this->BinSpacing;
+}
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLScalarVolumeDisplayNode);
@@ -106,6 +404,9 @@ vtkMRMLScalarVolumeDisplayNode::vtkMRMLScalarVolumeDisplayNode()
 
   this->HistogramStatistics = nullptr;
   this->IsInCalculateAutoLevels = false;
+  this->AutoLevelsHistogramMode = AutoLevelsHistogramFull;
+  this->AutoLevelsSamplingTolerance = 1e-4;
+  this->Internal = new vtkInternal;
 
   vtkEventBroker::GetInstance()->AddObservation(
     this, vtkCommand::ModifiedEvent, this, this->MRMLCallbackCommand  , 10000.);
@@ -130,6 +431,7 @@ vtkMRMLScalarVolumeDisplayNode::~vtkMRMLScalarVolumeDisplayNode()
     this->HistogramStatistics->Delete();
     this->HistogramStatistics = nullptr;
     }
+  delete this->Internal;
 }
 
 //----------------------------------------------------------------------------
@@ -248,6 +550,12 @@ void vtkMRMLScalarVolumeDisplayNode::WriteXML(ostream& of, int nIndent)
   ss << this->AutoThreshold;
   of << " autoThreshold=\"" << ss.str() << "\"";
   }
+  of << " autoLevelsHistogramMode=\"" << this->GetAutoLevelsHistogramModeAsString(this->AutoLevelsHistogramMode) << "\"";
+  {
+  std::stringstream ss;
+  ss << this->AutoLevelsSamplingTolerance;
+  of << " autoLevelsSamplingTolerance=\"" << ss.str() << "\"";
+  }
   if (this->WindowLevelPresets.size() > 0)
     {
     for (int p = 0; p < this->GetNumberOfWindowLevelPresets(); p++)
@@ -334,6 +642,26 @@ void vtkMRMLScalarVolumeDisplayNode::ReadXMLAttributes(const char** atts)
       ss << attValue;
       ss >> this->AutoThreshold;
       }
+    else if (!strcmp(attName, "autoLevelsHistogramMode"))
+      {
+      int mode = this->GetAutoLevelsHistogramModeFromString(attValue);
+      if (mode >= 0)
+        {
+        this->SetAutoLevelsHistogramMode(mode);
+        }
+      else
+        {
+        vtkWarningMacro("ReadXMLAttributes: invalid autoLevelsHistogramMode: " << attValue);
+        }
+      }
+    else if (!strcmp(attName, "autoLevelsSamplingTolerance"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      double tolerance;
+      ss >> tolerance;
+      this->SetAutoLevelsSamplingTolerance(tolerance);
+      }
     else if (!strncmp(attName, "windowLevelPreset", 17))
       {
       this->AddWindowLevelPresetFromString(attValue);
@@ -355,6 +683,8 @@ void vtkMRMLScalarVolumeDisplayNode::Copy(vtkMRMLNode *anode)
 
   this->SetWindowLevelLocked(node->GetWindowLevelLocked());
   this->SetAutoWindowLevel( node->GetAutoWindowLevel() );
+  this->SetAutoLevelsHistogramMode(node->GetAutoLevelsHistogramMode());
+  this->SetAutoLevelsSamplingTolerance(node->GetAutoLevelsSamplingTolerance());
   this->SetWindowLevel(node->GetWindow(), node->GetLevel());
   this->SetAutoThreshold( node->GetAutoThreshold() ); // don't want to run CalculateAutoLevel
   this->SetApplyThreshold(node->GetApplyThreshold());
@@ -389,6 +719,62 @@ void vtkMRMLScalarVolumeDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "UpperThreshold:    " << this->GetUpperThreshold() << "\n";
   os << indent << "LowerThreshold:    " << this->GetLowerThreshold() << "\n";
   os << indent << "Interpolate:       " << this->Interpolate << "\n";
+  os << indent << "AutoLevelsHistogramMode: " << this->GetAutoLevelsHistogramModeAsString(this->AutoLevelsHistogramMode) << "\n";
+  os << indent << "AutoLevelsSamplingTolerance: " << this->AutoLevelsSamplingTolerance << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsHistogramModeAsString(int mode)
+{
+  switch (mode)
+    {
+    case AutoLevelsHistogramFull: return "Full";
+    case AutoLevelsHistogramCached: return "Cached";
+    case AutoLevelsHistogramSampled: return "Sampled";
+    default:
+      // invalid id
+      return "";
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLScalarVolumeDisplayNode::GetAutoLevelsHistogramModeFromString(const char* name)
+{
+  if (name == nullptr)
+    {
+    // invalid name
+    return -1;
+    }
+  for (int i = 0; i < AutoLevelsHistogramMode_Last; i++)
+    {
+    if (strcmp(name, GetAutoLevelsHistogramModeAsString(i)) == 0)
+      {
+      // found a matching name
+      return i;
+      }
+    }
+  // unknown name
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::NotifyImageDataModifiedExtent(const int extent[6])
+{
+  if (this->AutoLevelsHistogramMode == AutoLevelsHistogramFull)
+    {
+    return;
+    }
+  if (!this->Internal->ModifiedExtentValid)
+    {
+    std::copy(extent, extent + 6, this->Internal->ModifiedExtent);
+    this->Internal->ModifiedExtentValid = true;
+    return;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    this->Internal->ModifiedExtent[2 * i] = std::min(this->Internal->ModifiedExtent[2 * i], extent[2 * i]);
+    this->Internal->ModifiedExtent[2 * i + 1] = std::max(this->Internal->ModifiedExtent[2 * i + 1], extent[2 * i + 1]);
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -730,7 +1116,7 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     return;
     }
 
-  if (this->HistogramStatistics == nullptr)
+  if (this->AutoLevelsHistogramMode == AutoLevelsHistogramFull && this->HistogramStatistics == nullptr)
     {
     this->HistogramStatistics = vtkImageHistogramStatistics::New();
 
@@ -745,7 +1131,7 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     // Therefore, we choose small, symmetric percentile values here
     // and maybe add modality-specific methods later (e.g., for CT
     // images we could set lower value to -1000HU).
-    this->HistogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+    this->HistogramStatistics->SetAutoRangePercentiles(AUTO_LEVELS_LOWER_PERCENTILE, AUTO_LEVELS_UPPER_PERCENTILE);
 
     // Percentiles are very low (0.1%), so there is no need for
     // range expansion.
@@ -753,9 +1139,30 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     }
 
   this->IsInCalculateAutoLevels = true;
-  this->HistogramStatistics->SetInputData(imageDataScalar);
-  this->HistogramStatistics->Update();
-  double* intensityRange = this->HistogramStatistics->GetAutoRange();
+  double intensityRange[2] = { 0.0, 0.0 };
+  if (this->AutoLevelsHistogramMode == AutoLevelsHistogramFull)
+    {
+    this->HistogramStatistics->SetInputData(imageDataScalar);
+    this->HistogramStatistics->Update();
+    this->HistogramStatistics->GetAutoRange(intensityRange);
+    }
+  else
+    {
+    // The histogram is kept between calls and only counted again
+    // where the image changed.
+    int stride[3] = { 1, 1, 1 };
+    if (this->AutoLevelsHistogramMode == AutoLevelsHistogramSampled)
+      {
+      this->Internal->ComputeStride(imageDataScalar, this->AutoLevelsSamplingTolerance, stride);
+      }
+    if (!this->Internal->UpdateHistogram(imageDataScalar, stride))
+      {
+      vtkDebugMacro("CalculateScalarAutoLevels: input image data is empty");
+      this->IsInCalculateAutoLevels = false;
+      return;
+      }
+    this->Internal->GetPercentiles(AUTO_LEVELS_LOWER_PERCENTILE, AUTO_LEVELS_UPPER_PERCENTILE, intensityRange);
+    }
   vtkDebugMacro("CalculateScalarAutoLevels:"
                 << " lower: " << intensityRange[0] << " upper: " << intensityRange[1]);
 
@@ -126,6 +126,46 @@ class VTK_MRML_EXPORT vtkMRMLScalarVolumeDisplayNode : public vtkMRMLVolumeDispl
 
   virtual void SetThreshold(double lower, double upper);
 
+  /// Histogram modes used to compute the automatic window/level and threshold.
+  enum AutoLevelsHistogramModes
+    {
+    /// Compute the histogram of all the voxels each time the image changes
+    AutoLevelsHistogramFull = 0,
+    /// Keep the histogram of all the voxels, split in slabs of slices, and
+    /// only update the slabs of the extent given to
+    /// NotifyImageDataModifiedExtent() when the image changes
+    AutoLevelsHistogramCached,
+    /// Same as AutoLevelsHistogramCached but only voxels on a regular grid
+    /// are counted, see AutoLevelsSamplingTolerance
+    AutoLevelsHistogramSampled,
+    AutoLevelsHistogramMode_Last
+    };
+
+  ///
+  /// Histogram mode of the automatic window/level and threshold.
+  /// Default is AutoLevelsHistogramFull.
+  vtkGetMacro(AutoLevelsHistogramMode, int);
+  vtkSetClampMacro(AutoLevelsHistogramMode, int, AutoLevelsHistogramFull, AutoLevelsHistogramMode_Last - 1);
+  static const char* GetAutoLevelsHistogramModeAsString(int mode);
+  static int GetAutoLevelsHistogramModeFromString(const char* name);
+
+  ///
+  /// Upper bound of the expected error on the percentiles of the automatic
+  /// window/level in AutoLevelsHistogramSampled mode, as a fraction of the
+  /// number of voxels (rank error). The sampling grid is chosen so that
+  /// the standard error of the lowest percentile, sqrt(p(1-p)/n) for n
+  /// sampled voxels, stays below this value. Default is 1e-4.
+  vtkGetMacro(AutoLevelsSamplingTolerance, double);
+  vtkSetClampMacro(AutoLevelsSamplingTolerance, double, 1e-7, 1.0);
+
+  ///
+  /// Tell the display node that the next change of the input image only
+  /// affects the voxels within extent. Call it before invoking Modified()
+  /// on the image data so that the cached histogram is only updated for
+  /// that region. Successive calls are merged.
+  /// Ignored in AutoLevelsHistogramFull mode.
+  void NotifyImageDataModifiedExtent(const int extent[6]);
+
   ///
   /// Set/Get interpolate reformated slices
   vtkGetMacro(Interpolate, int);
@@ -243,6 +283,12 @@ protected:
   /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
   vtkImageHistogramStatistics *HistogramStatistics;
   bool IsInCalculateAutoLevels;
+
+  int AutoLevelsHistogramMode;
+  double AutoLevelsSamplingTolerance;
+
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
@@ -41,6 +41,7 @@
 #include <vtkCallbackCommand.h>
 #include <vtkGeneralTransform.h>
 #include <vtkHomogeneousTransform.h>
+#include <vtkImageCast.h>
 #include <vtkImageThreshold.h>
 #include <vtkIntArray.h>
 #include <vtkLookupTable.h>
@@ -1077,8 +1078,13 @@ double* vtkMRMLSegmentationNode::GetSegmentCenter(const std::string& segmentID)
     resampledLabelmap->SetSpacing(resampledSpacing);
     vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(effectiveExtentLabelmap, resampledLabelmap, resampledLabelmap, false, true);
 
+    // Island labels may not fit in the scalar type of the labelmap (typically unsigned char)
+    vtkNew<vtkImageCast> castToUnsignedInt;
+    castToUnsignedInt->SetInputData(resampledLabelmap);
+    castToUnsignedInt->SetOutputScalarTypeToUnsignedInt();
+
     vtkNew<vtkITKIslandMath> islandMath;
-    islandMath->SetInputData(resampledLabelmap);
+    islandMath->SetInputConnection(castToUnsignedInt->GetOutputPort());
 
     vtkNew<vtkImageThreshold> largestIslandFilter;
     largestIslandFilter->SetInputConnection(islandMath->GetOutputPort());
@@ -30,12 +30,386 @@ Care Ontario.
 // vtkAddon includes
 #include <vtkStreamingVolumeCodecFactory.h>
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLStreamingVolumeNode);
 
 const int NUMBER_OF_INTERNAL_IMAGEDATACONNECTION_OBSERVERS = 1;
 const int NUMBER_OF_INTERNAL_IMAGEDATA_OBSERVERS = 2;
 
+//----------------------------------------------------------------------------
+/// Background decoding of frames.
+/// The worker thread owns its own codec instance, so that the decoding state of the
+/// codec used on the main thread is not affected. Decoded images are kept in a
+/// least recently used cache, they are only handed over to the node on the main thread.
+/// Frame modification times are only read on the main thread, when the frame is requested.
+class vtkMRMLStreamingVolumeNode::vtkInternal
+{
+public:
+  vtkInternal(vtkMRMLStreamingVolumeNode* external);
+  ~vtkInternal();
+
+  vtkMRMLStreamingVolumeNode* External;
+
+  /// Set by the worker thread when a frame is decoded, reset on the main thread
+  /// when the decoded frames are processed.
+  std::atomic<bool> DecodedFrameReady;
+
+  /// Set the maximum number of cached images. 0 stops the worker and clears the cache.
+  void SetCacheSize(int cacheSize);
+
+  /// Decode this frame next, before any queued frame
+  void RequestFrame(vtkStreamingVolumeFrame* frame);
+  /// Decode this frame after the already queued frames, if it fits in the cache
+  void QueueFrame(vtkStreamingVolumeFrame* frame);
+  void ClearQueue();
+  void WaitForIdle();
+
+  /// Returns the decoded image of the frame if it is in the cache
+  vtkSmartPointer<vtkImageData> GetDecodedImage(vtkStreamingVolumeFrame* frame);
+
+  void SetDecodedFrameReadyCallback(DecodedFrameReadyCallbackType callback, void* clientData);
+
+private:
+  struct QueuedFrame
+  {
+    vtkSmartPointer<vtkStreamingVolumeFrame> Frame;
+    vtkMTimeType FrameMTime = 0;
+  };
+  struct CachedImage
+  {
+    vtkSmartPointer<vtkStreamingVolumeFrame> Frame;
+    vtkMTimeType FrameMTime;
+    vtkSmartPointer<vtkImageData> Image;
+  };
+
+  void StartWorker();
+  void StopWorker();
+  void Run();
+  /// Must be called with Mutex locked
+  bool IsCached(vtkStreamingVolumeFrame* frame, vtkMTimeType frameMTime);
+  bool IsQueued(vtkStreamingVolumeFrame* frame);
+  void TrimCache();
+  /// Called by the worker thread without the lock
+  vtkSmartPointer<vtkImageData> Decode(vtkStreamingVolumeFrame* frame);
+  void NotifyDecodedFrameReady();
+
+  std::mutex Mutex;
+  std::condition_variable WorkAvailable;
+  std::condition_variable WorkDone;
+  std::thread WorkerThread;
+  bool StopRequested = false;
+  bool Busy = false;
+  size_t CacheSize = 0;
+  QueuedFrame RequestedFrame;
+  std::deque<QueuedFrame> Queue;
+  /// Most recently used first
+  std::list<CachedImage> Cache;
+  /// Only used by the worker thread
+  vtkSmartPointer<vtkStreamingVolumeCodec> WorkerCodec;
+
+  /// Guards the callback, so that it is not called anymore once it is replaced
+  std::mutex CallbackMutex;
+  DecodedFrameReadyCallbackType DecodedFrameReadyCallback = nullptr;
+  void* DecodedFrameReadyClientData = nullptr;
+};
+
+//----------------------------------------------------------------------------
+vtkMRMLStreamingVolumeNode::vtkInternal::vtkInternal(vtkMRMLStreamingVolumeNode* external)
+  : External(external)
+  , DecodedFrameReady(false)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLStreamingVolumeNode::vtkInternal::~vtkInternal()
+{
+  this->StopWorker();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::SetCacheSize(int cacheSize)
+{
+  if (cacheSize <= 0)
+    {
+    this->StopWorker();
+    }
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->CacheSize = static_cast<size_t>(std::max(0, cacheSize));
+  if (this->CacheSize == 0)
+    {
+    this->RequestedFrame = QueuedFrame();
+    this->Queue.clear();
+    }
+  this->TrimCache();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::StartWorker()
+{
+  if (this->WorkerThread.joinable())
+    {
+    return;
+    }
+  this->StopRequested = false;
+  this->WorkerThread = std::thread(&vtkMRMLStreamingVolumeNode::vtkInternal::Run, this);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::StopWorker()
+{
+  if (!this->WorkerThread.joinable())
+    {
+    return;
+    }
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->StopRequested = true;
+    }
+  this->WorkAvailable.notify_all();
+  this->WorkerThread.join();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::RequestFrame(vtkStreamingVolumeFrame* frame)
+{
+  if (!frame)
+    {
+    return;
+    }
+  QueuedFrame requestedFrame;
+  requestedFrame.Frame = frame;
+  requestedFrame.FrameMTime = frame->GetMTime();
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->CacheSize == 0 || this->IsCached(frame, requestedFrame.FrameMTime))
+      {
+      return;
+      }
+    this->RequestedFrame = requestedFrame;
+    this->StartWorker();
+    }
+  this->WorkAvailable.notify_one();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::QueueFrame(vtkStreamingVolumeFrame* frame)
+{
+  if (!frame)
+    {
+    return;
+    }
+  QueuedFrame queuedFrame;
+  queuedFrame.Frame = frame;
+  queuedFrame.FrameMTime = frame->GetMTime();
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->Queue.size() >= this->CacheSize
+      || this->IsCached(frame, queuedFrame.FrameMTime) || this->IsQueued(frame))
+      {
+      return;
+      }
+    this->Queue.push_back(queuedFrame);
+    this->StartWorker();
+    }
+  this->WorkAvailable.notify_one();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::ClearQueue()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Queue.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::WaitForIdle()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->WorkDone.wait(lock, [this]()
+    {
+    return !this->WorkerThread.joinable() || (!this->Busy && !this->RequestedFrame.Frame && this->Queue.empty());
+    });
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> vtkMRMLStreamingVolumeNode::vtkInternal::GetDecodedImage(vtkStreamingVolumeFrame* frame)
+{
+  if (!frame)
+    {
+    return nullptr;
+    }
+  const vtkMTimeType frameMTime = frame->GetMTime();
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  for (std::list<CachedImage>::iterator it = this->Cache.begin(); it != this->Cache.end(); ++it)
+    {
+    if (it->Frame != frame)
+      {
+      continue;
+      }
+    if (it->FrameMTime != frameMTime)
+      {
+      // The frame has been modified since it was decoded
+      this->Cache.erase(it);
+      return nullptr;
+      }
+    this->Cache.splice(this->Cache.begin(), this->Cache, it);
+    return this->Cache.front().Image;
+    }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeNode::vtkInternal::IsCached(vtkStreamingVolumeFrame* frame, vtkMTimeType frameMTime)
+{
+  for (const CachedImage& cachedImage : this->Cache)
+    {
+    if (cachedImage.Frame == frame && cachedImage.FrameMTime == frameMTime)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeNode::vtkInternal::IsQueued(vtkStreamingVolumeFrame* frame)
+{
+  if (this->RequestedFrame.Frame == frame)
+    {
+    return true;
+    }
+  return std::find_if(this->Queue.begin(), this->Queue.end(),
+    [frame](const QueuedFrame& queuedFrame) { return queuedFrame.Frame == frame; }) != this->Queue.end();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::TrimCache()
+{
+  while (this->Cache.size() > this->CacheSize)
+    {
+    this->Cache.pop_back();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::Run()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  while (true)
+    {
+    this->WorkAvailable.wait(lock, [this]()
+      {
+      return this->StopRequested || this->RequestedFrame.Frame || !this->Queue.empty();
+      });
+    if (this->StopRequested)
+      {
+      break;
+      }
+
+    QueuedFrame frame;
+    bool requested = false;
+    if (this->RequestedFrame.Frame)
+      {
+      frame = this->RequestedFrame;
+      this->RequestedFrame = QueuedFrame();
+      requested = true;
+      }
+    else
+      {
+      frame = this->Queue.front();
+      this->Queue.pop_front();
+      }
+
+    // Busy until the callback returns, so that WaitForIdle() returns after the notification
+    this->Busy = true;
+    bool ready = false;
+    if (this->IsCached(frame.Frame, frame.FrameMTime))
+      {
+      // Decoded while it was queued, the node may be waiting for it
+      ready = requested;
+      }
+    else
+      {
+      lock.unlock();
+      vtkSmartPointer<vtkImageData> image = this->Decode(frame.Frame);
+      lock.lock();
+
+      if (image)
+        {
+        CachedImage cachedImage;
+        cachedImage.Frame = frame.Frame;
+        cachedImage.FrameMTime = frame.FrameMTime;
+        cachedImage.Image = image;
+        this->Cache.push_front(cachedImage);
+        this->TrimCache();
+        ready = true;
+        }
+      }
+    if (ready)
+      {
+      // Set after the image is in the cache, so that the main thread finds it
+      this->DecodedFrameReady = true;
+      lock.unlock();
+      this->NotifyDecodedFrameReady();
+      lock.lock();
+      }
+    this->Busy = false;
+    this->WorkDone.notify_all();
+    }
+  this->Busy = false;
+  this->WorkDone.notify_all();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::SetDecodedFrameReadyCallback(DecodedFrameReadyCallbackType callback, void* clientData)
+{
+  std::lock_guard<std::mutex> lock(this->CallbackMutex);
+  this->DecodedFrameReadyCallback = callback;
+  this->DecodedFrameReadyClientData = clientData;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::vtkInternal::NotifyDecodedFrameReady()
+{
+  std::lock_guard<std::mutex> lock(this->CallbackMutex);
+  if (this->DecodedFrameReadyCallback)
+    {
+    this->DecodedFrameReadyCallback(this->DecodedFrameReadyClientData);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> vtkMRMLStreamingVolumeNode::vtkInternal::Decode(vtkStreamingVolumeFrame* frame)
+{
+  if (!this->WorkerCodec || this->WorkerCodec->GetFourCC() != frame->GetCodecFourCC())
+    {
+    this->WorkerCodec = vtkSmartPointer<vtkStreamingVolumeCodec>::Take(
+      vtkStreamingVolumeCodecFactory::GetInstance()->CreateCodecByFourCC(frame->GetCodecFourCC()));
+    }
+  if (!this->WorkerCodec)
+    {
+    return nullptr;
+    }
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(frame->GetDimensions());
+  image->AllocateScalars(frame->GetVTKScalarType(), frame->GetNumberOfComponents());
+  if (!this->WorkerCodec->DecodeFrame(frame, image))
+    {
+    return nullptr;
+    }
+  return image;
+}
+
 //----------------------------------------------------------------------------
 // vtkMRMLStreamingVolumeNode methods
 
@@ -45,15 +419,20 @@ vtkMRMLStreamingVolumeNode::vtkMRMLStreamingVolumeNode()
   , Frame(nullptr)
   , FrameDecoded(false)
   , FrameDecodingInProgress(false)
+  , ImageDataUpdateInProgress(false)
+  , DecodedFrameCacheSize(0)
   , FrameModifiedCallbackCommand(vtkSmartPointer<vtkCallbackCommand>::New())
 {
+  this->Internal = new vtkInternal(this);
   this->FrameModifiedCallbackCommand->SetClientData(reinterpret_cast<void *>(this));
   this->FrameModifiedCallbackCommand->SetCallback(vtkMRMLStreamingVolumeNode::FrameModifiedCallback);
 }
 
 //-----------------------------------------------------------------------------
 vtkMRMLStreamingVolumeNode::~vtkMRMLStreamingVolumeNode()
-= default;
+{
+  delete this->Internal;
+}
 
 //---------------------------------------------------------------------------
 void vtkMRMLStreamingVolumeNode::FrameModifiedCallback(vtkObject *caller, unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
@@ -66,7 +445,13 @@ void vtkMRMLStreamingVolumeNode::FrameModifiedCallback(vtkObject *caller, unsign
 
   if (vtkStreamingVolumeFrame::SafeDownCast(caller) == self->Frame)
     {
-    if (self->HasExternalImageObserver())
+    if (self->DecodedFrameCacheSize > 0)
+      {
+      // Decode the modified frame in the background
+      self->FrameDecoded = false;
+      self->DecodeFrame();
+      }
+    else if (self->HasExternalImageObserver())
       {
       self->DecodeFrame();
       }
@@ -82,7 +467,7 @@ void vtkMRMLStreamingVolumeNode::ProcessMRMLEvents(vtkObject *caller, unsigned l
     this->ImageDataConnection->GetProducer() == vtkAlgorithm::SafeDownCast(caller) &&
     event == vtkCommand::ModifiedEvent)
     {
-    if (!this->FrameDecodingInProgress)
+    if (!this->ImageDataUpdateInProgress)
       {
       // The image data has been modified externally
       // This invalidates the contents of the current frame
@@ -104,7 +489,7 @@ bool vtkMRMLStreamingVolumeNode::IsKeyFrame()
 //---------------------------------------------------------------------------
 void vtkMRMLStreamingVolumeNode::SetAndObserveImageData(vtkImageData* imageData)
 {
-  if (!this->FrameDecodingInProgress)
+  if (!this->ImageDataUpdateInProgress)
     {
     // If no frame is being decoded, then this call is external
     // The current frame data is invalid
@@ -187,6 +572,7 @@ void vtkMRMLStreamingVolumeNode::SetAndObserveFrame(vtkStreamingVolumeFrame* fra
 
   this->Frame = frame;
   this->FrameDecoded = false;
+  this->FrameDecodingInProgress = false;
 
   if (this->Frame)
     {
@@ -199,7 +585,8 @@ void vtkMRMLStreamingVolumeNode::SetAndObserveFrame(vtkStreamingVolumeFrame* fra
 
     // If the image is being observed beyond the default internal observations of the volume node, then the frame should be decoded
     // since some external class is observing the image data.
-    if (this->HasExternalImageObserver())
+    // Frames are always queued for background decoding, it does not block and the image is ready sooner.
+    if (this->DecodedFrameCacheSize > 0 || this->HasExternalImageObserver())
       {
       this->DecodeFrame();
       }
@@ -211,7 +598,7 @@ void vtkMRMLStreamingVolumeNode::SetAndObserveFrame(vtkStreamingVolumeFrame* fra
 //---------------------------------------------------------------------------
 bool vtkMRMLStreamingVolumeNode::DecodeFrame()
 {
-  if (this->FrameDecodingInProgress)
+  if (this->ImageDataUpdateInProgress)
     {
     // Frame is already being decoded
     return true;
@@ -230,7 +617,19 @@ bool vtkMRMLStreamingVolumeNode::DecodeFrame()
     return true;
     }
 
+  if (this->DecodedFrameCacheSize > 0)
+    {
+    // Decode in the background, the current image is kept until the frame is decoded
+    if (!this->UpdateImageDataFromDecodedFrame())
+      {
+      this->FrameDecodingInProgress = true;
+      this->Internal->RequestFrame(this->Frame);
+      }
+    return true;
+    }
+
   this->FrameDecodingInProgress = true;
+  this->ImageDataUpdateInProgress = true;
   this->FrameDecoded = false;
 
   vtkSmartPointer<vtkImageData> imageData = Superclass::GetImageData();
@@ -262,10 +661,109 @@ bool vtkMRMLStreamingVolumeNode::DecodeFrame()
     this->FrameDecoded = true;
     }
   this->SetAndObserveImageData(imageData);
+  this->ImageDataUpdateInProgress = false;
   this->FrameDecodingInProgress = false;
   return success;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::SetDecodedFrameCacheSize(int cacheSize)
+{
+  cacheSize = std::max(0, cacheSize);
+  if (this->DecodedFrameCacheSize == cacheSize)
+    {
+    return;
+    }
+  this->DecodedFrameCacheSize = cacheSize;
+  this->Internal->SetCacheSize(cacheSize);
+  if (cacheSize == 0 && this->FrameDecodingInProgress)
+    {
+    // The background request has been cancelled, decode the frame now
+    this->FrameDecodingInProgress = false;
+    this->DecodeFrame();
+    }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::QueueFrameForDecoding(vtkStreamingVolumeFrame* frame)
+{
+  if (this->DecodedFrameCacheSize <= 0)
+    {
+    return;
+    }
+  this->Internal->QueueFrame(frame);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::ClearDecodingQueue()
+{
+  this->Internal->ClearQueue();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::WaitForDecoding()
+{
+  this->Internal->WaitForIdle();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLStreamingVolumeNode::SetDecodedFrameReadyCallback(DecodedFrameReadyCallbackType callback, void* clientData)
+{
+  this->Internal->SetDecodedFrameReadyCallback(callback, clientData);
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeNode::IsDecodedFrameReady()
+{
+  return this->Internal->DecodedFrameReady;
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeNode::ProcessDecodedFrames()
+{
+  // Reset the flag before looking up the cache: frames decoded after this point set it again
+  if (!this->Internal->DecodedFrameReady.exchange(false))
+    {
+    return false;
+    }
+  return this->UpdateImageDataFromDecodedFrame();
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLStreamingVolumeNode::UpdateImageDataFromDecodedFrame()
+{
+  if (!this->Frame || this->FrameDecoded || this->DecodedFrameCacheSize <= 0)
+    {
+    return false;
+    }
+  vtkSmartPointer<vtkImageData> decodedImage = this->Internal->GetDecodedImage(this->Frame);
+  if (!decodedImage)
+    {
+    return false;
+    }
+
+  // Copy into the current image, so that the cached image cannot be modified through the node
+  // and the image data object observed by the displayable managers stays the same.
+  vtkSmartPointer<vtkImageData> imageData = Superclass::GetImageData();
+  if (!imageData)
+    {
+    imageData = vtkSmartPointer<vtkImageData>::New();
+    }
+  int wasModifying = this->StartModify();
+  this->ImageDataUpdateInProgress = true;
+  imageData->DeepCopy(decodedImage);
+  this->FrameDecoded = true;
+  this->FrameDecodingInProgress = false;
+  this->SetAndObserveImageData(imageData);
+  this->ImageDataUpdateInProgress = false;
+  // The image data object may be the same, notify observers explicitly
+  this->Modified();
+  this->InvokeCustomModifiedEvent(vtkMRMLVolumeNode::ImageDataModifiedEvent);
+  this->EndModify(wasModifying);
+  return true;
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLStreamingVolumeNode::EncodeImageData(bool forceKeyFrame/*=false*/)
 {
@@ -365,5 +863,7 @@ void vtkMRMLStreamingVolumeNode::PrintSelf(ostream& os, vtkIndent indent)
     {
     vtkMRMLPrintStdStringMacro(CodecFourCC);
     }
+  vtkMRMLPrintIntMacro(DecodedFrameCacheSize);
+  vtkMRMLPrintBooleanMacro(FrameDecodingInProgress);
   vtkMRMLPrintEndMacro();
 }
@@ -85,8 +85,55 @@ public:
 
   /// Decodes the current frame and stores the contents in the volume node as vtkImageData
   /// Returns true if the frame is successfully decoded
+  /// If background decoding is enabled, the frame is queued for decoding and the method returns
+  /// immediately, the image data is updated by ProcessDecodedFrames() once the frame is decoded.
+  /// \sa SetDecodedFrameCacheSize()
   virtual bool DecodeFrame();
 
+  /// Maximum number of decoded images kept in the background decoding cache.
+  /// If greater than zero, frames are decoded by a worker thread as soon as they are set and
+  /// DecodeFrame() does not block: the previous image is kept until the current frame is decoded.
+  /// The worker then calls the decoded frame ready callback and ProcessDecodedFrames() must be called
+  /// from the main thread (vtkMRMLApplicationLogic does it for the nodes of its scene).
+  /// 0 (default) disables background decoding, frames are decoded when they are requested.
+  void SetDecodedFrameCacheSize(int cacheSize);
+  vtkGetMacro(DecodedFrameCacheSize, int);
+
+  /// Decode a frame ahead of time in the background, typically one of the frames that follow the
+  /// current frame in the playback direction. Queued frames are decoded in order, frames that do
+  /// not fit in the cache are ignored. Frames must not be modified while they are queued.
+  /// Has no effect if background decoding is disabled.
+  void QueueFrameForDecoding(vtkStreamingVolumeFrame* frame);
+
+  /// Remove the frames waiting to be decoded in the background, for example when the
+  /// playback direction changes. The current frame is kept in the queue.
+  void ClearDecodingQueue();
+
+  /// Update the image data if the current frame has been decoded in the background,
+  /// and invoke ModifiedEvent and ImageDataModifiedEvent.
+  /// Must be called from the main thread, typically scheduled by the decoded frame ready callback.
+  /// Returns true if the image data was updated.
+  bool ProcessDecodedFrames();
+
+  /// Returns true if frames have been decoded in the background since the last
+  /// call of ProcessDecodedFrames(). Can be called from any thread.
+  bool IsDecodedFrameReady();
+
+  /// Function called by the background decoding thread (not the main thread) when a frame has been decoded.
+  /// It must not access the node but schedule a call of ProcessDecodedFrames() on the main thread.
+  typedef void (*DecodedFrameReadyCallbackType)(void* clientData);
+
+  /// Set the function that is called when a frame has been decoded in the background.
+  /// Once this method returns, the previous callback is not running and is not called anymore.
+  /// vtkMRMLApplicationLogic sets it for the streaming volume nodes of its scene.
+  void SetDecodedFrameReadyCallback(DecodedFrameReadyCallbackType callback, void* clientData);
+
+  /// Block until all queued frames are decoded.
+  void WaitForDecoding();
+
+  /// Returns true while the current frame is being decoded, in the background or not
+  vtkGetMacro(FrameDecodingInProgress, bool);
+
   /// Returns true if the current frame is a keyframe
   /// Keyframes are not interpolated and don't require any additional frames in order to be decoded to an uncompressed image
   virtual bool IsKeyFrame();
@@ -94,6 +141,8 @@ public:
   /// Callback that is called if the current frame is modified
   /// Invokes FrameModifiedEvent
   static void FrameModifiedCallback(vtkObject *caller, unsigned long eid, void* clientData, void* callData);
+
+  /// FrameModifiedEvent is invoked when the current frame is changed or modified.
   enum
   {
     FrameModifiedEvent = 18002
@@ -125,14 +174,22 @@ protected:
   /// Returns true if the number of observers on the ImageData or ImageDataConnection is greater than the default expected number
   bool HasExternalImageObserver();
 
+  /// Copy the decoded image of the current frame into the image data if it is in the background decoding cache.
+  /// Returns true if the image data was updated.
+  bool UpdateImageDataFromDecodedFrame();
+
 protected:
   vtkSmartPointer<vtkStreamingVolumeCodec> Codec;
   std::string                              CodecFourCC;
   vtkSmartPointer<vtkStreamingVolumeFrame> Frame;
   bool                                     FrameDecoded;
   bool                                     FrameDecodingInProgress;
+  bool                                     ImageDataUpdateInProgress;
+  int                                      DecodedFrameCacheSize;
   vtkSmartPointer<vtkCallbackCommand>      FrameModifiedCallbackCommand;
 
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif
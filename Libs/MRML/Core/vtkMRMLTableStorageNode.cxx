@@ -22,11 +22,13 @@
 
 // MRML includes
 #include "vtkMRMLTableStorageNode.h"
+#include "vtkMRMLMappedFile.h"
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLScene.h"
 
 // VTK includes
 #include <vtkObjectFactory.h>
+#include <vtkByteSwap.h>
 #include <vtkDelimitedTextReader.h>
 #include <vtkDelimitedTextWriter.h>
 #include <vtkErrorSink.h>
@@ -36,11 +38,394 @@
 #include <vtkNew.h>
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableStorageNode);
 
 const char* COMPONENT_SEPERATOR = "_";
 
+//------------------------------------------------------------------------------
+// Columnar binary table file (.ctbl) layout. All values are little endian.
+//
+//   char[8]   magic ("MRMLCTBL")
+//   uint32    version
+//   uint32    number of tables (1, or 2 if the schema is stored)
+//   uint64    directory offset
+//   ...       column data blocks, each aligned to 64 bytes
+//   directory, for each table (table then schema):
+//     uint64  number of rows
+//     uint32  number of columns
+//     for each column:
+//       string  name (uint32 length followed by the characters)
+//       int32   VTK data type
+//       int32   number of components
+//       uint32  number of component names, followed by the names as strings
+//       uint64  offset of the data block
+//       uint64  size of the data block in bytes
+//
+// Numeric columns are stored as the raw values of the array, bit columns
+// packed, and string columns as uint64 offsets[numberOfValues+1] followed by
+// the characters. Numeric blocks are used in place from the memory-mapped
+// file when a table is read, except on Windows where a mapped file cannot be
+// replaced: blocks are copied and the file is released once it is read.
+
+static const char COLUMNAR_MAGIC[8] = { 'M', 'R', 'M', 'L', 'C', 'T', 'B', 'L' };
+static const vtkTypeUInt32 COLUMNAR_VERSION = 1;
+static const size_t COLUMNAR_HEADER_SIZE = 24;
+static const size_t COLUMNAR_ALIGNMENT = 64;
+
+#if !defined(_WIN32) && !defined(VTK_WORDS_BIGENDIAN)
+# define COLUMNAR_USE_BLOCKS_IN_PLACE
+#endif
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+template<class T> void WriteLE(std::ostream& out, T value)
+{
+  vtkByteSwap::SwapLE(&value);
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//------------------------------------------------------------------------------
+void WriteColumnarString(std::ostream& out, const std::string& value)
+{
+  WriteLE<vtkTypeUInt32>(out, static_cast<vtkTypeUInt32>(value.size()));
+  out.write(value.c_str(), value.size());
+}
+
+//------------------------------------------------------------------------------
+/// Bounds checked reading of little endian values from a file view.
+class ColumnarParser
+{
+public:
+  ColumnarParser(const char* data, size_t size, size_t position)
+    : Data(data), Size(size), Position(position), Valid(position <= size)
+    {
+    }
+
+  template<class T> T Read()
+    {
+    T value = T();
+    if (!this->Valid || this->Size - this->Position < sizeof(T))
+      {
+      this->Valid = false;
+      return value;
+      }
+    memcpy(&value, this->Data + this->Position, sizeof(T));
+    vtkByteSwap::SwapLE(&value);
+    this->Position += sizeof(T);
+    return value;
+    }
+
+  std::string ReadString()
+    {
+    vtkTypeUInt32 length = this->Read<vtkTypeUInt32>();
+    if (!this->Valid || this->Size - this->Position < length)
+      {
+      this->Valid = false;
+      return std::string();
+      }
+    std::string value(this->Data + this->Position, length);
+    this->Position += length;
+    return value;
+    }
+
+  const char* Data;
+  size_t Size;
+  size_t Position;
+  bool Valid;
+};
+
+//------------------------------------------------------------------------------
+// Numeric columns that point into a file view keep the view alive until
+// VTK releases their memory. VTK only passes the pointer to the free function,
+// so the views are looked up by column data pointer.
+// The map is intentionally never destroyed, arrays may be released at exit.
+typedef std::map<void*, std::shared_ptr<vtkMRMLMappedFile> > ColumnarBlockMap;
+
+std::mutex& GetColumnarBlocksMutex()
+{
+  static std::mutex* mutex = new std::mutex;
+  return *mutex;
+}
+
+ColumnarBlockMap& GetColumnarBlocks()
+{
+  static ColumnarBlockMap* blocks = new ColumnarBlockMap;
+  return *blocks;
+}
+
+void ReleaseColumnarBlock(void* block)
+{
+  std::lock_guard<std::mutex> lock(GetColumnarBlocksMutex());
+  GetColumnarBlocks().erase(block);
+}
+
+//------------------------------------------------------------------------------
+bool IsColumnarNumericType(int dataType)
+{
+  switch (dataType)
+    {
+    case VTK_CHAR:
+    case VTK_SIGNED_CHAR:
+    case VTK_UNSIGNED_CHAR:
+    case VTK_SHORT:
+    case VTK_UNSIGNED_SHORT:
+    case VTK_INT:
+    case VTK_UNSIGNED_INT:
+    case VTK_LONG:
+    case VTK_UNSIGNED_LONG:
+    case VTK_LONG_LONG:
+    case VTK_UNSIGNED_LONG_LONG:
+    case VTK_ID_TYPE:
+    case VTK_FLOAT:
+    case VTK_DOUBLE:
+      return true;
+    default:
+      return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// Column description read from or written to the directory
+struct ColumnarColumn
+{
+  std::string Name;
+  vtkTypeInt32 DataType{VTK_STRING};
+  vtkTypeInt32 NumberOfComponents{1};
+  std::vector<std::string> ComponentNames;
+  vtkTypeUInt64 Offset{0};
+  vtkTypeUInt64 Size{0};
+};
+
+//------------------------------------------------------------------------------
+/// Write the data block of a column and return its description.
+/// Columns that are neither numeric nor bit arrays are written as strings.
+ColumnarColumn WriteColumnarBlock(std::ostream& out, vtkAbstractArray* array, vtkIdType numberOfRows)
+{
+  ColumnarColumn column;
+  column.Name = (array->GetName() ? array->GetName() : "");
+  column.NumberOfComponents = array->GetNumberOfComponents();
+  column.ComponentNames = vtkMRMLTableNode::GetComponentNamesFromArray(array);
+  column.DataType = array->GetDataType();
+
+  // Align the block
+  std::streamoff position = out.tellp();
+  size_t padding = (COLUMNAR_ALIGNMENT - static_cast<size_t>(position) % COLUMNAR_ALIGNMENT) % COLUMNAR_ALIGNMENT;
+  static const char zeros[COLUMNAR_ALIGNMENT] = { 0 };
+  out.write(zeros, padding);
+  column.Offset = static_cast<vtkTypeUInt64>(position) + padding;
+
+  vtkIdType numberOfValues = numberOfRows * column.NumberOfComponents;
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  if (dataArray && IsColumnarNumericType(column.DataType))
+    {
+    int valueSize = dataArray->GetDataTypeSize();
+    column.Size = static_cast<vtkTypeUInt64>(numberOfValues) * valueSize;
+    if (numberOfValues > 0)
+      {
+#ifdef VTK_WORDS_BIGENDIAN
+      std::vector<char> swapped(static_cast<size_t>(column.Size));
+      memcpy(&swapped[0], dataArray->GetVoidPointer(0), swapped.size());
+      vtkByteSwap::SwapVoidRange(&swapped[0], numberOfValues, valueSize);
+      out.write(&swapped[0], static_cast<std::streamsize>(swapped.size()));
+#else
+      out.write(static_cast<const char*>(dataArray->GetVoidPointer(0)), static_cast<std::streamsize>(column.Size));
+#endif
+      }
+    }
+  else if (vtkBitArray::SafeDownCast(array))
+    {
+    column.Size = (static_cast<vtkTypeUInt64>(numberOfValues) + 7) / 8;
+    if (numberOfValues > 0)
+      {
+      out.write(reinterpret_cast<const char*>(vtkBitArray::SafeDownCast(array)->GetPointer(0)),
+        static_cast<std::streamsize>(column.Size));
+      }
+    }
+  else
+    {
+    column.DataType = VTK_STRING;
+    vtkStringArray* stringArray = vtkStringArray::SafeDownCast(array);
+    std::vector<std::string> values(numberOfValues);
+    for (vtkIdType valueIndex = 0; valueIndex < numberOfValues; ++valueIndex)
+      {
+      values[valueIndex] = (stringArray ? stringArray->GetValue(valueIndex)
+        : array->GetVariantValue(valueIndex).ToString());
+      }
+    vtkTypeUInt64 offset = 0;
+    WriteLE<vtkTypeUInt64>(out, offset);
+    for (const std::string& value : values)
+      {
+      offset += value.size();
+      WriteLE<vtkTypeUInt64>(out, offset);
+      }
+    for (const std::string& value : values)
+      {
+      out.write(value.c_str(), value.size());
+      }
+    column.Size = (values.size() + 1) * sizeof(vtkTypeUInt64) + offset;
+    }
+  return column;
+}
+
+//------------------------------------------------------------------------------
+void WriteColumnarDirectory(std::ostream& out, vtkIdType numberOfRows, const std::vector<ColumnarColumn>& columns)
+{
+  WriteLE<vtkTypeUInt64>(out, static_cast<vtkTypeUInt64>(numberOfRows));
+  WriteLE<vtkTypeUInt32>(out, static_cast<vtkTypeUInt32>(columns.size()));
+  for (const ColumnarColumn& column : columns)
+    {
+    WriteColumnarString(out, column.Name);
+    WriteLE<vtkTypeInt32>(out, column.DataType);
+    WriteLE<vtkTypeInt32>(out, column.NumberOfComponents);
+    WriteLE<vtkTypeUInt32>(out, static_cast<vtkTypeUInt32>(column.ComponentNames.size()));
+    for (const std::string& componentName : column.ComponentNames)
+      {
+      WriteColumnarString(out, componentName);
+      }
+    WriteLE<vtkTypeUInt64>(out, column.Offset);
+    WriteLE<vtkTypeUInt64>(out, column.Size);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// Maximum number of values that a file view can describe (bit columns store 8 values per byte).
+/// Used for rejecting invalid sizes before anything is allocated.
+vtkTypeUInt64 GetColumnarMaximumNumberOfValues(const vtkMRMLMappedFile& view)
+{
+  return static_cast<vtkTypeUInt64>(view.GetSize()) * 8;
+}
+
+//------------------------------------------------------------------------------
+/// Create the array of a column from its data block.
+/// Numeric columns use the block in place if the platform allows it.
+/// The block is validated before any allocation, returns nullptr if it is invalid.
+vtkSmartPointer<vtkAbstractArray> ReadColumnarBlock(const std::shared_ptr<vtkMRMLMappedFile>& view,
+  const ColumnarColumn& column, vtkTypeUInt64 numberOfRows)
+{
+  if (column.NumberOfComponents < 1 || column.Offset > view->GetSize() || view->GetSize() - column.Offset < column.Size
+    || numberOfRows > GetColumnarMaximumNumberOfValues(*view) / static_cast<vtkTypeUInt64>(column.NumberOfComponents))
+    {
+    return nullptr;
+    }
+  char* block = view->GetData() + column.Offset;
+  vtkIdType numberOfValues = static_cast<vtkIdType>(numberOfRows * column.NumberOfComponents);
+
+  vtkSmartPointer<vtkAbstractArray> array;
+  if (IsColumnarNumericType(column.DataType))
+    {
+    vtkSmartPointer<vtkDataArray> dataArray = vtkSmartPointer<vtkDataArray>::Take(
+      vtkDataArray::CreateDataArray(column.DataType));
+    dataArray->SetNumberOfComponents(column.NumberOfComponents);
+    if (column.Size != static_cast<vtkTypeUInt64>(numberOfValues) * dataArray->GetDataTypeSize()
+      || column.Offset % dataArray->GetDataTypeSize() != 0)
+      {
+      return nullptr;
+      }
+    if (numberOfValues == 0)
+      {
+      dataArray->SetNumberOfTuples(0);
+      }
+    else
+      {
+#ifdef COLUMNAR_USE_BLOCKS_IN_PLACE
+      {
+      std::lock_guard<std::mutex> lock(GetColumnarBlocksMutex());
+      GetColumnarBlocks()[block] = view;
+      }
+      dataArray->SetVoidArray(block, numberOfValues, 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+      dataArray->SetArrayFreeFunction(ReleaseColumnarBlock);
+#else
+      dataArray->SetNumberOfTuples(static_cast<vtkIdType>(numberOfRows));
+      memcpy(dataArray->GetVoidPointer(0), block, column.Size);
+# ifdef VTK_WORDS_BIGENDIAN
+      vtkByteSwap::SwapVoidRange(dataArray->GetVoidPointer(0), numberOfValues, dataArray->GetDataTypeSize());
+# endif
+#endif
+      }
+    array = dataArray;
+    }
+  else if (column.DataType == VTK_BIT)
+    {
+    vtkSmartPointer<vtkBitArray> bitArray = vtkSmartPointer<vtkBitArray>::New();
+    bitArray->SetNumberOfComponents(column.NumberOfComponents);
+    if (column.Size != (static_cast<vtkTypeUInt64>(numberOfValues) + 7) / 8)
+      {
+      return nullptr;
+      }
+    bitArray->SetNumberOfTuples(static_cast<vtkIdType>(numberOfRows));
+    if (numberOfValues > 0)
+      {
+      memcpy(bitArray->GetPointer(0), block, column.Size);
+      }
+    array = bitArray;
+    }
+  else if (column.DataType == VTK_STRING)
+    {
+    vtkTypeUInt64 offsetsSize = (static_cast<vtkTypeUInt64>(numberOfValues) + 1) * sizeof(vtkTypeUInt64);
+    if (column.Size < offsetsSize)
+      {
+      return nullptr;
+      }
+    vtkTypeUInt64 stringsSize = column.Size - offsetsSize;
+    const char* strings = block + offsetsSize;
+
+    // Check all the offsets before allocating the strings
+    ColumnarParser offsets(block, static_cast<size_t>(offsetsSize), 0);
+    vtkTypeUInt64 start = offsets.Read<vtkTypeUInt64>();
+    if (start > stringsSize)
+      {
+      return nullptr;
+      }
+    for (vtkIdType valueIndex = 0; valueIndex < numberOfValues; ++valueIndex)
+      {
+      vtkTypeUInt64 end = offsets.Read<vtkTypeUInt64>();
+      if (!offsets.Valid || start > end || end > stringsSize)
+        {
+        return nullptr;
+        }
+      start = end;
+      }
+
+    vtkSmartPointer<vtkStringArray> stringArray = vtkSmartPointer<vtkStringArray>::New();
+    stringArray->SetNumberOfComponents(column.NumberOfComponents);
+    stringArray->SetNumberOfTuples(static_cast<vtkIdType>(numberOfRows));
+    offsets.Position = 0;
+    start = offsets.Read<vtkTypeUInt64>();
+    for (vtkIdType valueIndex = 0; valueIndex < numberOfValues; ++valueIndex)
+      {
+      vtkTypeUInt64 end = offsets.Read<vtkTypeUInt64>();
+      stringArray->SetValue(valueIndex, std::string(strings + start, static_cast<size_t>(end - start)));
+      start = end;
+      }
+    array = stringArray;
+    }
+  else
+    {
+    return nullptr;
+    }
+
+  array->SetName(column.Name.c_str());
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  for (int componentIndex = 0; dataArray && componentIndex < static_cast<int>(column.ComponentNames.size())
+    && componentIndex < column.NumberOfComponents; ++componentIndex)
+    {
+    dataArray->SetComponentName(componentIndex, column.ComponentNames[componentIndex].c_str());
+    }
+  return array;
+}
+
+}
+
 //----------------------------------------------------------------------------
 vtkMRMLTableStorageNode::vtkMRMLTableStorageNode()
 {
@@ -88,6 +473,18 @@ int vtkMRMLTableStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     return 0;
     }
 
+  if (this->GetLowercaseExtensionFromFileName(fullName) == ".ctbl")
+    {
+    // Schema is stored in the same file
+    if (!this->ReadColumnarTable(fullName, tableNode))
+      {
+      vtkErrorMacro("ReadData: failed to read table from '" << fullName << "'");
+      return 0;
+      }
+    vtkDebugMacro("ReadData: successfully read table from file: " << fullName);
+    return 1;
+    }
+
   if (this->GetSchemaFileName().empty() && this->AutoFindSchema)
     {
     this->SetSchemaFileName(this->FindSchemaFileName(fullName.c_str()).c_str());
@@ -133,6 +530,18 @@ int vtkMRMLTableStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     return 0;
     }
 
+  if (this->GetLowercaseExtensionFromFileName(fullName) == ".ctbl")
+    {
+    // Column types and schema are stored in the same file
+    if (!this->WriteColumnarTable(fullName, tableNode))
+      {
+      vtkErrorMacro("WriteData: failed to write table node " << refNode->GetID() << " to file " << fullName);
+      return 0;
+      }
+    vtkDebugMacro("WriteData: successfully wrote table to file: " << fullName);
+    return 1;
+    }
+
   if (!this->WriteTable(fullName, tableNode))
     {
     vtkErrorMacro("WriteData: failed to write table node " << refNode->GetID() << " to file " << fullName);
@@ -183,6 +592,7 @@ void vtkMRMLTableStorageNode::InitializeSupportedReadFileTypes()
   this->SupportedReadFileTypes->InsertNextValue("Tab-separated values (.tsv)");
   this->SupportedReadFileTypes->InsertNextValue("Comma-separated values (.csv)");
   this->SupportedReadFileTypes->InsertNextValue("Text (.txt)");
+  this->SupportedReadFileTypes->InsertNextValue("Columnar binary table (.ctbl)");
 }
 
 //----------------------------------------------------------------------------
@@ -191,6 +601,7 @@ void vtkMRMLTableStorageNode::InitializeSupportedWriteFileTypes()
   this->SupportedWriteFileTypes->InsertNextValue("Tab-separated values (.tsv)");
   this->SupportedWriteFileTypes->InsertNextValue("Comma-separated values (.csv)");
   this->SupportedWriteFileTypes->InsertNextValue("Text (.txt)");
+  this->SupportedWriteFileTypes->InsertNextValue("Columnar binary table (.ctbl)");
 }
 
 //----------------------------------------------------------------------------
@@ -813,3 +1224,158 @@ bool vtkMRMLTableStorageNode::WriteSchema(std::string filename, vtkMRMLTableNode
 
   return true;
 }
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableStorageNode::ReadColumnarTable(std::string filename, vtkMRMLTableNode* tableNode)
+{
+  // Copy-on-write, so that columns used in place can be modified without changing the file
+  std::shared_ptr<vtkMRMLMappedFile> view = std::make_shared<vtkMRMLMappedFile>();
+  if (!view->Open(filename, true) || view->GetSize() < COLUMNAR_HEADER_SIZE)
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::ReadColumnarTable: failed to read file: " << filename);
+    return false;
+    }
+  if (memcmp(view->GetData(), COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC)) != 0)
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::ReadColumnarTable: " << filename << " is not a columnar table file");
+    return false;
+    }
+  ColumnarParser header(view->GetData(), view->GetSize(), sizeof(COLUMNAR_MAGIC));
+  vtkTypeUInt32 version = header.Read<vtkTypeUInt32>();
+  vtkTypeUInt32 numberOfTables = header.Read<vtkTypeUInt32>();
+  vtkTypeUInt64 directoryOffset = header.Read<vtkTypeUInt64>();
+  if (version != COLUMNAR_VERSION)
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::ReadColumnarTable: unsupported version " << version << " in file: " << filename);
+    return false;
+    }
+  if (numberOfTables < 1 || numberOfTables > 2)
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::ReadColumnarTable: invalid number of tables in file: " << filename);
+    return false;
+    }
+
+  // First table is the data, second table is the schema
+  ColumnarParser directory(view->GetData(), view->GetSize(), static_cast<size_t>(std::min<vtkTypeUInt64>(directoryOffset, view->GetSize())));
+  vtkSmartPointer<vtkTable> tables[2];
+  for (vtkTypeUInt32 tableIndex = 0; tableIndex < numberOfTables; ++tableIndex)
+    {
+    vtkTypeUInt64 numberOfRows = directory.Read<vtkTypeUInt64>();
+    vtkTypeUInt32 numberOfColumns = directory.Read<vtkTypeUInt32>();
+    if (directory.Valid && numberOfRows > GetColumnarMaximumNumberOfValues(*view))
+      {
+      vtkErrorMacro("vtkMRMLTableStorageNode::ReadColumnarTable: invalid number of rows (" << numberOfRows
+        << ") in file: " << filename);
+      return false;
+      }
+    tables[tableIndex] = vtkSmartPointer<vtkTable>::New();
+    for (vtkTypeUInt32 columnIndex = 0; columnIndex < numberOfColumns && directory.Valid; ++columnIndex)
+      {
+      ColumnarColumn column;
+      column.Name = directory.ReadString();
+      column.DataType = directory.Read<vtkTypeInt32>();
+      column.NumberOfComponents = directory.Read<vtkTypeInt32>();
+      vtkTypeUInt32 numberOfComponentNames = directory.Read<vtkTypeUInt32>();
+      for (vtkTypeUInt32 componentIndex = 0; componentIndex < numberOfComponentNames && directory.Valid; ++componentIndex)
+        {
+        column.ComponentNames.push_back(directory.ReadString());
+        }
+      column.Offset = directory.Read<vtkTypeUInt64>();
+      column.Size = directory.Read<vtkTypeUInt64>();
+      if (!directory.Valid)
+        {
+        break;
+        }
+      vtkSmartPointer<vtkAbstractArray> array = ReadColumnarBlock(view, column, numberOfRows);
+      if (!array)
+        {
+        vtkErrorMacro("vtkMRMLTableStorageNode::ReadColumnarTable: invalid column '" << column.Name
+          << "' in file: " << filename);
+        return false;
+        }
+      tables[tableIndex]->AddColumn(array);
+      }
+    if (!directory.Valid)
+      {
+      vtkErrorMacro("vtkMRMLTableStorageNode::ReadColumnarTable: invalid directory in file: " << filename);
+      return false;
+      }
+    }
+
+  if (tables[1])
+    {
+    tableNode->SetAndObserveSchema(tables[1]);
+    }
+  tableNode->SetAndObserveTable(tables[0]);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTableStorageNode::WriteColumnarTable(std::string filename, vtkMRMLTableNode* tableNode)
+{
+  vtkTable* tables[2] = { tableNode->GetTable(), tableNode->GetSchema() };
+  if (!tables[0])
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::WriteColumnarTable: no table to write to file: " << filename);
+    return false;
+    }
+  vtkTypeUInt32 numberOfTables = (tables[1] ? 2 : 1);
+
+  // Columns of a table that was read from this file may point into the file,
+  // so the file is only replaced once the new content is complete.
+  // On Windows no column points into the file after reading, so it can be replaced.
+  std::string temporaryFileName = filename + ".tmp";
+  {
+  std::ofstream out(temporaryFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out.is_open())
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::WriteColumnarTable: failed to open file for writing: " << temporaryFileName);
+    return false;
+    }
+  out.write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+  WriteLE<vtkTypeUInt32>(out, COLUMNAR_VERSION);
+  WriteLE<vtkTypeUInt32>(out, numberOfTables);
+  WriteLE<vtkTypeUInt64>(out, 0); // directory offset, updated when the blocks are written
+
+  std::vector<ColumnarColumn> columns[2];
+  for (vtkTypeUInt32 tableIndex = 0; tableIndex < numberOfTables; ++tableIndex)
+    {
+    vtkTable* table = tables[tableIndex];
+    vtkIdType numberOfRows = table->GetNumberOfRows();
+    for (vtkIdType col = 0; col < table->GetNumberOfColumns(); ++col)
+      {
+      vtkAbstractArray* column = table->GetColumn(col);
+      if (column == nullptr || column->GetNumberOfTuples() != numberOfRows)
+        {
+        vtkWarningMacro("vtkMRMLTableStorageNode::WriteColumnarTable: invalid column " << col
+          << " in file: " << filename << ", skipping column");
+        continue;
+        }
+      columns[tableIndex].push_back(WriteColumnarBlock(out, column, numberOfRows));
+      }
+    }
+
+  vtkTypeUInt64 directoryOffset = static_cast<vtkTypeUInt64>(out.tellp());
+  for (vtkTypeUInt32 tableIndex = 0; tableIndex < numberOfTables; ++tableIndex)
+    {
+    WriteColumnarDirectory(out, tables[tableIndex]->GetNumberOfRows(), columns[tableIndex]);
+    }
+  out.seekp(COLUMNAR_HEADER_SIZE - sizeof(vtkTypeUInt64));
+  WriteLE<vtkTypeUInt64>(out, directoryOffset);
+  out.close();
+  if (!out)
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::WriteColumnarTable: failed to write file: " << temporaryFileName);
+    vtksys::SystemTools::RemoveFile(temporaryFileName);
+    return false;
+    }
+  }
+
+  if (!vtksys::SystemTools::RenameFile(temporaryFileName.c_str(), filename.c_str()))
+    {
+    vtkErrorMacro("vtkMRMLTableStorageNode::WriteColumnarTable: failed to replace file: " << filename);
+    vtksys::SystemTools::RemoveFile(temporaryFileName);
+    return false;
+    }
+  return true;
+}
@@ -41,6 +41,11 @@ class vtkTable;
 /// Values in comma-separated files may not contain quotation marks but may contain
 /// any other characters (including commas and tabs).
 ///
+/// If the file extension is .ctbl then the table is stored in a binary
+/// columnar file, which keeps the column types and the schema in the same file.
+/// Numeric columns are stored as raw values and, when read, are memory-mapped
+/// directly into the data arrays (copy-on-write, the file is not modified).
+///
 class VTK_MRML_EXPORT vtkMRMLTableStorageNode : public vtkMRMLStorageNode
 {
 public:
@@ -119,6 +124,10 @@ protected:
   bool WriteTable(std::string filename, vtkMRMLTableNode* tableNode);
   bool WriteSchema(std::string filename, vtkMRMLTableNode* tableNode);
 
+  /// Read/write the table and schema of a columnar binary file (.ctbl)
+  bool ReadColumnarTable(std::string filename, vtkMRMLTableNode* tableNode);
+  bool WriteColumnarTable(std::string filename, vtkMRMLTableNode* tableNode);
+
   bool AutoFindSchema;
 };
 
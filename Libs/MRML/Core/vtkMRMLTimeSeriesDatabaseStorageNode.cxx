@@ -0,0 +1,261 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLTimeSeriesDatabaseStorageNode.h"
+
+// vtkITK includes
+#include <vtkITKTimeSeriesDatabase.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkStringArray.h>
+#include <vtksys/SystemTools.hxx>
+
+//----------------------------------------------------------------------------
+vtkMRMLNodeNewMacro(vtkMRMLTimeSeriesDatabaseStorageNode);
+
+//----------------------------------------------------------------------------
+vtkMRMLTimeSeriesDatabaseStorageNode::vtkMRMLTimeSeriesDatabaseStorageNode()
+{
+  this->CurrentFrame = 0;
+  this->CacheSizeInMiB = 512.0;
+  this->NumberOfPrefetchedFrames = 4;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTimeSeriesDatabaseStorageNode::~vtkMRMLTimeSeriesDatabaseStorageNode()
+{
+  this->CloseDatabase();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTimeSeriesDatabaseStorageNode::WriteXML(ostream& of, int nIndent)
+{
+  Superclass::WriteXML(of, nIndent);
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLIntMacro(currentFrame, CurrentFrame);
+  vtkMRMLWriteXMLFloatMacro(cacheSizeInMiB, CacheSizeInMiB);
+  vtkMRMLWriteXMLIntMacro(numberOfPrefetchedFrames, NumberOfPrefetchedFrames);
+  vtkMRMLWriteXMLEndMacro();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTimeSeriesDatabaseStorageNode::ReadXMLAttributes(const char** atts)
+{
+  int disabledModify = this->StartModify();
+  Superclass::ReadXMLAttributes(atts);
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLIntMacro(currentFrame, CurrentFrame);
+  vtkMRMLReadXMLFloatMacro(cacheSizeInMiB, CacheSizeInMiB);
+  vtkMRMLReadXMLIntMacro(numberOfPrefetchedFrames, NumberOfPrefetchedFrames);
+  vtkMRMLReadXMLEndMacro();
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+// Copy the node's attributes to this object.
+// Does NOT copy: ID, FilePrefix, Name, StorageID
+void vtkMRMLTimeSeriesDatabaseStorageNode::Copy(vtkMRMLNode *anode)
+{
+  int disabledModify = this->StartModify();
+  Superclass::Copy(anode);
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyIntMacro(CurrentFrame);
+  vtkMRMLCopyFloatMacro(CacheSizeInMiB);
+  vtkMRMLCopyIntMacro(NumberOfPrefetchedFrames);
+  vtkMRMLCopyEndMacro();
+  this->EndModify(disabledModify);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTimeSeriesDatabaseStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os,indent);
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintIntMacro(CurrentFrame);
+  vtkMRMLPrintFloatMacro(CacheSizeInMiB);
+  vtkMRMLPrintIntMacro(NumberOfPrefetchedFrames);
+  vtkMRMLPrintEndMacro();
+  os << indent << "NumberOfFrames: " << this->GetNumberOfFrames() << "\n";
+  os << indent << "CacheHitRate: " << this->GetCacheHitRate() << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTimeSeriesDatabaseStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
+{
+  return refNode->IsA("vtkMRMLScalarVolumeNode");
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTimeSeriesDatabaseStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *vtkNotUsed(refNode))
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTimeSeriesDatabaseStorageNode::InitializeSupportedReadFileTypes()
+{
+  this->SupportedReadFileTypes->InsertNextValue("Time Series Database (.tsd)");
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTimeSeriesDatabaseStorageNode::ReadFrame(vtkMRMLNode* refNode, int frame)
+{
+  this->SetCurrentFrame(frame);
+  return this->ReadData(refNode);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTimeSeriesDatabaseStorageNode::GetNumberOfFrames()
+{
+  if (!this->Database || !this->Database->IsConnected())
+    {
+    return 0;
+    }
+  return this->Database->GetNumberOfVolumes();
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLTimeSeriesDatabaseStorageNode::GetCacheHitRate()
+{
+  if (!this->Database)
+    {
+    return 0.0;
+    }
+  return this->Database->GetCacheHitRate();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTimeSeriesDatabaseStorageNode::CloseDatabase()
+{
+  if (this->Database && this->Database->IsConnected())
+    {
+    this->Database->Disconnect();
+    }
+  this->Database = nullptr;
+  this->DatabaseFileName.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTimeSeriesDatabaseStorageNode::OpenDatabase(const std::string& fileName)
+{
+  if (this->Database && this->Database->IsConnected() && this->DatabaseFileName == fileName)
+    {
+    return true;
+    }
+  this->CloseDatabase();
+  vtkSmartPointer<vtkITKTimeSeriesDatabase> database = vtkSmartPointer<vtkITKTimeSeriesDatabase>::New();
+  if (!database->Connect(fileName.c_str()))
+    {
+    return false;
+    }
+  this->Database = database;
+  this->DatabaseFileName = fileName;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTimeSeriesDatabaseStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
+{
+  vtkMRMLScalarVolumeNode* volNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (!volNode)
+    {
+    vtkErrorMacro("ReadDataInternal: not a scalar volume node.");
+    return 0;
+    }
+
+  std::string fullName = this->GetFullNameFromFileName();
+  if (fullName.empty())
+    {
+    vtkErrorMacro("ReadDataInternal: File name not specified");
+    return 0;
+    }
+  std::string extension = vtksys::SystemTools::LowerCase(vtksys::SystemTools::GetFilenameLastExtension(fullName));
+  if (extension != ".tsd")
+    {
+    vtkDebugMacro("ReadDataInternal: not a time series database: " << fullName);
+    return 0;
+    }
+  if (!vtksys::SystemTools::FileExists(fullName.c_str()))
+    {
+    vtkErrorMacro("ReadDataInternal: time series database '" << fullName << "' not found.");
+    return 0;
+    }
+
+  if (!this->OpenDatabase(fullName))
+    {
+    vtkErrorMacro("ReadDataInternal: Cannot open time series database: " << fullName);
+    return 0;
+    }
+
+  int numberOfFrames = this->Database->GetNumberOfVolumes();
+  if (this->CurrentFrame < 0 || this->CurrentFrame >= numberOfFrames)
+    {
+    vtkErrorMacro("ReadDataInternal: frame " << this->CurrentFrame << " is out of range [0, "
+      << numberOfFrames - 1 << "] in " << fullName);
+    return 0;
+    }
+
+  if (this->Database->GetCacheSizeInMiB() != this->CacheSizeInMiB)
+    {
+    this->Database->SetCacheSizeInMiB(this->CacheSizeInMiB);
+    }
+  this->Database->SetNumberOfPrefetchedImages(this->NumberOfPrefetchedFrames);
+  this->Database->SetCurrentImage(static_cast<unsigned int>(this->CurrentFrame));
+  this->Database->Update();
+
+  // The database output is reused for the next frame, the volume gets its own copy
+  vtkNew<vtkImageData> frameImage;
+  frameImage->DeepCopy(this->Database->GetOutput());
+  frameImage->SetOrigin(0, 0, 0);
+  frameImage->SetSpacing(1, 1, 1);
+  if (frameImage->GetNumberOfPoints() == 0)
+    {
+    vtkErrorMacro("ReadDataInternal: Cannot read frame " << this->CurrentFrame << " of " << fullName);
+    return 0;
+    }
+
+  // Image geometry is stored in LPS, convert it to RAS
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  double direction[3][3];
+  this->Database->GetOutputOrigin(origin);
+  this->Database->GetOutputSpacing(spacing);
+  this->Database->GetOutputDirection(direction);
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  for (int row = 0; row < 3; row++)
+    {
+    double lpsToRAS = (row < 2 ? -1.0 : 1.0);
+    for (int col = 0; col < 3; col++)
+      {
+      ijkToRAS->SetElement(row, col, lpsToRAS * direction[row][col] * spacing[col]);
+      }
+    ijkToRAS->SetElement(row, 3, lpsToRAS * origin[row]);
+    }
+
+  int disabledModify = volNode->StartModify();
+  volNode->SetIJKToRASMatrix(ijkToRAS.GetPointer());
+  volNode->SetAndObserveImageData(frameImage.GetPointer());
+  volNode->EndModify(disabledModify);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTimeSeriesDatabaseStorageNode::WriteDataInternal(vtkMRMLNode *vtkNotUsed(refNode))
+{
+  vtkErrorMacro("WriteDataInternal: writing time series databases is not supported");
+  return 0;
+}
@@ -0,0 +1,123 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLTimeSeriesDatabaseStorageNode_h
+#define __vtkMRMLTimeSeriesDatabaseStorageNode_h
+
+#include "vtkMRMLStorageNode.h"
+
+// VTK includes
+#include <vtkSmartPointer.h>
+
+class vtkITKTimeSeriesDatabase;
+
+/// \brief MRML node for reading 4D series frame by frame from a time series database.
+///
+/// A time series database (.tsd, see itk::TimeSeriesDatabase) stores a 4D image
+/// as 16x16x16 voxel blocks spread over one or more files. Only the frame
+/// selected by CurrentFrame is loaded into the scalar volume node, so that
+/// series larger than the available memory (e.g. perfusion or fMRI) can be
+/// browsed. Recently used blocks are kept in a LRU cache and the frames that
+/// follow the current one are read into the cache in the background.
+///
+/// The database stays open between reads, call ReadFrame() to switch frames.
+/// Writing is not supported, use vtkITKTimeSeriesDatabase::CreateFromFileArchetype
+/// to create a database from a series of volumes.
+class VTK_MRML_EXPORT vtkMRMLTimeSeriesDatabaseStorageNode : public vtkMRMLStorageNode
+{
+public:
+  static vtkMRMLTimeSeriesDatabaseStorageNode *New();
+  vtkTypeMacro(vtkMRMLTimeSeriesDatabaseStorageNode,vtkMRMLStorageNode);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  vtkMRMLNode* CreateNodeInstance() override;
+
+  ///
+  /// Read node attributes from XML file
+  void ReadXMLAttributes( const char** atts) override;
+
+  ///
+  /// Write this node's information to a MRML file in XML format.
+  void WriteXML(ostream& of, int indent) override;
+
+  ///
+  /// Copy the node's attributes to this object
+  void Copy(vtkMRMLNode *node) override;
+
+  ///
+  /// Get node XML tag name (like Storage, Model)
+  const char* GetNodeTagName() override {return "TimeSeriesDatabaseStorage";}
+
+  /// Return true if node can be read in
+  bool CanReadInReferenceNode(vtkMRMLNode *refNode) override;
+  bool CanWriteFromReferenceNode(vtkMRMLNode *refNode) override;
+
+  ///
+  /// Index of the frame that is read by ReadData
+  vtkSetMacro(CurrentFrame, int);
+  vtkGetMacro(CurrentFrame, int);
+
+  ///
+  /// Set CurrentFrame and read it into the volume node.
+  /// Returns 1 on success, 0 otherwise.
+  int ReadFrame(vtkMRMLNode* refNode, int frame);
+
+  ///
+  /// Number of frames in the database, 0 if it has not been read yet.
+  int GetNumberOfFrames();
+
+  ///
+  /// Size of the block cache in MiB. Default is 512.
+  vtkSetMacro(CacheSizeInMiB, float);
+  vtkGetMacro(CacheSizeInMiB, float);
+
+  ///
+  /// Number of frames following the current one that are read into the
+  /// cache in the background. Default is 4.
+  vtkSetMacro(NumberOfPrefetchedFrames, int);
+  vtkGetMacro(NumberOfPrefetchedFrames, int);
+
+  ///
+  /// Fraction of block reads served from the cache since the database
+  /// was opened, in [0,1].
+  double GetCacheHitRate();
+
+  ///
+  /// Close the database files and release the cache.
+  void CloseDatabase();
+
+protected:
+  vtkMRMLTimeSeriesDatabaseStorageNode();
+  ~vtkMRMLTimeSeriesDatabaseStorageNode() override;
+  vtkMRMLTimeSeriesDatabaseStorageNode(const vtkMRMLTimeSeriesDatabaseStorageNode&);
+  void operator=(const vtkMRMLTimeSeriesDatabaseStorageNode&);
+
+  /// Initialize all the supported read file types
+  void InitializeSupportedReadFileTypes() override;
+
+  /// Read data and set it in the referenced node
+  int ReadDataInternal(vtkMRMLNode *refNode) override;
+
+  /// Writing is not supported
+  int WriteDataInternal(vtkMRMLNode *refNode) override;
+
+  /// Open the database if it is not already open
+  bool OpenDatabase(const std::string& fileName);
+
+  int CurrentFrame;
+  float CacheSizeInMiB;
+  int NumberOfPrefetchedFrames;
+
+  vtkSmartPointer<vtkITKTimeSeriesDatabase> Database;
+  std::string DatabaseFileName;
+};
+
+#endif
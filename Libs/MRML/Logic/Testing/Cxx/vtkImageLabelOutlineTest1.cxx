@@ -0,0 +1,184 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkImageLabelOutline.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkLookupTable.h>
+#include <vtkNew.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Reference implementation: a non-background pixel is an outline pixel if a
+// pixel in its neighborhood has a different label or if the neighborhood
+// reaches outside of the image.
+short ReferenceOutline(vtkImageData* image, int i, int j, int k, int outline, short background)
+{
+  int* dims = image->GetDimensions();
+  short label = *static_cast<short*>(image->GetScalarPointer(i, j, k));
+  if (label == background)
+    {
+    return background;
+    }
+  for (int dj = -outline; dj <= outline; ++dj)
+    {
+    for (int di = -outline; di <= outline; ++di)
+      {
+      if (i + di < 0 || i + di >= dims[0] || j + dj < 0 || j + dj >= dims[1])
+        {
+        return label;
+        }
+      if (*static_cast<short*>(image->GetScalarPointer(i + di, j + dj, k)) != label)
+        {
+        return label;
+        }
+      }
+    }
+  return background;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLabelOutlineTest1(int , char * [] )
+{
+  vtkNew<vtkImageLabelOutline> outlineFilter;
+  EXERCISE_BASIC_OBJECT_METHODS(outlineFilter.GetPointer());
+
+  // Overlapping rectangles of different labels
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(37, 29, 2);
+  image->AllocateScalars(VTK_SHORT, 1);
+  int* dims = image->GetDimensions();
+  for (int k = 0; k < dims[2]; ++k)
+    {
+    for (int j = 0; j < dims[1]; ++j)
+      {
+      for (int i = 0; i < dims[0]; ++i)
+        {
+        short label = 0;
+        if (i > 3 && i < 20 && j > 2 && j < 25)
+          {
+          label = 1;
+          }
+        if (i > 12 && j > 10 + k)
+          {
+          label = 7;
+          }
+        *static_cast<short*>(image->GetScalarPointer(i, j, k)) = label;
+        }
+      }
+    }
+  outlineFilter->SetInputData(image.GetPointer());
+
+  for (int outline = 1; outline <= 3; ++outline)
+    {
+    outlineFilter->SetOutline(outline);
+    outlineFilter->Update();
+    vtkImageData* output = outlineFilter->GetOutput();
+    CHECK_INT(output->GetScalarType(), VTK_SHORT);
+    for (int k = 0; k < dims[2]; ++k)
+      {
+      for (int j = 0; j < dims[1]; ++j)
+        {
+        for (int i = 0; i < dims[0]; ++i)
+          {
+          CHECK_INT(*static_cast<short*>(output->GetScalarPointer(i, j, k)),
+            ReferenceOutline(image.GetPointer(), i, j, k, outline, 0));
+          }
+        }
+      }
+    }
+
+  // Outline mapped to colors in the same pass
+  vtkNew<vtkLookupTable> lookupTable;
+  lookupTable->SetNumberOfTableValues(8);
+  lookupTable->SetTableRange(0, 7);
+  for (int label = 0; label < 8; ++label)
+    {
+    lookupTable->SetTableValue(label, label / 7.0, 0.5, 1.0 - label / 7.0, label > 0 ? 1.0 : 0.0);
+    }
+  outlineFilter->SetOutline(2);
+  outlineFilter->SetLookupTable(lookupTable.GetPointer());
+  outlineFilter->Update();
+  vtkImageData* colors = outlineFilter->GetOutput();
+  CHECK_INT(colors->GetScalarType(), VTK_UNSIGNED_CHAR);
+  CHECK_INT(colors->GetNumberOfScalarComponents(), 4);
+  for (int j = 0; j < dims[1]; ++j)
+    {
+    for (int i = 0; i < dims[0]; ++i)
+      {
+      short label = ReferenceOutline(image.GetPointer(), i, j, 1, 2, 0);
+      const unsigned char* expected = lookupTable->MapValue(label);
+      unsigned char* color = static_cast<unsigned char*>(colors->GetScalarPointer(i, j, 1));
+      for (int c = 0; c < 4; ++c)
+        {
+        CHECK_INT(color[c], expected[c]);
+        }
+      }
+    }
+
+  // Fill and outline in the same pass, opaque outline covers the fill
+  vtkNew<vtkLookupTable> fillLookupTable;
+  fillLookupTable->SetNumberOfTableValues(8);
+  fillLookupTable->SetTableRange(0, 7);
+  for (int label = 0; label < 8; ++label)
+    {
+    fillLookupTable->SetTableValue(label, 1.0, label / 7.0, 0.0, label > 0 ? 0.5 : 0.0);
+    }
+  outlineFilter->SetFillLookupTable(fillLookupTable.GetPointer());
+  outlineFilter->Update();
+  colors = outlineFilter->GetOutput();
+  CHECK_INT(colors->GetScalarType(), VTK_UNSIGNED_CHAR);
+  for (int j = 0; j < dims[1]; ++j)
+    {
+    for (int i = 0; i < dims[0]; ++i)
+      {
+      short label = *static_cast<short*>(image->GetScalarPointer(i, j, 1));
+      bool outlinePixel = (ReferenceOutline(image.GetPointer(), i, j, 1, 2, 0) != 0);
+      const unsigned char* expected = outlinePixel ? lookupTable->MapValue(label) : fillLookupTable->MapValue(label);
+      unsigned char* color = static_cast<unsigned char*>(colors->GetScalarPointer(i, j, 1));
+      for (int c = 0; c < 4; ++c)
+        {
+        CHECK_INT(color[c], expected[c]);
+        }
+      }
+    }
+
+  // Semi-transparent outline is blended over the fill
+  lookupTable->SetTableValue(7, 0.0, 0.0, 1.0, 0.5);
+  fillLookupTable->SetTableValue(7, 1.0, 0.0, 0.0, 0.5);
+  outlineFilter->Update();
+  const unsigned char* outlineColor = lookupTable->MapValue(7);
+  const unsigned char* fillColor = fillLookupTable->MapValue(7);
+  double outlineAlpha = outlineColor[3] / 255.0;
+  double fillAlpha = fillColor[3] / 255.0 * (1.0 - outlineAlpha);
+  unsigned char* blendedColor = static_cast<unsigned char*>(outlineFilter->GetOutput()->GetScalarPointer(dims[0] - 1, dims[1] - 1, 1));
+  CHECK_INT(blendedColor[0], static_cast<int>(255.0 * fillAlpha / (outlineAlpha + fillAlpha) + 0.5));
+  CHECK_INT(blendedColor[1], 0);
+  CHECK_INT(blendedColor[2], static_cast<int>(255.0 * outlineAlpha / (outlineAlpha + fillAlpha) + 0.5));
+  CHECK_INT(blendedColor[3], static_cast<int>(255.0 * (outlineAlpha + fillAlpha) + 0.5));
+
+  outlineFilter->SetFillLookupTable(nullptr);
+  outlineFilter->SetLookupTable(nullptr);
+  outlineFilter->Update();
+  CHECK_INT(outlineFilter->GetOutput()->GetScalarType(), VTK_SHORT);
+
+  return EXIT_SUCCESS;
+}
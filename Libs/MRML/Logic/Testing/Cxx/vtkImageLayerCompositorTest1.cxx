@@ -0,0 +1,113 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRMLLogic includes
+#include "vtkImageLayerCompositor.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageBlend.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> CreateLayer(int seed)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(31, 17, 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+  unsigned char* ptr = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints() * 4; ++i)
+    {
+    ptr[i] = static_cast<unsigned char>((i * 37 + seed * 101 + (i / 4) * seed) % 256);
+    }
+  return image;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageLayerCompositorTest1(int , char * [] )
+{
+  vtkNew<vtkImageLayerCompositor> compositor;
+  EXERCISE_BASIC_OBJECT_METHODS(compositor.GetPointer());
+
+  vtkSmartPointer<vtkImageData> background = CreateLayer(1);
+  vtkSmartPointer<vtkImageData> foreground = CreateLayer(2);
+  vtkSmartPointer<vtkImageData> label = CreateLayer(3);
+
+  // Alpha blending gives the same colors as vtkImageBlend
+  vtkNew<vtkImageBlend> blend;
+  compositor->SetCompositingToAlpha();
+  blend->AddInputData(background);
+  compositor->AddInputData(background);
+  blend->AddInputData(foreground);
+  compositor->AddInputData(foreground);
+  blend->AddInputData(label);
+  compositor->AddInputData(label);
+  blend->SetOpacity(1, 0.6);
+  compositor->SetOpacity(1, 0.6);
+  blend->SetOpacity(2, 0.3);
+  compositor->SetOpacity(2, 0.3);
+  CHECK_DOUBLE_TOLERANCE(compositor->GetOpacity(1), 0.6, 1e-12);
+  CHECK_DOUBLE_TOLERANCE(compositor->GetOpacity(5), 1.0, 1e-12);
+  blend->Update();
+  compositor->Update();
+
+  vtkImageData* expected = blend->GetOutput();
+  vtkImageData* output = compositor->GetOutput();
+  CHECK_INT(output->GetScalarType(), VTK_UNSIGNED_CHAR);
+  CHECK_INT(output->GetNumberOfScalarComponents(), 4);
+  CHECK_INT(output->GetNumberOfPoints(), background->GetNumberOfPoints());
+  unsigned char* expectedPtr = static_cast<unsigned char*>(expected->GetScalarPointer());
+  unsigned char* outputPtr = static_cast<unsigned char*>(output->GetScalarPointer());
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints() * 4; ++i)
+    {
+    if (i % 4 != 3)
+      {
+      CHECK_BOOL(std::abs(expectedPtr[i] - outputPtr[i]) <= 1, true);
+      }
+    }
+
+  // Add and subtract the background and foreground, keep the background alpha
+  for (int compositing = vtkImageLayerCompositor::Add; compositing <= vtkImageLayerCompositor::Subtract; ++compositing)
+    {
+    compositor->SetCompositing(compositing);
+    compositor->SetOpacity(2, 0.0);
+    compositor->Update();
+    unsigned char* backgroundPtr = static_cast<unsigned char*>(background->GetScalarPointer());
+    unsigned char* foregroundPtr = static_cast<unsigned char*>(foreground->GetScalarPointer());
+    outputPtr = static_cast<unsigned char*>(compositor->GetOutput()->GetScalarPointer());
+    for (vtkIdType i = 0; i < output->GetNumberOfPoints() * 4; ++i)
+      {
+      int value = backgroundPtr[i];
+      if (i % 4 != 3)
+        {
+        value += (compositing == vtkImageLayerCompositor::Add ? foregroundPtr[i] : -foregroundPtr[i]);
+        value = std::max(0, std::min(255, value));
+        }
+      CHECK_INT(outputPtr[i], value);
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
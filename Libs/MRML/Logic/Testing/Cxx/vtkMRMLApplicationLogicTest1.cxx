@@ -23,15 +23,21 @@
 #include "vtkMRMLCoreTestingMacros.h"
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSliceNode.h>
+#include <vtkMRMLStreamingVolumeNode.h>
 
 // VTK includes
+#include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
+#include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <cstring>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <vector>
 
 
 //-----------------------------------------------------------------------------
@@ -39,6 +45,7 @@ int SliceLogicsTest();
 int SliceOrientationPresetInitializationTest();
 int TemporaryPathTest();
 int CreateUniqueFileNameTest(std::string tempDir);
+int StreamingVolumeDecodedFrameTest();
 
 //-----------------------------------------------------------------------------
 int vtkMRMLApplicationLogicTest1(int argc, char *argv [])
@@ -57,6 +64,7 @@ int vtkMRMLApplicationLogicTest1(int argc, char *argv [])
   CHECK_EXIT_SUCCESS(SliceOrientationPresetInitializationTest());
   CHECK_EXIT_SUCCESS(TemporaryPathTest());
   CHECK_EXIT_SUCCESS(CreateUniqueFileNameTest(tempDir));
+  CHECK_EXIT_SUCCESS(StreamingVolumeDecodedFrameTest());
   return EXIT_SUCCESS;
 }
 
@@ -239,3 +247,119 @@ int CreateUniqueFileNameTest(std::string tempDir)
 
   return EXIT_SUCCESS;
 }
+
+namespace
+{
+//----------------------------------------------------------------------------
+/// Records the requests of invoking events on the main thread, as the application does
+struct InvokeRequestRecorder
+{
+  std::mutex Mutex;
+  std::vector<vtkMRMLApplicationLogic::InvokeRequest> Requests;
+
+  static void RecordCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+    void* clientData, void* callData)
+  {
+    InvokeRequestRecorder* self = reinterpret_cast<InvokeRequestRecorder*>(clientData);
+    std::lock_guard<std::mutex> lock(self->Mutex);
+    self->Requests.push_back(*reinterpret_cast<vtkMRMLApplicationLogic::InvokeRequest*>(callData));
+  }
+
+  /// Invoke the recorded events, must be called on the main thread
+  void ProcessRequests()
+  {
+    std::vector<vtkMRMLApplicationLogic::InvokeRequest> requests;
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      requests.swap(this->Requests);
+    }
+    for (const vtkMRMLApplicationLogic::InvokeRequest& request : requests)
+      {
+      request.Caller->InvokeEvent(request.EventID, request.CallData);
+      }
+  }
+};
+
+//----------------------------------------------------------------------------
+void CountEventsCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+  void* clientData, void* vtkNotUsed(callData))
+{
+  int* count = reinterpret_cast<int*>(clientData);
+  ++(*count);
+}
+}
+
+//-----------------------------------------------------------------------------
+int StreamingVolumeDecodedFrameTest()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLApplicationLogic> appLogic;
+  appLogic->SetMRMLScene(scene.GetPointer());
+
+  InvokeRequestRecorder recorder;
+  vtkNew<vtkCallbackCommand> recordCallback;
+  recordCallback->SetClientData(&recorder);
+  recordCallback->SetCallback(InvokeRequestRecorder::RecordCallback);
+  appLogic->AddObserver(vtkMRMLApplicationLogic::RequestInvokeEvent, recordCallback);
+
+  // Encode an image
+  const int width = 12;
+  const int height = 8;
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(width, height, 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  unsigned char* imagePointer = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int i = 0; i < width * height * 3; ++i)
+    {
+    imagePointer[i] = static_cast<unsigned char>(i % 251);
+    }
+  vtkNew<vtkMRMLStreamingVolumeNode> encoderNode;
+  encoderNode->SetCodecFourCC("RV24");
+  encoderNode->SetAndObserveImageData(image.GetPointer());
+  CHECK_BOOL(encoderNode->EncodeImageData(), true);
+
+  vtkMRMLStreamingVolumeNode* playbackNode = vtkMRMLStreamingVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLStreamingVolumeNode"));
+  CHECK_NOT_NULL(playbackNode);
+  playbackNode->SetDecodedFrameCacheSize(2);
+  int imageDataModifiedCount = 0;
+  vtkNew<vtkCallbackCommand> imageDataModifiedCallback;
+  imageDataModifiedCallback->SetClientData(&imageDataModifiedCount);
+  imageDataModifiedCallback->SetCallback(CountEventsCallback);
+  playbackNode->AddObserver(vtkMRMLVolumeNode::ImageDataModifiedEvent, imageDataModifiedCallback);
+
+  // Setting the frame starts decoding in the background, nobody has to request the image
+  playbackNode->SetAndObserveFrame(encoderNode->GetFrame());
+  playbackNode->WaitForDecoding();
+  CHECK_INT(imageDataModifiedCount, 0);
+  {
+    std::lock_guard<std::mutex> lock(recorder.Mutex);
+    CHECK_INT(static_cast<int>(recorder.Requests.size()), 1);
+    CHECK_POINTER(recorder.Requests[0].Caller, appLogic.GetPointer());
+    CHECK_INT(static_cast<int>(recorder.Requests[0].EventID), vtkMRMLApplicationLogic::ProcessStreamingVolumeFramesEvent);
+  }
+
+  // The decoded frame is swapped in on the main thread and observers are notified
+  recorder.ProcessRequests();
+  CHECK_BOOL(imageDataModifiedCount > 0, true);
+  CHECK_BOOL(playbackNode->GetFrameDecodingInProgress(), false);
+  CHECK_BOOL(playbackNode->IsDecodedFrameReady(), false);
+  vtkImageData* decodedImage = playbackNode->GetImageData();
+  CHECK_NOT_NULL(decodedImage);
+  CHECK_INT(memcmp(decodedImage->GetScalarPointer(), imagePointer, width * height * 3), 0);
+
+  // Nodes removed from the scene are not observed anymore
+  playbackNode->RemoveObserver(imageDataModifiedCallback);
+  vtkSmartPointer<vtkMRMLStreamingVolumeNode> removedNode = playbackNode;
+  scene->RemoveNode(playbackNode);
+  CHECK_BOOL(encoderNode->EncodeImageData(true), true);
+  removedNode->SetAndObserveFrame(encoderNode->GetFrame());
+  removedNode->WaitForDecoding();
+  {
+    std::lock_guard<std::mutex> lock(recorder.Mutex);
+    CHECK_INT(static_cast<int>(recorder.Requests.size()), 0);
+  }
+
+  appLogic->RemoveObserver(recordCallback);
+  return EXIT_SUCCESS;
+}
@@ -14,12 +14,19 @@
 #include "vtkImageLabelOutline.h"
 
 // VTK includes
+#include <vtkDataObject.h>
 #include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkLookupTable.h>
 #include "vtkObjectFactory.h"
 #include "vtkImageData.h"
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
+// STD includes
+#include <algorithm>
+#include <vector>
+
 //------------------------------------------------------------------------------
 vtkStandardNewMacro(vtkImageLabelOutline);
 
@@ -30,6 +37,8 @@ vtkImageLabelOutline::vtkImageLabelOutline()
 {
   this->Outline = 1;
   this->Background = 0;
+  this->LookupTable = nullptr;
+  this->FillLookupTable = nullptr;
   this->HandleBoundaries = 1;
   this->SetNeighborTo8();
 }
@@ -37,85 +46,215 @@ vtkImageLabelOutline::vtkImageLabelOutline()
 
 //----------------------------------------------------------------------------
 vtkImageLabelOutline::~vtkImageLabelOutline()
-= default;
+{
+  this->SetLookupTable(nullptr);
+  this->SetFillLookupTable(nullptr);
+}
+
+//----------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkImageLabelOutline, LookupTable, vtkLookupTable);
+vtkCxxSetObjectMacro(vtkImageLabelOutline, FillLookupTable, vtkLookupTable);
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkImageLabelOutline::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->LookupTable)
+    {
+    mTime = std::max(mTime, this->LookupTable->GetMTime());
+    }
+  if (this->FillLookupTable)
+    {
+    mTime = std::max(mTime, this->FillLookupTable->GetMTime());
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelOutline::RequestInformation(vtkInformation* request,
+                                             vtkInformationVector** inputVector,
+                                             vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestInformation(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+  if (this->LookupTable)
+    {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLabelOutline::RequestData(vtkInformation* request,
+                                      vtkInformationVector** inputVector,
+                                      vtkInformationVector* outputVector)
+{
+  if (this->LookupTable)
+    {
+    // Build the tables here, not in the threads
+    this->LookupTable->Build();
+    if (this->FillLookupTable)
+      {
+      this->FillLookupTable->Build();
+      }
+    }
+  return this->Superclass::RequestData(request, inputVector, outputVector);
+}
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Merge src into the running minimum and maximum. There is no branch in the
+// loop so that it can be vectorized.
+template <class T>
+void vtkImageLabelOutlineMinMax(const T* srcMin, const T* srcMax,
+                                T* dstMin, T* dstMax, int count)
+{
+  for (int i = 0; i < count; ++i)
+    {
+    dstMin[i] = srcMin[i] < dstMin[i] ? srcMin[i] : dstMin[i];
+    dstMax[i] = srcMax[i] > dstMax[i] ? srcMax[i] : dstMax[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+// Minimum and maximum of the row over [x - outline, x + outline] for each
+// output x, neighbors outside of [inMin, inMax] are ignored.
+// rowPtr points to the input value at inMin.
+template <class T>
+void vtkImageLabelOutlineRowMinMax(const T* rowPtr, int inMin, int inMax,
+                                   int outMin, int outMax, int outline,
+                                   T* rowMin, T* rowMax)
+{
+  const int width = outMax - outMin + 1;
+  const T* center = rowPtr + (outMin - inMin);
+  std::copy(center, center + width, rowMin);
+  std::copy(center, center + width, rowMax);
+  for (int offset = 1; offset <= outline; ++offset)
+    {
+    // left neighbors exist for outMin + x - offset >= inMin
+    int first = std::max(0, inMin - outMin + offset);
+    if (first < width)
+      {
+      vtkImageLabelOutlineMinMax(center + first - offset, center + first - offset,
+                                 rowMin + first, rowMax + first, width - first);
+      }
+    // right neighbors exist for outMin + x + offset <= inMax
+    int last = std::min(width - 1, inMax - outMin - offset);
+    if (last >= 0)
+      {
+      vtkImageLabelOutlineMinMax(center + offset, center + offset,
+                                 rowMin, rowMax, last + 1);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
+// Colors of the outline and of the fill of a label. Without a fill lookup
+// table the fill has the background color, otherwise the outline is blended
+// over the fill color of the label.
+void vtkImageLabelOutlineMapLabel(vtkLookupTable* lookupTable, vtkLookupTable* fillLookupTable,
+                                  double label, double background,
+                                  unsigned char outlineColor[4], unsigned char fillColor[4])
+{
+  const unsigned char* outline = lookupTable->MapValue(label);
+  std::copy(outline, outline + 4, outlineColor);
+  if (!fillLookupTable)
+    {
+    const unsigned char* backgroundColor = lookupTable->MapValue(background);
+    std::copy(backgroundColor, backgroundColor + 4, fillColor);
+    return;
+    }
+  const unsigned char* fill = fillLookupTable->MapValue(label);
+  std::copy(fill, fill + 4, fillColor);
+  const double outlineAlpha = outlineColor[3] / 255.0;
+  const double fillAlpha = fillColor[3] / 255.0 * (1.0 - outlineAlpha);
+  const double alpha = outlineAlpha + fillAlpha;
+  if (alpha <= 0.0)
+    {
+    return;
+    }
+  for (int c = 0; c < 3; ++c)
+    {
+    outlineColor[c] = static_cast<unsigned char>(
+      (outlineColor[c] * outlineAlpha + fillColor[c] * fillAlpha) / alpha + 0.5);
+    }
+  outlineColor[3] = static_cast<unsigned char>(alpha * 255.0 + 0.5);
+}
 
+} // end of anonymous namespace
 
+//----------------------------------------------------------------------------
 // Description:
 // This templated function executes the filter for any type of data.
+// A non-background pixel is an outline pixel if the minimum or the maximum
+// of its neighborhood differs from its label, or if the neighborhood reaches
+// outside of the image.
 template <class T>
 static void vtkImageLabelOutlineExecute(vtkImageLabelOutline *self,
-                     vtkImageData *inData, T *inPtr,
+                     vtkImageData *inData, T *vtkNotUsed(inPtr),
                      vtkImageData *outData,
                      int outExt[6], int id)
 {
-  int *kernelMiddle, *kernelSize;
-  // For looping though output (and input) pixels.
-  int outMin0, outMax0, outMin1, outMax1, outMin2, outMax2;
-  int outIdx0, outIdx1, outIdx2;
-  vtkIdType inInc0, inInc1, inInc2;
-  vtkIdType outInc0, outInc1, outInc2;
-  T *inPtr0, *inPtr1, *inPtr2;
-  T *outPtr0, *outPtr1, *outPtr2;
-  // For looping through hood pixels
-  int hoodMin0, hoodMax0, hoodMin1, hoodMax1, hoodMin2, hoodMax2;
-  int hoodIdx0, hoodIdx1, hoodIdx2;
-  T *hoodPtr0, *hoodPtr1, *hoodPtr2;
-  // The extent of the whole input image
-  int inImageMin0, inImageMin1, inImageMin2;
-  int inImageMax0, inImageMax1, inImageMax2;
-  // Other
-  T backgroundLabelValue = (T)(self->GetBackground());
-  T inLabelValue;
-  T *outPtr = (T*)outData->GetScalarPointerForExtent(outExt);
-  unsigned long count = 0;
-  unsigned long target;
+  const T backgroundLabelValue = static_cast<T>(self->GetBackground());
+  const int outline = std::max(0, self->GetOutline());
+  vtkLookupTable* lookupTable = self->GetLookupTable();
+  vtkLookupTable* fillLookupTable = self->GetFillLookupTable();
 
-  // Get information to march through data
-
-  inData->GetIncrements(inInc0, inInc1, inInc2);
-  int inExt[6];
+  int wholeExt[6];
   self->GetInputInformation()->Get(
-        vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
-  inImageMin0 = inExt[0]; inImageMax0 = inExt[1];
-  inImageMin1 = inExt[2]; inImageMax1 = inExt[3];
-  inImageMin2 = inExt[4]; inImageMax2 = inExt[5];
+        vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt);
+  int inDataExt[6];
+  inData->GetExtent(inDataExt);
+
+  // Part of the input that is used to compute the output rows
+  const int inMin0 = std::max(outExt[0] - outline, inDataExt[0]);
+  const int inMax0 = std::min(outExt[1] + outline, inDataExt[1]);
+  const int inMin1 = std::max(outExt[2] - outline, inDataExt[2]);
+  const int inMax1 = std::min(outExt[3] + outline, inDataExt[3]);
+
+  const int width = outExt[1] - outExt[0] + 1;
+  const int numberOfRows = inMax1 - inMin1 + 1;
+  if (width <= 0 || numberOfRows <= 0)
+    {
+    return;
+    }
+
+  // Pixels closer to the image boundary than the outline are always
+  // outline pixels, like in the neighborhood implementation.
+  const int borderMin0 = wholeExt[0] + outline - outExt[0];
+  const int borderMax0 = wholeExt[1] - outline - outExt[0];
+
+  std::vector<T> rowMin(static_cast<size_t>(numberOfRows) * width);
+  std::vector<T> rowMax(static_cast<size_t>(numberOfRows) * width);
+  std::vector<T> hoodMin(width);
+  std::vector<T> hoodMax(width);
+  std::vector<T> labels(width);
+
+  vtkIdType outInc0, outInc1, outInc2;
   outData->GetIncrements(outInc0, outInc1, outInc2);
-  outMin0 = outExt[0];   outMax0 = outExt[1];
-  outMin1 = outExt[2];   outMax1 = outExt[3];
-  outMin2 = outExt[4];   outMax2 = outExt[5];
-
-  // Neighborhood around current voxel
-  kernelSize = self->GetKernelSize();
-  kernelMiddle = self->GetKernelMiddle();
-  hoodMin0 = kernelMiddle[0] - kernelSize[0]/2; // truncate on purpose
-  hoodMin1 = kernelMiddle[1] - kernelSize[1]/2; // to round down odd sizes
-  hoodMin2 = kernelMiddle[2] - kernelSize[2]/2;
-  hoodMax0 = hoodMin0 + kernelSize[0];
-  hoodMax1 = hoodMin1 + kernelSize[1];
-  hoodMax2 = hoodMin2 + kernelSize[2];
-
-  int outline = self->GetOutline();
-  hoodMin0 = - outline;
-  hoodMin1 = - outline;
-  hoodMin2 = 0;
-  hoodMax0 = outline;
-  hoodMax1 = outline;
-  hoodMax2 = 0;
-
-  // in and out should be marching through corresponding pixels.
-  target = (unsigned long)((outMax2-outMin2+1)*(outMax1-outMin1+1)/50.0);
+
+  unsigned long count = 0;
+  unsigned long target = (unsigned long)((outExt[5]-outExt[4]+1)*(outExt[3]-outExt[2]+1)/50.0);
   target++;
 
-  // loop through pixels of output
-  outPtr2 = outPtr;
-  inPtr2 = (T*)(inData->GetScalarPointer(outMin0, outMin1, outMin2));
-  for (outIdx2 = outMin2; outIdx2 <= outMax2; outIdx2++)
+  for (int idx2 = outExt[4]; idx2 <= outExt[5] && !self->AbortExecute; ++idx2)
     {
-    outPtr1 = outPtr2;
-    inPtr1 = inPtr2;
-    for (outIdx1 = outMin1;
-      !self->AbortExecute && outIdx1 <= outMax1; outIdx1++)
+    // Horizontal pass
+    for (int idx1 = inMin1; idx1 <= inMax1; ++idx1)
+      {
+      const T* rowPtr = static_cast<T*>(inData->GetScalarPointer(inMin0, idx1, idx2));
+      size_t rowOffset = static_cast<size_t>(idx1 - inMin1) * width;
+      vtkImageLabelOutlineRowMinMax(rowPtr, inMin0, inMax0, outExt[0], outExt[1],
+                                    outline, &rowMin[rowOffset], &rowMax[rowOffset]);
+      }
+
+    // Vertical pass and output
+    for (int idx1 = outExt[2]; !self->AbortExecute && idx1 <= outExt[3]; ++idx1)
       {
       if (!id)
         {
@@ -125,74 +264,66 @@ static void vtkImageLabelOutlineExecute(vtkImageLabelOutline *self,
           }
         count++;
         }
-      outPtr0 = outPtr1;
-      inPtr0 = inPtr1;
-      for (outIdx0 = outMin0; outIdx0 <= outMax0; outIdx0++)
+
+      size_t rowOffset = static_cast<size_t>(idx1 - inMin1) * width;
+      std::copy(rowMin.begin() + rowOffset, rowMin.begin() + rowOffset + width, hoodMin.begin());
+      std::copy(rowMax.begin() + rowOffset, rowMax.begin() + rowOffset + width, hoodMax.begin());
+      const int first1 = std::max(idx1 - outline, inMin1);
+      const int last1 = std::min(idx1 + outline, inMax1);
+      for (int hoodIdx1 = first1; hoodIdx1 <= last1; ++hoodIdx1)
+        {
+        if (hoodIdx1 == idx1)
+          {
+          continue;
+          }
+        size_t hoodOffset = static_cast<size_t>(hoodIdx1 - inMin1) * width;
+        vtkImageLabelOutlineMinMax(&rowMin[hoodOffset], &rowMax[hoodOffset],
+                                   &hoodMin[0], &hoodMax[0], width);
+        }
+
+      const bool borderRow = (idx1 - outline < wholeExt[2] || idx1 + outline > wholeExt[3]);
+      const T* inPtr0 = static_cast<T*>(inData->GetScalarPointer(outExt[0], idx1, idx2));
+      for (int idx0 = 0; idx0 < width; ++idx0)
+        {
+        const T inLabelValue = inPtr0[idx0];
+        const bool border = borderRow || idx0 < borderMin0 || idx0 > borderMax0;
+        const bool transition = hoodMin[idx0] != inLabelValue || hoodMax[idx0] != inLabelValue;
+        labels[idx0] = (inLabelValue != backgroundLabelValue && (border || transition))
+          ? inLabelValue : backgroundLabelValue;
+        }
+
+      if (lookupTable)
         {
-        inLabelValue = *inPtr0;
-        // Default output equal to backgroundLabelValue
-        // on the assumption this is not an outline pixel
-        *outPtr0 = backgroundLabelValue;
-
-        // look at neighborhood around non-background
-        // pixels to see if there is a transition.
-        // If there is, then this is an outline pixel
-        if (inLabelValue != backgroundLabelValue)
+        // Labels come in runs, only look up the colors when the label changes
+        unsigned char* outPtr0 = static_cast<unsigned char*>(outData->GetScalarPointer(outExt[0], idx1, idx2));
+        unsigned char outlineColor[4] = { 0, 0, 0, 0 };
+        unsigned char fillColor[4] = { 0, 0, 0, 0 };
+        T colorLabel = inPtr0[0];
+        vtkImageLabelOutlineMapLabel(lookupTable, fillLookupTable, static_cast<double>(colorLabel),
+          static_cast<double>(backgroundLabelValue), outlineColor, fillColor);
+        for (int idx0 = 0; idx0 < width; ++idx0)
           {
-          // Loop through neighborhood pixels
-          // Note: hood pointer marches out of bounds.
-          // start at lower left pixel
-          hoodPtr2 = inPtr0 + hoodMin0 * inInc0
-                            + hoodMin1 * inInc1
-                            + hoodMin2 * inInc2;
-
-          for (hoodIdx2 = hoodMin2; hoodIdx2 <= hoodMax2; ++hoodIdx2)
+          if (inPtr0[idx0] != colorLabel)
             {
-            hoodPtr1 = hoodPtr2;
-            for (hoodIdx1 = hoodMin1; hoodIdx1 <= hoodMax1; ++hoodIdx1)
-              {
-              hoodPtr0 = hoodPtr1;
-              for (hoodIdx0 = hoodMin0; hoodIdx0 <= hoodMax0; ++hoodIdx0)
-                {
-                // handle boundaries
-                if (outIdx0 + hoodIdx0 >= inImageMin0 &&
-                    outIdx0 + hoodIdx0 <= inImageMax0 &&
-                    outIdx1 + hoodIdx1 >= inImageMin1 &&
-                    outIdx1 + hoodIdx1 <= inImageMax1 &&
-                    outIdx2 + hoodIdx2 >= inImageMin2 &&
-                    outIdx2 + hoodIdx2 <= inImageMax2)
-                  {
-                  // If the neighbor value is not the same label value
-                  // that means this is an outline pixel
-                  // (border is within neighborhood).
-                  // so set the output to foreground
-                  if (*hoodPtr0 != inLabelValue)
-                    {
-                    *outPtr0 = inLabelValue;
-                    }
-                  }
-                else
-                  {
-                  // neighborhood reaches outside of the input
-                  // domain, so this is also an outline pixel
-                  *outPtr0 = inLabelValue;
-                  }
-                hoodPtr0 += inInc0;
-                }//for0
-              hoodPtr1 += inInc1;
-              }//for1
-            hoodPtr2 += inInc2;
-            }//for2
-          }//if
-        inPtr0 += inInc0;
-        outPtr0 += outInc0;
-        }//for0
-      inPtr1 += inInc1;
-      outPtr1 += outInc1;
-      }//for1
-    inPtr2 += inInc2;
-    outPtr2 += outInc2;
-    }//for2
+            colorLabel = inPtr0[idx0];
+            vtkImageLabelOutlineMapLabel(lookupTable, fillLookupTable, static_cast<double>(colorLabel),
+              static_cast<double>(backgroundLabelValue), outlineColor, fillColor);
+            }
+          const unsigned char* color = (labels[idx0] != backgroundLabelValue ? outlineColor : fillColor);
+          outPtr0[0] = color[0];
+          outPtr0[1] = color[1];
+          outPtr0[2] = color[2];
+          outPtr0[3] = color[3];
+          outPtr0 += outInc0;
+          }
+        }
+      else
+        {
+        T* outPtr0 = static_cast<T*>(outData->GetScalarPointer(outExt[0], idx1, idx2));
+        std::copy(labels.begin(), labels.end(), outPtr0);
+        }
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -213,6 +344,12 @@ void vtkImageLabelOutline::ThreadedExecute(vtkImageData *inData,
     vtkErrorMacro(<<"Input has "<<x1<<" instead of 1 scalar component.");
     return;
   }
+  if (this->LookupTable &&
+      (outData->GetScalarType() != VTK_UNSIGNED_CHAR || outData->GetNumberOfScalarComponents() != 4))
+    {
+    vtkErrorMacro(<<"Output must be RGBA unsigned char when a lookup table is set.");
+    return;
+    }
 
 
   void *inPtr = inData->GetScalarPointerForExtent(outExt);
@@ -272,6 +409,8 @@ void vtkImageLabelOutline::PrintSelf(ostream& os, vtkIndent indent)
 
     os << indent << "Outline: " << this->Outline << "\n";
     os << indent << "Background: " << this->Background<< "\n";
+    os << indent << "LookupTable: " << this->LookupTable << "\n";
+    os << indent << "FillLookupTable: " << this->FillLookupTable << "\n";
 
     if (this->GetInput() != nullptr)
       {
@@ -20,11 +20,24 @@
 #include "vtkMRMLLogicExport.h"
 
 class vtkImageData;
+class vtkLookupTable;
 
 /// \brief Display labelmap outlines.
 ///
 /// Used  in slicer for the Label layer to outline the segmented
 /// structures (instead of showing them filled-in).
+///
+/// A pixel is part of the outline if its label differs from the background
+/// and any pixel within Outline pixels (in the slice plane) has a different
+/// label. The neighborhood minimum and maximum are computed separably, first
+/// along rows then along columns, so that the inner loops run over contiguous
+/// memory and can be vectorized by the compiler.
+///
+/// If a LookupTable is set, the outline is mapped through it in the same pass
+/// and the output is RGBA unsigned char, as vtkImageMapToColors would produce.
+/// If a FillLookupTable is set as well, the rest of the labels is mapped through
+/// it and the outline is blended over the fill, so that a filled and outlined
+/// labelmap is produced by a single filter.
 class VTK_MRML_LOGIC_EXPORT vtkImageLabelOutline : public vtkImageNeighborhoodFilter
 {
 public:
@@ -42,12 +55,39 @@ public:
   void SetOutline(int outline);
   vtkGetMacro(Outline, int);
 
+  ///
+  /// Optional lookup table used to colorize the outline. If set, the output is
+  /// RGBA unsigned char instead of labels, which saves a vtkImageMapToColors
+  /// pass and the intermediate outline image. Default is nullptr.
+  virtual void SetLookupTable(vtkLookupTable* lookupTable);
+  vtkGetObjectMacro(LookupTable, vtkLookupTable);
+
+  ///
+  /// Optional lookup table used to colorize the pixels that are not part of
+  /// the outline. Only used if LookupTable is set. Default is nullptr, which
+  /// maps these pixels to the color of the background in LookupTable.
+  virtual void SetFillLookupTable(vtkLookupTable* lookupTable);
+  vtkGetObjectMacro(FillLookupTable, vtkLookupTable);
+
+  ///
+  /// Take the lookup tables modification time into account
+  vtkMTimeType GetMTime() override;
+
 protected:
   vtkImageLabelOutline();
   ~vtkImageLabelOutline() override;
 
+  int RequestInformation(vtkInformation* request,
+                         vtkInformationVector** inputVector,
+                         vtkInformationVector* outputVector) override;
+  int RequestData(vtkInformation* request,
+                  vtkInformationVector** inputVector,
+                  vtkInformationVector* outputVector) override;
+
   float Background;
   int Outline;
+  vtkLookupTable* LookupTable;
+  vtkLookupTable* FillLookupTable;
 
   void ThreadedExecute(vtkImageData *inData, vtkImageData *outData,
                        int extent[6], int id) override;
@@ -0,0 +1,370 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkImageLayerCompositor.h"
+
+// VTK includes
+#include <vtkAlgorithm.h>
+#include <vtkDataObject.h>
+#include <vtkImageData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageLayerCompositor);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Part of the output row [outExt[0], outExt[1]] at (y, z) that is covered
+// by the input. Returns the input pointer at first, nullptr if not covered.
+const unsigned char* vtkImageLayerCompositorInputRow(vtkImageData* input,
+  int y, int z, const int outExt[6], int& first, int& last)
+{
+  if (!input)
+    {
+    return nullptr;
+    }
+  int* inExt = input->GetExtent();
+  if (y < inExt[2] || y > inExt[3] || z < inExt[4] || z > inExt[5])
+    {
+    return nullptr;
+    }
+  first = std::max(outExt[0], inExt[0]);
+  last = std::min(outExt[1], inExt[1]);
+  if (first > last)
+    {
+    return nullptr;
+    }
+  return static_cast<unsigned char*>(input->GetScalarPointer(first, y, z));
+}
+
+//----------------------------------------------------------------------------
+// Convert a row of 1 to 4 components to RGBA
+void vtkImageLayerCompositorCopyRow(const unsigned char* in, int inC,
+  unsigned char* out, int count)
+{
+  switch (inC)
+    {
+    case 4:
+      memcpy(out, in, 4 * static_cast<size_t>(count));
+      break;
+    case 3:
+      for (int i = 0; i < count; ++i, in += 3, out += 4)
+        {
+        out[0] = in[0];
+        out[1] = in[1];
+        out[2] = in[2];
+        out[3] = 255;
+        }
+      break;
+    default:
+      for (int i = 0; i < count; ++i, in += inC, out += 4)
+        {
+        out[0] = out[1] = out[2] = in[0];
+        out[3] = (inC == 2 ? in[1] : 255);
+        }
+      break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Add or subtract the RGB of a row of 1 to 4 components to a RGBA row,
+// clamped to [0, 255]. The alpha of the RGBA row is kept.
+void vtkImageLayerCompositorAddSubtractRow(const unsigned char* in, int inC, bool subtract,
+  unsigned char* out, int count)
+{
+  const int sign = subtract ? -1 : 1;
+  for (int i = 0; i < count; ++i, in += inC, out += 4)
+    {
+    for (int c = 0; c < 3; ++c)
+      {
+      int value = out[c] + sign * in[inC >= 3 ? c : 0];
+      out[c] = static_cast<unsigned char>(value < 0 ? 0 : (value > 255 ? 255 : value));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Alpha blend a row of 1 to 4 components onto a RGBA row. Opacity is in
+// [0, 256], the arithmetic is the same as vtkImageBlend for unsigned char.
+// The RGBA loop has no branch so that it can be vectorized.
+void vtkImageLayerCompositorBlendRow(const unsigned char* in, int inC,
+  unsigned char* out, int count, unsigned int opacity)
+{
+  if (inC == 4)
+    {
+    for (int i = 0; i < count; ++i)
+      {
+      // in [0, 65280] where 65280 = 255*256 = range of alpha * range of opacity
+      unsigned int r = in[4 * i + 3] * opacity;
+      unsigned int f = 65280 - r;
+      out[4 * i + 0] = static_cast<unsigned char>((out[4 * i + 0] * f + in[4 * i + 0] * r) >> 16);
+      out[4 * i + 1] = static_cast<unsigned char>((out[4 * i + 1] * f + in[4 * i + 1] * r) >> 16);
+      out[4 * i + 2] = static_cast<unsigned char>((out[4 * i + 2] * f + in[4 * i + 2] * r) >> 16);
+      }
+    return;
+    }
+  for (int i = 0; i < count; ++i, in += inC, out += 4)
+    {
+    unsigned int alpha = (inC == 2 ? in[1] : 255);
+    unsigned int r = alpha * opacity;
+    unsigned int f = 65280 - r;
+    out[0] = static_cast<unsigned char>((out[0] * f + in[0] * r) >> 16);
+    out[1] = static_cast<unsigned char>((out[1] * f + in[inC >= 3 ? 1 : 0] * r) >> 16);
+    out[2] = static_cast<unsigned char>((out[2] * f + in[inC >= 3 ? 2 : 0] * r) >> 16);
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkImageLayerCompositor::vtkImageLayerCompositor()
+{
+  this->Compositing = vtkImageLayerCompositor::Alpha;
+}
+
+//----------------------------------------------------------------------------
+vtkImageLayerCompositor::~vtkImageLayerCompositor() = default;
+
+//----------------------------------------------------------------------------
+void vtkImageLayerCompositor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Compositing: " << this->Compositing << "\n";
+  for (size_t i = 0; i < this->Opacity.size(); ++i)
+    {
+    os << indent << "Opacity(" << i << "): " << this->Opacity[i] << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLayerCompositor::SetOpacity(int idx, double opacity)
+{
+  if (idx < 0)
+    {
+    vtkErrorMacro("SetOpacity: invalid index " << idx);
+    return;
+    }
+  opacity = std::min(1.0, std::max(0.0, opacity));
+  if (idx >= static_cast<int>(this->Opacity.size()))
+    {
+    this->Opacity.resize(idx + 1, 1.0);
+    }
+  else if (this->Opacity[idx] == opacity)
+    {
+    return;
+    }
+  this->Opacity[idx] = opacity;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+double vtkImageLayerCompositor::GetOpacity(int idx)
+{
+  if (idx < 0 || idx >= static_cast<int>(this->Opacity.size()))
+    {
+    return 1.0;
+    }
+  return this->Opacity[idx];
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLayerCompositor::FillInputPortInformation(int port, vtkInformation* info)
+{
+  if (!this->Superclass::FillInputPortInformation(port, info))
+    {
+    return 0;
+    }
+  info->Set(vtkAlgorithm::INPUT_IS_REPEATABLE(), 1);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLayerCompositor::RequestInformation(vtkInformation* vtkNotUsed(request),
+                                                vtkInformationVector** inputVector,
+                                                vtkInformationVector* outputVector)
+{
+  // The output covers all the layers, the geometry is the one of input 0
+  int wholeExt[6] = { 0, -1, 0, -1, 0, -1 };
+  int numberOfInputs = inputVector[0]->GetNumberOfInformationObjects();
+  for (int idx = 0; idx < numberOfInputs; ++idx)
+    {
+    int inExt[6];
+    inputVector[0]->GetInformationObject(idx)->Get(
+      vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      if (idx == 0 || inExt[2 * axis] < wholeExt[2 * axis])
+        {
+        wholeExt[2 * axis] = inExt[2 * axis];
+        }
+      if (idx == 0 || inExt[2 * axis + 1] > wholeExt[2 * axis + 1])
+        {
+        wholeExt[2 * axis + 1] = inExt[2 * axis + 1];
+        }
+      }
+    }
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), wholeExt, 6);
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, VTK_UNSIGNED_CHAR, 4);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageLayerCompositor::RequestUpdateExtent(vtkInformation* vtkNotUsed(request),
+                                                 vtkInformationVector** inputVector,
+                                                 vtkInformationVector* outputVector)
+{
+  int outExt[6];
+  outputVector->GetInformationObject(0)->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), outExt);
+  int numberOfInputs = inputVector[0]->GetNumberOfInformationObjects();
+  for (int idx = 0; idx < numberOfInputs; ++idx)
+    {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(idx);
+    int inExt[6];
+    inInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(), inExt);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      inExt[2 * axis] = std::max(inExt[2 * axis], outExt[2 * axis]);
+      inExt[2 * axis + 1] = std::min(inExt[2 * axis + 1], outExt[2 * axis + 1]);
+      }
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), inExt, 6);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageLayerCompositor::ThreadedRequestData(vtkInformation* vtkNotUsed(request),
+                                                  vtkInformationVector** inputVector,
+                                                  vtkInformationVector* vtkNotUsed(outputVector),
+                                                  vtkImageData*** inData,
+                                                  vtkImageData** outData,
+                                                  int outExt[6], int id)
+{
+  vtkImageData* output = outData[0];
+  if (output->GetScalarType() != VTK_UNSIGNED_CHAR || output->GetNumberOfScalarComponents() != 4)
+    {
+    vtkErrorMacro("ThreadedRequestData: output must be RGBA unsigned char.");
+    return;
+    }
+
+  // Layers that can't be composited are skipped
+  int numberOfInputs = inputVector[0]->GetNumberOfInformationObjects();
+  std::vector<vtkImageData*> inputs(numberOfInputs, nullptr);
+  for (int idx = 0; idx < numberOfInputs; ++idx)
+    {
+    vtkImageData* input = inData[0][idx];
+    if (!input || !input->GetPointData()->GetScalars())
+      {
+      continue;
+      }
+    int numberOfComponents = input->GetNumberOfScalarComponents();
+    if (input->GetScalarType() != VTK_UNSIGNED_CHAR || numberOfComponents < 1 || numberOfComponents > 4)
+      {
+      if (id == 0)
+        {
+        vtkErrorMacro("ThreadedRequestData: input " << idx << " is not an unsigned char image with 1 to 4 components.");
+        }
+      continue;
+      }
+    inputs[idx] = input;
+    }
+
+  const bool addSubtract = (this->Compositing != vtkImageLayerCompositor::Alpha && numberOfInputs >= 2);
+  const int firstBlendedInput = addSubtract ? 2 : 1;
+  std::vector<unsigned int> opacities(numberOfInputs, 0);
+  for (int idx = firstBlendedInput; idx < numberOfInputs; ++idx)
+    {
+    // round to [0, 256] to divide by bit shifting
+    opacities[idx] = static_cast<unsigned int>(256.0 * this->GetOpacity(idx) + 0.5);
+    }
+
+  const int width = outExt[1] - outExt[0] + 1;
+  unsigned long count = 0;
+  unsigned long target = (unsigned long)((outExt[5]-outExt[4]+1)*(outExt[3]-outExt[2]+1)/50.0);
+  target++;
+
+  for (int z = outExt[4]; z <= outExt[5]; ++z)
+    {
+    for (int y = outExt[2]; !this->AbortExecute && y <= outExt[3]; ++y)
+      {
+      if (!id)
+        {
+        if (!(count%target))
+          {
+          this->UpdateProgress(count/(50.0*target));
+          }
+        count++;
+        }
+      unsigned char* outRow = static_cast<unsigned char*>(output->GetScalarPointer(outExt[0], y, z));
+
+      // Base layer
+      int first = 0;
+      int last = -1;
+      const unsigned char* inRow = numberOfInputs > 0
+        ? vtkImageLayerCompositorInputRow(inputs[0], y, z, outExt, first, last) : nullptr;
+      if (!inRow || first != outExt[0] || last != outExt[1])
+        {
+        memset(outRow, 0, 4 * static_cast<size_t>(width));
+        }
+      if (inRow)
+        {
+        vtkImageLayerCompositorCopyRow(inRow, inputs[0]->GetNumberOfScalarComponents(),
+          outRow + 4 * (first - outExt[0]), last - first + 1);
+        }
+      if (addSubtract && inRow)
+        {
+        int first1 = 0;
+        int last1 = -1;
+        const unsigned char* inRow1 = vtkImageLayerCompositorInputRow(inputs[1], y, z, outExt, first1, last1);
+        if (inRow1)
+          {
+          first1 = std::max(first, first1);
+          last1 = std::min(last, last1);
+          if (first1 <= last1)
+            {
+            vtkImageLayerCompositorAddSubtractRow(
+              static_cast<unsigned char*>(inputs[1]->GetScalarPointer(first1, y, z)),
+              inputs[1]->GetNumberOfScalarComponents(),
+              this->Compositing == vtkImageLayerCompositor::Subtract,
+              outRow + 4 * (first1 - outExt[0]), last1 - first1 + 1);
+            }
+          }
+        }
+
+      // Blended layers
+      for (int idx = firstBlendedInput; idx < numberOfInputs; ++idx)
+        {
+        if (opacities[idx] == 0)
+          {
+          continue;
+          }
+        inRow = vtkImageLayerCompositorInputRow(inputs[idx], y, z, outExt, first, last);
+        if (!inRow)
+          {
+          continue;
+          }
+        vtkImageLayerCompositorBlendRow(inRow, inputs[idx]->GetNumberOfScalarComponents(),
+          outRow + 4 * (first - outExt[0]), last - first + 1, opacities[idx]);
+        }
+      }
+    }
+}
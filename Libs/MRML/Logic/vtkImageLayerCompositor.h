@@ -0,0 +1,89 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkImageLayerCompositor_h
+#define __vtkImageLayerCompositor_h
+
+#include "vtkMRMLLogicExport.h"
+
+// VTK includes
+#include <vtkThreadedImageAlgorithm.h>
+
+// STD includes
+#include <vector>
+
+/// \brief Composite colorized slice layers in a single pass.
+///
+/// Used by vtkMRMLSliceLogic to combine the background, foreground and
+/// label layers of a slice view. All inputs are connected to port 0 and
+/// must be unsigned char images with 1 to 4 components, the output is RGBA.
+///
+/// Input 0 is the base layer and its opacity is ignored. The next inputs are
+/// alpha blended onto it in order, using their alpha channel multiplied by
+/// their opacity, with the same integer arithmetic as vtkImageBlend.
+/// In Add and Subtract compositing mode, the base layer is the sum
+/// (difference) of the RGB of inputs 0 and 1, with the alpha of input 0,
+/// and the opacity of input 1 is ignored.
+///
+/// Each output pixel is written once, without intermediate images.
+class VTK_MRML_LOGIC_EXPORT vtkImageLayerCompositor : public vtkThreadedImageAlgorithm
+{
+public:
+  static vtkImageLayerCompositor *New();
+  vtkTypeMacro(vtkImageLayerCompositor, vtkThreadedImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum
+    {
+    Alpha = 0,
+    Add,
+    Subtract
+    };
+
+  ///
+  /// How the first two inputs are combined. Default is Alpha.
+  vtkSetClampMacro(Compositing, int, Alpha, Subtract);
+  vtkGetMacro(Compositing, int);
+  void SetCompositingToAlpha() { this->SetCompositing(Alpha); }
+  void SetCompositingToAdd() { this->SetCompositing(Add); }
+  void SetCompositingToSubtract() { this->SetCompositing(Subtract); }
+
+  ///
+  /// Opacity of an input, in [0, 1]. Default is 1.
+  void SetOpacity(int idx, double opacity);
+  double GetOpacity(int idx);
+
+protected:
+  vtkImageLayerCompositor();
+  ~vtkImageLayerCompositor() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+  int RequestInformation(vtkInformation* request,
+                         vtkInformationVector** inputVector,
+                         vtkInformationVector* outputVector) override;
+  int RequestUpdateExtent(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector) override;
+  void ThreadedRequestData(vtkInformation* request,
+                           vtkInformationVector** inputVector,
+                           vtkInformationVector* outputVector,
+                           vtkImageData*** inData,
+                           vtkImageData** outData,
+                           int outExt[6], int id) override;
+
+  vtkImageLayerCompositor(const vtkImageLayerCompositor&);
+  void operator=(const vtkImageLayerCompositor&);
+
+  int Compositing;
+  std::vector<double> Opacity;
+};
+
+#endif
@@ -39,23 +39,29 @@
 #include "vtkMRMLStorableNode.h"
 #include "vtkMRMLStorageNode.h"
 #include "vtkMRMLSceneViewNode.h"
+#include "vtkMRMLStreamingVolumeNode.h"
 #include "vtkMRMLTableViewNode.h"
 #include "vtkMRMLViewNode.h"
 
 // VTK includes
+#include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
 #include <vtkImageData.h>
+#include <vtkIntArray.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPNGWriter.h>
 #include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 
 // VTKSYS includes
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/Glob.hxx>
 
 // STD includes
+#include <atomic>
 #include <cassert>
+#include <map>
 #include <sstream>
 
 // For LoadDefaultParameterSets
@@ -77,6 +83,12 @@ public:
   void PropagateVolumeSelection(int layer, int fit);
   ~vtkInternal();
 
+  /// Observe frames decoded in the background by streaming volume nodes of the scene
+  void ObserveStreamingVolumeNodes(vtkMRMLScene* scene, bool observe);
+  void ProcessStreamingVolumeFrames();
+  static void StreamingVolumeCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+  static void DecodedFrameReadyCallback(void* clientData);
+
   vtkMRMLApplicationLogic* External;
   vtkSmartPointer<vtkMRMLSelectionNode> SelectionNode;
   vtkSmartPointer<vtkMRMLInteractionNode> InteractionNode;
@@ -85,8 +97,11 @@ public:
   vtkSmartPointer<vtkMRMLSliceLinkLogic> SliceLinkLogic;
   vtkSmartPointer<vtkMRMLViewLinkLogic> ViewLinkLogic;
   vtkSmartPointer<vtkMRMLColorLogic> ColorLogic;
+  std::map<std::string, vtkWeakPointer<vtkMRMLAbstractLogic> > ModuleLogicMap;
   std::string TemporaryPath;
-
+  vtkSmartPointer<vtkCallbackCommand> StreamingVolumeCallbackCommand;
+  /// Set when processing of decoded frames has been requested on the main thread
+  std::atomic<bool> StreamingVolumeFramesProcessingScheduled;
 };
 
 //----------------------------------------------------------------------------
@@ -99,6 +114,10 @@ vtkMRMLApplicationLogic::vtkInternal::vtkInternal(vtkMRMLApplicationLogic* exter
   this->SliceLinkLogic = vtkSmartPointer<vtkMRMLSliceLinkLogic>::New();
   this->ViewLinkLogic = vtkSmartPointer<vtkMRMLViewLinkLogic>::New();
   this->ColorLogic = vtkSmartPointer<vtkMRMLColorLogic>::New();
+  this->StreamingVolumeCallbackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->StreamingVolumeCallbackCommand->SetClientData(this);
+  this->StreamingVolumeCallbackCommand->SetCallback(vtkMRMLApplicationLogic::vtkInternal::StreamingVolumeCallback);
+  this->StreamingVolumeFramesProcessingScheduled = false;
 }
 
 //----------------------------------------------------------------------------
@@ -146,6 +165,62 @@ void vtkMRMLApplicationLogic::vtkInternal::PropagateVolumeSelection(int layer, i
     this->External->FitSliceToAll(true);
     }
 }
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::vtkInternal::ObserveStreamingVolumeNodes(vtkMRMLScene* scene, bool observe)
+{
+  if (!scene)
+    {
+    return;
+    }
+  std::vector<vtkMRMLNode*> streamingVolumeNodes;
+  scene->GetNodesByClass("vtkMRMLStreamingVolumeNode", streamingVolumeNodes);
+  for (vtkMRMLNode* node : streamingVolumeNodes)
+    {
+    vtkMRMLStreamingVolumeNode::SafeDownCast(node)->SetDecodedFrameReadyCallback(
+      observe ? vtkMRMLApplicationLogic::vtkInternal::DecodedFrameReadyCallback : nullptr, observe ? this : nullptr);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::vtkInternal::ProcessStreamingVolumeFrames()
+{
+  this->StreamingVolumeFramesProcessingScheduled = false;
+  vtkMRMLScene* scene = this->External->GetMRMLScene();
+  if (!scene)
+    {
+    return;
+    }
+  std::vector<vtkMRMLNode*> streamingVolumeNodes;
+  scene->GetNodesByClass("vtkMRMLStreamingVolumeNode", streamingVolumeNodes);
+  for (vtkMRMLNode* node : streamingVolumeNodes)
+    {
+    vtkMRMLStreamingVolumeNode::SafeDownCast(node)->ProcessDecodedFrames();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::vtkInternal::StreamingVolumeCallback(vtkObject* vtkNotUsed(caller),
+  unsigned long eid, void* clientData, void* vtkNotUsed(callData))
+{
+  vtkInternal* self = reinterpret_cast<vtkInternal*>(clientData);
+  if (eid == vtkMRMLApplicationLogic::ProcessStreamingVolumeFramesEvent)
+    {
+    self->ProcessStreamingVolumeFrames();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::vtkInternal::DecodedFrameReadyCallback(void* clientData)
+{
+  // Called by the decoding thread: the decoded frames are swapped in on the main thread.
+  // The event is invoked on the application logic and not on the node, which may be deleted in the meantime.
+  vtkInternal* self = reinterpret_cast<vtkInternal*>(clientData);
+  if (!self->StreamingVolumeFramesProcessingScheduled.exchange(true))
+    {
+    self->External->InvokeEventWithDelay(0, self->External, vtkMRMLApplicationLogic::ProcessStreamingVolumeFramesEvent);
+    }
+}
 //----------------------------------------------------------------------------
 // vtkMRMLApplicationLogic methods
 
@@ -156,11 +231,14 @@ vtkMRMLApplicationLogic::vtkMRMLApplicationLogic()
   this->Internal->SliceLinkLogic->SetMRMLApplicationLogic(this);
   this->Internal->ViewLinkLogic->SetMRMLApplicationLogic(this);
   this->Internal->ColorLogic->SetMRMLApplicationLogic(this);
+  this->AddObserver(vtkMRMLApplicationLogic::ProcessStreamingVolumeFramesEvent, this->Internal->StreamingVolumeCallbackCommand);
 }
 
 //----------------------------------------------------------------------------
 vtkMRMLApplicationLogic::~vtkMRMLApplicationLogic()
 {
+  this->Internal->ObserveStreamingVolumeNodes(this->GetMRMLScene(), false);
+  this->RemoveObservers(vtkMRMLApplicationLogic::ProcessStreamingVolumeFramesEvent, this->Internal->StreamingVolumeCallbackCommand);
   delete this->Internal;
 }
 
@@ -195,6 +273,41 @@ vtkMRMLColorLogic* vtkMRMLApplicationLogic::GetColorLogic()const
   return this->Internal->ColorLogic;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::SetModuleLogic(const char* moduleName, vtkMRMLAbstractLogic* moduleLogic)
+{
+  if (!moduleName)
+    {
+    vtkErrorMacro("SetModuleLogic: Invalid module name");
+    return;
+    }
+  if (moduleLogic)
+    {
+    this->Internal->ModuleLogicMap[moduleName] = moduleLogic;
+    }
+  else
+    {
+    this->Internal->ModuleLogicMap.erase(moduleName);
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLAbstractLogic* vtkMRMLApplicationLogic::GetModuleLogic(const char* moduleName)const
+{
+  if (!moduleName)
+    {
+    vtkErrorMacro("GetModuleLogic: Invalid module name");
+    return nullptr;
+    }
+  std::map<std::string, vtkWeakPointer<vtkMRMLAbstractLogic> >::const_iterator logicIt =
+    this->Internal->ModuleLogicMap.find(moduleName);
+  if (logicIt == this->Internal->ModuleLogicMap.end())
+    {
+    return nullptr;
+    }
+  return logicIt->second;
+}
+
 //----------------------------------------------------------------------------
 vtkCollection* vtkMRMLApplicationLogic::GetSliceLogics()const
 {
@@ -396,12 +509,39 @@ void vtkMRMLApplicationLogic::SetMRMLSceneInternal(vtkMRMLScene* newScene)
   // Add default slice orientation presets
   vtkMRMLSliceNode::AddDefaultSliceOrientationPresets(newScene);
 
-  this->Superclass::SetMRMLSceneInternal(newScene);
+  this->Internal->ObserveStreamingVolumeNodes(this->GetMRMLScene(), false);
+  vtkNew<vtkIntArray> events;
+  events->InsertNextValue(vtkMRMLScene::NodeAddedEvent);
+  events->InsertNextValue(vtkMRMLScene::NodeRemovedEvent);
+  this->SetAndObserveMRMLSceneEventsInternal(newScene, events.GetPointer());
+  this->Internal->ObserveStreamingVolumeNodes(newScene, true);
 
   this->Internal->SliceLinkLogic->SetMRMLScene(newScene);
   this->Internal->ViewLinkLogic->SetMRMLScene(newScene);
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::OnMRMLSceneNodeAdded(vtkMRMLNode* node)
+{
+  vtkMRMLStreamingVolumeNode* streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(node);
+  if (streamingVolumeNode)
+    {
+    streamingVolumeNode->SetDecodedFrameReadyCallback(vtkMRMLApplicationLogic::vtkInternal::DecodedFrameReadyCallback, this->Internal);
+    // Frames decoded before the node was added to the scene
+    streamingVolumeNode->ProcessDecodedFrames();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLApplicationLogic::OnMRMLSceneNodeRemoved(vtkMRMLNode* node)
+{
+  vtkMRMLStreamingVolumeNode* streamingVolumeNode = vtkMRMLStreamingVolumeNode::SafeDownCast(node);
+  if (streamingVolumeNode)
+    {
+    streamingVolumeNode->SetDecodedFrameReadyCallback(nullptr, nullptr);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLApplicationLogic::SetSelectionNode(vtkMRMLSelectionNode* selectionNode)
 {
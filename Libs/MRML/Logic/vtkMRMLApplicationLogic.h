@@ -80,6 +80,14 @@ public:
   void SetColorLogic(vtkMRMLColorLogic* newColorLogic);
   vtkMRMLColorLogic* GetColorLogic()const;
 
+  /// Set/Get the logic of a module, by module name.
+  /// It allows logics and displayable managers to use the logic of other
+  /// modules without depending on how modules are instantiated.
+  /// The application logic does not hold a reference to module logics.
+  /// GetModuleLogic returns nullptr if the module logic is not registered.
+  void SetModuleLogic(const char* moduleName, vtkMRMLAbstractLogic* moduleLogic);
+  vtkMRMLAbstractLogic* GetModuleLogic(const char* moduleName)const;
+
   /// Apply the active volumes in the SelectionNode to the slice composite nodes
   /// Perform the default behavior related to selecting a volume
   /// (in this case, making it the background for all SliceCompositeNodes)
@@ -184,10 +192,15 @@ public:
   static std::string CreateUniqueFileName(const std::string &filename, const std::string& knownExtension="");
 
   /// List of custom events fired by the class.
+  /// ProcessStreamingVolumeFramesEvent is invoked on the main thread (using InvokeEventWithDelay())
+  /// after frames of streaming volume nodes of the scene have been decoded in the background.
+  /// The decoded frames are then swapped into the nodes.
+  /// \sa vtkMRMLStreamingVolumeNode::SetDecodedFrameReadyCallback
   enum Events{
     RequestInvokeEvent = vtkCommand::UserEvent + 1,
     PauseRenderEvent = vtkCommand::UserEvent + 101,
-    ResumeRenderEvent
+    ResumeRenderEvent,
+    ProcessStreamingVolumeFramesEvent
   };
   /// Structure passed as calldata pointer in the RequestEvent invoked event.
   struct InvokeRequest{
@@ -237,6 +250,8 @@ protected:
   ~vtkMRMLApplicationLogic() override;
 
   void SetMRMLSceneInternal(vtkMRMLScene *newScene) override;
+  void OnMRMLSceneNodeAdded(vtkMRMLNode* node) override;
+  void OnMRMLSceneNodeRemoved(vtkMRMLNode* node) override;
 
   void SetSelectionNode(vtkMRMLSelectionNode* );
   void SetInteractionNode(vtkMRMLInteractionNode* );
@@ -36,6 +36,7 @@
 #include <vtkImageReslice.h>
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
+#include <vtkLookupTable.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
@@ -598,6 +599,12 @@ vtkImageData* vtkMRMLSliceLayerLogic::GetImageData()
     {
     return nullptr;
     }
+  if (this->LabelOutline->GetLookupTable() &&
+      this->GetLabelOutlineLookupTable(this->VolumeDisplayNode))
+    {
+    // the label outline is already mapped to colors
+    return this->LabelOutline->GetOutput();
+    }
   return this->GetVolumeDisplayNode()->GetOutputImageData();
 }
 
@@ -608,6 +615,12 @@ vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetImageDataConnection()
     {
     return nullptr;
     }
+  if (this->LabelOutline->GetLookupTable() &&
+      this->GetLabelOutlineLookupTable(this->VolumeDisplayNode))
+    {
+    // the label outline is already mapped to colors
+    return this->LabelOutline->GetOutputPort();
+    }
   return this->GetVolumeDisplayNode()->GetOutputImageDataConnection();
 }
 
@@ -618,6 +631,11 @@ vtkImageData* vtkMRMLSliceLayerLogic::GetImageDataUVW()
     {
     return nullptr;
     }
+  if (this->LabelOutlineUVW->GetLookupTable() &&
+      this->GetLabelOutlineLookupTable(this->VolumeDisplayNodeUVW))
+    {
+    return this->LabelOutlineUVW->GetOutput();
+    }
   return this->GetVolumeDisplayNodeUVW()->GetOutputImageData();
 }
 
@@ -628,9 +646,33 @@ vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetImageDataConnectionUVW()
     {
     return nullptr;
     }
+  if (this->LabelOutlineUVW->GetLookupTable() &&
+      this->GetLabelOutlineLookupTable(this->VolumeDisplayNodeUVW))
+    {
+    return this->LabelOutlineUVW->GetOutputPort();
+    }
   return this->GetVolumeDisplayNodeUVW()->GetOutputImageDataConnection();
 }
 
+//----------------------------------------------------------------------------
+vtkLookupTable* vtkMRMLSliceLayerLogic::GetLabelOutlineLookupTable(vtkMRMLVolumeDisplayNode* displayNode)
+{
+  vtkMRMLLabelMapVolumeDisplayNode* labelMapVolumeDisplayNode =
+    vtkMRMLLabelMapVolumeDisplayNode::SafeDownCast(displayNode);
+  if (!this->GetIsLabelLayer() || !labelMapVolumeDisplayNode ||
+      !this->SliceNode || !this->SliceNode->GetUseLabelOutline() ||
+      (this->VolumeNode && this->VolumeNode->IsA("vtkMRMLDiffusionTensorVolumeNode")))
+    {
+    return nullptr;
+    }
+  vtkLookupTable* lookupTable = vtkLookupTable::SafeDownCast(labelMapVolumeDisplayNode->GetLookupTable());
+  if (!lookupTable || lookupTable->GetNumberOfTableValues() == 0)
+    {
+    return nullptr;
+    }
+  return lookupTable;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
 {
@@ -760,20 +802,28 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
       this->LabelOutline->SetInputConnection( this->Reslice->GetOutputPort() );
       int outlineThickness = labelMapVolumeDisplayNode->GetSliceIntersectionThickness();
       this->LabelOutline->SetOutline(outlineThickness);
+      // map the outline to colors in the same pass, the display node then
+      // does not need to colorize an intermediate outline image
+      this->LabelOutline->SetLookupTable(this->GetLabelOutlineLookupTable(this->VolumeDisplayNode));
       // don't activate 3D UVW reslice pipeline if we use single 2D reslice pipeline
       if (this->SliceNode->GetSliceResolutionMode() != vtkMRMLSliceNode::SliceResolutionMatch2DView)
         {
         this->LabelOutlineUVW->SetInputConnection( this->ResliceUVW->GetOutputPort() );
+        this->LabelOutlineUVW->SetOutline(outlineThickness);
+        this->LabelOutlineUVW->SetLookupTable(this->GetLabelOutlineLookupTable(this->VolumeDisplayNodeUVW));
         }
       else
         {
         this->LabelOutlineUVW->SetInputConnection( nullptr );
+        this->LabelOutlineUVW->SetLookupTable(nullptr);
         }
       }
     else
       {
         this->LabelOutline->SetInputConnection(nullptr);
         this->LabelOutlineUVW->SetInputConnection(nullptr);
+        this->LabelOutline->SetLookupTable(nullptr);
+        this->LabelOutlineUVW->SetLookupTable(nullptr);
       }
     }
 
@@ -817,6 +867,11 @@ vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetSliceImageDataConnection()
       vtkMRMLLabelMapVolumeDisplayNode::SafeDownCast(this->VolumeDisplayNode)&&
       this->SliceNode && this->SliceNode->GetUseLabelOutline() )
     {
+    if (this->LabelOutline->GetLookupTable())
+      {
+      // the outline filter maps the labels to colors itself, see GetImageDataConnection()
+      return this->Reslice->GetOutputPort();
+      }
     return this->LabelOutline->GetOutputPort();
     }
   if (this->VolumeNode && this->VolumeNode->IsA("vtkMRMLDiffusionTensorVolumeNode") )
@@ -839,6 +894,10 @@ vtkAlgorithmOutput* vtkMRMLSliceLayerLogic::GetSliceImageDataConnectionUVW()
       vtkMRMLLabelMapVolumeDisplayNode::SafeDownCast(this->VolumeDisplayNodeUVW)&&
       this->SliceNode && this->SliceNode->GetUseLabelOutline() )
     {
+    if (this->LabelOutlineUVW->GetLookupTable())
+      {
+      return this->ResliceUVW->GetOutputPort();
+      }
     return this->LabelOutlineUVW->GetOutputPort();
     }
   if (this->VolumeNode && this->VolumeNode->IsA("vtkMRMLDiffusionTensorVolumeNode") )
@@ -55,6 +55,7 @@ class vtkGeneralTransform;
 //#include <cstdlib>
 
 class vtkImageLabelOutline;
+class vtkLookupTable;
 class vtkTransform;
 
 class VTK_MRML_LOGIC_EXPORT vtkMRMLSliceLayerLogic
@@ -153,6 +154,13 @@ protected:
   vtkAlgorithmOutput* GetSliceImageDataConnection();
   vtkAlgorithmOutput* GetSliceImageDataConnectionUVW();
 
+  ///
+  /// Lookup table used by the label outline filter to map the outline to
+  /// colors in the same pass as the outline detection. Returns nullptr if
+  /// the label outline is not displayed or if the colors come from a
+  /// procedural color node, in which case the display node maps the colors.
+  vtkLookupTable* GetLabelOutlineLookupTable(vtkMRMLVolumeDisplayNode* displayNode);
+
   // Copy VolumeDisplayNodeObserved into VolumeDisplayNode
   void UpdateVolumeDisplayNode();
 
@@ -14,6 +14,7 @@
 
 // MRMLLogic includes
 #include "vtkMRMLSliceLogic.h"
+#include "vtkImageLayerCompositor.h"
 #include "vtkMRMLSliceLayerLogic.h"
 
 // MRML includes
@@ -32,12 +33,8 @@
 #include <vtkAlgorithmOutput.h>
 #include <vtkCallbackCommand.h>
 #include <vtkCollection.h>
-#include <vtkImageAppendComponents.h>
-#include <vtkImageBlend.h>
 #include <vtkImageResample.h>
-#include <vtkImageCast.h>
 #include <vtkImageData.h>
-#include <vtkImageMathematics.h>
 #include <vtkImageReslice.h>
 #include <vtkImageThreshold.h>
 #include <vtkInformation.h>
@@ -81,46 +78,21 @@ struct BlendPipeline
   BlendPipeline()
   {
     /*
-    // AlphaBlending, ReverseAlphaBlending:
-    //
-    //   foreground \
-    //               > Blend
-    //   background /
-    //
-    // Add, Subtract:
+    // All the layers are composited in a single pass, each layer is read once:
     //
-    //   Casting is needed to avoid overflow during adding (or subtracting).
+    //   background \
+    //   foreground  > Blend
+    //   label      /
     //
-    //   AddSubMath adds/subtracts alpha channel, therefore we copy RGB and alpha
-    //   components and copy of the background's alpha channel to the output.
-    //   Splitting and appending channels is probably quite inefficient, but there does not
-    //   seem to be simpler pipeline to do this in VTK.
+    // AlphaBlending, ReverseAlphaBlending:
     //
-    //   foreground > AddSubForegroundCast \
-    //                                      > AddSubMath > AddSubOutputCast ...
-    //   background > AddSubBackroundCast  /
+    //   The first layer is the base, the others are alpha blended onto it.
     //
+    // Add, Subtract:
     //
-    //     ... AddSubOutputCast > AddSubExtractRGB \
-    //                                              > AddSubAppendRGBA > Blend
-    //             background > AddSubExtractAlpha /
+    //   The base is the sum (difference) of the background and foreground RGB,
+    //   with the background alpha. The label layer is alpha blended onto it.
     */
-
-    this->AddSubForegroundCast->SetOutputScalarTypeToShort();
-    this->AddSubBackgroundCast->SetOutputScalarTypeToShort();
-    this->AddSubMath->SetOperationToAdd();
-    this->AddSubMath->SetInputConnection(0, this->AddSubBackgroundCast->GetOutputPort());
-    this->AddSubMath->SetInputConnection(1, this->AddSubForegroundCast->GetOutputPort());
-    this->AddSubOutputCast->SetInputConnection(this->AddSubMath->GetOutputPort());
-
-    this->AddSubExtractRGB->SetInputConnection(this->AddSubOutputCast->GetOutputPort());
-    this->AddSubExtractRGB->SetComponents(0, 1, 2);
-    this->AddSubExtractAlpha->SetComponents(3);
-    this->AddSubAppendRGBA->AddInputConnection(this->AddSubExtractRGB->GetOutputPort());
-    this->AddSubAppendRGBA->AddInputConnection(this->AddSubExtractAlpha->GetOutputPort());
-
-    this->AddSubOutputCast->SetOutputScalarTypeToUnsignedChar();
-    this->AddSubOutputCast->ClampOverflowOn();
   }
 
   void AddLayers(std::deque<SliceLayerInfo>& layers, int sliceCompositing,
@@ -139,6 +111,7 @@ struct BlendPipeline
 
     if (sliceCompositing == vtkMRMLSliceCompositeNode::Alpha)
       {
+      this->Blend->SetCompositingToAlpha();
       if (backgroundImagePort)
         {
         layers.push_back(SliceLayerInfo(backgroundImagePort, 1.0));
@@ -150,6 +123,7 @@ struct BlendPipeline
       }
     else if (sliceCompositing == vtkMRMLSliceCompositeNode::ReverseAlpha)
       {
+      this->Blend->SetCompositingToAlpha();
       if (foregroundImagePort)
         {
         layers.push_back(SliceLayerInfo(foregroundImagePort, 1.0));
@@ -161,18 +135,24 @@ struct BlendPipeline
       }
     else
       {
-      this->AddSubForegroundCast->SetInputConnection(foregroundImagePort);
-      this->AddSubBackgroundCast->SetInputConnection(backgroundImagePort);
-      this->AddSubExtractAlpha->SetInputConnection(backgroundImagePort);
       if (sliceCompositing == vtkMRMLSliceCompositeNode::Add)
         {
-        this->AddSubMath->SetOperationToAdd();
+        this->Blend->SetCompositingToAdd();
         }
       else
         {
-        this->AddSubMath->SetOperationToSubtract();
+        this->Blend->SetCompositingToSubtract();
+        }
+      // The compositor adds (subtracts) the first two inputs, never let a
+      // missing layer make the label layer one of them.
+      if (backgroundImagePort)
+        {
+        layers.push_back(SliceLayerInfo(backgroundImagePort, 1.0));
+        }
+      if (foregroundImagePort)
+        {
+        layers.push_back(SliceLayerInfo(foregroundImagePort, 1.0));
         }
-      layers.push_back(SliceLayerInfo(this->AddSubAppendRGBA->GetOutputPort(), 1.0));
       }
 
     // always blending the label layer
@@ -182,14 +162,7 @@ struct BlendPipeline
       }
   }
 
-  vtkNew<vtkImageCast> AddSubForegroundCast;
-  vtkNew<vtkImageCast> AddSubBackgroundCast;
-  vtkNew<vtkImageMathematics> AddSubMath;
-  vtkNew<vtkImageExtractComponents> AddSubExtractRGB;
-  vtkNew<vtkImageExtractComponents> AddSubExtractAlpha;
-  vtkNew<vtkImageAppendComponents> AddSubAppendRGBA;
-  vtkNew<vtkImageCast> AddSubOutputCast;
-  vtkNew<vtkImageBlend> Blend;
+  vtkNew<vtkImageLayerCompositor> Blend;
 };
 
 //----------------------------------------------------------------------------
@@ -953,17 +926,28 @@ void vtkMRMLSliceLogic::UpdateImageData ()
 }
 
 //----------------------------------------------------------------------------
-bool vtkMRMLSliceLogic::UpdateBlendLayers(vtkImageBlend* blend, const std::deque<SliceLayerInfo> &layers)
+bool vtkMRMLSliceLogic::UpdateBlendLayers(vtkImageLayerCompositor* blend, const std::deque<SliceLayerInfo> &layers)
 {
   const int blendPort = 0;
   vtkMTimeType oldBlendMTime = blend->GetMTime();
 
+  // Only layers that have an image are connected to the blend filter,
+  // compare the inputs against those.
+  std::deque<SliceLayerInfo> connectedLayers;
+  for (std::deque<SliceLayerInfo>::const_iterator layerIt = layers.begin(); layerIt != layers.end(); ++layerIt)
+    {
+    if (layerIt->BlendInput)
+      {
+      connectedLayers.push_back(*layerIt);
+      }
+    }
+
   bool layersChanged = false;
-  int numberOfLayers = layers.size();
+  int numberOfLayers = connectedLayers.size();
   if (numberOfLayers == blend->GetNumberOfInputConnections(blendPort))
     {
     int layerIndex = 0;
-    for (std::deque<SliceLayerInfo>::const_iterator layerIt = layers.begin(); layerIt != layers.end(); ++layerIt, ++layerIndex)
+    for (std::deque<SliceLayerInfo>::const_iterator layerIt = connectedLayers.begin(); layerIt != connectedLayers.end(); ++layerIt, ++layerIndex)
       {
       if (layerIt->BlendInput != blend->GetInputConnection(blendPort, layerIndex))
         {
@@ -979,8 +963,7 @@ bool vtkMRMLSliceLogic::UpdateBlendLayers(vtkImageBlend* blend, const std::deque
   if (layersChanged)
     {
     blend->RemoveAllInputs();
-    int layerIndex = 0;
-    for (std::deque<SliceLayerInfo>::const_iterator layerIt = layers.begin(); layerIt != layers.end(); ++layerIt, ++layerIndex)
+    for (std::deque<SliceLayerInfo>::const_iterator layerIt = connectedLayers.begin(); layerIt != connectedLayers.end(); ++layerIt)
       {
       blend->AddInputConnection(layerIt->BlendInput);
       }
@@ -989,7 +972,7 @@ bool vtkMRMLSliceLogic::UpdateBlendLayers(vtkImageBlend* blend, const std::deque
   // Update opacities
     {
     int layerIndex = 0;
-    for (std::deque<SliceLayerInfo>::const_iterator layerIt = layers.begin(); layerIt != layers.end(); ++layerIt, ++layerIndex)
+    for (std::deque<SliceLayerInfo>::const_iterator layerIt = connectedLayers.begin(); layerIt != connectedLayers.end(); ++layerIt, ++layerIndex)
       {
       blend->SetOpacity(layerIndex, layerIt->Opacity);
       }
@@ -1095,6 +1078,9 @@ void vtkMRMLSliceLogic::UpdatePipeline()
     std::deque<SliceLayerInfo> layers;
     std::deque<SliceLayerInfo> layersUVW;
 
+    // AddLayers sets the compositing mode of the blend filters
+    vtkMTimeType oldBlendMTime = this->Pipeline->Blend->GetMTime();
+    vtkMTimeType oldBlendUVWMTime = this->PipelineUVW->Blend->GetMTime();
     this->Pipeline->AddLayers(layers, this->SliceCompositeNode->GetCompositing(),
       backgroundImagePort, foregroundImagePort, this->SliceCompositeNode->GetForegroundOpacity(),
       labelImagePort, this->SliceCompositeNode->GetLabelOpacity());
@@ -1102,6 +1088,11 @@ void vtkMRMLSliceLogic::UpdatePipeline()
       backgroundImagePortUVW, foregroundImagePortUVW, this->SliceCompositeNode->GetForegroundOpacity(),
       labelImagePortUVW, this->SliceCompositeNode->GetLabelOpacity());
 
+    if (this->Pipeline->Blend->GetMTime() > oldBlendMTime ||
+        this->PipelineUVW->Blend->GetMTime() > oldBlendUVWMTime)
+      {
+      modified = 1;
+      }
     if (this->UpdateBlendLayers(this->Pipeline->Blend.GetPointer(), layers))
       {
       modified = 1;
@@ -2419,13 +2410,13 @@ bool vtkMRMLSliceLogic::IsSliceModelDisplayNode(vtkMRMLDisplayNode *mrmlDisplayN
 }
 
 //----------------------------------------------------------------------------
-vtkImageBlend* vtkMRMLSliceLogic::GetBlend()
+vtkImageLayerCompositor* vtkMRMLSliceLogic::GetBlend()
 {
   return this->Pipeline->Blend.GetPointer();
 }
 
 //----------------------------------------------------------------------------
-vtkImageBlend* vtkMRMLSliceLogic::GetBlendUVW()
+vtkImageLayerCompositor* vtkMRMLSliceLogic::GetBlendUVW()
 {
   return this->PipelineUVW->Blend.GetPointer();
 }
@@ -33,7 +33,7 @@ class vtkMRMLVolumeNode;
 
 class vtkAlgorithmOutput;
 class vtkCollection;
-class vtkImageBlend;
+class vtkImageLayerCompositor;
 class vtkTransform;
 class vtkImageData;
 class vtkImageReslice;
@@ -157,8 +157,8 @@ public:
   ///
   /// The compositing filter
   /// TODO: this will eventually be generalized to a per-layer compositing function
-  vtkImageBlend* GetBlend();
-  vtkImageBlend* GetBlendUVW();
+  vtkImageLayerCompositor* GetBlend();
+  vtkImageLayerCompositor* GetBlendUVW();
 
   ///
   /// An image reslice instance to pull a single slice from the volume that
@@ -403,7 +403,7 @@ protected:
   /// It minimizes changes to the imaging pipeline (does not remove and
   /// re-add an input if it is not changed) because rebuilding of the pipeline
   /// is a relatively expensive operation.
-  bool UpdateBlendLayers(vtkImageBlend* blend, const std::deque<SliceLayerInfo> &layers);
+  bool UpdateBlendLayers(vtkImageLayerCompositor* blend, const std::deque<SliceLayerInfo> &layers);
 
   bool                        AddingSliceModelNodes;
   bool                        Initialized;
@@ -33,6 +33,7 @@
 
 // VTK includes
 #include <vtkNew.h>
+#include <vtkSmartPointer.h>
 
 // ----------------------------------------------------------------------------
 class qMRMLSceneModelTester: public QObject
@@ -43,6 +44,7 @@ private slots:
   void testDefaults();
   void testSetsAndGets();
   void testSetScene();
+  void testLazyUpdate();
   void testSetColumns();
   void testSetColumns_data();
   void testSetColumnsWithScene();
@@ -108,6 +110,46 @@ void qMRMLSceneModelTester::testSetScene()
   QCOMPARE(sceneModel.columnCount(sceneModel.mrmlSceneIndex()), 1);
 }
 
+// ----------------------------------------------------------------------------
+void qMRMLSceneModelTester::testLazyUpdate()
+{
+  qMRMLSceneModel sceneModel;
+  sceneModel.setListenNodeModifiedEvent(qMRMLSceneModel::AllNodes);
+  sceneModel.setLazyUpdate(true);
+  vtkNew<vtkMRMLScene> scene;
+  sceneModel.setMRMLScene(scene.GetPointer());
+
+  QList<vtkSmartPointer<vtkMRMLViewNode> > nodes;
+  for (int i = 0; i < 10; ++i)
+    {
+    vtkNew<vtkMRMLViewNode> node;
+    scene->AddNode(node.GetPointer());
+    nodes << node.GetPointer();
+    }
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 10);
+  QPersistentModelIndex firstNodeIndex = sceneModel.indexFromNode(nodes[0]);
+
+  // Changes are applied at the end of the batch processing
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  vtkNew<vtkMRMLViewNode> addedNode;
+  scene->AddNode(addedNode.GetPointer());
+  vtkNew<vtkMRMLViewNode> addedAndRemovedNode;
+  scene->AddNode(addedAndRemovedNode.GetPointer());
+  scene->RemoveNode(addedAndRemovedNode.GetPointer());
+  scene->RemoveNode(nodes[5]);
+  nodes[1]->SetName("Modified");
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 10);
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 10);
+  QVERIFY(sceneModel.indexFromNode(addedNode.GetPointer()).isValid());
+  QVERIFY(!sceneModel.indexFromNode(nodes[5]).isValid());
+  QCOMPARE(sceneModel.indexFromNode(nodes[1]).data().toString(), QString("Modified"));
+  // Unchanged nodes are not repopulated
+  QVERIFY(firstNodeIndex.isValid());
+  QCOMPARE(sceneModel.mrmlNodeFromIndex(firstNodeIndex), static_cast<vtkMRMLNode*>(nodes[0].GetPointer()));
+}
+
 // ----------------------------------------------------------------------------
 void qMRMLSceneModelTester::testSetColumns()
 {
@@ -29,6 +29,9 @@
 // Slicer includes
 #include "vtkSlicerConfigure.h"
 
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
 // qMRML includes
 #include "qMRMLTableModel.h"
 #include "qMRMLTableView.h"
@@ -85,6 +88,29 @@ int qMRMLTableViewTest1( int argc, char * argv [] )
   tableView->setMRMLTableNode(tableNode.GetPointer());
   vbox.addWidget(tableView);
 
+  // Cells are served from the table, the first row contains the column names
+  qMRMLTableModel* tableModel = tableView->tableModel();
+  CHECK_NOT_NULL(tableModel);
+  CHECK_INT(tableModel->rowCount(), numPoints + 1);
+  CHECK_INT(tableModel->columnCount(), 3);
+  CHECK_QVARIANT(tableModel->data(tableModel->index(0, 1)), QVariant(QString("Y Axis")));
+  CHECK_QVARIANT(tableModel->data(tableModel->index(1, 0)), QVariant(QString("-10")));
+
+  // Sorting only changes the displayed order
+  tableModel->sort(0, Qt::DescendingOrder);
+  CHECK_INT(tableModel->mrmlTableRowIndex(tableModel->index(1, 0)), numPoints - 1);
+  CHECK_QVARIANT(tableModel->data(tableModel->index(numPoints, 0)), QVariant(QString("-10")));
+  CHECK_BOOL(tableModel->setData(tableModel->index(numPoints, 1), QString("100")), true);
+  CHECK_INT(table->GetValue(0, 1).ToInt(), 100);
+  tableModel->sort(-1);
+  CHECK_INT(tableModel->mrmlTableRowIndex(tableModel->index(1, 0)), 0);
+
+  // Filtering
+  tableModel->setFilterText("100");
+  CHECK_INT(tableModel->rowCount(), 2);
+  tableModel->setFilterText(QString());
+  CHECK_INT(tableModel->rowCount(), numPoints + 1);
+
   qMRMLTableView* tableViewTransposed = new qMRMLTableView();
   tableViewTransposed->setParent(&parentWidget);
   tableViewTransposed->setTransposed(true);
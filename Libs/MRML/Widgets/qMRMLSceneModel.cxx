@@ -61,6 +61,7 @@ qMRMLSceneModelPrivate::qMRMLSceneModelPrivate(qMRMLSceneModel& object)
 
   this->MRMLScene = nullptr;
   this->DraggedItem = nullptr;
+  this->PendingFullUpdate = false;
 
   qRegisterMetaType<QStandardItem* >("QStandardItem*");
 }
@@ -698,6 +699,7 @@ void qMRMLSceneModel::updateScene()
                  this, SLOT(onMRMLNodeIDChanged(vtkObject*,void*)));
 
   d->RowCache.clear();
+  d->clearPendingChanges();
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -827,6 +829,90 @@ QStandardItem* qMRMLSceneModelPrivate::insertNode(vtkMRMLNode* node, int nodeInd
   return nodeItem;
 }
 
+//------------------------------------------------------------------------------
+bool qMRMLSceneModelPrivate::isUpdateDeferred()const
+{
+  return this->MRMLScene &&
+    (this->MRMLScene->IsImporting() || (this->LazyUpdate && this->MRMLScene->IsBatchProcessing()));
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::clearPendingChanges()
+{
+  this->PendingAddedNodes.clear();
+  this->PendingRemovedNodeIDs.clear();
+  this->PendingModifiedNodeIDs.clear();
+  this->PendingFullUpdate = false;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::applyPendingChanges()
+{
+  Q_Q(qMRMLSceneModel);
+  if (!this->MRMLScene || !q->mrmlSceneItem())
+    {
+    q->updateScene();
+    return;
+    }
+  int numberOfChanges = this->PendingAddedNodes.count()
+    + this->PendingRemovedNodeIDs.count() + this->PendingModifiedNodeIDs.count();
+  if (numberOfChanges == 0 && !this->PendingFullUpdate)
+    {
+    return;
+    }
+  // Each change requires a lookup in the model, repopulating the model
+  // is faster if most of the scene has changed.
+  if (this->PendingFullUpdate || numberOfChanges > this->MRMLScene->GetNumberOfNodes() / 2)
+    {
+    q->updateScene();
+    return;
+    }
+
+  // Removed nodes
+  foreach(const QString& nodeID, this->PendingRemovedNodeIDs)
+    {
+    QModelIndexList nodeIndexes = this->indexes(nodeID);
+    if (nodeIndexes.isEmpty())
+      {
+      continue;
+      }
+    QStandardItem* item = q->itemFromIndex(nodeIndexes[0]);
+    if (item->rowCount() > 0)
+      {
+      // Children of the removed node would have to be reparented
+      q->updateScene();
+      return;
+      }
+    q->removeRow(nodeIndexes[0].row(), nodeIndexes[0].parent());
+    }
+
+  // Added nodes
+  QSet<vtkMRMLNode*> addedNodes;
+  this->MisplacedNodes.clear();
+  foreach(vtkMRMLNode* node, this->PendingAddedNodes)
+    {
+    q->insertNode(node);
+    addedNodes.insert(node);
+    }
+  QList<vtkMRMLNode*> misplacedNodes = this->MisplacedNodes;
+  foreach(vtkMRMLNode* misplacedNode, misplacedNodes)
+    {
+    q->onMRMLNodeModified(misplacedNode);
+    }
+
+  // Modified nodes, added nodes are already up-to-date
+  foreach(const QString& nodeID, this->PendingModifiedNodeIDs)
+    {
+    vtkMRMLNode* node = this->MRMLScene->GetNodeByID(nodeID.toLatin1().constData());
+    if (node && !addedNodes.contains(node) && !this->indexes(nodeID).isEmpty())
+      {
+      q->updateNodeItems(node, nodeID);
+      }
+    }
+
+  this->clearPendingChanges();
+}
+
 //------------------------------------------------------------------------------
 QStandardItem* qMRMLSceneModel::insertNode(vtkMRMLNode* node, QStandardItem* parent, int row)
 {
@@ -1190,10 +1276,12 @@ void qMRMLSceneModel::onMRMLSceneNodeAdded(vtkMRMLScene* scene, vtkMRMLNode* nod
   Q_ASSERT(scene == d->MRMLScene);
   Q_ASSERT(vtkMRMLNode::SafeDownCast(node));
 
-  if (d->MRMLScene->IsImporting() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->isUpdateDeferred())
     {
     // Node IDs and references are not valid until the import is completed, therefore do not attempt
     // to add a node during importing (see https://issues.slicer.org/view.php?id=4080).
+    // The node is inserted when the import (or the batch processing in lazy mode) is completed.
+    d->PendingAddedNodes << node;
     return;
     }
   this->insertNode(node);
@@ -1207,8 +1295,22 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
   Q_UNUSED(scene);
   Q_ASSERT(scene == d->MRMLScene);
 
-  if (d->MRMLScene->IsClosing() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->PendingAddedNodes.removeAll(node))
     {
+    // The node has been added and removed while the update was deferred,
+    // it has no item in the model.
+    qvtkDisconnect(node, vtkCommand::NoEvent, this, nullptr);
+    return;
+    }
+  if (d->MRMLScene->IsClosing())
+    {
+    return;
+    }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    qvtkDisconnect(node, vtkCommand::NoEvent, this, nullptr);
+    d->PendingRemovedNodeIDs << QString(node->GetID());
+    d->PendingModifiedNodeIDs.remove(QString(node->GetID()));
     return;
     }
 
@@ -1359,8 +1461,18 @@ void qMRMLSceneModel::updateNodeItems(vtkMRMLNode* node, const QString& nodeUID)
 {
   Q_D(qMRMLSceneModel);
 
-  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsImporting() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsClosing())
+    {
+    return;
+    }
+  if (d->isUpdateDeferred())
     {
+    if (node && nodeUID != QString(node->GetID()))
+      {
+      // The items are found by node ID, which has changed.
+      d->PendingFullUpdate = true;
+      }
+    d->PendingModifiedNodeIDs.insert(nodeUID);
     return;
     }
 
@@ -1481,9 +1593,14 @@ void qMRMLSceneModel::onMRMLSceneImported(vtkMRMLScene* scene)
 {
   Q_D(qMRMLSceneModel);
   Q_UNUSED(scene);
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    // Changes are applied at the end of the batch processing
+    return;
+    }
   // Node IDs and references are not valid until the import is completed,
   // therefore we must update the model now (see https://issues.slicer.org/view.php?id=4080).
-  this->updateScene();
+  d->applyPendingChanges();
   //this->endResetModel();
 }
 
@@ -1519,7 +1636,7 @@ void qMRMLSceneModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
   Q_UNUSED(scene);
   if (d->LazyUpdate)
     {
-    this->updateScene();
+    d->applyPendingChanges();
     emit sceneUpdated();
     }
 }
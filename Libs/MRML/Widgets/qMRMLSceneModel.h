@@ -69,9 +69,10 @@ class QMRML_WIDGETS_EXPORT qMRMLSceneModel : public QStandardItemModel
   Q_PROPERTY (NodeTypes listenNodeModifiedEvent READ listenNodeModifiedEvent WRITE setListenNodeModifiedEvent)
 
   /// Control whether the model actively listens to the scene.
-  /// If LazyUpdate is true, the model ignores added node events when the
-  /// scene is importing/restoring, but synchronize with the scene once its
-  /// imported/restored.
+  /// If LazyUpdate is true, the model records added, removed and modified
+  /// nodes while the scene is batch processing (importing, restoring...) and
+  /// applies them once the batch processing is over.
+  /// Nodes added during scene import are always applied at the end of the import.
   Q_PROPERTY (bool lazyUpdate READ lazyUpdate WRITE setLazyUpdate)
 
   /// Control in which column vtkMRMLNode names are displayed (Qt::DisplayRole).
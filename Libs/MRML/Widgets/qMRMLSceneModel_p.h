@@ -36,6 +36,7 @@
 class QStandardItemModel;
 #include <QFlags>
 #include <QMap>
+#include <QSet>
 
 // qMRML includes
 #include "qMRMLSceneModel.h"
@@ -77,6 +78,15 @@ public:
   /// qMRMLSceneModel::nodeIndex(vtkMRMLNode*).
   QStandardItem* insertNode(vtkMRMLNode* node, int index);
 
+  /// Returns true if scene changes are recorded instead of being applied
+  /// on the model immediately.
+  bool isUpdateDeferred()const;
+  /// Apply the nodes added, removed and modified since the update was deferred.
+  /// Falls back to a full update of the scene if the changes cannot be applied
+  /// individually or if most of the scene has changed.
+  void applyPendingChanges();
+  void clearPendingChanges();
+
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   qMRMLSceneModel::NodeTypes ListenNodeModifiedEvent;
   bool LazyUpdate;
@@ -101,6 +111,12 @@ public:
   // likely to be unreachable when browsing the model
   QList<QList<QStandardItem*> > Orphans;
 
+  // Scene changes recorded while the update is deferred
+  QList<vtkMRMLNode*> PendingAddedNodes;
+  QStringList PendingRemovedNodeIDs;
+  QSet<QString> PendingModifiedNodeIDs;
+  bool PendingFullUpdate;
+
   // Map from MRML node to row.
   // It just stores the result of the latest lookup by indexFromNode,
   // not guaranteed to contain up-to-date information, should be just used
@@ -22,6 +22,7 @@
 
 // Qt includes
 #include <QApplication>
+#include <QFont>
 #include <QPalette>
 
 // qMRML includes
@@ -34,10 +35,14 @@
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
 #include <vtkTable.h>
 #include <vtkBitArray.h>
 
-static int UserRoleValueType = Qt::UserRole + 1;
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 //------------------------------------------------------------------------------
 // qMRMLTableModelPrivate
@@ -58,9 +63,44 @@ public:
   // Generate tooltip text
   QString columnTooltipText(int tableCol);
 
+  // Text displayed in a table cell
+  static QString cellText(vtkTable* table, vtkIdType tableRow, vtkIdType tableCol);
+
+  // Returns the displayed table rows (filtered and sorted) in rowOrder.
+  // Returns false if all the table rows are displayed in their original order.
+  bool computeRowOrder(vtkTable* table, std::vector<vtkIdType>& rowOrder);
+
+  // Update row order while keeping persistent indices (selection, current item)
+  void updateRowOrder();
+
+  // Table row index of a model row (column if transposed), -1 for the column name row
+  vtkIdType tableRowIndex(int modelIndex)const;
+
+  // Table and model index along the table rows axis
+  QModelIndex modelIndex(int modelIndexAlongTableRows, int modelIndexAlongTableColumns)const;
+
+  vtkTable* table()const;
+
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   vtkSmartPointer<vtkMRMLTableNode>   MRMLTableNode;
   bool Transposed;
+
+  // Structure of the table at the last update, the model content is served
+  // based on this until the next update.
+  vtkIdType NumberOfTableColumns;
+  vtkIdType NumberOfTableRows;
+  // offset: modelIndex = mrmlIndex - offset
+  vtkIdType TableColOffset;
+  vtkIdType TableRowOffset;
+  QStringList ColumnTooltips;
+
+  // Sorting and filtering. If RowOrderActive is false then table rows are
+  // displayed in their original order and RowOrder is empty.
+  QString FilterText;
+  vtkIdType SortTableColumn;
+  Qt::SortOrder SortOrder;
+  bool RowOrderActive;
+  std::vector<vtkIdType> RowOrder;
 };
 
 //------------------------------------------------------------------------------
@@ -69,6 +109,13 @@ qMRMLTableModelPrivate::qMRMLTableModelPrivate(qMRMLTableModel& object)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
   this->Transposed = false;
+  this->NumberOfTableColumns = 0;
+  this->NumberOfTableRows = 0;
+  this->TableColOffset = 0;
+  this->TableRowOffset = 0;
+  this->SortTableColumn = -1;
+  this->SortOrder = Qt::AscendingOrder;
+  this->RowOrderActive = false;
 }
 
 //------------------------------------------------------------------------------
@@ -86,8 +133,6 @@ void qMRMLTableModelPrivate::init()
   Q_Q(qMRMLTableModel);
   this->CallBack->SetClientData(q);
   this->CallBack->SetCallback(qMRMLTableModel::onMRMLNodeEvent);
-  q->setColumnCount(0);
-  QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
 }
 
 //------------------------------------------------------------------------------
@@ -141,11 +186,204 @@ QString qMRMLTableModelPrivate::columnTooltipText(int tableCol)
   return textLines.join("<p>");
 }
 
+//------------------------------------------------------------------------------
+QString qMRMLTableModelPrivate::cellText(vtkTable* table, vtkIdType tableRow, vtkIdType tableCol)
+{
+  vtkVariant variant = table->GetValue(tableRow, tableCol);
+  int dataType = table->GetColumn(tableCol)->GetDataType();
+  if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+    {
+    // vtkVariant converts char type to string as a single letter, therefore we need to use
+    // custom converter
+    return QString::number(variant.ToInt());
+    }
+  return QString(variant.ToString());
+}
+
+//------------------------------------------------------------------------------
+vtkTable* qMRMLTableModelPrivate::table()const
+{
+  return (this->MRMLTableNode ? this->MRMLTableNode->GetTable() : nullptr);
+}
+
+//------------------------------------------------------------------------------
+vtkIdType qMRMLTableModelPrivate::tableRowIndex(int modelIndex)const
+{
+  vtkIdType displayedRowIndex = modelIndex + this->TableRowOffset;
+  if (displayedRowIndex < 0)
+    {
+    // column name row
+    return -1;
+    }
+  if (!this->RowOrderActive)
+    {
+    return displayedRowIndex;
+    }
+  if (displayedRowIndex >= static_cast<vtkIdType>(this->RowOrder.size()))
+    {
+    return -1;
+    }
+  return this->RowOrder[displayedRowIndex];
+}
+
+//------------------------------------------------------------------------------
+QModelIndex qMRMLTableModelPrivate::modelIndex(int modelIndexAlongTableRows, int modelIndexAlongTableColumns)const
+{
+  Q_Q(const qMRMLTableModel);
+  if (this->Transposed)
+    {
+    return q->index(modelIndexAlongTableColumns, modelIndexAlongTableRows);
+    }
+  else
+    {
+    return q->index(modelIndexAlongTableRows, modelIndexAlongTableColumns);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModelPrivate::computeRowOrder(vtkTable* table, std::vector<vtkIdType>& rowOrder)
+{
+  rowOrder.clear();
+  if (table == nullptr)
+    {
+    return false;
+    }
+  vtkIdType numberOfTableRows = table->GetNumberOfRows();
+  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
+  if (this->SortTableColumn >= numberOfTableColumns)
+    {
+    // sort column has been removed
+    this->SortTableColumn = -1;
+    }
+  if (this->SortTableColumn < 0 && this->FilterText.isEmpty())
+    {
+    return false;
+    }
+
+  // Filter
+  rowOrder.reserve(numberOfTableRows);
+  for (vtkIdType tableRow = 0; tableRow < numberOfTableRows; ++tableRow)
+    {
+    bool accepted = this->FilterText.isEmpty();
+    for (vtkIdType tableCol = 0; tableCol < numberOfTableColumns && !accepted; ++tableCol)
+      {
+      if (vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
+        {
+        // checkboxes have no text
+        continue;
+        }
+      accepted = this->cellText(table, tableRow, tableCol).contains(this->FilterText, Qt::CaseInsensitive);
+      }
+    if (accepted)
+      {
+      rowOrder.push_back(tableRow);
+      }
+    }
+
+  // Sort
+  if (this->SortTableColumn >= 0)
+    {
+    bool ascending = (this->SortOrder == Qt::AscendingOrder);
+    vtkAbstractArray* column = table->GetColumn(this->SortTableColumn);
+    vtkDataArray* dataColumn = vtkDataArray::SafeDownCast(column);
+    if (dataColumn && dataColumn->GetNumberOfComponents() == 1)
+      {
+      // Compare numbers, NaN is placed after all other values
+      std::vector<double> keys(numberOfTableRows);
+      for (vtkIdType tableRow : rowOrder)
+        {
+        keys[tableRow] = dataColumn->GetComponent(tableRow, 0);
+        }
+      std::stable_sort(rowOrder.begin(), rowOrder.end(), [&keys, ascending](vtkIdType a, vtkIdType b)
+        {
+        double first = ascending ? keys[a] : keys[b];
+        double second = ascending ? keys[b] : keys[a];
+        return !std::isnan(first) && (std::isnan(second) || first < second);
+        });
+      }
+    else
+      {
+      vtkStringArray* stringColumn = vtkStringArray::SafeDownCast(column);
+      std::vector<std::string> keys(numberOfTableRows);
+      for (vtkIdType tableRow : rowOrder)
+        {
+        keys[tableRow] = stringColumn ? stringColumn->GetValue(tableRow) : column->GetVariantValue(tableRow).ToString();
+        }
+      std::stable_sort(rowOrder.begin(), rowOrder.end(), [&keys, ascending](vtkIdType a, vtkIdType b)
+        {
+        return ascending ? keys[a] < keys[b] : keys[b] < keys[a];
+        });
+      }
+    }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModelPrivate::updateRowOrder()
+{
+  Q_Q(qMRMLTableModel);
+  std::vector<vtkIdType> rowOrder;
+  bool rowOrderActive = this->computeRowOrder(this->table(), rowOrder);
+
+  emit q->layoutAboutToBeChanged();
+
+  // Remember the table rows of persistent indices
+  QModelIndexList persistentIndices = q->persistentIndexList();
+  std::vector<vtkIdType> persistentTableRows;
+  foreach(const QModelIndex& index, persistentIndices)
+    {
+    persistentTableRows.push_back(this->tableRowIndex(this->Transposed ? index.column() : index.row()));
+    }
+
+  this->RowOrderActive = rowOrderActive;
+  this->RowOrder.swap(rowOrder);
+
+  // Find persistent indices in the new order
+  if (!persistentIndices.empty())
+    {
+    std::vector<int> displayedRowIndices(this->NumberOfTableRows, -1);
+    vtkIdType numberOfDisplayedRows = this->RowOrderActive ? static_cast<vtkIdType>(this->RowOrder.size()) : this->NumberOfTableRows;
+    for (vtkIdType displayedRowIndex = 0; displayedRowIndex < numberOfDisplayedRows; ++displayedRowIndex)
+      {
+      vtkIdType tableRow = this->RowOrderActive ? this->RowOrder[displayedRowIndex] : displayedRowIndex;
+      if (tableRow >= 0 && tableRow < this->NumberOfTableRows)
+        {
+        displayedRowIndices[tableRow] = static_cast<int>(displayedRowIndex);
+        }
+      }
+    QModelIndexList newPersistentIndices;
+    for (int i = 0; i < persistentIndices.size(); ++i)
+      {
+      const QModelIndex& index = persistentIndices[i];
+      int modelIndexAlongTableColumns = this->Transposed ? index.row() : index.column();
+      vtkIdType tableRow = persistentTableRows[i];
+      if (tableRow < 0)
+        {
+        // column name row is not moved
+        newPersistentIndices << index;
+        }
+      else if (tableRow < this->NumberOfTableRows && displayedRowIndices[tableRow] >= 0)
+        {
+        int modelIndexAlongTableRows = static_cast<int>(displayedRowIndices[tableRow] - this->TableRowOffset);
+        newPersistentIndices << this->modelIndex(modelIndexAlongTableRows, modelIndexAlongTableColumns);
+        }
+      else
+        {
+        // filtered out
+        newPersistentIndices << QModelIndex();
+        }
+      }
+    q->changePersistentIndexList(persistentIndices, newPersistentIndices);
+    }
+
+  emit q->layoutChanged();
+}
+
 //------------------------------------------------------------------------------
 // qMRMLTableModel
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(QObject *_parent)
-  : QStandardItemModel(_parent)
+  : QAbstractTableModel(_parent)
   , d_ptr(new qMRMLTableModelPrivate(*this))
 {
   Q_D(qMRMLTableModel);
@@ -154,7 +392,7 @@ qMRMLTableModel::qMRMLTableModel(QObject *_parent)
 
 //------------------------------------------------------------------------------
 qMRMLTableModel::qMRMLTableModel(qMRMLTableModelPrivate* pimpl, QObject *parentObject)
-  : QStandardItemModel(parentObject)
+  : QAbstractTableModel(parentObject)
   , d_ptr(pimpl)
 {
   Q_D(qMRMLTableModel);
@@ -178,6 +416,7 @@ void qMRMLTableModel::setMRMLTableNode(vtkMRMLTableNode* tableNode)
     tableNode->AddObserver(vtkCommand::ModifiedEvent, d->CallBack);
     }
   d->MRMLTableNode = tableNode;
+  d->SortTableColumn = -1;
   this->updateModelFromMRML();
 }
 
@@ -193,343 +432,411 @@ void qMRMLTableModel::updateModelFromMRML()
 {
   Q_D(qMRMLTableModel);
 
-  QObject::disconnect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)));
-
   vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
   vtkTable* table = (tableNode ? tableNode->GetTable() : nullptr);
-  if (table==nullptr || table->GetNumberOfColumns()==0)
-    {
-    beginResetModel();
-    // setRowCount and setColumnCount to 0 would not be enough, it's necessary to remove the header as well
-    setRowCount(0);
-    setColumnCount(0);
-    endResetModel();
-    QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+
+  vtkIdType numberOfTableColumns = 0;
+  vtkIdType numberOfTableRows = 0;
+  vtkIdType tableColOffset = 0;
+  vtkIdType tableRowOffset = 0;
+  if (table != nullptr && table->GetNumberOfColumns() > 0)
+    {
+    numberOfTableColumns = table->GetNumberOfColumns();
+    numberOfTableRows = table->GetNumberOfRows();
+    tableColOffset = tableNode->GetUseFirstColumnAsRowHeader() ? 1 : 0;
+    tableRowOffset = tableNode->GetUseColumnNameAsColumnHeader() ? 0 : -1;
+    }
+
+  std::vector<vtkIdType> rowOrder;
+  bool rowOrderActive = d->computeRowOrder(numberOfTableColumns > 0 ? table : nullptr, rowOrder);
+
+  QStringList columnTooltips;
+  for (vtkIdType tableCol = 0; tableCol < numberOfTableColumns; ++tableCol)
+    {
+    columnTooltips << d->columnTooltipText(tableCol);
+    }
+
+  if (numberOfTableColumns == d->NumberOfTableColumns
+    && numberOfTableRows == d->NumberOfTableRows
+    && tableColOffset == d->TableColOffset
+    && tableRowOffset == d->TableRowOffset
+    && rowOrderActive == d->RowOrderActive
+    && rowOrder == d->RowOrder)
+    {
+    // Only cell values have changed, there is no need to reset the view
+    d->ColumnTooltips = columnTooltips;
+    if (this->rowCount() > 0 && this->columnCount() > 0)
+      {
+      emit dataChanged(this->index(0, 0), this->index(this->rowCount() - 1, this->columnCount() - 1));
+      emit headerDataChanged(Qt::Horizontal, 0, this->columnCount() - 1);
+      emit headerDataChanged(Qt::Vertical, 0, this->rowCount() - 1);
+      }
     return;
     }
 
-  bool tableLocked = tableNode->GetLocked();
-  bool labelInFirstTableColumn = tableNode->GetUseFirstColumnAsRowHeader();
-  bool useColumnNameAsColumnHeader = tableNode->GetUseColumnNameAsColumnHeader();
+  this->beginResetModel();
+  d->NumberOfTableColumns = numberOfTableColumns;
+  d->NumberOfTableRows = numberOfTableRows;
+  d->TableColOffset = tableColOffset;
+  d->TableRowOffset = tableRowOffset;
+  d->ColumnTooltips = columnTooltips;
+  d->RowOrderActive = rowOrderActive;
+  d->RowOrder.swap(rowOrder);
+  this->endResetModel();
+}
 
-  vtkIdType numberOfTableColumns = table->GetNumberOfColumns();
-  vtkIdType numberOfTableRows = table->GetNumberOfRows();
-  // offset: modelIndex = mrmlIndex - offset
-  vtkIdType tableColOffset = labelInFirstTableColumn ? 1 : 0;
-  vtkIdType tableRowOffset = useColumnNameAsColumnHeader ? 0 : -1;
+//------------------------------------------------------------------------------
+int qMRMLTableModel::rowCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  if (parent.isValid() || d->NumberOfTableColumns == 0)
+    {
+    return 0;
+    }
+  vtkIdType numberOfDisplayedRows = d->RowOrderActive ? static_cast<vtkIdType>(d->RowOrder.size()) : d->NumberOfTableRows;
   if (d->Transposed)
     {
-    setRowCount(static_cast<int>(numberOfTableColumns-tableColOffset));
-    setColumnCount(static_cast<int>(numberOfTableRows-tableRowOffset));
+    return static_cast<int>(d->NumberOfTableColumns - d->TableColOffset);
     }
   else
     {
-    setRowCount(static_cast<int>(numberOfTableRows-tableRowOffset));
-    setColumnCount(static_cast<int>(numberOfTableColumns-tableColOffset));
+    return static_cast<int>(numberOfDisplayedRows - d->TableRowOffset);
     }
+}
 
-  // Setup items for each table column
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+//------------------------------------------------------------------------------
+int qMRMLTableModel::columnCount(const QModelIndex& parent)const
+{
+  Q_D(const qMRMLTableModel);
+  if (parent.isValid() || d->NumberOfTableColumns == 0)
+    {
+    return 0;
+    }
+  vtkIdType numberOfDisplayedRows = d->RowOrderActive ? static_cast<vtkIdType>(d->RowOrder.size()) : d->NumberOfTableRows;
+  if (d->Transposed)
+    {
+    return static_cast<int>(numberOfDisplayedRows - d->TableRowOffset);
+    }
+  else
     {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
+    return static_cast<int>(d->NumberOfTableColumns - d->TableColOffset);
+    }
+}
 
-    QString columnName(table->GetColumnName(tableCol));
-    vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::data(const QModelIndex& index, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == nullptr)
+    {
+    return QVariant();
+    }
+  int tableRow = this->mrmlTableRowIndex(index);
+  int tableCol = this->mrmlTableColumnIndex(index);
+  // The table may have been changed since the last update (e.g., within StartModify/EndModify)
+  if (tableCol < 0 || tableCol >= table->GetNumberOfColumns() || tableRow >= table->GetNumberOfRows())
+    {
+    return QVariant();
+    }
 
-    if (useColumnNameAsColumnHeader)
-      {
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, columnName);
-      }
-    else
-      {
-      QString autoColumnHeader = d->columnNameFromIndex(modelCol);
-      setHeaderData(modelCol, d->Transposed ? Qt::Vertical : Qt::Horizontal, autoColumnHeader);
-      }
+  if (role == Qt::ToolTipRole)
+    {
+    return (tableCol < d->ColumnTooltips.size() ? d->ColumnTooltips[tableCol] : QString());
+    }
 
-    // Go through the rows of the current column
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+  if (tableRow < 0)
+    {
+    // Column names are displayed in bold in the first row
+    switch (role)
       {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-
-      // Use existing item if already created
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-        {
-        existingItem = this->item(modelCol, modelRow);
-        }
-      else
-        {
-        existingItem = this->item(modelRow, modelCol);
-        }
-      QStandardItem* item = existingItem;
-      // Create item if did not exist
-      if (item==nullptr)
+      case Qt::DisplayRole:
+      case Qt::EditRole:
+      case SortRole:
+        return QString(table->GetColumnName(tableCol));
+      case Qt::FontRole:
         {
-        item = new QStandardItem();
-        }
-
-      // Items in first row use bold font, the others regular
-      if (tableRow>=0)
-        {
-        vtkVariant variant = table->GetValue(tableRow, tableCol);
-        if (tableRow==0)
-          {
-          // the first row might have been bold earlier, make sure
-          // it is reset to non-bold
-          QFont font;
-          item->setData(font, Qt::FontRole);
-          }
-
-        int dataType = columnArray->GetDataType();
-
-        // Set item property for known types.
-        // Special types are defined to be displayed differently, handled by qMRMLTableItemDelegate.
-        // NOTE: The data type itself can be enough, but in future types it will be necessary to define display role
-        //       as well, e.g. double array can be both color and position.
-        if (vtkBitArray::SafeDownCast(columnArray))
-          {
-          // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes
-          item->setData(VTK_BIT, UserRoleValueType);
-          item->setCheckable(true);
-          item->setCheckState(variant.ToInt() ? Qt::Checked : Qt::Unchecked);
-          item->setText(QString()); // No text is supposed to be in the cell
-          }
-        // Default display as text
-        else
-          {
-          if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
-            {
-            // vtkVariant converts char type to string as a single letter, therefore we need to use
-            // custom converter
-            item->setText(QString::number(variant.ToInt()));
-            }
-          else
-            {
-            item->setText(QString(variant.ToString()));
-            }
-          item->setData(QVariant(), UserRoleValueType);
-          item->setCheckable(false);
-          item->setData(QVariant(), Qt::CheckStateRole);
-          }
-        }
-      else
-        {
-        item->setText(columnName);
         QFont font;
         font.setBold(true);
-        item->setData(font, Qt::FontRole);
-        }
-
-      // Handle locked flag
-      if (item->isCheckable())
-        {
-        if (tableLocked)
-          {
-          // Item is view-only, clear the ItemIsUserCheckable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsUserCheckable));
-          }
-        else
-          {
-          // Item is editable, set the ItemIsUserCheckable flag
-          item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-          }
-        // Item text is empty and should not be editable
-        item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-        }
-      else
-        {
-        if (tableLocked)
-          {
-          // Item is view-only, clear the ItemIsEditable flag
-          item->setFlags(item->flags() & (~Qt::ItemIsEditable));
-          }
-        else
-          {
-          // Item is editable, set the ItemIsEditable flag
-          item->setFlags(item->flags() | Qt::ItemIsEditable);
-          }
+        return font;
         }
+      default:
+        return QVariant();
+      }
+    }
 
-      // Add item if just created
-      if (item!=existingItem)
-        {
-        if (d->Transposed)
-          {
-          setItem(modelCol, modelRow, item);
-          }
-        else
-          {
-          setItem(modelRow, modelCol, item);
-          }
-        }
+  vtkAbstractArray* columnArray = table->GetColumn(tableCol);
+  if (vtkBitArray::SafeDownCast(columnArray))
+    {
+    // Boolean values indicated by a column of vtkBitArray type are displayed as checkboxes,
+    // no text is supposed to be in the cell
+    int value = table->GetValue(tableRow, tableCol).ToInt();
+    switch (role)
+      {
+      case Qt::CheckStateRole:
+        return value ? Qt::Checked : Qt::Unchecked;
+      case SortRole:
+        return value;
+      default:
+        return QVariant();
       }
     }
-  // Set row label: either simply 1, 2, ... or values of the first column
-  for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+
+  switch (role)
     {
-    int modelRow = static_cast<int>(tableRow - tableRowOffset);
-    QString rowLabel;
-    if(labelInFirstTableColumn)
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+      return d->cellText(table, tableRow, tableCol);
+    case SortRole:
       {
-      if (tableRow>=0)
+      vtkDataArray* dataArray = vtkDataArray::SafeDownCast(columnArray);
+      if (dataArray && dataArray->GetNumberOfComponents() == 1)
         {
-        rowLabel = QString(table->GetValue(tableRow, 0).ToString());
-        }
-      else
-        {
-        rowLabel = QString(table->GetColumnName(0));;
+        return dataArray->GetComponent(tableRow, 0);
         }
+      return d->cellText(table, tableRow, tableCol);
       }
-    else
+    default:
+      return QVariant();
+    }
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+  if (!index.isValid())
+    {
+    return false;
+    }
+  if (!this->updateMRMLFromModel(index, value, role))
+    {
+    return false;
+    }
+  emit dataChanged(index, index);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+Qt::ItemFlags qMRMLTableModel::flags(const QModelIndex& index)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (!index.isValid() || table == nullptr)
+    {
+    return Qt::NoItemFlags;
+    }
+  Qt::ItemFlags itemFlags = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+  bool tableLocked = d->MRMLTableNode->GetLocked();
+  int tableRow = this->mrmlTableRowIndex(index);
+  int tableCol = this->mrmlTableColumnIndex(index);
+  if (tableRow >= 0 && tableCol >= 0 && tableCol < table->GetNumberOfColumns()
+    && vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
+    {
+    // Item text is empty and should not be editable
+    if (!tableLocked)
       {
-      rowLabel = QString::number(modelRow+1);
+      itemFlags |= Qt::ItemIsUserCheckable;
       }
-    setHeaderData(modelRow, d->Transposed ? Qt::Horizontal : Qt::Vertical, rowLabel);
     }
+  else if (!tableLocked)
+    {
+    itemFlags |= Qt::ItemIsEditable;
+    }
+  return itemFlags;
+}
 
-  // Add tooltip text
-  for (vtkIdType tableCol = tableColOffset; tableCol < numberOfTableColumns; ++tableCol)
+//------------------------------------------------------------------------------
+QVariant qMRMLTableModel::headerData(int section, Qt::Orientation orientation, int role)const
+{
+  Q_D(const qMRMLTableModel);
+  vtkTable* table = d->table();
+  if (role != Qt::DisplayRole || table == nullptr || section < 0)
     {
-    int modelCol = static_cast<int>(tableCol - tableColOffset);
-    QString tooltipText = d->columnTooltipText(tableCol);
-    for (vtkIdType tableRow = tableRowOffset; tableRow < numberOfTableRows; ++tableRow)
+    return QVariant();
+    }
+  bool tableColumnHeader = (orientation == (d->Transposed ? Qt::Vertical : Qt::Horizontal));
+  if (tableColumnHeader)
+    {
+    vtkIdType tableCol = section + d->TableColOffset;
+    if (!d->MRMLTableNode->GetUseColumnNameAsColumnHeader())
       {
-      int modelRow = static_cast<int>(tableRow - tableRowOffset);
-      QStandardItem* existingItem = nullptr;
-      if (d->Transposed)
-        {
-        existingItem = this->item(modelCol, modelRow);
-        }
-      else
-        {
-        existingItem = this->item(modelRow, modelCol);
-        }
-      existingItem->setToolTip(tooltipText);
+      return d->columnNameFromIndex(section);
+      }
+    if (tableCol >= table->GetNumberOfColumns())
+      {
+      return QVariant();
       }
+    return QString(table->GetColumnName(tableCol));
     }
 
-  QObject::connect(this, SIGNAL(itemChanged(QStandardItem*)), this, SLOT(onItemChanged(QStandardItem*)), Qt::UniqueConnection);
+  // Row label: either simply 1, 2, ... or values of the first column
+  vtkIdType tableRow = d->tableRowIndex(section);
+  if (!d->MRMLTableNode->GetUseFirstColumnAsRowHeader())
+    {
+    return QString::number(tableRow - d->TableRowOffset + 1);
+    }
+  if (table->GetNumberOfColumns() == 0 || tableRow >= table->GetNumberOfRows())
+    {
+    return QVariant();
+    }
+  if (tableRow < 0)
+    {
+    return QString(table->GetColumnName(0));
+    }
+  return QString(table->GetValue(tableRow, 0).ToString());
 }
 
 //------------------------------------------------------------------------------
-void qMRMLTableModel::updateMRMLFromModel(QStandardItem* item)
+void qMRMLTableModel::sort(int column, Qt::SortOrder order)
 {
   Q_D(qMRMLTableModel);
-  if (item == nullptr)
+  if (d->Transposed && column >= 0)
     {
-    qCritical("qMRMLTableModel::updateMRMLFromModel failed: item is invalid");
+    qWarning("qMRMLTableModel::sort failed: sorting is not supported in transposed mode");
     return;
     }
+  d->SortTableColumn = (column >= 0 ? column + d->TableColOffset : -1);
+  d->SortOrder = order;
+  d->updateRowOrder();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLTableModel::setFilterText(const QString& filterText)
+{
+  Q_D(qMRMLTableModel);
+  if (d->FilterText == filterText)
+    {
+    return;
+    }
+  d->FilterText = filterText;
+  // Filtering changes the number of rows, the model has to be reset
+  this->beginResetModel();
+  d->RowOrderActive = d->computeRowOrder(d->NumberOfTableColumns > 0 ? d->table() : nullptr, d->RowOrder);
+  this->endResetModel();
+}
+
+//------------------------------------------------------------------------------
+QString qMRMLTableModel::filterText()const
+{
+  Q_D(const qMRMLTableModel);
+  return d->FilterText;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLTableModel::updateMRMLFromModel(const QModelIndex& index, const QVariant& value, int role)
+{
+  Q_D(qMRMLTableModel);
+  if (!index.isValid())
+    {
+    qCritical("qMRMLTableModel::updateMRMLFromModel failed: index is invalid");
+    return false;
+    }
   vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(d->MRMLTableNode);
   if (tableNode==nullptr)
     {
     qCritical("qMRMLTableModel::updateMRMLFromModel failed: tableNode is invalid");
-    return;
+    return false;
     }
   vtkTable* table = tableNode->GetTable();
   if (table==nullptr)
     {
     qCritical("qMRMLTableModel::updateMRMLFromModel failed: table is invalid");
-    return;
+    return false;
     }
 
-  int tableRow = mrmlTableRowIndex(item->index());
-  int tableCol = mrmlTableColumnIndex(item->index());
+  int tableRow = mrmlTableRowIndex(index);
+  int tableCol = mrmlTableColumnIndex(index);
+  if (tableCol < 0 || tableCol >= table->GetNumberOfColumns() || tableRow >= table->GetNumberOfRows())
+    {
+    qCritical("qMRMLTableModel::updateMRMLFromModel failed: index is out of range");
+    return false;
+    }
 
-  if (tableRow>=0)
+  if (tableRow < 0)
     {
-    // Get item value according to type
-    int widgetType = item->data(UserRoleValueType).toInt();
-    if (widgetType == VTK_BIT)
+    // Column header changed
+    if (role != Qt::EditRole)
       {
-      // Cell bool value changed
-      int checked = item->checkState();
-      int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
-      if (checked == valueBefore)
+      return false;
+      }
+    vtkAbstractArray* column = table->GetColumn(tableCol);
+    if (column)
+      {
+      QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
+      if (valueBefore!=value.toString())
         {
-        // The value is not changed, this means that the table cannot store this value - revert the value in the table
-        this->blockSignals(true);
-        item->setCheckState(valueBefore ? Qt::Checked : Qt::Unchecked);
-        item->setText(QString()); // No text is supposed to be in the cell
-        this->blockSignals(false);
+        tableNode->RenameColumn(tableCol, value.toString().toUtf8().constData());
         }
-      else
+      }
+    return true;
+    }
+
+  if (vtkBitArray::SafeDownCast(table->GetColumn(tableCol)))
+    {
+    // Cell bool value changed
+    if (role != Qt::CheckStateRole)
+      {
+      return false;
+      }
+    int checked = (value.toInt() == Qt::Checked ? 1 : 0);
+    int valueBefore = table->GetValue(tableRow, tableCol).ToInt();
+    if (checked == valueBefore)
+      {
+      return false;
+      }
+    table->SetValue(tableRow, tableCol, vtkVariant(checked));
+    table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
+    table->Modified();
+    return true;
+    }
+
+  if (role != Qt::EditRole)
+    {
+    return false;
+    }
+
+  // Cell text value changed
+  int dataType = table->GetColumn(tableCol)->GetDataType();
+  if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+    {
+    // vtkVariant would convert char to a letter, so we need custom conversion here
+    bool valid = false;
+    int newValue = value.toString().toInt(&valid);
+    if (dataType == VTK_UNSIGNED_CHAR)
+      {
+      if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
         {
-        table->SetValue(tableRow, tableCol, vtkVariant(checked));
-        table->GetColumn(tableCol)->Modified(); // Enable observation of checked state changed separately
-        table->Modified();
+        valid = false;
         }
       }
     else
       {
-      // Cell text value changed
-      int dataType = table->GetColumn(tableCol)->GetDataType();
-      if (dataType == VTK_CHAR || dataType == VTK_UNSIGNED_CHAR || dataType == VTK_SIGNED_CHAR)
+      if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
         {
-        // vtkVariant would convert char to a letter, so we need custom conversion here
-        bool valid = false;
-        int newValue = item->text().toInt(&valid);
-        if (dataType == VTK_UNSIGNED_CHAR)
-          {
-          if (newValue < VTK_UNSIGNED_CHAR_MIN || newValue > VTK_UNSIGNED_CHAR_MAX)
-            {
-            valid = false;
-            }
-          }
-        else
-          {
-          if (newValue < VTK_SIGNED_CHAR_MIN || newValue > VTK_SIGNED_CHAR_MAX)
-            {
-            valid = false;
-            }
-          }
-        if (valid)
-          {
-          table->SetValue(tableRow, tableCol, newValue);
-          table->Modified();
-          }
-        else
-          {
-          vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-          this->blockSignals(true);
-          item->setText(QString::number(valueInTableBefore.ToInt()));
-          this->blockSignals(false);
-          }
-        }
-      else
-        {
-        vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol); // restore this value if new value is invalid
-        vtkVariant itemText(item->text().toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
-        table->SetValue(tableRow, tableCol, itemText);
-        vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
-        if (valueInTableBefore == valueInTableAfter)
-          {
-          // The value is not changed then it means it is invalid,
-          // restore previous value
-          this->blockSignals(true);
-          item->setText(QString(valueInTableBefore.ToString()));
-          this->blockSignals(false);
-          }
-        else
-          {
-          table->Modified();
-          }
+        valid = false;
         }
       }
-    }
-  else
-    {
-    // Column header changed
-    vtkAbstractArray* column = table->GetColumn(tableCol);
-    if (column)
+    if (!valid)
       {
-      QString valueBefore = QString::fromStdString(column->GetName()?column->GetName():"");
-      if (valueBefore!=item->text())
-        {
-        tableNode->RenameColumn(tableCol, item->text().toUtf8().constData());
-        }
+      return false;
       }
+    table->SetValue(tableRow, tableCol, newValue);
+    table->Modified();
+    return true;
+    }
+
+  vtkVariant valueInTableBefore = table->GetValue(tableRow, tableCol);
+  vtkVariant itemText(value.toString().toUtf8().constData()); // the vtkVariant constructor makes a copy of the input buffer, so using constData is safe
+  table->SetValue(tableRow, tableCol, itemText);
+  vtkVariant valueInTableAfter = table->GetValue(tableRow, tableCol);
+  if (valueInTableBefore == valueInTableAfter)
+    {
+    // The value is not changed then it means it is invalid,
+    // the view keeps displaying the previous value
+    return false;
     }
+  table->Modified();
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -560,16 +867,6 @@ void qMRMLTableModel::onMRMLTableNodeModified(vtkObject* node)
   this->updateModelFromMRML();
 }
 
-//------------------------------------------------------------------------------
-void qMRMLTableModel::onItemChanged(QStandardItem * item)
-{
-  if (item == this->invisibleRootItem())
-    {
-    return;
-    }
-  this->updateMRMLFromModel(item);
-}
-
 //------------------------------------------------------------------------------
 void qMRMLTableModel::setTransposed(bool transposed)
 {
@@ -578,8 +875,15 @@ void qMRMLTableModel::setTransposed(bool transposed)
     {
     return;
     }
+  this->beginResetModel();
   d->Transposed = transposed;
-  this->updateModelFromMRML();
+  if (transposed)
+    {
+    // rows cannot be sorted by the values of a row
+    d->SortTableColumn = -1;
+    d->RowOrderActive = d->computeRowOrder(d->NumberOfTableColumns > 0 ? d->table() : nullptr, d->RowOrder);
+    }
+  this->endResetModel();
 }
 
 //------------------------------------------------------------------------------
@@ -598,14 +902,7 @@ int qMRMLTableModel::mrmlTableRowIndex(QModelIndex modelIndex)const
     qWarning("qMRMLTableModel::mrmlTableRowIndex failed: invalid table node");
     return -1;
     }
-  if (d->Transposed)
-    {
-    return d->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? modelIndex.column() : modelIndex.column()-1;
-    }
-  else
-    {
-    return d->MRMLTableNode->GetUseColumnNameAsColumnHeader() ? modelIndex.row() : modelIndex.row()-1;
-    }
+  return static_cast<int>(d->tableRowIndex(d->Transposed ? modelIndex.column() : modelIndex.row()));
 }
 
 //------------------------------------------------------------------------------
@@ -24,7 +24,7 @@
 #define __qMRMLTableModel_h
 
 // Qt includes
-#include <QStandardItemModel>
+#include <QAbstractTableModel>
 
 // CTK includes
 #include <ctkPimpl.h>
@@ -40,15 +40,21 @@ class QAction;
 class qMRMLTableModelPrivate;
 
 //------------------------------------------------------------------------------
-class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QStandardItemModel
+/// \brief Item model of a vtkMRMLTableNode.
+///
+/// Cell values are served directly from the columns of the vtkTable, no item
+/// is stored in the model, so that tables with millions of rows can be displayed.
+/// Sorting and filtering only reorder a list of table row indices.
+class QMRML_WIDGETS_EXPORT qMRMLTableModel : public QAbstractTableModel
 {
   Q_OBJECT
   QVTK_OBJECT
   Q_ENUMS(ItemDataRole)
   Q_PROPERTY(bool transposed READ transposed WRITE setTransposed)
+  Q_PROPERTY(QString filterText READ filterText WRITE setFilterText)
 
 public:
-  typedef QAbstractItemModel Superclass;
+  typedef QAbstractTableModel Superclass;
   qMRMLTableModel(QObject *parent=nullptr);
   ~qMRMLTableModel() override;
 
@@ -64,12 +70,31 @@ public:
   void setTransposed(bool transposed);
   bool transposed()const;
 
-  /// Return the VTK table cell associated to the node index.
-  void updateMRMLFromModel(QStandardItem* item);
+  /// Set/Get filter text.
+  /// If not empty then only those table rows are shown that contain the text
+  /// (case insensitive) in any of their cells.
+  void setFilterText(const QString& filterText);
+  QString filterText()const;
+
+  /// Update the VTK table cell associated to the model index.
+  /// Returns true if the value was accepted by the table.
+  bool updateMRMLFromModel(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole);
 
   /// Update the entire table from the MRML node
   void updateModelFromMRML();
 
+  int rowCount(const QModelIndex& parent = QModelIndex())const override;
+  int columnCount(const QModelIndex& parent = QModelIndex())const override;
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole)const override;
+  bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+  Qt::ItemFlags flags(const QModelIndex& index)const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole)const override;
+
+  /// Sort the table rows by the values of a model column.
+  /// Only the displayed row order is changed, the MRML table is not modified.
+  /// Column -1 restores the original order. Not supported in transposed mode.
+  void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
   /// Get MRML table index from model index
   int mrmlTableRowIndex(QModelIndex modelIndex)const;
 
@@ -84,7 +109,6 @@ public:
 
 protected slots:
   void onMRMLTableNodeModified(vtkObject* node);
-  void onItemChanged(QStandardItem * item);
 
 protected:
 
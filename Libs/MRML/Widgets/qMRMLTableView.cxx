@@ -74,6 +74,28 @@
     return false;                       \
     }
 
+namespace
+{
+//------------------------------------------------------------------------------
+// Sorting is delegated to the table model, which only reorders table row indices,
+// instead of the proxy model comparing item data of all the rows.
+class qMRMLTableSortFilterProxyModel : public QSortFilterProxyModel
+{
+public:
+  qMRMLTableSortFilterProxyModel(QObject* parent)
+    : QSortFilterProxyModel(parent)
+  {
+  }
+  void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override
+  {
+    if (this->sourceModel())
+      {
+      this->sourceModel()->sort(column, order);
+      }
+  }
+};
+}
+
 //------------------------------------------------------------------------------
 qMRMLTableViewPrivate::qMRMLTableViewPrivate(qMRMLTableView& object)
   : q_ptr(&object)
@@ -94,7 +116,7 @@ void qMRMLTableViewPrivate::init()
   Q_Q(qMRMLTableView);
 
   qMRMLTableModel* tableModel = new qMRMLTableModel(q);
-  QSortFilterProxyModel* sortFilterModel = new QSortFilterProxyModel(q);
+  QSortFilterProxyModel* sortFilterModel = new qMRMLTableSortFilterProxyModel(q);
   sortFilterModel->setSourceModel(tableModel);
   q->setModel(sortFilterModel);
 
@@ -333,14 +355,15 @@ void qMRMLTableView::copySelection()
         {
         textToCopy.append('\t');
         }
-      QStandardItem *item = mrmlModel->item(rowIndex, columnIndex);
-      if (item->isCheckable())
+      QModelIndex index = mrmlModel->index(rowIndex, columnIndex);
+      QVariant checkState = mrmlModel->data(index, Qt::CheckStateRole);
+      if (checkState.isValid())
         {
-        textToCopy.append(item->checkState() == Qt::Checked ? "1" : "0");
+        textToCopy.append(checkState.toInt() == Qt::Checked ? "1" : "0");
         }
       else
         {
-        textToCopy.append(item->text());
+        textToCopy.append(mrmlModel->data(index).toString());
         }
       }
     }
@@ -426,17 +449,17 @@ void qMRMLTableView::pasteSelection()
           }
         mrmlModel->updateModelFromMRML();
         }
-      // Set values in items
-      QStandardItem* item = mrmlModel->item(rowIndex,columnIndex);
-      if (item != nullptr)
+      // Set values in the table
+      QModelIndex index = mrmlModel->index(rowIndex, columnIndex);
+      if (index.isValid())
         {
-        if (item->isCheckable())
+        if (mrmlModel->data(index, Qt::CheckStateRole).isValid())
           {
-          item->setCheckState(cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked);
+          mrmlModel->setData(index, cell.toInt() == 0 ? Qt::Unchecked : Qt::Checked, Qt::CheckStateRole);
           }
         else
           {
-          item->setText(cell);
+          mrmlModel->setData(index, cell);
           }
         }
       else
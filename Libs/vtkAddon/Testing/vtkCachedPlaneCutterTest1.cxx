@@ -0,0 +1,132 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkAddonTestingMacros.h"
+#include "vtkCachedPlaneCutter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCutter.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPlane.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+namespace
+{
+//----------------------------------------------------------------------------
+double GetTotalLineLength(vtkPolyData* polyData)
+{
+  double totalLength = 0.0;
+  vtkCellArray* lines = polyData->GetLines();
+  vtkNew<vtkIdList> pointIds;
+  for (lines->InitTraversal(); lines->GetNextCell(pointIds.GetPointer());)
+    {
+    for (vtkIdType i = 0; i + 1 < pointIds->GetNumberOfIds(); ++i)
+      {
+      double point0[3] = { 0.0, 0.0, 0.0 };
+      double point1[3] = { 0.0, 0.0, 0.0 };
+      polyData->GetPoint(pointIds->GetId(i), point0);
+      polyData->GetPoint(pointIds->GetId(i + 1), point1);
+      totalLength += sqrt(vtkMath::Distance2BetweenPoints(point0, point1));
+      }
+    }
+  return totalLength;
+}
+
+//----------------------------------------------------------------------------
+int CompareWithCutter(vtkCachedPlaneCutter* cachedCutter, vtkCutter* cutter, double offset)
+{
+  vtkPlane* plane = cachedCutter->GetPlane();
+  double normal[3] = { 0.0, 0.0, 0.0 };
+  plane->GetNormal(normal);
+  vtkMath::Normalize(normal);
+  plane->SetOrigin(offset * normal[0], offset * normal[1], offset * normal[2]);
+  cachedCutter->Update();
+  cutter->Update();
+  vtkPolyData* cachedOutput = cachedCutter->GetOutput();
+  vtkPolyData* output = cutter->GetOutput();
+  CHECK_INT(cachedOutput->GetNumberOfLines(), output->GetNumberOfLines());
+  CHECK_DOUBLE_TOLERANCE(GetTotalLineLength(cachedOutput), GetTotalLineLength(output), 1e-6);
+  // Points on shared edges are merged
+  CHECK_BOOL(cachedOutput->GetNumberOfPoints() <= cachedOutput->GetNumberOfLines() + 1, true);
+  return EXIT_SUCCESS;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedPlaneCutterTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(10.0);
+  sphere->SetThetaResolution(48);
+  sphere->SetPhiResolution(32);
+
+  vtkNew<vtkPlane> plane;
+  plane->SetNormal(0.2, -0.4, 0.9);
+
+  vtkNew<vtkCachedPlaneCutter> cachedCutter;
+  cachedCutter->SetInputConnection(sphere->GetOutputPort());
+  cachedCutter->SetPlane(plane.GetPointer());
+  CHECK_POINTER(cachedCutter->GetPlane(), plane.GetPointer());
+
+  vtkNew<vtkCutter> cutter;
+  cutter->SetInputConnection(sphere->GetOutputPort());
+  cutter->SetCutFunction(plane.GetPointer());
+
+  // Same intersection as vtkCutter, the index is built only once
+  const double offsets[] = { 0.123, -3.3, 7.77, -9.5, 0.0123 };
+  for (double offset : offsets)
+    {
+    CHECK_EXIT_SUCCESS(CompareWithCutter(cachedCutter.GetPointer(), cutter.GetPointer(), offset));
+    }
+  CHECK_INT(cachedCutter->GetNumberOfIndexBuilds(), 1);
+  CHECK_INT(cachedCutter->GetNumberOfCacheHits(), 0);
+
+  // Plane outside of the model
+  plane->SetOrigin(0.0, 0.0, 0.0);
+  plane->Push(20.0);
+  cachedCutter->Update();
+  CHECK_INT(cachedCutter->GetOutput()->GetNumberOfLines(), 0);
+
+  // Going back to a recent offset is served from the cache
+  CHECK_EXIT_SUCCESS(CompareWithCutter(cachedCutter.GetPointer(), cutter.GetPointer(), -3.3));
+  CHECK_INT(cachedCutter->GetNumberOfCacheHits(), 1);
+  CHECK_INT(cachedCutter->GetNumberOfIndexBuilds(), 1);
+
+  // Changing the orientation rebuilds the index
+  plane->SetNormal(0.0, 0.0, 1.0);
+  CHECK_EXIT_SUCCESS(CompareWithCutter(cachedCutter.GetPointer(), cutter.GetPointer(), 2.5));
+  CHECK_INT(cachedCutter->GetNumberOfIndexBuilds(), 2);
+
+  // Changing the input rebuilds the index
+  sphere->SetThetaResolution(17);
+  CHECK_EXIT_SUCCESS(CompareWithCutter(cachedCutter.GetPointer(), cutter.GetPointer(), 2.5));
+  CHECK_INT(cachedCutter->GetNumberOfIndexBuilds(), 3);
+  CHECK_INT(cachedCutter->GetNumberOfCacheHits(), 1);
+
+  // Without caching every offset is cut again
+  cachedCutter->SetCacheSize(0);
+  CHECK_EXIT_SUCCESS(CompareWithCutter(cachedCutter.GetPointer(), cutter.GetPointer(), -1.0));
+  CHECK_EXIT_SUCCESS(CompareWithCutter(cachedCutter.GetPointer(), cutter.GetPointer(), 1.0));
+  CHECK_EXIT_SUCCESS(CompareWithCutter(cachedCutter.GetPointer(), cutter.GetPointer(), -1.0));
+  CHECK_INT(cachedCutter->GetNumberOfCacheHits(), 1);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkAddonTestingMacros.h"
+#include "vtkDeltaZLibVolumeCodec.h"
+#include "vtkStreamingVolumeCodecFactory.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <cstring>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> CreateFrameImage(int scalarType, int numberOfComponents, int width, int height, int frameIndex)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(width, height, 2);
+  image->AllocateScalars(scalarType, numberOfComponents);
+  for (int z = 0; z < 2; ++z)
+    {
+    for (int y = 0; y < height; ++y)
+      {
+      for (int x = 0; x < width; ++x)
+        {
+        for (int c = 0; c < numberOfComponents; ++c)
+          {
+          // Smooth gradient that moves between frames, with negative values and a few outliers
+          double value = (x + frameIndex) * 3 - y * 2 + z + c * 10 - 40;
+          if ((x * 7 + y * 13 + frameIndex) % 37 == 0)
+            {
+            value += 100.5;
+            }
+          image->SetScalarComponentFromDouble(x, y, z, c, value);
+          }
+        }
+      }
+    }
+  return image;
+}
+
+//----------------------------------------------------------------------------
+bool ImagesEqual(vtkImageData* image1, vtkImageData* image2)
+{
+  if (image1->GetScalarType() != image2->GetScalarType()
+    || image1->GetNumberOfScalarComponents() != image2->GetNumberOfScalarComponents())
+    {
+    return false;
+    }
+  int* dimensions1 = image1->GetDimensions();
+  int* dimensions2 = image2->GetDimensions();
+  for (int i = 0; i < 3; ++i)
+    {
+    if (dimensions1[i] != dimensions2[i])
+      {
+      return false;
+      }
+    }
+  size_t numberOfBytes = static_cast<size_t>(dimensions1[0]) * dimensions1[1] * dimensions1[2]
+    * image1->GetNumberOfScalarComponents() * image1->GetScalarSize();
+  return memcmp(image1->GetScalarPointer(), image2->GetScalarPointer(), numberOfBytes) == 0;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> AllocateImageForFrame(vtkStreamingVolumeFrame* frame)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(frame->GetDimensions());
+  image->AllocateScalars(frame->GetVTKScalarType(), frame->GetNumberOfComponents());
+  return image;
+}
+}
+
+//----------------------------------------------------------------------------
+int vtkDeltaZLibVolumeCodecTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // The codec is available from the factory
+  vtkSmartPointer<vtkStreamingVolumeCodec> factoryCodec = vtkSmartPointer<vtkStreamingVolumeCodec>::Take(
+    vtkStreamingVolumeCodecFactory::GetInstance()->CreateCodecByFourCC("DZLB"));
+  CHECK_NOT_NULL(factoryCodec.GetPointer());
+  CHECK_STD_STRING(factoryCodec->GetClassName(), "vtkDeltaZLibVolumeCodec");
+
+  vtkNew<vtkDeltaZLibVolumeCodec> encoder;
+  CHECK_BOOL(encoder->SetParameter("KeyFrameInterval", "3"), true);
+  CHECK_INT(encoder->GetKeyFrameInterval(), 3);
+  CHECK_BOOL(encoder->SetParametersFromPresetValue("ZLIB_9"), true);
+  CHECK_INT(encoder->GetCompressionLevel(), 9);
+  CHECK_BOOL(encoder->SetParametersFromPresetValue(encoder->GetDefaultParameterPresetValue()), true);
+  CHECK_INT(encoder->GetCompressionLevel(), 1);
+
+  // Encode a sequence of signed scalar frames: I P P I P
+  const int numberOfFrames = 5;
+  const int expectedFrameTypes[numberOfFrames] = { vtkStreamingVolumeFrame::IFrame, vtkStreamingVolumeFrame::PFrame,
+    vtkStreamingVolumeFrame::PFrame, vtkStreamingVolumeFrame::IFrame, vtkStreamingVolumeFrame::PFrame };
+  std::vector<vtkSmartPointer<vtkImageData> > images;
+  std::vector<vtkSmartPointer<vtkStreamingVolumeFrame> > frames;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    vtkSmartPointer<vtkImageData> image = CreateFrameImage(VTK_SHORT, 1, 64, 48, frameIndex);
+    vtkSmartPointer<vtkStreamingVolumeFrame> frame = vtkSmartPointer<vtkStreamingVolumeFrame>::New();
+    CHECK_BOOL(encoder->EncodeImageData(image, frame), true);
+    CHECK_INT(frame->GetFrameType(), expectedFrameTypes[frameIndex]);
+    CHECK_STD_STRING(frame->GetCodecFourCC(), "DZLB");
+    CHECK_INT(frame->GetVTKScalarType(), VTK_SHORT);
+    // Smooth images must compress well
+    CHECK_BOOL(frame->GetFrameData()->GetNumberOfValues() < 64 * 48 * 2 * 2 / 4, true);
+    images.push_back(image);
+    frames.push_back(frame);
+    }
+  CHECK_POINTER(frames[2]->GetPreviousFrame(), frames[1].GetPointer());
+  CHECK_NULL(frames[3]->GetPreviousFrame());
+
+  // Decode in order, then seek backward and forward
+  vtkNew<vtkDeltaZLibVolumeCodec> decoder;
+  vtkSmartPointer<vtkImageData> decodedImage = AllocateImageForFrame(frames[0]);
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    CHECK_BOOL(decoder->DecodeFrame(frames[frameIndex], decodedImage), true);
+    CHECK_BOOL(ImagesEqual(decodedImage, images[frameIndex]), true);
+    }
+  CHECK_BOOL(decoder->DecodeFrame(frames[2], decodedImage), true);
+  CHECK_BOOL(ImagesEqual(decodedImage, images[2]), true);
+  CHECK_BOOL(decoder->DecodeFrame(frames[4], decodedImage), true);
+  CHECK_BOOL(ImagesEqual(decodedImage, images[4]), true);
+
+  // Floating point multi-component images are restored exactly,
+  // a change of image type starts a new key frame
+  vtkSmartPointer<vtkImageData> floatImage1 = CreateFrameImage(VTK_FLOAT, 3, 31, 17, 0);
+  vtkSmartPointer<vtkImageData> floatImage2 = CreateFrameImage(VTK_FLOAT, 3, 31, 17, 1);
+  vtkNew<vtkStreamingVolumeFrame> floatFrame1;
+  vtkNew<vtkStreamingVolumeFrame> floatFrame2;
+  CHECK_BOOL(encoder->EncodeImageData(floatImage1, floatFrame1.GetPointer()), true);
+  CHECK_INT(floatFrame1->GetFrameType(), vtkStreamingVolumeFrame::IFrame);
+  CHECK_BOOL(encoder->EncodeImageData(floatImage2, floatFrame2.GetPointer()), true);
+  CHECK_INT(floatFrame2->GetFrameType(), vtkStreamingVolumeFrame::PFrame);
+  vtkSmartPointer<vtkImageData> decodedFloatImage = AllocateImageForFrame(floatFrame2.GetPointer());
+  CHECK_BOOL(decoder->DecodeFrame(floatFrame2.GetPointer(), decodedFloatImage), true);
+  CHECK_BOOL(ImagesEqual(decodedFloatImage, floatImage2), true);
+
+  // Forced key frame
+  vtkNew<vtkStreamingVolumeFrame> floatFrame3;
+  CHECK_BOOL(encoder->EncodeImageData(floatImage1, floatFrame3.GetPointer(), true), true);
+  CHECK_INT(floatFrame3->GetFrameType(), vtkStreamingVolumeFrame::IFrame);
+  CHECK_BOOL(decoder->DecodeFrame(floatFrame3.GetPointer(), decodedFloatImage), true);
+  CHECK_BOOL(ImagesEqual(decodedFloatImage, floatImage1), true);
+
+  return EXIT_SUCCESS;
+}
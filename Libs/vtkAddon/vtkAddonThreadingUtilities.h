@@ -0,0 +1,123 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+/// vtkAddonThreadingUtilities
+///
+/// Helpers for processing independent work items (slices, slabs, labels, files...)
+/// on multiple threads using vtkMultiThreader.
+/// Header-only so that libraries that only have vtkAddon in their include path
+/// (vtkITK, vtkSegmentationCore) can use it.
+
+#ifndef vtkAddonThreadingUtilities_h
+#define vtkAddonThreadingUtilities_h
+
+// VTK includes
+#include <vtkMultiThreader.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+class vtkAddonThreadingUtilities
+{
+public:
+  /// Get the number of threads to use for a requested number of threads.
+  /// If requestedNumberOfThreads is not positive then the global default
+  /// number of threads of vtkMultiThreader is used.
+  static int GetNumberOfThreadsToUse(int requestedNumberOfThreads)
+    {
+    if (requestedNumberOfThreads > 0)
+      {
+      return requestedNumberOfThreads;
+      }
+    return std::max(1, vtkMultiThreader::GetGlobalDefaultNumberOfThreads());
+    }
+
+  /// Call function(item) for all the items in [0, numberOfItems), on up to
+  /// numberOfThreads threads (the calling thread included). Items are
+  /// processed in no particular order. The first exception thrown by
+  /// function is rethrown in the calling thread once all the threads are done,
+  /// remaining items are then skipped.
+  static void ParallelFor(int numberOfThreads, int numberOfItems,
+                          const std::function<void(int)>& function)
+    {
+    numberOfThreads = std::min(numberOfThreads, numberOfItems);
+    if (numberOfThreads <= 1)
+      {
+      for (int item = 0; item < numberOfItems; ++item)
+        {
+        function(item);
+        }
+      return;
+      }
+
+    ParallelForData data(numberOfItems, function);
+    vtkNew<vtkMultiThreader> threader;
+    threader->SetNumberOfThreads(numberOfThreads);
+    threader->SetSingleMethod(&vtkAddonThreadingUtilities::ParallelForThread, &data);
+    threader->SingleMethodExecute();
+    if (data.FirstException)
+      {
+      std::rethrow_exception(data.FirstException);
+      }
+    }
+
+protected:
+  struct ParallelForData
+    {
+    ParallelForData(int numberOfItems, const std::function<void(int)>& function)
+      : NextItem(0)
+      , NumberOfItems(numberOfItems)
+      , Function(function)
+      {
+      }
+    std::atomic<int> NextItem;
+    const int NumberOfItems;
+    const std::function<void(int)>& Function;
+    std::exception_ptr FirstException;
+    std::mutex ExceptionMutex;
+    };
+
+  static VTK_THREAD_RETURN_TYPE ParallelForThread(void* arg)
+    {
+    vtkMultiThreader::ThreadInfo* info = static_cast<vtkMultiThreader::ThreadInfo*>(arg);
+    ParallelForData* data = static_cast<ParallelForData*>(info->UserData);
+    for (int item = data->NextItem++; item < data->NumberOfItems; item = data->NextItem++)
+      {
+      try
+        {
+        data->Function(item);
+        }
+      catch (...)
+        {
+        // Exceptions must not leave the thread, store the first one and stop processing
+        std::lock_guard<std::mutex> lock(data->ExceptionMutex);
+        if (!data->FirstException)
+          {
+          data->FirstException = std::current_exception();
+          }
+        data->NextItem = data->NumberOfItems;
+        break;
+        }
+      }
+    return VTK_THREAD_RETURN_VALUE;
+    }
+};
+
+#endif
@@ -0,0 +1,502 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkCachedPlaneCutter.h"
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCutter.h>
+#include <vtkIdList.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPlane.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolygon.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <list>
+#include <map>
+#include <vector>
+
+vtkStandardNewMacro(vtkCachedPlaneCutter);
+vtkCxxSetObjectMacro(vtkCachedPlaneCutter, Plane, vtkPlane);
+
+//----------------------------------------------------------------------------
+class vtkCachedPlaneCutter::vtkInternal
+{
+public:
+  /// Forget the index and cached results if the input or the plane normal changed
+  void Update(vtkDataSet* input, const double normal[3]);
+  void Clear();
+
+  vtkPolyData* FindCachedCut(double offset);
+  void AddCachedCut(double offset, vtkPolyData* cut, int cacheSize);
+
+  /// Returns false if the input cannot be indexed
+  bool BuildIndex(vtkPolyData* input);
+  void Cut(vtkPolyData* input, double offset, vtkPolyData* output);
+
+  vtkWeakPointer<vtkDataSet> Input;
+  vtkMTimeType InputMTime = 0;
+  double Normal[3] = { 0.0, 0.0, 0.0 };
+  bool IndexBuilt = false;
+
+  struct CachedCut
+  {
+    double Offset;
+    vtkSmartPointer<vtkPolyData> Output;
+  };
+  /// Most recently used first
+  std::list<CachedCut> Cache;
+
+private:
+  int GetBin(double projection) const;
+  vtkIdType GetEdgePoint(vtkIdType pointId0, vtkIdType pointId1, double distance0, double distance1,
+    vtkPoints* inputPoints, vtkPointData* inputPointData, vtkPoints* outputPoints, vtkPointData* outputPointData);
+
+  /// Position of each point along the plane normal
+  std::vector<double> PointProjections;
+  /// Copy of the polygon connectivity, for random access to the cells
+  std::vector<vtkIdType> CellOffsets;
+  std::vector<vtkIdType> CellPointIds;
+  /// Range of each cell along the plane normal
+  std::vector<double> CellMinimum;
+  std::vector<double> CellMaximum;
+  /// Cells overlapping each bin of the range along the normal
+  double RangeMinimum = 0.0;
+  double RangeMaximum = 0.0;
+  double BinWidth = 1.0;
+  int NumberOfBins = 0;
+  std::vector<vtkIdType> BinOffsets;
+  std::vector<vtkIdType> BinCellIds;
+
+  /// Output points already created on input edges
+  std::map<std::pair<vtkIdType, vtkIdType>, vtkIdType> EdgePoints;
+  std::vector<vtkIdType> Crossings;
+};
+
+//----------------------------------------------------------------------------
+void vtkCachedPlaneCutter::vtkInternal::Update(vtkDataSet* input, const double normal[3])
+{
+  if (this->Input == input && input->GetMTime() == this->InputMTime
+    && this->Normal[0] == normal[0] && this->Normal[1] == normal[1] && this->Normal[2] == normal[2])
+    {
+    return;
+    }
+  this->Clear();
+  this->Input = input;
+  this->InputMTime = input->GetMTime();
+  this->Normal[0] = normal[0];
+  this->Normal[1] = normal[1];
+  this->Normal[2] = normal[2];
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedPlaneCutter::vtkInternal::Clear()
+{
+  this->Input = nullptr;
+  this->InputMTime = 0;
+  this->IndexBuilt = false;
+  this->Cache.clear();
+  this->PointProjections.clear();
+  this->CellOffsets.clear();
+  this->CellPointIds.clear();
+  this->CellMinimum.clear();
+  this->CellMaximum.clear();
+  this->BinOffsets.clear();
+  this->BinCellIds.clear();
+  this->NumberOfBins = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkPolyData* vtkCachedPlaneCutter::vtkInternal::FindCachedCut(double offset)
+{
+  const double tolerance = 1e-9 * std::max(1.0, std::abs(offset));
+  for (std::list<CachedCut>::iterator it = this->Cache.begin(); it != this->Cache.end(); ++it)
+    {
+    if (std::abs(it->Offset - offset) <= tolerance)
+      {
+      this->Cache.splice(this->Cache.begin(), this->Cache, it);
+      return this->Cache.front().Output;
+      }
+    }
+  return nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedPlaneCutter::vtkInternal::AddCachedCut(double offset, vtkPolyData* cut, int cacheSize)
+{
+  if (cacheSize <= 0)
+    {
+    return;
+    }
+  CachedCut cachedCut;
+  cachedCut.Offset = offset;
+  cachedCut.Output = cut;
+  this->Cache.push_front(cachedCut);
+  while (this->Cache.size() > static_cast<size_t>(cacheSize))
+    {
+    this->Cache.pop_back();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedPlaneCutter::vtkInternal::GetBin(double projection) const
+{
+  int bin = static_cast<int>((projection - this->RangeMinimum) / this->BinWidth);
+  return std::min(std::max(bin, 0), this->NumberOfBins - 1);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCachedPlaneCutter::vtkInternal::BuildIndex(vtkPolyData* input)
+{
+  vtkPoints* points = input->GetPoints();
+  vtkCellArray* polys = input->GetPolys();
+  vtkIdType numberOfCells = polys ? polys->GetNumberOfCells() : 0;
+  if (!points || numberOfCells == 0 || input->GetNumberOfCells() != numberOfCells)
+    {
+    // Only meshes made of polygons are indexed
+    return false;
+    }
+
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  this->PointProjections.resize(numberOfPoints);
+  double point[3] = { 0.0, 0.0, 0.0 };
+  for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+    {
+    points->GetPoint(pointId, point);
+    this->PointProjections[pointId] = vtkMath::Dot(point, this->Normal);
+    }
+
+  this->CellOffsets.resize(numberOfCells + 1);
+  this->CellPointIds.clear();
+  this->CellPointIds.reserve(3 * numberOfCells);
+  this->CellMinimum.resize(numberOfCells);
+  this->CellMaximum.resize(numberOfCells);
+  this->RangeMinimum = VTK_DOUBLE_MAX;
+  this->RangeMaximum = VTK_DOUBLE_MIN;
+  vtkNew<vtkIdList> cellPointIds;
+  polys->InitTraversal();
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+    {
+    polys->GetNextCell(cellPointIds.GetPointer());
+    vtkIdType npts = cellPointIds->GetNumberOfIds();
+    vtkIdType* pts = cellPointIds->GetPointer(0);
+    this->CellOffsets[cellId] = static_cast<vtkIdType>(this->CellPointIds.size());
+    double cellMinimum = VTK_DOUBLE_MAX;
+    double cellMaximum = VTK_DOUBLE_MIN;
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      this->CellPointIds.push_back(pts[i]);
+      double projection = this->PointProjections[pts[i]];
+      cellMinimum = std::min(cellMinimum, projection);
+      cellMaximum = std::max(cellMaximum, projection);
+      }
+    this->CellMinimum[cellId] = cellMinimum;
+    this->CellMaximum[cellId] = cellMaximum;
+    if (npts > 0)
+      {
+      this->RangeMinimum = std::min(this->RangeMinimum, cellMinimum);
+      this->RangeMaximum = std::max(this->RangeMaximum, cellMaximum);
+      }
+    }
+  this->CellOffsets[numberOfCells] = static_cast<vtkIdType>(this->CellPointIds.size());
+
+  // About sqrt(n) bins keeps both the number of bins a cell overlaps
+  // and the number of cells per bin small.
+  this->NumberOfBins = static_cast<int>(std::min(65536.0, std::ceil(2.0 * std::sqrt(static_cast<double>(numberOfCells)))));
+  this->BinWidth = (this->RangeMaximum - this->RangeMinimum) / this->NumberOfBins;
+  if (!(this->BinWidth > 0.0))
+    {
+    this->NumberOfBins = 1;
+    this->BinWidth = 1.0;
+    }
+
+  this->BinOffsets.assign(this->NumberOfBins + 1, 0);
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+    {
+    if (this->CellOffsets[cellId] == this->CellOffsets[cellId + 1])
+      {
+      continue;
+      }
+    int lastBin = this->GetBin(this->CellMaximum[cellId]);
+    for (int bin = this->GetBin(this->CellMinimum[cellId]); bin <= lastBin; ++bin)
+      {
+      ++this->BinOffsets[bin + 1];
+      }
+    }
+  for (int bin = 0; bin < this->NumberOfBins; ++bin)
+    {
+    this->BinOffsets[bin + 1] += this->BinOffsets[bin];
+    }
+  this->BinCellIds.resize(this->BinOffsets[this->NumberOfBins]);
+  std::vector<vtkIdType> binFill(this->BinOffsets.begin(), this->BinOffsets.end() - 1);
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+    {
+    if (this->CellOffsets[cellId] == this->CellOffsets[cellId + 1])
+      {
+      continue;
+      }
+    int lastBin = this->GetBin(this->CellMaximum[cellId]);
+    for (int bin = this->GetBin(this->CellMinimum[cellId]); bin <= lastBin; ++bin)
+      {
+      this->BinCellIds[binFill[bin]++] = cellId;
+      }
+    }
+
+  this->IndexBuilt = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCachedPlaneCutter::vtkInternal::GetEdgePoint(vtkIdType pointId0, vtkIdType pointId1,
+  double distance0, double distance1, vtkPoints* inputPoints, vtkPointData* inputPointData,
+  vtkPoints* outputPoints, vtkPointData* outputPointData)
+{
+  std::pair<vtkIdType, vtkIdType> edge(std::min(pointId0, pointId1), std::max(pointId0, pointId1));
+  std::map<std::pair<vtkIdType, vtkIdType>, vtkIdType>::iterator edgeIt = this->EdgePoints.find(edge);
+  if (edgeIt != this->EdgePoints.end())
+    {
+    return edgeIt->second;
+    }
+
+  double t = distance0 / (distance0 - distance1);
+  double point0[3] = { 0.0, 0.0, 0.0 };
+  double point1[3] = { 0.0, 0.0, 0.0 };
+  inputPoints->GetPoint(pointId0, point0);
+  inputPoints->GetPoint(pointId1, point1);
+  double point[3] =
+    {
+    point0[0] + t * (point1[0] - point0[0]),
+    point0[1] + t * (point1[1] - point0[1]),
+    point0[2] + t * (point1[2] - point0[2])
+    };
+  vtkIdType outputPointId = outputPoints->InsertNextPoint(point);
+  outputPointData->InterpolateEdge(inputPointData, outputPointId, pointId0, pointId1, t);
+  this->EdgePoints[edge] = outputPointId;
+  return outputPointId;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedPlaneCutter::vtkInternal::Cut(vtkPolyData* input, double offset, vtkPolyData* output)
+{
+  // A cell is cut if some of its points are below the plane and some are on or above it
+  if (this->NumberOfBins == 0 || offset <= this->RangeMinimum || offset > this->RangeMaximum)
+    {
+    return;
+    }
+  int bin = this->GetBin(offset);
+  vtkIdType firstCandidate = this->BinOffsets[bin];
+  vtkIdType lastCandidate = this->BinOffsets[bin + 1];
+
+  vtkPoints* inputPoints = input->GetPoints();
+  vtkPointData* inputPointData = input->GetPointData();
+  vtkCellData* inputCellData = input->GetCellData();
+
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetDataType(inputPoints->GetDataType());
+  vtkNew<vtkCellArray> outputLines;
+  vtkPointData* outputPointData = output->GetPointData();
+  vtkCellData* outputCellData = output->GetCellData();
+  vtkIdType estimatedSize = std::max<vtkIdType>(lastCandidate - firstCandidate, 16);
+  outputPoints->Allocate(estimatedSize);
+  outputLines->Allocate(3 * estimatedSize);
+  outputPointData->InterpolateAllocate(inputPointData, estimatedSize);
+  outputCellData->CopyAllocate(inputCellData, estimatedSize);
+
+  this->EdgePoints.clear();
+  for (vtkIdType candidate = firstCandidate; candidate < lastCandidate; ++candidate)
+    {
+    vtkIdType cellId = this->BinCellIds[candidate];
+    if (this->CellMinimum[cellId] >= offset || this->CellMaximum[cellId] < offset)
+      {
+      continue;
+      }
+    vtkIdType npts = this->CellOffsets[cellId + 1] - this->CellOffsets[cellId];
+    vtkIdType* pts = &this->CellPointIds[this->CellOffsets[cellId]];
+
+    this->Crossings.clear();
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      vtkIdType pointId0 = pts[i];
+      vtkIdType pointId1 = pts[(i + 1) % npts];
+      double distance0 = this->PointProjections[pointId0] - offset;
+      double distance1 = this->PointProjections[pointId1] - offset;
+      if ((distance0 >= 0.0) != (distance1 >= 0.0))
+        {
+        this->Crossings.push_back(this->GetEdgePoint(pointId0, pointId1, distance0, distance1,
+          inputPoints, inputPointData, outputPoints.GetPointer(), outputPointData));
+        }
+      }
+
+    if (this->Crossings.size() > 2)
+      {
+      // Concave polygon: pair the crossings along the intersection line
+      double polygonNormal[3] = { 0.0, 0.0, 0.0 };
+      vtkPolygon::ComputeNormal(inputPoints, static_cast<int>(npts), pts, polygonNormal);
+      double direction[3] = { 0.0, 0.0, 0.0 };
+      vtkMath::Cross(this->Normal, polygonNormal, direction);
+      std::sort(this->Crossings.begin(), this->Crossings.end(),
+        [&outputPoints, &direction](vtkIdType a, vtkIdType b)
+        {
+        double pointA[3] = { 0.0, 0.0, 0.0 };
+        double pointB[3] = { 0.0, 0.0, 0.0 };
+        outputPoints->GetPoint(a, pointA);
+        outputPoints->GetPoint(b, pointB);
+        return vtkMath::Dot(pointA, direction) < vtkMath::Dot(pointB, direction);
+        });
+      }
+    for (size_t i = 0; i + 1 < this->Crossings.size(); i += 2)
+      {
+      vtkIdType line[2] = { this->Crossings[i], this->Crossings[i + 1] };
+      vtkIdType outputCellId = outputLines->InsertNextCell(2, line);
+      outputCellData->CopyData(inputCellData, cellId, outputCellId);
+      }
+    }
+  this->EdgePoints.clear();
+
+  output->SetPoints(outputPoints.GetPointer());
+  output->SetLines(outputLines.GetPointer());
+  output->Squeeze();
+}
+
+//----------------------------------------------------------------------------
+vtkCachedPlaneCutter::vtkCachedPlaneCutter()
+{
+  this->Plane = nullptr;
+  this->CacheSize = 8;
+  this->NumberOfCacheHits = 0;
+  this->NumberOfIndexBuilds = 0;
+  this->Cutter = vtkSmartPointer<vtkCutter>::New();
+  this->Cutter->SetGenerateCutScalars(0);
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkCachedPlaneCutter::~vtkCachedPlaneCutter()
+{
+  this->SetPlane(nullptr);
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedPlaneCutter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Plane: " << this->Plane << "\n";
+  os << indent << "CacheSize: " << this->CacheSize << "\n";
+  os << indent << "NumberOfCacheHits: " << this->NumberOfCacheHits << "\n";
+  os << indent << "NumberOfIndexBuilds: " << this->NumberOfIndexBuilds << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkCachedPlaneCutter::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Plane)
+    {
+    mTime = std::max(mTime, this->Plane->GetMTime());
+    }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedPlaneCutter::ClearCache()
+{
+  this->Internal->Clear();
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedPlaneCutter::FillInputPortInformation(int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkCachedPlaneCutter::RequestData(vtkInformation* vtkNotUsed(request),
+                                      vtkInformationVector** inputVector,
+                                      vtkInformationVector* outputVector)
+{
+  vtkDataSet* input = vtkDataSet::GetData(inputVector[0]);
+  vtkPolyData* output = vtkPolyData::GetData(outputVector);
+  if (!input || !output)
+    {
+    return 0;
+    }
+  if (!this->Plane)
+    {
+    vtkErrorMacro("RequestData failed: no plane is specified");
+    return 0;
+    }
+  if (input->GetNumberOfPoints() == 0 || input->GetNumberOfCells() == 0)
+    {
+    return 1;
+    }
+
+  double normal[3] = { 0.0, 0.0, 0.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  this->Plane->GetNormal(normal);
+  this->Plane->GetOrigin(origin);
+  if (vtkMath::Normalize(normal) == 0.0)
+    {
+    vtkErrorMacro("RequestData failed: plane normal is invalid");
+    return 0;
+    }
+  double offset = vtkMath::Dot(normal, origin);
+
+  this->Internal->Update(input, normal);
+  vtkPolyData* cachedCut = this->Internal->FindCachedCut(offset);
+  if (cachedCut)
+    {
+    ++this->NumberOfCacheHits;
+    output->ShallowCopy(cachedCut);
+    return 1;
+    }
+
+  vtkSmartPointer<vtkPolyData> cut = vtkSmartPointer<vtkPolyData>::New();
+  vtkPolyData* polyData = vtkPolyData::SafeDownCast(input);
+  if (polyData && !this->Internal->IndexBuilt && this->Internal->BuildIndex(polyData))
+    {
+    ++this->NumberOfIndexBuilds;
+    }
+  if (polyData && this->Internal->IndexBuilt)
+    {
+    this->Internal->Cut(polyData, offset, cut);
+    }
+  else
+    {
+    // Not a polygonal mesh, cut all the cells
+    this->Cutter->SetCutFunction(this->Plane);
+    this->Cutter->SetInputData(input);
+    this->Cutter->Update();
+    cut->ShallowCopy(this->Cutter->GetOutput());
+    this->Cutter->SetInputData(nullptr);
+    }
+
+  this->Internal->AddCachedCut(offset, cut, this->CacheSize);
+  output->ShallowCopy(cut);
+  return 1;
+}
@@ -0,0 +1,98 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkCachedPlaneCutter_h
+#define __vtkCachedPlaneCutter_h
+
+// vtkAddon includes
+#include "vtkAddon.h"
+
+// VTK includes
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+class vtkCutter;
+class vtkPlane;
+
+/// \brief Cut a dataset with a plane that is moved along its normal.
+///
+/// Intended for displaying intersections of models in slice views, where the
+/// same model is cut repeatedly with planes of the same orientation.
+///
+/// For polygonal meshes an interval index of the cells along the plane normal
+/// is built the first time the input is cut, and reused as long as the input
+/// and the plane normal do not change. Only the cells whose range contains the
+/// plane are visited, so cutting at a new offset costs in proportion to the
+/// size of the intersection instead of the size of the mesh.
+/// Other datasets (e.g., volumetric meshes) are cut with vtkCutter.
+///
+/// The results of the most recent cuts are kept, so that moving the plane back
+/// to a recently visited offset does not require cutting again.
+///
+/// The output contains line segments for polygons (polygons for volumetric
+/// cells) with point data interpolated and cell data copied from the input.
+class VTK_ADDON_EXPORT vtkCachedPlaneCutter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkCachedPlaneCutter *New();
+  vtkTypeMacro(vtkCachedPlaneCutter, vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Plane used for cutting
+  void SetPlane(vtkPlane* plane);
+  vtkGetObjectMacro(Plane, vtkPlane);
+
+  /// Maximum number of cut results kept for recently visited plane offsets.
+  /// 0 disables caching of results. Default is 8.
+  vtkSetClampMacro(CacheSize, int, 0, VTK_INT_MAX);
+  vtkGetMacro(CacheSize, int);
+
+  /// Number of cuts served from the result cache, for testing and profiling
+  vtkGetMacro(NumberOfCacheHits, int);
+
+  /// Number of times the interval index has been built, for testing and profiling
+  vtkGetMacro(NumberOfIndexBuilds, int);
+
+  /// Remove the interval index and all cached results
+  void ClearCache();
+
+  /// Plane modifications modify the output
+  vtkMTimeType GetMTime() override;
+
+protected:
+  vtkCachedPlaneCutter();
+  ~vtkCachedPlaneCutter() override;
+
+  int FillInputPortInformation(int port, vtkInformation* info) override;
+  int RequestData(vtkInformation* request,
+                  vtkInformationVector** inputVector,
+                  vtkInformationVector* outputVector) override;
+
+  vtkPlane* Plane;
+  int CacheSize;
+  int NumberOfCacheHits;
+  int NumberOfIndexBuilds;
+
+  vtkSmartPointer<vtkCutter> Cutter;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
+private:
+  vtkCachedPlaneCutter(const vtkCachedPlaneCutter&) = delete;
+  void operator=(const vtkCachedPlaneCutter&) = delete;
+};
+
+#endif
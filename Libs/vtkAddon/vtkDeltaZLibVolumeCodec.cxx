@@ -0,0 +1,406 @@
+/*==============================================================================
+
+Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+==============================================================================*/
+
+// vtkAddon includes
+#include "vtkDeltaZLibVolumeCodec.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkObjectFactory.h>
+#include <vtkType.h>
+#include <vtkVariant.h>
+#include <vtkZLibDataCompressor.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
+
+vtkCodecNewMacro(vtkDeltaZLibVolumeCodec);
+
+namespace
+{
+//---------------------------------------------------------------------------
+// Store the zigzag encoded residual of value i as byte planes, so that small
+// positive and negative residuals both compress well.
+template<typename T>
+inline void StoreResidual(T residual, vtkIdType i, vtkIdType numberOfValues, unsigned char* planes)
+{
+  const int numberOfBits = 8 * sizeof(T);
+  T sign = static_cast<T>(static_cast<T>(0) - static_cast<T>(residual >> (numberOfBits - 1)));
+  T zigzag = static_cast<T>(static_cast<T>(residual << 1) ^ sign);
+  for (unsigned int byte = 0; byte < sizeof(T); ++byte)
+    {
+    planes[byte * numberOfValues + i] = static_cast<unsigned char>(zigzag >> (8 * byte));
+    }
+}
+
+//---------------------------------------------------------------------------
+template<typename T>
+inline T LoadResidual(const unsigned char* planes, vtkIdType i, vtkIdType numberOfValues)
+{
+  T zigzag = 0;
+  for (unsigned int byte = 0; byte < sizeof(T); ++byte)
+    {
+    zigzag |= static_cast<T>(static_cast<T>(planes[byte * numberOfValues + i]) << (8 * byte));
+    }
+  return static_cast<T>((zigzag >> 1) ^ static_cast<T>(static_cast<T>(0) - static_cast<T>(zigzag & 1)));
+}
+
+//---------------------------------------------------------------------------
+// Compute the residual of each value to its prediction and store it as byte planes.
+// T is an unsigned integer type of the size of the scalar type, so that the
+// arithmetic wraps around and is lossless for any scalar type.
+// If reference is nullptr the previous value of the same component is used as
+// prediction (key frame), otherwise the reference value (delta frame).
+template<typename T>
+void EncodeResiduals(const T* input, const T* reference, vtkIdType numberOfValues, int numberOfComponents,
+                     unsigned char* planes)
+{
+  if (reference)
+    {
+    for (vtkIdType i = 0; i < numberOfValues; ++i)
+      {
+      StoreResidual(static_cast<T>(input[i] - reference[i]), i, numberOfValues, planes);
+      }
+    return;
+    }
+  vtkIdType firstPredicted = std::min<vtkIdType>(numberOfComponents, numberOfValues);
+  for (vtkIdType i = 0; i < firstPredicted; ++i)
+    {
+    StoreResidual(input[i], i, numberOfValues, planes);
+    }
+  for (vtkIdType i = firstPredicted; i < numberOfValues; ++i)
+    {
+    StoreResidual(static_cast<T>(input[i] - input[i - numberOfComponents]), i, numberOfValues, planes);
+    }
+}
+
+//---------------------------------------------------------------------------
+// Inverse of EncodeResiduals. For delta frames output must contain the
+// reference image on input.
+template<typename T>
+void DecodeResiduals(const unsigned char* planes, vtkIdType numberOfValues, int numberOfComponents,
+                     bool keyFrame, T* output)
+{
+  if (!keyFrame)
+    {
+    for (vtkIdType i = 0; i < numberOfValues; ++i)
+      {
+      output[i] = static_cast<T>(output[i] + LoadResidual<T>(planes, i, numberOfValues));
+      }
+    return;
+    }
+  vtkIdType firstPredicted = std::min<vtkIdType>(numberOfComponents, numberOfValues);
+  for (vtkIdType i = 0; i < firstPredicted; ++i)
+    {
+    output[i] = LoadResidual<T>(planes, i, numberOfValues);
+    }
+  for (vtkIdType i = firstPredicted; i < numberOfValues; ++i)
+    {
+    output[i] = static_cast<T>(output[i - numberOfComponents] + LoadResidual<T>(planes, i, numberOfValues));
+    }
+}
+}
+
+//---------------------------------------------------------------------------
+vtkDeltaZLibVolumeCodec::vtkDeltaZLibVolumeCodec()
+  : KeyFrameInterval(30)
+  , CompressionLevel(1)
+  , LastEncodedFrame(nullptr)
+  , NumberOfFramesSinceKeyFrame(0)
+{
+  this->Compressor = vtkSmartPointer<vtkZLibDataCompressor>::New();
+  this->Compressor->SetCompressionLevel(this->CompressionLevel);
+
+  this->AvailiableParameterNames.push_back("KeyFrameInterval");
+  this->AvailiableParameterNames.push_back("CompressionLevel");
+  this->Parameters["KeyFrameInterval"] = "30";
+  this->Parameters["CompressionLevel"] = "1";
+
+  ParameterPreset fastPreset;
+  fastPreset.Name = "fast";
+  fastPreset.Value = "ZLIB_1";
+  this->ParameterPresets.push_back(fastPreset);
+  ParameterPreset balancedPreset;
+  balancedPreset.Name = "balanced";
+  balancedPreset.Value = "ZLIB_5";
+  this->ParameterPresets.push_back(balancedPreset);
+  ParameterPreset maximumPreset;
+  maximumPreset.Name = "maximum compression";
+  maximumPreset.Value = "ZLIB_9";
+  this->ParameterPresets.push_back(maximumPreset);
+  this->DefaultParameterPresetValue = "ZLIB_1";
+}
+
+//---------------------------------------------------------------------------
+vtkDeltaZLibVolumeCodec::~vtkDeltaZLibVolumeCodec()
+= default;
+
+//---------------------------------------------------------------------------
+std::string vtkDeltaZLibVolumeCodec::GetParameterDescription(std::string parameterName)
+{
+  if (parameterName == "KeyFrameInterval")
+    {
+    return "Number of frames between key frames. Smaller values allow faster seeking, larger values give smaller files.";
+    }
+  if (parameterName == "CompressionLevel")
+    {
+    return "zlib compression level, from 1 (fastest) to 9 (smallest).";
+    }
+  return "";
+}
+
+//---------------------------------------------------------------------------
+bool vtkDeltaZLibVolumeCodec::UpdateParameterInternal(std::string parameterName, std::string parameterValue)
+{
+  bool valid = false;
+  int value = vtkVariant(parameterValue).ToInt(&valid);
+  if (!valid)
+    {
+    vtkErrorMacro("UpdateParameterInternal: invalid value \"" << parameterValue << "\" for parameter " << parameterName);
+    return false;
+    }
+
+  if (parameterName == "KeyFrameInterval")
+    {
+    this->KeyFrameInterval = std::max(1, value);
+    return true;
+    }
+  if (parameterName == "CompressionLevel")
+    {
+    this->CompressionLevel = std::min(9, std::max(1, value));
+    this->Compressor->SetCompressionLevel(this->CompressionLevel);
+    return true;
+    }
+  return false;
+}
+
+//---------------------------------------------------------------------------
+bool vtkDeltaZLibVolumeCodec::SetParametersFromPresetValue(const std::string& presetValue)
+{
+  if (presetValue.empty())
+    {
+    // no change requested, nothing to do
+    return true;
+    }
+  const std::string prefix = "ZLIB_";
+  if (presetValue.compare(0, prefix.size(), prefix) != 0)
+    {
+    vtkWarningMacro("SetParametersFromPresetValue failed: unknown preset " << presetValue);
+    return false;
+    }
+  return this->SetParameter("CompressionLevel", presetValue.substr(prefix.size()));
+}
+
+//---------------------------------------------------------------------------
+bool vtkDeltaZLibVolumeCodec::EncodeImageDataInternal(vtkImageData* inputImageData, vtkStreamingVolumeFrame* outputFrame, bool forceKeyFrame)
+{
+  if (!inputImageData || !outputFrame)
+    {
+    vtkErrorMacro("Incorrect arguments!");
+    return false;
+    }
+
+  int dimensions[3] = { 0,0,0 };
+  inputImageData->GetDimensions(dimensions);
+  int scalarType = inputImageData->GetScalarType();
+  int numberOfComponents = inputImageData->GetNumberOfScalarComponents();
+  vtkIdType numberOfValues = static_cast<vtkIdType>(dimensions[0]) * dimensions[1] * dimensions[2] * numberOfComponents;
+  if (numberOfValues <= 0)
+    {
+    vtkErrorMacro("Cannot encode frame, number of voxels is zero");
+    return false;
+    }
+  int scalarSize = inputImageData->GetScalarSize();
+  size_t numberOfBytes = static_cast<size_t>(numberOfValues) * scalarSize;
+  const unsigned char* inputPointer = static_cast<const unsigned char*>(inputImageData->GetScalarPointer());
+
+  bool keyFrame = forceKeyFrame
+    || !this->LastEncodedFrame
+    || this->NumberOfFramesSinceKeyFrame + 1 >= this->KeyFrameInterval
+    || this->EncoderReference.size() != numberOfBytes
+    || this->LastEncodedFrame->GetVTKScalarType() != scalarType
+    || this->LastEncodedFrame->GetNumberOfComponents() != numberOfComponents;
+  if (!keyFrame)
+    {
+    int* lastDimensions = this->LastEncodedFrame->GetDimensions();
+    keyFrame = (lastDimensions[0] != dimensions[0] || lastDimensions[1] != dimensions[1] || lastDimensions[2] != dimensions[2]);
+    }
+
+  this->ResidualBuffer.resize(numberOfBytes);
+  const unsigned char* referencePointer = keyFrame ? nullptr : this->EncoderReference.data();
+  switch (scalarSize)
+    {
+    case 1:
+      EncodeResiduals(reinterpret_cast<const vtkTypeUInt8*>(inputPointer), reinterpret_cast<const vtkTypeUInt8*>(referencePointer),
+        numberOfValues, numberOfComponents, this->ResidualBuffer.data());
+      break;
+    case 2:
+      EncodeResiduals(reinterpret_cast<const vtkTypeUInt16*>(inputPointer), reinterpret_cast<const vtkTypeUInt16*>(referencePointer),
+        numberOfValues, numberOfComponents, this->ResidualBuffer.data());
+      break;
+    case 4:
+      EncodeResiduals(reinterpret_cast<const vtkTypeUInt32*>(inputPointer), reinterpret_cast<const vtkTypeUInt32*>(referencePointer),
+        numberOfValues, numberOfComponents, this->ResidualBuffer.data());
+      break;
+    case 8:
+      EncodeResiduals(reinterpret_cast<const vtkTypeUInt64*>(inputPointer), reinterpret_cast<const vtkTypeUInt64*>(referencePointer),
+        numberOfValues, numberOfComponents, this->ResidualBuffer.data());
+      break;
+    default:
+      vtkErrorMacro("Cannot encode frame, unsupported scalar type " << inputImageData->GetScalarTypeAsString());
+      return false;
+    }
+
+  vtkSmartPointer<vtkUnsignedCharArray> frameData = vtkSmartPointer<vtkUnsignedCharArray>::Take(
+    this->Compressor->Compress(this->ResidualBuffer.data(), numberOfBytes));
+  if (!frameData)
+    {
+    vtkErrorMacro("Cannot encode frame, compression failed");
+    return false;
+    }
+  // The compressor allocates space for the worst case
+  frameData->Squeeze();
+
+  this->EncoderReference.assign(inputPointer, inputPointer + numberOfBytes);
+
+  outputFrame->SetFrameData(frameData);
+  outputFrame->SetVTKScalarType(scalarType);
+  outputFrame->SetDimensions(dimensions);
+  outputFrame->SetNumberOfComponents(numberOfComponents);
+  outputFrame->SetCodecFourCC(this->GetFourCC());
+  if (keyFrame)
+    {
+    outputFrame->SetFrameType(vtkStreamingVolumeFrame::IFrame);
+    outputFrame->SetPreviousFrame(nullptr);
+    this->NumberOfFramesSinceKeyFrame = 0;
+    }
+  else
+    {
+    outputFrame->SetFrameType(vtkStreamingVolumeFrame::PFrame);
+    outputFrame->SetPreviousFrame(this->LastEncodedFrame);
+    ++this->NumberOfFramesSinceKeyFrame;
+    }
+  this->LastEncodedFrame = outputFrame;
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool vtkDeltaZLibVolumeCodec::DecodeFrameInternal(vtkStreamingVolumeFrame* inputFrame, vtkImageData* outputImageData, bool saveDecodedImage/*=true*/)
+{
+  if (!inputFrame || !outputImageData)
+    {
+    vtkErrorMacro("Incorrect arguments!");
+    return false;
+    }
+
+  vtkUnsignedCharArray* frameData = inputFrame->GetFrameData();
+  if (!frameData || frameData->GetNumberOfValues() == 0)
+    {
+    vtkErrorMacro("Cannot decode frame, frame data is empty");
+    return false;
+    }
+
+  int frameDimensions[3] = { 0,0,0 };
+  inputFrame->GetDimensions(frameDimensions);
+  int numberOfComponents = inputFrame->GetNumberOfComponents();
+  vtkIdType numberOfValues = static_cast<vtkIdType>(frameDimensions[0]) * frameDimensions[1] * frameDimensions[2] * numberOfComponents;
+  if (numberOfValues <= 0)
+    {
+    vtkErrorMacro("Cannot decode frame, number of voxels is zero");
+    return false;
+    }
+  int scalarSize = vtkDataArray::GetDataTypeSize(inputFrame->GetVTKScalarType());
+  size_t numberOfBytes = static_cast<size_t>(numberOfValues) * scalarSize;
+
+  bool keyFrame = inputFrame->IsKeyFrame();
+  if (!keyFrame && this->DecoderReference.size() != numberOfBytes)
+    {
+    vtkErrorMacro("Cannot decode frame, previous frame is not available");
+    return false;
+    }
+
+  this->ResidualBuffer.resize(numberOfBytes);
+  size_t uncompressedSize = this->Compressor->Uncompress(frameData->GetPointer(0), frameData->GetNumberOfValues(),
+    this->ResidualBuffer.data(), numberOfBytes);
+  if (uncompressedSize != numberOfBytes)
+    {
+    vtkErrorMacro("Cannot decode frame, frame data is corrupted");
+    this->DecoderReference.clear();
+    return false;
+    }
+
+  this->DecoderReference.resize(numberOfBytes);
+  unsigned char* decodedPointer = this->DecoderReference.data();
+  switch (scalarSize)
+    {
+    case 1:
+      DecodeResiduals(this->ResidualBuffer.data(), numberOfValues, numberOfComponents, keyFrame,
+        reinterpret_cast<vtkTypeUInt8*>(decodedPointer));
+      break;
+    case 2:
+      DecodeResiduals(this->ResidualBuffer.data(), numberOfValues, numberOfComponents, keyFrame,
+        reinterpret_cast<vtkTypeUInt16*>(decodedPointer));
+      break;
+    case 4:
+      DecodeResiduals(this->ResidualBuffer.data(), numberOfValues, numberOfComponents, keyFrame,
+        reinterpret_cast<vtkTypeUInt32*>(decodedPointer));
+      break;
+    case 8:
+      DecodeResiduals(this->ResidualBuffer.data(), numberOfValues, numberOfComponents, keyFrame,
+        reinterpret_cast<vtkTypeUInt64*>(decodedPointer));
+      break;
+    default:
+      vtkErrorMacro("Cannot decode frame, unsupported scalar type " << inputFrame->GetVTKScalarType());
+      this->DecoderReference.clear();
+      return false;
+    }
+
+  if (!saveDecodedImage)
+    {
+    return true;
+    }
+
+  int imageDimensions[3] = { 0,0,0 };
+  outputImageData->GetDimensions(imageDimensions);
+  for (int i = 0; i < 3; ++i)
+    {
+    if (frameDimensions[i] != imageDimensions[i])
+      {
+      vtkErrorMacro("Cannot decode frame, voxel size does not match image");
+      return false;
+      }
+    }
+  if (outputImageData->GetScalarType() != inputFrame->GetVTKScalarType()
+    || outputImageData->GetNumberOfScalarComponents() != numberOfComponents)
+    {
+    vtkErrorMacro("Cannot decode frame, scalar type or number of components does not match image");
+    return false;
+    }
+
+  memcpy(outputImageData->GetScalarPointer(), decodedPointer, numberOfBytes);
+  outputImageData->Modified();
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkDeltaZLibVolumeCodec::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "KeyFrameInterval:\t" << this->KeyFrameInterval << std::endl;
+  os << indent << "CompressionLevel:\t" << this->CompressionLevel << std::endl;
+}
@@ -0,0 +1,101 @@
+/*==============================================================================
+
+Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkDeltaZLibVolumeCodec_h
+#define __vtkDeltaZLibVolumeCodec_h
+
+// vtkAddon includes
+#include "vtkStreamingVolumeCodec.h"
+
+// STD includes
+#include <vector>
+
+class vtkZLibDataCompressor;
+
+/// \brief Lossless codec using key frames and delta frames, compressed with zlib
+///
+/// Key frames store the difference of each voxel value to the previous voxel
+/// of the same component, delta frames store the difference to the previously
+/// encoded image. Residuals are zigzag encoded, split into byte planes and
+/// compressed using zlib.
+///
+/// All scalar types and any number of components are supported. Floating point
+/// values are processed as their bit patterns, so decoding is always exact.
+///
+/// Parameters:
+/// - KeyFrameInterval: number of frames between key frames (default 30).
+///   A key frame is also encoded if the size or type of the image changes.
+/// - CompressionLevel: zlib compression level from 1 (fastest) to 9 (smallest). Default is 1.
+class VTK_ADDON_EXPORT vtkDeltaZLibVolumeCodec : public vtkStreamingVolumeCodec
+{
+public:
+  static vtkDeltaZLibVolumeCodec *New();
+  vtkStreamingVolumeCodec* CreateCodecInstance() override;
+  vtkTypeMacro(vtkDeltaZLibVolumeCodec, vtkStreamingVolumeCodec);
+
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// FourCC code representing lossless delta frames compressed with zlib
+  std::string GetFourCC() override { return "DZLB"; };
+
+  /// Return the codec parameter description
+  std::string GetParameterDescription(std::string parameterName) override;
+
+  /// Set the compression level from a preset value ("ZLIB_1" to "ZLIB_9")
+  bool SetParametersFromPresetValue(const std::string& presetValue) override;
+
+  /// Number of frames between key frames
+  vtkGetMacro(KeyFrameInterval, int);
+
+  /// zlib compression level
+  vtkGetMacro(CompressionLevel, int);
+
+protected:
+  vtkDeltaZLibVolumeCodec();
+  ~vtkDeltaZLibVolumeCodec() override;
+
+  /// Decode the compressed frame to an image
+  bool DecodeFrameInternal(vtkStreamingVolumeFrame* inputFrame, vtkImageData* outputImageData, bool saveDecodedImage = true) override;
+
+  /// Encode the image to a compressed frame
+  bool EncodeImageDataInternal(vtkImageData* inputImageData, vtkStreamingVolumeFrame* outputFrame, bool forceKeyFrame) override;
+
+  /// Update the codec parameters
+  bool UpdateParameterInternal(std::string parameterName, std::string parameterValue) override;
+
+protected:
+  int KeyFrameInterval;
+  int CompressionLevel;
+
+  vtkSmartPointer<vtkZLibDataCompressor> Compressor;
+
+  /// Encoder state: last encoded frame and its image, used as reference for the next delta frame
+  vtkSmartPointer<vtkStreamingVolumeFrame> LastEncodedFrame;
+  std::vector<unsigned char> EncoderReference;
+  int NumberOfFramesSinceKeyFrame;
+
+  /// Decoder state: last decoded image, used as reference for the next delta frame
+  std::vector<unsigned char> DecoderReference;
+
+  /// Buffer holding the residual byte planes
+  std::vector<unsigned char> ResidualBuffer;
+
+private:
+  vtkDeltaZLibVolumeCodec(const vtkDeltaZLibVolumeCodec&) = delete;
+  void operator=(const vtkDeltaZLibVolumeCodec&) = delete;
+};
+
+#endif
@@ -19,6 +19,7 @@ Care Ontario.
 ==============================================================================*/
 
 // vtkAddon includes
+#include "vtkDeltaZLibVolumeCodec.h"
 #include "vtkRawRGBVolumeCodec.h"
 #include "vtkStreamingVolumeCodecFactory.h"
 
@@ -114,6 +115,7 @@ void vtkStreamingVolumeCodecFactory::classInitialize()
   vtkStreamingVolumeCodecFactoryInstance = vtkStreamingVolumeCodecFactory::GetInstance();
 
   vtkStreamingVolumeCodecFactoryInstance->RegisterStreamingCodec(vtkSmartPointer<vtkRawRGBVolumeCodec>::New());
+  vtkStreamingVolumeCodecFactoryInstance->RegisterStreamingCodec(vtkSmartPointer<vtkDeltaZLibVolumeCodec>::New());
 }
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,195 @@
+import os
+import shutil
+import sqlite3
+import tempfile
+import unittest
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+import numpy
+from pydicom.dataset import Dataset, FileDataset
+from pydicom.uid import ExplicitVRLittleEndian, generate_uid
+
+"""
+To run as test from slicer python console, replace the following with your source tree path and paste:
+
+exec(open('/path/to/Slicer/Libs/vtkITK/Testing/vtkITKArchetypeHeaderIndexTest.py').read()); t = vtkITKArchetypeHeaderIndexTest(); t.runTest()
+"""
+
+class vtkITKArchetypeHeaderIndexTest(unittest.TestCase):
+    def setUp(self):
+        # Write a series of DICOM files, one slice per file
+        self.numberOfSlices = 5
+        self.tempDir = tempfile.mkdtemp()
+        self.dicomDir = os.path.join(self.tempDir, 'dicom')
+        os.mkdir(self.dicomDir)
+        self.indexFileName = os.path.join(self.tempDir, 'HeaderIndex.sql')
+        self.seriesInstanceUID = generate_uid()
+        studyInstanceUID = generate_uid()
+        numpy.random.seed(36)
+        self.fileNames = []
+        for sliceIndex in range(self.numberOfSlices):
+            fileName = os.path.join(self.dicomDir, 'slice_%03d.dcm' % sliceIndex)
+            self.writeSlice(fileName, studyInstanceUID, sliceIndex)
+            self.fileNames.append(fileName)
+
+    def tearDown(self):
+        shutil.rmtree(self.tempDir, ignore_errors=True)
+
+    def writeSlice(self, fileName, studyInstanceUID, sliceIndex):
+        sopInstanceUID = generate_uid()
+        fileMeta = Dataset()
+        fileMeta.MediaStorageSOPClassUID = '1.2.840.10008.5.1.4.1.1.2'  # CT image storage
+        fileMeta.MediaStorageSOPInstanceUID = sopInstanceUID
+        fileMeta.TransferSyntaxUID = ExplicitVRLittleEndian
+        ds = FileDataset(fileName, {}, file_meta=fileMeta, preamble=b'\0' * 128)
+        ds.is_little_endian = True
+        ds.is_implicit_VR = False
+        ds.SOPClassUID = fileMeta.MediaStorageSOPClassUID
+        ds.SOPInstanceUID = sopInstanceUID
+        ds.StudyInstanceUID = studyInstanceUID
+        ds.SeriesInstanceUID = self.seriesInstanceUID
+        ds.PatientName = 'HeaderIndex^Test'
+        ds.PatientID = 'HeaderIndexTest'
+        ds.Modality = 'CT'
+        ds.InstanceNumber = sliceIndex + 1
+        ds.ImagePositionPatient = [0.0, 0.0, 2.5 * sliceIndex]
+        ds.ImageOrientationPatient = [1.0, 0.0, 0.0, 0.0, 1.0, 0.0]
+        ds.SliceLocation = 2.5 * sliceIndex
+        ds.PixelSpacing = [0.5, 0.5]
+        ds.SliceThickness = 2.5
+        ds.Rows = 16
+        ds.Columns = 12
+        ds.SamplesPerPixel = 1
+        ds.PhotometricInterpretation = 'MONOCHROME2'
+        ds.BitsAllocated = 16
+        ds.BitsStored = 16
+        ds.HighBit = 15
+        ds.PixelRepresentation = 0
+        ds.PixelData = numpy.random.randint(0, 4096, size=(16, 12), dtype=numpy.uint16).tobytes()
+        ds.save_as(fileName)
+
+    def readSeries(self, fileNames=None):
+        if fileNames is None:
+            fileNames = self.fileNames
+        reader = vtkITK.vtkITKArchetypeImageSeriesScalarReader()
+        reader.SetArchetype(fileNames[0])
+        for fileName in fileNames:
+            reader.AddFileName(fileName)
+        reader.SetSingleFile(0)
+        reader.SetOutputScalarTypeToNative()
+        reader.SetDesiredCoordinateOrientationToNative()
+        reader.SetUseOrientationFromFile(1)
+        reader.SetHeaderIndexFileName(self.indexFileName)
+        reader.Update()
+        return reader
+
+    def indexedRows(self):
+        """Return the indexed series instance UID and slice location of each file"""
+        connection = sqlite3.connect(self.indexFileName)
+        try:
+            rows = connection.execute('SELECT FileName, SeriesInstanceUID, SliceLocation FROM DICOMHeaderIndex').fetchall()
+        finally:
+            connection.close()
+        return {os.path.normcase(os.path.abspath(row[0])): (row[1], row[2]) for row in rows}
+
+    def fileKey(self, fileName):
+        return os.path.normcase(os.path.abspath(fileName))
+
+    def fileNameArray(self, fileNames):
+        array = vtk.vtkStringArray()
+        for fileName in fileNames:
+            array.InsertNextValue(fileName)
+        return array
+
+    def test_insert_and_query(self):
+        # No index, no rows: all headers are parsed and inserted
+        self.assertFalse(os.path.exists(self.indexFileName))
+        firstReader = self.readSeries()
+        self.assertEqual(firstReader.GetNumberOfIndexedHeaders(), 0)
+        rows = self.indexedRows()
+        self.assertEqual(len(rows), self.numberOfSlices)
+        for sliceIndex, fileName in enumerate(self.fileNames):
+            self.assertIn(self.fileKey(fileName), rows)
+            seriesInstanceUID, sliceLocation = rows[self.fileKey(fileName)]
+            self.assertEqual(seriesInstanceUID, self.seriesInstanceUID)
+            self.assertAlmostEqual(float(sliceLocation), 2.5 * sliceIndex)
+
+        # All headers are read from the index, the output is the same
+        secondReader = self.readSeries()
+        self.assertEqual(secondReader.GetNumberOfIndexedHeaders(), self.numberOfSlices)
+        firstOutput = firstReader.GetOutput()
+        secondOutput = secondReader.GetOutput()
+        self.assertEqual(secondOutput.GetDimensions(), (12, 16, self.numberOfSlices))
+        self.assertEqual(secondOutput.GetDimensions(), firstOutput.GetDimensions())
+        self.assertEqual(secondOutput.GetSpacing(), firstOutput.GetSpacing())
+        for i in range(4):
+            for j in range(4):
+                self.assertEqual(secondReader.GetRasToIjkMatrix().GetElement(i, j),
+                                 firstReader.GetRasToIjkMatrix().GetElement(i, j))
+        self.assertTrue(numpy.array_equal(ns.vtk_to_numpy(firstOutput.GetPointData().GetScalars()),
+                                          ns.vtk_to_numpy(secondOutput.GetPointData().GetScalars())))
+
+    def test_remove(self):
+        self.readSeries()
+        removedFileNames = self.fileNames[:2]
+
+        # Removing files that are not indexed does nothing
+        self.assertEqual(vtkITK.vtkITKArchetypeImageSeriesReader.RemoveFromHeaderIndex(
+            self.indexFileName, self.fileNameArray([os.path.join(self.dicomDir, 'missing.dcm')])), 0)
+        self.assertEqual(len(self.indexedRows()), self.numberOfSlices)
+
+        self.assertEqual(vtkITK.vtkITKArchetypeImageSeriesReader.RemoveFromHeaderIndex(
+            self.indexFileName, self.fileNameArray(removedFileNames)), len(removedFileNames))
+        rows = self.indexedRows()
+        self.assertEqual(len(rows), self.numberOfSlices - len(removedFileNames))
+        for fileName in removedFileNames:
+            self.assertNotIn(self.fileKey(fileName), rows)
+
+        # Removed files are parsed again, and inserted again
+        reader = self.readSeries()
+        self.assertEqual(reader.GetNumberOfIndexedHeaders(), self.numberOfSlices - len(removedFileNames))
+        self.assertEqual(len(self.indexedRows()), self.numberOfSlices)
+
+        # Removing from a missing index does not create it
+        missingIndexFileName = os.path.join(self.tempDir, 'MissingHeaderIndex.sql')
+        self.assertEqual(vtkITK.vtkITKArchetypeImageSeriesReader.RemoveFromHeaderIndex(
+            missingIndexFileName, self.fileNameArray(removedFileNames)), 0)
+        self.assertFalse(os.path.exists(missingIndexFileName))
+
+    def test_prune(self):
+        self.readSeries()
+
+        # Keep only the files that are still in the database
+        keptFileNames = self.fileNames[1:]
+        self.assertEqual(vtkITK.vtkITKArchetypeImageSeriesReader.PruneHeaderIndex(
+            self.indexFileName, self.fileNameArray(keptFileNames)), 1)
+        rows = self.indexedRows()
+        self.assertEqual(len(rows), len(keptFileNames))
+        self.assertNotIn(self.fileKey(self.fileNames[0]), rows)
+        self.assertEqual(vtkITK.vtkITKArchetypeImageSeriesReader.PruneHeaderIndex(
+            self.indexFileName, self.fileNameArray(keptFileNames)), 0)
+
+        # Without a list, the rows of deleted files are removed
+        os.remove(self.fileNames[-1])
+        self.assertEqual(vtkITK.vtkITKArchetypeImageSeriesReader.PruneHeaderIndex(self.indexFileName, None), 1)
+        rows = self.indexedRows()
+        self.assertEqual(len(rows), len(keptFileNames) - 1)
+        self.assertNotIn(self.fileKey(self.fileNames[-1]), rows)
+
+        # A file that is re-imported with a different content is not served from the index
+        self.writeSlice(self.fileNames[-1], generate_uid(), self.numberOfSlices + 3)
+        reader = self.readSeries(self.fileNames[1:])
+        self.assertEqual(reader.GetNumberOfIndexedHeaders(), len(keptFileNames) - 1)
+        self.assertAlmostEqual(float(self.indexedRows()[self.fileKey(self.fileNames[-1])][1]), 2.5 * (self.numberOfSlices + 3))
+
+    def runTest(self):
+        self.setUp()
+        self.test_insert_and_query()
+        self.tearDown()
+        self.setUp()
+        self.test_remove()
+        self.tearDown()
+        self.setUp()
+        self.test_prune()
+        self.tearDown()
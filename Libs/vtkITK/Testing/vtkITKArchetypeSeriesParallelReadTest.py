@@ -0,0 +1,98 @@
+import os
+import shutil
+import tempfile
+import unittest
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+import numpy
+
+"""
+To run as test from slicer python console, replace the following with your source tree path and paste:
+
+exec(open('/path/to/Slicer/Libs/vtkITK/Testing/vtkITKArchetypeSeriesParallelReadTest.py').read()); t = vtkITKArchetypeSeriesParallelReadTest(); t.runTest()
+"""
+
+class ProgressObserver:
+    def __init__(self):
+        self.progressValues = []
+
+    def __call__(self, caller, event):
+        self.progressValues.append(caller.GetProgress())
+
+class vtkITKArchetypeSeriesParallelReadTest(unittest.TestCase):
+    def setUp(self):
+        # Write a volume with a different content in each slice as a series of PNG files
+        self.dimensions = (23, 17, 12)  # x, y, z
+        numpy.random.seed(35)
+        self.voxels = numpy.random.randint(0, 65535, size=self.dimensions[::-1], dtype=numpy.uint16)
+        image = vtk.vtkImageData()
+        image.SetDimensions(self.dimensions)
+        image.AllocateScalars(vtk.VTK_UNSIGNED_SHORT, 1)
+        ns.vtk_to_numpy(image.GetPointData().GetScalars())[:] = self.voxels.ravel()
+
+        self.tempDir = tempfile.mkdtemp()
+        writer = vtk.vtkPNGWriter()
+        writer.SetInputData(image)
+        writer.SetFileDimensionality(2)
+        writer.SetFilePrefix(os.path.join(self.tempDir, 'slice'))
+        writer.SetFilePattern('%s_%03d.png')
+        writer.Write()
+        self.archetype = os.path.join(self.tempDir, 'slice_000.png')
+
+    def tearDown(self):
+        shutil.rmtree(self.tempDir, ignore_errors=True)
+
+    def readSeries(self, numberOfThreads, progressObserver=None):
+        reader = vtkITK.vtkITKArchetypeImageSeriesScalarReader()
+        reader.SetArchetype(self.archetype)
+        reader.SetSingleFile(0)
+        reader.SetOutputScalarTypeToNative()
+        reader.SetDesiredCoordinateOrientationToNative()
+        reader.SetUseNativeOriginOn()
+        reader.SetNumberOfThreads(numberOfThreads)
+        if progressObserver:
+            reader.AddObserver(vtk.vtkCommand.ProgressEvent, progressObserver)
+        reader.Update()
+        self.assertEqual(reader.GetNumberOfFileNames(), self.dimensions[2])
+        return reader
+
+    def test_default_number_of_threads(self):
+        reader = vtkITK.vtkITKArchetypeImageSeriesScalarReader()
+        self.assertEqual(reader.GetNumberOfThreads(), 0)
+
+    def test_parallel_read_matches_serial_read(self):
+        serialReader = self.readSeries(1)
+        progressObserver = ProgressObserver()
+        parallelReader = self.readSeries(4, progressObserver)
+
+        serialOutput = serialReader.GetOutput()
+        parallelOutput = parallelReader.GetOutput()
+        self.assertEqual(parallelOutput.GetDimensions(), self.dimensions)
+        self.assertEqual(parallelOutput.GetDimensions(), serialOutput.GetDimensions())
+        self.assertEqual(parallelOutput.GetScalarType(), serialOutput.GetScalarType())
+        self.assertEqual(parallelOutput.GetSpacing(), serialOutput.GetSpacing())
+        self.assertEqual(parallelOutput.GetOrigin(), serialOutput.GetOrigin())
+        for i in range(4):
+            for j in range(4):
+                self.assertEqual(parallelReader.GetRasToIjkMatrix().GetElement(i, j),
+                                 serialReader.GetRasToIjkMatrix().GetElement(i, j))
+
+        serialVoxels = ns.vtk_to_numpy(serialOutput.GetPointData().GetScalars())
+        parallelVoxels = ns.vtk_to_numpy(parallelOutput.GetPointData().GetScalars())
+        self.assertTrue(numpy.array_equal(serialVoxels, parallelVoxels))
+        # PNG rows may be flipped on reading, but all the voxels must be there
+        self.assertTrue(numpy.array_equal(numpy.sort(parallelVoxels), numpy.sort(self.voxels.ravel())))
+
+        # Progress is reported from the main thread only, and reaches the end
+        self.assertTrue(len(progressObserver.progressValues) > 0)
+        self.assertEqual(progressObserver.progressValues, sorted(progressObserver.progressValues))
+        self.assertAlmostEqual(progressObserver.progressValues[-1], 1.0)
+
+    def runTest(self):
+        self.setUp()
+        self.test_default_number_of_threads()
+        self.tearDown()
+        self.setUp()
+        self.test_parallel_read_matches_serial_read()
+        self.tearDown()
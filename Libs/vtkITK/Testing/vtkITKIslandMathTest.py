@@ -0,0 +1,116 @@
+import unittest
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+import numpy
+
+"""
+To run as test from slicer python console, replace the following with your source tree path and paste:
+
+exec(open('/path/to/Slicer/Libs/vtkITK/Testing/vtkITKIslandMathTest.py').read()); t = vtkITKIslandMathTest(); t.runTest()
+"""
+
+class ErrorObserver:
+    def __init__(self):
+        self.errorOccurred = False
+
+    def __call__(self, caller, event):
+        self.errorOccurred = True
+
+class vtkITKIslandMathTest(unittest.TestCase):
+    def setUp(self):
+        # Three islands of 4x4x4, 2x2x2 and 1 voxel, with different labels,
+        # the two small ones touch diagonally
+        self.voxels = numpy.zeros((20, 30, 40), dtype=numpy.int16)  # z, y, x
+        self.voxels[2:6, 3:7, 4:8] = 5
+        self.voxels[10:12, 10:12, 20:22] = 7
+        self.voxels[12, 12, 22] = 3
+        self.image = vtk.vtkImageData()
+        self.image.SetDimensions(40, 30, 20)
+        self.image.AllocateScalars(vtk.VTK_SHORT, 1)
+        ns.vtk_to_numpy(self.image.GetPointData().GetScalars())[:] = self.voxels.ravel()
+
+        self.islandMath = vtkITK.vtkITKIslandMath()
+        self.islandMath.SetInputData(self.image)
+
+    def getOutputVoxels(self):
+        self.islandMath.Update()
+        output = self.islandMath.GetOutput()
+        return ns.vtk_to_numpy(output.GetPointData().GetScalars()).reshape(self.voxels.shape)
+
+    def test_face_connected(self):
+        labels = self.getOutputVoxels()
+        self.assertEqual(self.islandMath.GetNumberOfIslands(), 3)
+        self.assertEqual(self.islandMath.GetOriginalNumberOfIslands(), 3)
+        self.assertTrue(numpy.all(labels[2:6, 3:7, 4:8] == 1))
+        self.assertTrue(numpy.all(labels[10:12, 10:12, 20:22] == 2))
+        self.assertEqual(labels[12, 12, 22], 3)
+        self.assertEqual(numpy.count_nonzero(labels), 64 + 8 + 1)
+
+    def test_fully_connected(self):
+        self.islandMath.SetFullyConnected(1)
+        labels = self.getOutputVoxels()
+        self.assertEqual(self.islandMath.GetNumberOfIslands(), 2)
+        self.assertEqual(labels[12, 12, 22], 2)
+
+    def test_size_limits(self):
+        self.islandMath.SetMinimumSize(2)
+        self.islandMath.SetMaximumSize(10)
+        labels = self.getOutputVoxels()
+        self.assertEqual(self.islandMath.GetNumberOfIslands(), 1)
+        self.assertEqual(self.islandMath.GetOriginalNumberOfIslands(), 3)
+        self.assertTrue(numpy.all(labels[10:12, 10:12, 20:22] == 1))
+        self.assertEqual(numpy.count_nonzero(labels), 8)
+
+    def test_threads_and_streaming(self):
+        expected = self.getOutputVoxels().copy()
+        for numberOfThreads in [1, 3]:
+            for streaming in [False, True]:
+                self.islandMath.SetNumberOfThreads(numberOfThreads)
+                self.islandMath.SetStreaming(streaming)
+                self.assertTrue(numpy.array_equal(self.getOutputVoxels(), expected))
+
+    def test_label_overflow(self):
+        # 300 single voxel islands, more than the number of labels that fit in unsigned char
+        ucharImage = vtk.vtkImageData()
+        ucharImage.SetDimensions(30, 20, 4)
+        ucharImage.AllocateScalars(vtk.VTK_UNSIGNED_CHAR, 1)
+        voxels = ns.vtk_to_numpy(ucharImage.GetPointData().GetScalars()).reshape(4, 20, 30)
+        voxels[:] = 0
+        voxels[::2, ::2, ::2] = 1
+        self.assertEqual(numpy.count_nonzero(voxels), 300)
+
+        # Labels do not fit in unsigned char: error is reported, islands are not wrapped into background or label 1
+        self.islandMath.SetInputData(ucharImage)
+        errorObserver = ErrorObserver()
+        self.islandMath.AddObserver(vtk.vtkCommand.ErrorEvent, errorObserver)
+        self.islandMath.Update()
+        self.assertTrue(errorObserver.errorOccurred)
+        self.assertEqual(self.islandMath.GetOriginalNumberOfIslands(), 300)
+        self.assertEqual(self.islandMath.GetNumberOfIslands(), 0)
+        self.assertEqual(numpy.count_nonzero(ns.vtk_to_numpy(self.islandMath.GetOutput().GetPointData().GetScalars())), 0)
+
+        # Same islands with unsigned short input
+        castToUnsignedShort = vtk.vtkImageCast()
+        castToUnsignedShort.SetInputData(ucharImage)
+        castToUnsignedShort.SetOutputScalarTypeToUnsignedShort()
+        self.islandMath.SetInputConnection(castToUnsignedShort.GetOutputPort())
+        errorObserver.errorOccurred = False
+        self.islandMath.Update()
+        self.assertFalse(errorObserver.errorOccurred)
+        self.assertEqual(self.islandMath.GetNumberOfIslands(), 300)
+        labels = ns.vtk_to_numpy(self.islandMath.GetOutput().GetPointData().GetScalars())
+        self.assertEqual(labels.max(), 300)
+        self.assertEqual(len(numpy.unique(labels[labels > 0])), 300)
+
+    def runTest(self):
+        self.setUp()
+        self.test_face_connected()
+        self.setUp()
+        self.test_fully_connected()
+        self.setUp()
+        self.test_size_limits()
+        self.setUp()
+        self.test_threads_and_streaming()
+        self.setUp()
+        self.test_label_overflow()
@@ -0,0 +1,77 @@
+import unittest
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+import numpy
+
+"""
+To run as test from slicer python console, replace the following with your source tree path and paste:
+
+exec(open('/path/to/Slicer/Libs/vtkITK/Testing/vtkITKLabelShapeStatisticsTest.py').read()); t = vtkITKLabelShapeStatisticsTest(); t.runTest()
+"""
+
+class vtkITKLabelShapeStatisticsTest(unittest.TestCase):
+    def setUp(self):
+        # Sphere, box and a sparse random blob in one labelmap
+        shape = (40, 50, 60)  # z, y, x
+        z, y, x = numpy.mgrid[0:shape[0], 0:shape[1], 0:shape[2]]
+        voxels = numpy.zeros(shape, dtype=numpy.int16)
+        voxels[(x - 20.3)**2 + (y - 22.1)**2 + (z - 18.7)**2 <= 15**2] = 3
+        voxels[5:35, 5:25, 45:55] = 5
+        random = numpy.random.RandomState(1)
+        voxels[(x < 8) & (y > 35) & (random.randint(0, 3, shape) == 0)] = 9
+        self.image = vtk.vtkImageData()
+        self.image.SetDimensions(shape[2], shape[1], shape[0])
+        self.image.SetSpacing(0.7, 1.1, 1.3)
+        self.image.SetOrigin(10.0, -5.0, 2.0)
+        self.image.AllocateScalars(vtk.VTK_SHORT, 1)
+        ns.vtk_to_numpy(self.image.GetPointData().GetScalars())[:] = voxels.ravel()
+
+        self.statistics = [vtkITK.vtkITKLabelShapeStatistics.GetShapeStatisticAsString(statistic) for statistic in [
+            vtkITK.vtkITKLabelShapeStatistics.Centroid,
+            vtkITK.vtkITKLabelShapeStatistics.FeretDiameter,
+            vtkITK.vtkITKLabelShapeStatistics.Perimeter,
+            vtkITK.vtkITKLabelShapeStatistics.PrincipalMoments,
+            vtkITK.vtkITKLabelShapeStatistics.OrientedBoundingBox,
+            vtkITK.vtkITKLabelShapeStatistics.Volume,
+            ]]
+
+    def computeStatistics(self, multiThreaded, numberOfThreads=0):
+        shapeStat = vtkITK.vtkITKLabelShapeStatistics()
+        shapeStat.SetInputData(self.image)
+        for statistic in self.statistics:
+            shapeStat.ComputeShapeStatisticOn(statistic)
+        shapeStat.SetMultiThreaded(multiThreaded)
+        shapeStat.SetNumberOfThreads(numberOfThreads)
+        shapeStat.Update()
+        table = vtk.vtkTable()
+        table.DeepCopy(shapeStat.GetOutput())
+        return table
+
+    def getColumn(self, table, name):
+        column = table.GetColumnByName(name)
+        self.assertIsNotNone(column, name)
+        return ns.vtk_to_numpy(column)
+
+    def test_same_as_itk(self):
+        itkTable = self.computeStatistics(False)
+        table = self.computeStatistics(True)
+        self.assertTrue(numpy.array_equal(self.getColumn(table, "LabelValue"), [3, 5, 9]))
+        self.assertTrue(numpy.array_equal(self.getColumn(table, "LabelValue"), self.getColumn(itkTable, "LabelValue")))
+        for name in ["Volume", "Centroid", "FeretDiameter"]:
+            self.assertTrue(numpy.allclose(self.getColumn(table, name), self.getColumn(itkTable, name), rtol=1e-6), name)
+        # Estimates that may be computed slightly differently
+        for name in ["Perimeter", "PrincipalMoments", "OrientedBoundingBoxSize"]:
+            self.assertTrue(numpy.allclose(self.getColumn(table, name), self.getColumn(itkTable, name), rtol=0.05), name)
+
+    def test_threads(self):
+        table = self.computeStatistics(True, 1)
+        for numberOfThreads in [3, 8]:
+            otherTable = self.computeStatistics(True, numberOfThreads)
+            for name in self.statistics[:-2] + ["Volume", "OrientedBoundingBoxSize"]:
+                self.assertTrue(numpy.array_equal(self.getColumn(table, name), self.getColumn(otherTable, name)), name)
+
+    def runTest(self):
+        self.setUp()
+        self.test_same_as_itk()
+        self.test_threads()
@@ -0,0 +1,103 @@
+import unittest
+import vtk
+import vtkITK
+from vtk.util import numpy_support as ns
+import numpy
+
+"""
+To run as test from slicer python console, replace the following with your source tree path and paste:
+
+exec(open('/path/to/Slicer/Libs/vtkITK/Testing/vtkITKMorphologicalContourInterpolatorTest.py').read()); t = vtkITKMorphologicalContourInterpolatorTest(); t.runTest()
+"""
+
+class vtkITKMorphologicalContourInterpolatorTest(unittest.TestCase):
+    def setUp(self):
+        # Three labels, each segmented on every fourth slice
+        self.shape = (30, 40, 50)  # z, y, x
+        z, y, x = numpy.mgrid[0:self.shape[0], 0:self.shape[1], 0:self.shape[2]]
+        self.voxels = numpy.zeros(self.shape, dtype=numpy.int16)
+        segmentedSlices = (z % 4 == 1)
+        self.voxels[segmentedSlices & ((x - 12)**2 + (y - 12)**2 <= (4 + z // 4)**2)] = 1
+        self.voxels[segmentedSlices & (z < 20) & (x > 30) & (x < 45 - z // 3) & (y > 5) & (y < 15)] = 2
+        self.voxels[segmentedSlices & (z > 8) & ((x - 25)**2 + (y - 30)**2 <= 36)] = 4
+        self.image = self.createImage(self.voxels)
+
+    def createImage(self, voxels):
+        image = vtk.vtkImageData()
+        image.SetDimensions(self.shape[2], self.shape[1], self.shape[0])
+        image.SetSpacing(0.8, 0.8, 2.0)
+        image.AllocateScalars(vtk.VTK_SHORT, 1)
+        ns.vtk_to_numpy(image.GetPointData().GetScalars())[:] = voxels.ravel()
+        return image
+
+    def getVoxels(self, image):
+        return ns.vtk_to_numpy(image.GetPointData().GetScalars()).reshape(self.shape).copy()
+
+    def interpolateEachLabel(self):
+        # Reference: interpolate each label in the whole image, lower labels have priority
+        expected = self.voxels.copy()
+        for label in [1, 2, 4]:
+            interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
+            interpolator.SetInputData(self.image)
+            interpolator.SetLabel(label)
+            interpolator.Update()
+            labelVoxels = self.getVoxels(interpolator.GetOutput())
+            expected[(expected == 0) & (labelVoxels == label)] = label
+        return expected
+
+    def test_same_as_whole_image(self):
+        expected = self.interpolateEachLabel()
+        for numberOfThreads in [1, 3, 0]:
+            interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
+            interpolator.ProcessLabelsIndependentlyOn()
+            interpolator.SetNumberOfThreads(numberOfThreads)
+            interpolator.SetInputData(self.image)
+            interpolator.Update()
+            self.assertEqual(interpolator.GetNumberOfInterpolatedLabels(), 3)
+            voxels = self.getVoxels(interpolator.GetOutput())
+            self.assertTrue(numpy.array_equal(voxels, expected))
+            # Slices between segmented slices are filled
+            self.assertGreater(numpy.count_nonzero(voxels), numpy.count_nonzero(self.voxels))
+
+    def test_only_modified_labels_are_interpolated(self):
+        interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
+        interpolator.ProcessLabelsIndependentlyOn()
+        interpolator.SetInputData(self.image)
+        interpolator.Update()
+        self.assertEqual(interpolator.GetNumberOfInterpolatedLabels(), 3)
+
+        # Same input, everything is reused
+        self.image.Modified()
+        interpolator.Update()
+        self.assertEqual(interpolator.GetNumberOfInterpolatedLabels(), 0)
+
+        # Edit label 2 only
+        self.voxels[17, 8:12, 40:43] = 2
+        ns.vtk_to_numpy(self.image.GetPointData().GetScalars())[:] = self.voxels.ravel()
+        self.image.Modified()
+        interpolator.Update()
+        self.assertEqual(interpolator.GetNumberOfInterpolatedLabels(), 1)
+        voxels = self.getVoxels(interpolator.GetOutput())
+        self.assertTrue(numpy.array_equal(voxels, self.interpolateEachLabel()))
+
+        # Changing a parameter invalidates all the results
+        interpolator.SetUseDistanceTransform(True)
+        interpolator.Update()
+        self.assertEqual(interpolator.GetNumberOfInterpolatedLabels(), 3)
+
+        # Removed label is removed from the output
+        self.voxels[self.voxels == 4] = 0
+        ns.vtk_to_numpy(self.image.GetPointData().GetScalars())[:] = self.voxels.ravel()
+        self.image.Modified()
+        interpolator.Update()
+        self.assertEqual(interpolator.GetNumberOfInterpolatedLabels(), 0)
+        self.assertEqual(numpy.count_nonzero(self.getVoxels(interpolator.GetOutput()) == 4), 0)
+
+    def runTest(self):
+        self.setUp()
+        self.test_same_as_whole_image()
+        self.setUp()
+        self.test_only_modified_labels_are_interpolated()
+
+if __name__ == '__main__':
+    unittest.main()
@@ -5,8 +5,10 @@
 #include <itkImage.h>
 #include <itkArray.h>
 #include <itkImageSource.h>
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 #include <itkTimeSeriesDatabaseHelper.h>
 
 #define TimeSeriesBlockSize 16
@@ -101,6 +103,30 @@ public:
    */
   float GetCacheSizeInMiB ();
 
+  /** Number of blocks the cache can hold, and number of blocks needed
+   * to hold one complete image of the series.
+   */
+  unsigned long GetCacheSizeInBlocks ();
+  unsigned long GetNumberOfBlocksPerImage () const;
+
+  /** Load all the blocks of an image into the cache without generating
+   * any output.  This method may be called from a background thread
+   * (e.g. to read ahead the next images during cine playback) while
+   * GenerateData runs in another one.  Prefetched blocks are not counted
+   * in the cache statistics.  Returns early if AbortPrefetch is set.
+   */
+  void PrefetchImage ( unsigned int image );
+  void SetAbortPrefetch ( bool abort ) { this->m_AbortPrefetch = abort; }
+  bool GetAbortPrefetch () const { return this->m_AbortPrefetch; }
+
+  /** Cache statistics of the block lookups done by GenerateData and
+   * GetVoxelTimeSeries.  The hit rate is in [0,1], 0 if no lookup was done.
+   */
+  unsigned long GetCacheHits ();
+  unsigned long GetCacheMisses ();
+  double GetCacheHitRate ();
+  void ResetCacheStatistics ();
+
 
 protected:
   TimeSeriesDatabase();
@@ -146,7 +172,16 @@ protected:
     TPixel data[TimeSeriesBlockSize*TimeSeriesBlockSize*TimeSeriesBlockSize];
   };
   TimeSeriesDatabaseHelper::LRUCache<unsigned long, CacheBlock> m_Cache;
+  /// Return the cached block, reading it from disk on a miss.
+  /// m_CacheMutex must be locked while the returned block is used.
   CacheBlock* GetCacheBlock ( unsigned long index );
+  CacheBlock* ReadCacheBlock ( unsigned long index );
+
+  /// Guards the cache, the file streams and the statistics
+  std::mutex        m_CacheMutex;
+  unsigned long     m_CacheHits;
+  unsigned long     m_CacheMisses;
+  std::atomic<bool> m_AbortPrefetch;
 };
 
 } // end namespace itk
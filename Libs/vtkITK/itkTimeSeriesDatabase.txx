@@ -60,12 +60,15 @@ bool TimeSeriesDatabase<TPixel>::IsOpen () const
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::Disconnect ()
 {
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
   for ( int idx = 0; idx < this->m_DatabaseFiles.size(); idx++ )
     {
     this->m_DatabaseFiles[idx]->close();
     }
   this->m_DatabaseFiles.clear();
   this->m_DatabaseFileNames.clear();
+  // Cached blocks are only valid for the database they were read from
+  this->m_Cache.clear();
 }
 
 template <class TPixel>
@@ -115,6 +118,10 @@ void TimeSeriesDatabase<TPixel>::Connect ( const char* filename )
     m_BlocksPerImage[idx] = (unsigned int) ceil ( m_Dimensions[idx] / (float)TimeSeriesBlockSize );
     }
   // Number of files
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  this->m_Cache.clear();
+  this->m_CacheHits = 0;
+  this->m_CacheMisses = 0;
   o >> dummy >> this->m_BlocksPerFile;
   int NumberOfFiles;
   o >> dummy >> NumberOfFiles;
@@ -183,24 +190,61 @@ template <class TPixel>
 }
 
 
+template <class TPixel>
+typename TimeSeriesDatabase<TPixel>::CacheBlock* TimeSeriesDatabase<TPixel>::ReadCacheBlock ( unsigned long index )
+{
+  CacheBlock B;
+  int FileIdx = this->CalculateFileIndex ( index );
+
+  this->m_DatabaseFiles[FileIdx]->seekg ( this->CalculatePosition ( index, this->m_BlocksPerFile ) );
+  this->m_DatabaseFiles[FileIdx]->read ( reinterpret_cast<char*> ( B.data ), TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
+  this->m_Cache.insert ( index, B );
+  return this->m_Cache.find ( index );
+}
+
+
 template <class TPixel>
 typename TimeSeriesDatabase<TPixel>::CacheBlock* TimeSeriesDatabase<TPixel>::GetCacheBlock ( unsigned long index )
 {
   CacheBlock* Buffer = this->m_Cache.find ( index );
   if ( Buffer == nullptr ) {
-    // Fill it in
-    CacheBlock B;
-    int FileIdx = this->CalculateFileIndex ( index );
-
-    this->m_DatabaseFiles[FileIdx]->seekg ( this->CalculatePosition ( index, this->m_BlocksPerFile ) );
-    this->m_DatabaseFiles[FileIdx]->read ( reinterpret_cast<char*> ( B.data ), TimeSeriesVolumeBlockSize * sizeof ( TPixel ) );
-    this->m_Cache.insert ( index, B );
-    Buffer = this->m_Cache.find ( index );
+    this->m_CacheMisses++;
+    Buffer = this->ReadCacheBlock ( index );
+  } else {
+    this->m_CacheHits++;
   }
   return Buffer;
 }
 
 
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::PrefetchImage ( unsigned int image )
+{
+  if ( !this->IsOpen() || image >= this->m_Dimensions[3] )
+    {
+    return;
+    }
+  Size<3> CurrentBlock;
+  for ( CurrentBlock[2] = 0; CurrentBlock[2] < this->m_BlocksPerImage[2]; CurrentBlock[2]++ ) {
+    for ( CurrentBlock[1] = 0; CurrentBlock[1] < this->m_BlocksPerImage[1]; CurrentBlock[1]++ ) {
+      for ( CurrentBlock[0] = 0; CurrentBlock[0] < this->m_BlocksPerImage[0]; CurrentBlock[0]++ ) {
+        if ( this->m_AbortPrefetch )
+          {
+          return;
+          }
+        // Lock per block so that GenerateData is never stalled for a whole image
+        std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+        unsigned long index = this->CalculateIndex ( CurrentBlock, image );
+        if ( this->m_Cache.find ( index ) == nullptr )
+          {
+          this->ReadCacheBlock ( index );
+          }
+        }
+      }
+    }
+}
+
+
 template <class TPixel>
 void TimeSeriesDatabase<TPixel>::GetVoxelTimeSeries ( typename OutputImageType::IndexType idx, ArrayType& array )
 {
@@ -209,16 +253,17 @@ void TimeSeriesDatabase<TPixel>::GetVoxelTimeSeries ( typename OutputImageType::
   Size<3> CurrentBlock;
   Size<3> Offset;
   for ( int i = 0; i < 3; i++ ) {
-    if ( idx[i] < 0 || idx[i] > this->m_OutputRegion.Size[i] ) {
-      throw 1;
+    if ( idx[i] < 0 || static_cast<SizeValueType>( idx[i] ) >= this->m_OutputRegion.GetSize ( i ) ) {
+      itkExceptionMacro ( "TimeSeriesDatabase::GetVoxelTimeSeries: index " << idx << " is outside of the image" );
     }
-    CurrentBlock[i] = reinterpret_cast<unsigned long> ( idx[i] / (double)TimeSeriesBlockSize );
+    CurrentBlock[i] = idx[i] / TimeSeriesBlockSize;
     Offset[i] = idx[i] % TimeSeriesBlockSize;
   }
   unsigned long offset = Offset[0] + Offset[1] * TimeSeriesBlockSize + Offset[2] * TimeSeriesBlockSizeP2;
   array = ArrayType ( this->m_Dimensions[3] );
-  for ( int volume = 0; volume < this->m_Dimensions[3]; volume++ ) {
-    CacheBlock* cache = this->GetCacheBlock ( CurrentBlock, volume );
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  for ( unsigned int volume = 0; volume < this->m_Dimensions[3]; volume++ ) {
+    CacheBlock* cache = this->GetCacheBlock ( this->CalculateIndex ( CurrentBlock, volume ) );
     array[volume] = cache->data[offset];
   }
 }
@@ -264,7 +309,7 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
     }
 
   Size<3> CurrentBlock;
-  // Now, read our data, caching as we go, in future, make this thread safe
+  // Now, read our data, caching as we go
   Size<3> BlockSize = { {TimeSeriesBlockSize, TimeSeriesBlockSize, TimeSeriesBlockSize }};
   ImageRegion<3> BlockRegion;
   BlockRegion.SetSize ( BlockSize );
@@ -275,6 +320,8 @@ void TimeSeriesDatabase<TPixel>::GenerateData()
         typename OutputImageType::RegionType BR, IR;
         if ( print ) {  std::cout << "For Block Index: " << CurrentBlock << std::endl; }
         unsigned long index = this->CalculateIndex ( CurrentBlock, this->m_CurrentImage );
+        // A concurrent prefetch may evict the block, hold the lock while copying it
+        std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
         CacheBlock* Buffer = this->GetCacheBlock ( index );
         if ( this->CalculateIntersection ( CurrentBlock, Region, BR, IR ) ) {
           // Just iterate over whole block
@@ -560,7 +607,7 @@ void TimeSeriesDatabase<TPixel>::CreateFromFileArchetype ( const char* TSDFilena
 template <class TPixel>
 float TimeSeriesDatabase<TPixel>::GetCacheSizeInMiB()
 {
-  unsigned cachesize = this->m_Cache.get_maxsize();
+  unsigned cachesize = this->GetCacheSizeInBlocks();
   return (float) cachesize * sizeof ( TPixel ) * TimeSeriesVolumeBlockSize / ( 1024*1024.);
 }
 
@@ -569,15 +616,62 @@ void TimeSeriesDatabase<TPixel>::SetCacheSizeInMiB ( float sz )
 {
   // How many blocks is this?
   double BlockSizeInMiB = sizeof ( TPixel ) * TimeSeriesVolumeBlockSize / ( 1024*1024.);
-  unsigned long int blocks = (unsigned long int) ceil ( sz * BlockSizeInMiB );
+  unsigned long int blocks = (unsigned long int) TSD_MAX ( 1.0, ceil ( sz / BlockSizeInMiB ) );
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
   this->m_Cache.set_maxsize ( blocks );
 }
 
+template <class TPixel>
+unsigned long TimeSeriesDatabase<TPixel>::GetCacheSizeInBlocks()
+{
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  return this->m_Cache.get_maxsize();
+}
+
+template <class TPixel>
+unsigned long TimeSeriesDatabase<TPixel>::GetNumberOfBlocksPerImage() const
+{
+  return static_cast<unsigned long>( this->m_BlocksPerImage[0] ) * this->m_BlocksPerImage[1] * this->m_BlocksPerImage[2];
+}
+
+template <class TPixel>
+unsigned long TimeSeriesDatabase<TPixel>::GetCacheHits()
+{
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  return this->m_CacheHits;
+}
+
+template <class TPixel>
+unsigned long TimeSeriesDatabase<TPixel>::GetCacheMisses()
+{
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  return this->m_CacheMisses;
+}
+
+template <class TPixel>
+double TimeSeriesDatabase<TPixel>::GetCacheHitRate()
+{
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  unsigned long lookups = this->m_CacheHits + this->m_CacheMisses;
+  return lookups > 0 ? this->m_CacheHits / (double) lookups : 0.0;
+}
+
+template <class TPixel>
+void TimeSeriesDatabase<TPixel>::ResetCacheStatistics()
+{
+  std::lock_guard<std::mutex> lock ( this->m_CacheMutex );
+  this->m_CacheHits = 0;
+  this->m_CacheMisses = 0;
+}
+
 template <class TPixel>
 TimeSeriesDatabase<TPixel>::TimeSeriesDatabase ()
-: m_Cache ( 1024 )
-, m_CurrentImage(0)
+: m_CurrentImage(0)
 , m_BlocksPerFile(0)
+, m_Cache ( 1024 )
+, m_CacheHits(0)
+, m_CacheMisses(0)
+, m_AbortPrefetch(false)
 {
   this->m_Dimensions.SetSize ( 4 );
   this->m_BlocksPerImage.SetSize ( 4 );
@@ -613,6 +707,8 @@ TimeSeriesDatabase<TPixel>
   } else {
     os << indent << "Database is closed." << "\n";
   }
+  os << indent << "CacheHits: " << m_CacheHits << "\n";
+  os << indent << "CacheMisses: " << m_CacheMisses << "\n";
 
   this->m_Cache.statistics ( os );
 }
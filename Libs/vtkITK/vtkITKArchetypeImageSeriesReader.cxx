@@ -26,7 +26,15 @@
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
+#include <vtkSQLiteDatabase.h>
+#include <vtkSQLQuery.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
+#include <vtkStringArray.h>
+#include <vtkVariant.h>
+#include <vtksys/SystemTools.hxx>
+
+// vtkAddon includes
+#include <vtkAddonThreadingUtilities.h>
 
 // ITK includes
 #include <itkNiftiImageIO.h>
@@ -39,6 +47,8 @@
 
 // STD includes
 #include <algorithm>
+#include <functional>
+#include <set>
 #include <vector>
 
 #include "itkArchetypeSeriesFileNames.h"
@@ -52,6 +62,123 @@
 
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
 
+namespace
+{
+
+/// DICOM tags analyzed to group and sort the files, with the name of the
+/// header index column they are stored in.
+enum
+  {
+  SeriesInstanceUIDTag = 0,
+  ContentTimeTag,
+  TriggerTimeTag,
+  EchoNumbersTag,
+  DiffusionGradientOrientationTag,
+  SliceLocationTag,
+  ImageOrientationPatientTag,
+  ImagePositionPatientTag,
+  NumberOfTags
+  };
+const char* const DICOMTags[NumberOfTags][2] =
+  {
+  { "0020|000e", "SeriesInstanceUID" },
+  { "0008|0033", "ContentTime" },
+  { "0018|1060", "TriggerTime" },
+  { "0018|0086", "EchoNumbers" },
+  { "0010|9089", "DiffusionGradientOrientation" },
+  { "0020|1041", "SliceLocation" },
+  { "0020|0037", "ImageOrientationPatient" },
+  { "0020|0032", "ImagePositionPatient" },
+  };
+
+//----------------------------------------------------------------------------
+/// Open the header index file and create its table if needed.
+/// Return nullptr if the index cannot be opened.
+vtkSmartPointer<vtkSQLiteDatabase> OpenHeaderIndexDatabase(const std::string& indexFileName)
+{
+  vtkSmartPointer<vtkSQLiteDatabase> database = vtkSmartPointer<vtkSQLiteDatabase>::New();
+  database->SetDatabaseFileName(indexFileName.c_str());
+  if (!database->Open("", vtkSQLiteDatabase::USE_EXISTING_OR_CREATE))
+    {
+    vtkGenericWarningMacro("vtkITKArchetypeImageSeriesReader: cannot open DICOM header index " << indexFileName
+                           << ", headers are parsed from the files");
+    return nullptr;
+    }
+
+  std::string createTable = "CREATE TABLE IF NOT EXISTS DICOMHeaderIndex "
+                            "(FileName TEXT PRIMARY KEY, ModifiedTime INTEGER, FileSize INTEGER";
+  for (int t = 0; t < NumberOfTags; ++t)
+    {
+    createTable += std::string(", ") + DICOMTags[t][1] + " TEXT";
+    }
+  createTable += ")";
+  vtkSmartPointer<vtkSQLQuery> query = vtkSmartPointer<vtkSQLQuery>::Take(database->GetQueryInstance());
+  query->SetQuery(createTable.c_str());
+  if (!query->Execute())
+    {
+    vtkGenericWarningMacro("vtkITKArchetypeImageSeriesReader: cannot create the header index table in " << indexFileName
+                           << ": " << query->GetLastErrorText());
+    return nullptr;
+    }
+  return database;
+}
+
+//----------------------------------------------------------------------------
+/// Delete the rows of the files for which isRemoved returns true, in a single transaction.
+/// Return the number of deleted rows, or -1 on error. A missing index file is not created.
+int RemoveHeaderIndexRows(const char* indexFileName, const std::function<bool(const std::string&)>& isRemoved)
+{
+  if (!indexFileName || !indexFileName[0] || !vtksys::SystemTools::FileExists(indexFileName, true))
+    {
+    return 0;
+    }
+  vtkSmartPointer<vtkSQLiteDatabase> database = OpenHeaderIndexDatabase(indexFileName);
+  if (!database)
+    {
+    return -1;
+    }
+
+  std::vector<std::string> removedFileNames;
+  vtkSmartPointer<vtkSQLQuery> query = vtkSmartPointer<vtkSQLQuery>::Take(database->GetQueryInstance());
+  query->SetQuery("SELECT FileName FROM DICOMHeaderIndex");
+  if (!query->Execute())
+    {
+    vtkGenericWarningMacro("vtkITKArchetypeImageSeriesReader: cannot read the header index " << indexFileName
+                           << ": " << query->GetLastErrorText());
+    return -1;
+    }
+  while (query->NextRow())
+    {
+    std::string fileName = query->DataValue(0).ToString();
+    if (isRemoved(fileName))
+      {
+      removedFileNames.push_back(fileName);
+      }
+    }
+  if (removedFileNames.empty())
+    {
+    return 0;
+    }
+
+  query->BeginTransaction();
+  query->SetQuery("DELETE FROM DICOMHeaderIndex WHERE FileName = ?");
+  for (const std::string& fileName : removedFileNames)
+    {
+    query->BindParameter(0, vtkVariant(vtkStdString(fileName)));
+    if (!query->Execute())
+      {
+      vtkGenericWarningMacro("vtkITKArchetypeImageSeriesReader: cannot remove " << fileName
+                             << " from the header index: " << query->GetLastErrorText());
+      query->RollbackTransaction();
+      return -1;
+      }
+    }
+  query->CommitTransaction();
+  return static_cast<int>(removedFileNames.size());
+}
+
+}
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
 {
@@ -72,6 +199,12 @@ vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
 #ifdef VTKITK_BUILD_DICOM_SUPPORT
   this->DICOMImageIOApproach = vtkITKArchetypeImageSeriesReader::GDCM;
 #endif
+  this->NumberOfThreads = 0;
+  this->HeaderIndexFileName = nullptr;
+  this->NumberOfIndexedHeaders = 0;
+  this->HeaderScanTime = 0.0;
+  this->PixelDecodeTime = 0.0;
+  this->ReorientTime = 0.0;
 
   this->OutputScalarType = VTK_FLOAT;
   this->NumberOfComponents = 0;
@@ -116,6 +249,7 @@ vtkITKArchetypeImageSeriesReader::~vtkITKArchetypeImageSeriesReader()
     delete [] this->Archetype;
     this->Archetype = nullptr;
     }
+  this->SetHeaderIndexFileName(nullptr);
  if (RasToIjkMatrix)
    {
    this->RasToIjkMatrix->Delete();
@@ -181,6 +315,20 @@ void vtkITKArchetypeImageSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
 #else
   os << indent << "DICOMImageIOApproach: " << "NA";
 #endif
+  os << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "HeaderIndexFileName: " <<
+    (this->HeaderIndexFileName ? this->HeaderIndexFileName : "(none)") << "\n";
+  os << indent << "NumberOfIndexedHeaders: " << this->NumberOfIndexedHeaders << "\n";
+  os << indent << "HeaderScanTime: " << this->HeaderScanTime << "\n";
+  os << indent << "PixelDecodeTime: " << this->PixelDecodeTime << "\n";
+  os << indent << "ReorientTime: " << this->ReorientTime << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkITKArchetypeImageSeriesReader::GetNumberOfThreadsToUse()
+{
+  return vtkAddonThreadingUtilities::GetNumberOfThreadsToUse(this->NumberOfThreads);
 }
 
 //----------------------------------------------------------------------------
@@ -1208,6 +1356,129 @@ std::string vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(const itk
   return tagValue;
 }
 
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkSQLiteDatabase> vtkITKArchetypeImageSeriesReader::OpenHeaderIndex()
+{
+  if (!this->HeaderIndexFileName || !this->HeaderIndexFileName[0])
+    {
+    return nullptr;
+    }
+  return OpenHeaderIndexDatabase(this->HeaderIndexFileName);
+}
+
+//----------------------------------------------------------------------------
+int vtkITKArchetypeImageSeriesReader::RemoveFromHeaderIndex(const char* indexFileName, vtkStringArray* fileNames)
+{
+  if (!fileNames)
+    {
+    return 0;
+    }
+  std::set<std::string> removedFileNames;
+  for (vtkIdType i = 0; i < fileNames->GetNumberOfValues(); ++i)
+    {
+    removedFileNames.insert(fileNames->GetValue(i));
+    }
+  return RemoveHeaderIndexRows(indexFileName, [&](const std::string& fileName)
+    {
+    return removedFileNames.count(fileName) > 0;
+    });
+}
+
+//----------------------------------------------------------------------------
+int vtkITKArchetypeImageSeriesReader::PruneHeaderIndex(const char* indexFileName, vtkStringArray* fileNamesToKeep)
+{
+  if (!fileNamesToKeep)
+    {
+    return RemoveHeaderIndexRows(indexFileName, [](const std::string& fileName)
+      {
+      return !vtksys::SystemTools::FileExists(fileName, true);
+      });
+    }
+  std::set<std::string> keptFileNames;
+  for (vtkIdType i = 0; i < fileNamesToKeep->GetNumberOfValues(); ++i)
+    {
+    keptFileNames.insert(fileNamesToKeep->GetValue(i));
+    }
+  return RemoveHeaderIndexRows(indexFileName, [&](const std::string& fileName)
+    {
+    return keptFileNames.count(fileName) == 0;
+    });
+}
+
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::ReadHeaderIndex(vtkSQLiteDatabase* database,
+                                                       std::vector<std::string>& fileTagValues,
+                                                       std::vector<int>& filesToParse)
+{
+  std::string select = "SELECT ModifiedTime, FileSize";
+  for (int t = 0; t < NumberOfTags; ++t)
+    {
+    select += std::string(", ") + DICOMTags[t][1];
+    }
+  select += " FROM DICOMHeaderIndex WHERE FileName = ?";
+  vtkSmartPointer<vtkSQLQuery> query = vtkSmartPointer<vtkSQLQuery>::Take(database->GetQueryInstance());
+  query->SetQuery(select.c_str());
+
+  int nFiles = this->AllFileNames.size();
+  for (int f = 0; f < nFiles; f++)
+    {
+    const std::string& fileName = this->AllFileNames[f];
+    // Rows of files that were modified since they were indexed are stale
+    bool indexed = false;
+    query->BindParameter(0, vtkVariant(vtkStdString(fileName)));
+    if (query->Execute() && query->NextRow()
+      && query->DataValue(0).ToTypeInt64() == vtksys::SystemTools::ModifiedTime(fileName)
+      && query->DataValue(1).ToTypeInt64() == static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(fileName)))
+      {
+      for (int t = 0; t < NumberOfTags; ++t)
+        {
+        fileTagValues[f * NumberOfTags + t] = query->DataValue(2 + t).ToString();
+        }
+      indexed = true;
+      }
+    if (!indexed)
+      {
+      filesToParse.push_back(f);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::WriteHeaderIndex(vtkSQLiteDatabase* database,
+                                                        const std::vector<std::string>& fileTagValues,
+                                                        const std::vector<int>& parsedFiles)
+{
+  std::string insert = "INSERT OR REPLACE INTO DICOMHeaderIndex VALUES (?, ?, ?";
+  for (int t = 0; t < NumberOfTags; ++t)
+    {
+    insert += ", ?";
+    }
+  insert += ")";
+  vtkSmartPointer<vtkSQLQuery> query = vtkSmartPointer<vtkSQLQuery>::Take(database->GetQueryInstance());
+  // A single transaction, committing each row would sync the file every time
+  query->BeginTransaction();
+  query->SetQuery(insert.c_str());
+  for (int f : parsedFiles)
+    {
+    const std::string& fileName = this->AllFileNames[f];
+    query->BindParameter(0, vtkVariant(vtkStdString(fileName)));
+    query->BindParameter(1, vtkVariant(static_cast<vtkTypeInt64>(vtksys::SystemTools::ModifiedTime(fileName))));
+    query->BindParameter(2, vtkVariant(static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(fileName))));
+    for (int t = 0; t < NumberOfTags; ++t)
+      {
+      query->BindParameter(3 + t, vtkVariant(vtkStdString(fileTagValues[f * NumberOfTags + t])));
+      }
+    if (!query->Execute())
+      {
+      vtkWarningMacro("WriteHeaderIndex: cannot add " << fileName << " to the header index: "
+                      << query->GetLastErrorText());
+      query->RollbackTransaction();
+      return;
+      }
+    }
+  query->CommitTransaction();
+}
+
 //----------------------------------------------------------------------------
 void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
 {
@@ -1311,24 +1582,61 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       idx = this->InsertImageOrientationPatient( sliceOrientation );
       this->IndexImageOrientationPatient[f] = idx;
       }
+    AnalyzeTime.Stop();
+    this->HeaderScanTime = AnalyzeTime.GetTotal();
     return;
     }
 
   // if Archetype is a Dicom File
-  gdcmIO->SetFileName( this->Archetype );
-  for (int f = 0; f < nFiles; f++)
+  // Tags of the files that are unchanged since they were added to the header
+  // index are not parsed again.
+  std::vector<std::string> fileTagValues(nFiles * NumberOfTags);
+  std::vector<int> filesToParse;
+  vtkSmartPointer<vtkSQLiteDatabase> headerIndex = this->OpenHeaderIndex();
+  if (headerIndex)
     {
-    gdcmIO->SetFileName( this->AllFileNames[f] );
-    gdcmIO->ReadImageInformation();
-    itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
-    std::string tagValue;
+    this->ReadHeaderIndex(headerIndex, fileTagValues, filesToParse);
+    }
+  else
+    {
+    for (int f = 0; f < nFiles; f++)
+      {
+      filesToParse.push_back(f);
+      }
+    }
+  this->NumberOfIndexedHeaders = nFiles - static_cast<int>(filesToParse.size());
 
+  // The headers are parsed concurrently, each file with its own ImageIO.
+  // The tag values are then inserted in file order so that the indices do
+  // not depend on the number of threads.
+  vtkAddonThreadingUtilities::ParallelFor(this->GetNumberOfThreadsToUse(), static_cast<int>(filesToParse.size()), [&](int i)
+    {
+    int f = filesToParse[i];
+    itk::GDCMImageIO::Pointer fileIO = itk::GDCMImageIO::New();
+    fileIO->SetFileName( this->AllFileNames[f] );
+    fileIO->ReadImageInformation();
+    itk::MetaDataDictionary &dict = fileIO->GetMetaDataDictionary();
     // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
     // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
     // multi-value separator backslashes.
+    for (int t = 0; t < NumberOfTags; ++t)
+      {
+      fileTagValues[f * NumberOfTags + t] =
+        vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, DICOMTags[t][0]);
+      }
+    });
+  if (headerIndex && !filesToParse.empty())
+    {
+    this->WriteHeaderIndex(headerIndex, fileTagValues, filesToParse);
+    }
+
+  for (int f = 0; f < nFiles; f++)
+    {
+    const std::string* fileTags = &fileTagValues[f * NumberOfTags];
+    std::string tagValue;
 
     // series instance UID
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|000e");
+    tagValue = fileTags[SeriesInstanceUIDTag];
     if (!tagValue.empty())
       {
       int idx = InsertSeriesInstanceUIDs( tagValue.c_str() );
@@ -1340,7 +1648,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // content time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0008|0033");
+    tagValue = fileTags[ContentTimeTag];
     if (!tagValue.empty())
       {
       int idx = InsertContentTime( tagValue.c_str() );
@@ -1352,7 +1660,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // trigger time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|1060");
+    tagValue = fileTags[TriggerTimeTag];
     if (!tagValue.empty())
       {
       int idx = InsertTriggerTime( tagValue.c_str() );
@@ -1364,7 +1672,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // echo numbers
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|0086");
+    tagValue = fileTags[EchoNumbersTag];
     if (!tagValue.empty())
       {
       int idx = InsertEchoNumbers( tagValue.c_str() );
@@ -1376,7 +1684,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // diffision gradient orientation
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0010|9089");
+    tagValue = fileTags[DiffusionGradientOrientationTag];
     if (!tagValue.empty())
       {
       float a[3] = { -1 };
@@ -1390,7 +1698,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // slice location
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|1041");
+    tagValue = fileTags[SliceLocationTag];
     if (!tagValue.empty())
       {
       float a = -1;
@@ -1404,7 +1712,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // image orientation patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0037");
+    tagValue = fileTags[ImageOrientationPatientTag];
     if (!tagValue.empty())
       {
       float a[6] = { -1 };
@@ -1417,7 +1725,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       this->IndexImageOrientationPatient[f] = -1;
       }
     // image position patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0032");
+    tagValue = fileTags[ImagePositionPatientTag];
     if (!tagValue.empty())
       {
       float a[3] = { -1 };
@@ -1432,8 +1740,10 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
   AnalyzeTime.Stop();
-
-  // double timeelapsed = AnalyzeTime.GetMean(); UNUSED
+  this->HeaderScanTime = AnalyzeTime.GetTotal();
+  vtkDebugMacro("AnalyzeDicomHeaders: scanned " << nFiles << " files ("
+                << this->NumberOfIndexedHeaders << " from the header index) in "
+                << this->HeaderScanTime << "s");
   AnalyzeHeader = false;
 #endif
 }
@@ -20,7 +20,10 @@ Version:   $Revision$
 
 // VTK includes
 #include "vtkImageAlgorithm.h"
+#include "vtkSmartPointer.h"
 class vtkMatrix4x4;
+class vtkSQLiteDatabase;
+class vtkStringArray;
 
 // ITK includes
 #include "itkImageIOBase.h"
@@ -226,6 +229,49 @@ public:
   void SetDICOMImageIOApproachToGDCM() {this->SetDICOMImageIOApproach(vtkITKArchetypeImageSeriesReader::GDCM);};
   void SetDICOMImageIOApproachToDCMTK() {this->SetDICOMImageIOApproach(vtkITKArchetypeImageSeriesReader::DCMTK);};
 
+  ///
+  /// Number of threads used to scan the DICOM headers and to decode the
+  /// slices of a series. Slices are decoded concurrently directly
+  /// into the output buffer, in the sorted file order.
+  /// 0 (default) uses all the available cores, 1 reads the files sequentially.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  ///
+  /// SQLite file of the persistent DICOM header index, created if it does
+  /// not exist. The tags used to group and sort the DICOM files are stored in
+  /// the index, and are read from it instead of parsing the headers again as
+  /// long as the modification time and size of the file are unchanged.
+  /// Empty by default, which disables the index.
+  vtkSetStringMacro(HeaderIndexFileName);
+  vtkGetStringMacro(HeaderIndexFileName);
+
+  ///
+  /// Remove the rows of fileNames from a header index, for example when the
+  /// files are removed from the DICOM database.
+  /// Return the number of removed rows, or -1 if the index cannot be updated.
+  static int RemoveFromHeaderIndex(const char* indexFileName, vtkStringArray* fileNames);
+
+  ///
+  /// Remove the rows of all the files that are not in fileNamesToKeep from a
+  /// header index. If fileNamesToKeep is nullptr then the rows of the files
+  /// that do not exist anymore are removed.
+  /// Return the number of removed rows, or -1 if the index cannot be updated.
+  static int PruneHeaderIndex(const char* indexFileName, vtkStringArray* fileNamesToKeep);
+
+  ///
+  /// Number of files whose tags were read from the header index instead of
+  /// the file by the last header analysis.
+  vtkGetMacro(NumberOfIndexedHeaders, int);
+
+  ///
+  /// Time in seconds spent by the last read in each stage: scanning the
+  /// DICOM headers of all the candidate files, decoding the pixels of the
+  /// slices and reorienting the volume.
+  vtkGetMacro(HeaderScanTime, double);
+  vtkGetMacro(PixelDecodeTime, double);
+  vtkGetMacro(ReorientTime, double);
+
   ///
   /// Get the file format.  Pixels are this type in the file.
   vtkSetMacro(OutputScalarType, int);
@@ -841,6 +887,27 @@ protected:
 
   int DICOMImageIOApproach;
 
+  int NumberOfThreads;
+  char* HeaderIndexFileName;
+  int NumberOfIndexedHeaders;
+  double HeaderScanTime;
+  double PixelDecodeTime;
+  double ReorientTime;
+
+  /// Number of threads resolved from NumberOfThreads, at least 1.
+  int GetNumberOfThreadsToUse();
+
+  /// Open the header index and create its table if needed.
+  /// Return nullptr if there is no header index or it cannot be opened.
+  vtkSmartPointer<vtkSQLiteDatabase> OpenHeaderIndex();
+  /// Copy the tag values of the indexed files of AllFileNames that are
+  /// unchanged into fileTagValues, and add the others to filesToParse.
+  void ReadHeaderIndex(vtkSQLiteDatabase* database, std::vector<std::string>& fileTagValues,
+                       std::vector<int>& filesToParse);
+  /// Add or update the tag values of parsedFiles in the header index.
+  void WriteHeaderIndex(vtkSQLiteDatabase* database, const std::vector<std::string>& fileTagValues,
+                        const std::vector<int>& parsedFiles);
+
   bool GroupingByTags;
   int SelectedUID;
   int SelectedContentTime;
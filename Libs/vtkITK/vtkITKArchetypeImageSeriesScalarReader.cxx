@@ -27,14 +27,22 @@
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkVersion.h>
 
+// vtkAddon includes
+#include <vtkAddonThreadingUtilities.h>
+
 // ITK includes
 #include <itkOrientImageFilter.h>
 #include <itkImageSeriesReader.h>
+#include <itkTimeProbe.h>
 #ifdef VTKITK_BUILD_DICOM_SUPPORT
 #include <itkDCMTKImageIO.h>
 #include <itkGDCMImageIO.h>
 #endif
 
+// STD includes
+#include <atomic>
+#include <thread>
+
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesScalarReader);
 
 namespace {
@@ -62,6 +70,65 @@ void vtkITKArchetypeImageSeriesScalarReader::PrintSelf(ostream& os, vtkIndent in
   os << indent << "vtk ITK Archetype Image Series Scalar Reader\n";
 }
 
+//----------------------------------------------------------------------------
+template <class TImage>
+typename TImage::Pointer vtkITKArchetypeImageSeriesScalarReader::ReadSeriesInParallel(
+  itk::ImageSeriesReader<TImage>* seriesReader, itk::ImageIOBase* imageIO)
+{
+  // Only the headers are read to compute the volume geometry
+  seriesReader->UpdateOutputInformation();
+  TImage* seriesOutput = seriesReader->GetOutput();
+  typename TImage::RegionType region = seriesOutput->GetLargestPossibleRegion();
+  typename TImage::SizeType size = region.GetSize();
+  int numberOfSlices = static_cast<int>(this->FileNames.size());
+  if (static_cast<int>(size[2]) != numberOfSlices)
+    {
+    // multi-frame files
+    return nullptr;
+    }
+
+  typename TImage::Pointer image = TImage::New();
+  image->CopyInformation(seriesOutput);
+  image->SetRegions(region);
+  image->Allocate();
+  typename TImage::PixelType* buffer = image->GetBufferPointer();
+  const size_t sliceLength = static_cast<size_t>(size[0]) * size[1];
+
+  // Each slice has its own ImageIO. Without an ImageIO (non-DICOM series)
+  // the slice reader gets one from the ImageIO factory.
+  const std::thread::id mainThreadId = std::this_thread::get_id();
+  std::atomic<int> numberOfReadSlices(0);
+  vtkAddonThreadingUtilities::ParallelFor(this->GetNumberOfThreadsToUse(), numberOfSlices, [&](int slice)
+    {
+    typename itk::ImageFileReader<TImage>::Pointer sliceReader = itk::ImageFileReader<TImage>::New();
+    if (imageIO)
+      {
+      itk::ImageIOBase::Pointer sliceIO = dynamic_cast<itk::ImageIOBase*>(imageIO->CreateAnother().GetPointer());
+      sliceReader->SetImageIO(sliceIO);
+      }
+    sliceReader->SetFileName(this->FileNames[slice]);
+    sliceReader->Update();
+    TImage* sliceImage = sliceReader->GetOutput();
+    typename TImage::SizeType sliceSize = sliceImage->GetLargestPossibleRegion().GetSize();
+    if (sliceSize[0] != size[0] || sliceSize[1] != size[1] || sliceSize[2] != 1)
+      {
+      itkGenericExceptionMacro("Size mismatch! The size of " << this->FileNames[slice] << " is "
+                               << sliceSize << " and does not match the required size "
+                               << size[0] << "x" << size[1] << " from file " << this->FileNames[0]);
+      }
+    std::copy(sliceImage->GetBufferPointer(), sliceImage->GetBufferPointer() + sliceLength,
+              buffer + slice * sliceLength);
+
+    // Observers are only notified in the thread that executes the reader
+    ++numberOfReadSlices;
+    if (std::this_thread::get_id() == mainThreadId)
+      {
+      this->UpdateProgress(static_cast<double>(numberOfReadSlices) / numberOfSlices);
+      }
+    });
+  return image;
+}
+
 //----------------------------------------------------------------------------
 // This function reads a data from a file.  The datas extent/axes
 // are assumed to be the same as the file extent/order.
@@ -119,8 +186,6 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
     case typeN: \
     {\
       typedef itk::Image<type,3> image##typeN;\
-      typedef itk::ImageSource<image##typeN> FilterType; \
-      FilterType::Pointer filter; \
       itk::ImageSeriesReader<image##typeN>::Pointer reader##typeN = \
         itk::ImageSeriesReader<image##typeN>::New(); \
       vtkITKExecuteDataDeclareDICOMImageIO \
@@ -134,23 +199,39 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
       reader##typeN->AddObserver(itk::ProgressEvent(),pcl); \
       reader##typeN->SetFileNames(this->FileNames); \
       reader##typeN->ReleaseDataFlagOn(); \
-      if (this->UseNativeCoordinateOrientation) \
+      itk::TimeProbe decodeTime; \
+      decodeTime.Start(); \
+      image##typeN::Pointer image; \
+      if (this->GetNumberOfThreadsToUse() > 1) \
         { \
-        filter = reader##typeN; \
+        image = this->ReadSeriesInParallel<image##typeN>(reader##typeN, this->ArchetypeIsDICOM ? imageIO.GetPointer() : nullptr); \
         } \
-      else \
+      if (!image) \
+        { \
+        reader##typeN->UpdateLargestPossibleRegion(); \
+        image = reader##typeN->GetOutput(); \
+        } \
+      decodeTime.Stop(); \
+      this->PixelDecodeTime = decodeTime.GetTotal(); \
+      itk::TimeProbe reorientTime; \
+      reorientTime.Start(); \
+      if (!this->UseNativeCoordinateOrientation) \
         { \
         itk::OrientImageFilter<image##typeN,image##typeN>::Pointer orient##typeN = \
             itk::OrientImageFilter<image##typeN,image##typeN>::New(); \
         if (this->Debug) {orient##typeN->DebugOn();} \
-        orient##typeN->SetInput(reader##typeN->GetOutput()); \
+        orient##typeN->SetInput(image); \
         orient##typeN->UseImageDirectionOn(); \
         orient##typeN->SetDesiredCoordinateOrientation(this->DesiredCoordinateOrientation); \
-        filter = orient##typeN; \
+        orient##typeN->UpdateLargestPossibleRegion(); \
+        image = orient##typeN->GetOutput(); \
         }\
-      filter->UpdateLargestPossibleRegion(); \
+      reorientTime.Stop(); \
+      this->ReorientTime = reorientTime.GetTotal(); \
+      vtkDebugMacro("Read " << this->FileNames.size() << " slices, decode: " \
+                    << this->PixelDecodeTime << "s, reorient: " << this->ReorientTime << "s"); \
       itk::ImportImageContainer<itk::SizeValueType, type>::Pointer PixelContainer##typeN;\
-      PixelContainer##typeN = filter->GetOutput()->GetPixelContainer();\
+      PixelContainer##typeN = image->GetPixelContainer();\
       void *ptr = static_cast<void *> (PixelContainer##typeN->GetBufferPointer());\
       DownCast<type>(data->GetPointData()->GetScalars())                \
         ->SetVoidArray(ptr, PixelContainer##typeN->Size(), 0,\
@@ -18,6 +18,7 @@
 #include "vtkITKArchetypeImageSeriesReader.h"
 
 #include "itkImageFileReader.h"
+#include "itkImageSeriesReader.h"
 
 class VTK_ITK_EXPORT vtkITKArchetypeImageSeriesScalarReader : public vtkITKArchetypeImageSeriesReader
 {
@@ -33,6 +34,15 @@ class VTK_ITK_EXPORT vtkITKArchetypeImageSeriesScalarReader : public vtkITKArche
 
   int RequestData(vtkInformation* request, vtkInformationVector** inputVector, vtkInformationVector* outputVector) override;
   static void ReadProgressCallback(itk::ProcessObject* obj,const itk::ProgressEvent&, void* data);
+
+  /// Decode the slices of FileNames concurrently into a single volume that
+  /// has the geometry computed by seriesReader. Each thread reads its slices
+  /// with a copy of imageIO, or with the ImageIO that the factory selects
+  /// for the file if imageIO is nullptr.
+  /// Return nullptr if the series can not be read slice by slice.
+  template <class TImage>
+  typename TImage::Pointer ReadSeriesInParallel(itk::ImageSeriesReader<TImage>* seriesReader,
+                                                itk::ImageIOBase* imageIO);
   /// private:
 };
 
@@ -18,12 +18,16 @@
 #include "vtkDataArray.h"
 #include "vtkPointData.h"
 #include "vtkImageData.h"
-#include "vtkAlgorithm.h"
 #include <vtkVersion.h>
 
-#include "itkConnectedComponentImageFilter.h"
-#include "itkRelabelComponentImageFilter.h"
-#include "itkCommand.h"
+// vtkAddon includes
+#include <vtkAddonThreadingUtilities.h>
+
+// STD includes
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
 
 vtkStandardNewMacro(vtkITKIslandMath);
 
@@ -33,6 +37,8 @@ vtkITKIslandMath::vtkITKIslandMath()
   this->SliceBySlice = 0;
   this->MinimumSize = 0;
   this->MaximumSize = VTK_ID_MAX;
+  this->NumberOfThreads = 0;
+  this->Streaming = false;
   this->NumberOfIslands = 0;
   this->OriginalNumberOfIslands = 0;
 
@@ -49,80 +55,492 @@ void vtkITKIslandMath::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "SliceBySlice: " << SliceBySlice << std::endl;
   os << indent << "MinimumSize: " << MinimumSize << std::endl;
   os << indent << "MaximumSize: " << MaximumSize << std::endl;
+  os << indent << "NumberOfThreads: " << NumberOfThreads << std::endl;
+  os << indent << "Streaming: " << Streaming << std::endl;
   os << indent << "NumberOfIslands: " << NumberOfIslands << std::endl;
   os << indent << "OriginalNumberOfIslands: " << OriginalNumberOfIslands << std::endl;
 }
 
-// Note: local function not method - conforms to signature in itkCommand.h
-void vtkITKIslandMathHandleProgressEvent (itk::Object *caller,
-                                          const itk::EventObject& vtkNotUsed(eventObject),
-                                          void *clientdata)
+int vtkITKIslandMath::GetNumberOfThreadsToUse()
+{
+  return vtkAddonThreadingUtilities::GetNumberOfThreadsToUse(this->NumberOfThreads);
+}
+
+namespace
+{
+
+// Number of voxels of the bounding box that a slab covers in streaming mode
+const vtkIdType StreamingSlabVoxels = 16 * 1024 * 1024;
+
+//----------------------------------------------------------------------------
+// Union-find on ids where the root of a set is always its smallest id,
+// so that sets stay ordered by their first element.
+vtkIdType vtkITKIslandMathFindRoot(std::vector<vtkIdType>& parents, vtkIdType id)
+{
+  while (parents[id] != id)
+    {
+    parents[id] = parents[parents[id]];
+    id = parents[id];
+    }
+  return id;
+}
+
+void vtkITKIslandMathMerge(std::vector<vtkIdType>& parents, vtkIdType id1, vtkIdType id2)
+{
+  id1 = vtkITKIslandMathFindRoot(parents, id1);
+  id2 = vtkITKIslandMathFindRoot(parents, id2);
+  if (id1 < id2)
+    {
+    parents[id2] = id1;
+    }
+  else if (id2 < id1)
+    {
+    parents[id1] = id2;
+    }
+}
+
+// Replace the parent of each id with the index of its set. Sets are numbered
+// in the order of their root. Parents always precede their children, so a
+// single pass is enough. Returns the number of sets.
+vtkIdType vtkITKIslandMathNumberSets(std::vector<vtkIdType>& parents)
 {
-  itk::ProcessObject *itkFilter = dynamic_cast<itk::ProcessObject*>(caller);
-  vtkAlgorithm *vtkFilter = reinterpret_cast<vtkAlgorithm*>(clientdata);
-  if ( itkFilter && vtkFilter )
+  vtkIdType numberOfSets = 0;
+  const vtkIdType numberOfIds = static_cast<vtkIdType>(parents.size());
+  for (vtkIdType id = 0; id < numberOfIds; ++id)
     {
-    vtkFilter->UpdateProgress ( itkFilter->GetProgress() );
+    const vtkIdType parent = parents[id];
+    parents[id] = (parent == id ? numberOfSets++ : parents[parent]);
     }
+  return numberOfSets;
+}
+
+//----------------------------------------------------------------------------
+// Run of non-zero voxels in a row, first and last voxel index
+struct IslandRun
+{
+  int Begin;
+  int End;
 };
 
+// Runs of a slab of slices, grouped into the islands of the slab
+struct IslandSlab
+{
+  int FirstSlice;
+  int LastSlice;
+  std::vector<IslandRun> Runs;
+  /// Index of the first run of each row, followed by the number of runs
+  std::vector<vtkIdType> RowOffsets;
+  /// Island of each run, islands are numbered in the order of their first voxel
+  std::vector<vtkIdType> RunIslands;
+  /// Number of voxels of each island
+  std::vector<vtkIdType> IslandSizes;
+
+  void Clear()
+    {
+    // Release the memory, not just the content
+    std::vector<IslandRun>().swap(this->Runs);
+    std::vector<vtkIdType>().swap(this->RowOffsets);
+    std::vector<vtkIdType>().swap(this->RunIslands);
+    std::vector<vtkIdType>().swap(this->IslandSizes);
+    }
+};
+
+// Rows that touch a row and precede it in the raster order
+struct IslandNeighborRow
+{
+  int RowOffset;
+  int SliceOffset;
+  int Tolerance; // runs touch if the gap between them is at most this
+};
+
+const IslandNeighborRow FaceNeighborRows[] = { { -1, 0, 0 }, { 0, -1, 0 } };
+const IslandNeighborRow FullNeighborRows[] = { { -1, 0, 1 }, { -1, -1, 1 }, { 0, -1, 1 }, { 1, -1, 1 } };
+
+//----------------------------------------------------------------------------
+// Call function(run, neighborRun) for each pair of touching runs of two rows
+template <class Function>
+void vtkITKIslandMathForEachTouchingRun(const IslandRun* runs, vtkIdType numberOfRuns,
+                                        const IslandRun* neighborRuns, vtkIdType numberOfNeighborRuns,
+                                        int tolerance, Function function)
+{
+  vtkIdType firstNeighbor = 0;
+  for (vtkIdType run = 0; run < numberOfRuns; ++run)
+    {
+    while (firstNeighbor < numberOfNeighborRuns && neighborRuns[firstNeighbor].End + tolerance < runs[run].Begin)
+      {
+      ++firstNeighbor;
+      }
+    for (vtkIdType neighbor = firstNeighbor;
+         neighbor < numberOfNeighborRuns && neighborRuns[neighbor].Begin <= runs[run].End + tolerance; ++neighbor)
+      {
+      function(run, neighbor);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the runs of a slab within the extent and group them into islands
+template <class T>
+void vtkITKIslandMathLabelSlab(const T* inPtr, vtkIdType inc1, vtkIdType inc2, const int extent[6],
+                               bool fullyConnected, IslandSlab& slab)
+{
+  const int numberOfRowsPerSlice = extent[3] - extent[2] + 1;
+  const int numberOfRows = numberOfRowsPerSlice * (slab.LastSlice - slab.FirstSlice + 1);
+  slab.Runs.clear();
+  slab.RowOffsets.resize(numberOfRows + 1);
+  int row = 0;
+  for (int z = slab.FirstSlice; z <= slab.LastSlice; ++z)
+    {
+    for (int y = extent[2]; y <= extent[3]; ++y, ++row)
+      {
+      slab.RowOffsets[row] = static_cast<vtkIdType>(slab.Runs.size());
+      const T* rowPtr = inPtr + z * inc2 + y * inc1;
+      int x = extent[0];
+      while (x <= extent[1])
+        {
+        if (rowPtr[x] == 0)
+          {
+          ++x;
+          continue;
+          }
+        IslandRun run;
+        run.Begin = x;
+        while (x <= extent[1] && rowPtr[x] != 0)
+          {
+          ++x;
+          }
+        run.End = x - 1;
+        slab.Runs.push_back(run);
+        }
+      }
+    }
+  slab.RowOffsets[numberOfRows] = static_cast<vtkIdType>(slab.Runs.size());
+
+  // Merge touching runs
+  std::vector<vtkIdType>& parents = slab.RunIslands;
+  parents.resize(slab.Runs.size());
+  std::iota(parents.begin(), parents.end(), 0);
+  const IslandNeighborRow* neighborRows = fullyConnected ? FullNeighborRows : FaceNeighborRows;
+  const int numberOfNeighborRows = fullyConnected ? 4 : 2;
+  for (row = 0; row < numberOfRows; ++row)
+    {
+    const vtkIdType firstRun = slab.RowOffsets[row];
+    const vtkIdType numberOfRuns = slab.RowOffsets[row + 1] - firstRun;
+    if (numberOfRuns == 0)
+      {
+      continue;
+      }
+    const int y = row % numberOfRowsPerSlice;
+    const int z = row / numberOfRowsPerSlice;
+    for (int neighborIndex = 0; neighborIndex < numberOfNeighborRows; ++neighborIndex)
+      {
+      const IslandNeighborRow& neighborRow = neighborRows[neighborIndex];
+      const int neighborY = y + neighborRow.RowOffset;
+      const int neighborZ = z + neighborRow.SliceOffset;
+      if (neighborY < 0 || neighborY >= numberOfRowsPerSlice || neighborZ < 0)
+        {
+        continue;
+        }
+      const int neighbor = neighborZ * numberOfRowsPerSlice + neighborY;
+      const vtkIdType firstNeighborRun = slab.RowOffsets[neighbor];
+      vtkITKIslandMathForEachTouchingRun(&slab.Runs[firstRun], numberOfRuns,
+        slab.Runs.data() + firstNeighborRun, slab.RowOffsets[neighbor + 1] - firstNeighborRun,
+        neighborRow.Tolerance, [&](vtkIdType run, vtkIdType neighborRun)
+          {
+          vtkITKIslandMathMerge(parents, firstRun + run, firstNeighborRun + neighborRun);
+          });
+      }
+    }
+
+  const vtkIdType numberOfIslands = vtkITKIslandMathNumberSets(parents);
+  slab.IslandSizes.assign(numberOfIslands, 0);
+  for (size_t run = 0; run < slab.Runs.size(); ++run)
+    {
+    slab.IslandSizes[slab.RunIslands[run]] += slab.Runs[run].End - slab.Runs[run].Begin + 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Merge the islands of the first slice of a slab with the islands of the last
+// slice of the previous slab. Islands are identified by the index of the slab's
+// first island plus their index in the slab.
+void vtkITKIslandMathJoinSlabs(const IslandSlab& previousSlab, vtkIdType previousFirstIsland,
+                               const IslandSlab& slab, vtkIdType firstIsland,
+                               int numberOfRowsPerSlice, bool fullyConnected,
+                               std::vector<vtkIdType>& parents)
+{
+  const int previousLastSliceFirstRow = (previousSlab.LastSlice - previousSlab.FirstSlice) * numberOfRowsPerSlice;
+  const IslandNeighborRow* neighborRows = fullyConnected ? FullNeighborRows : FaceNeighborRows;
+  const int numberOfNeighborRows = fullyConnected ? 4 : 2;
+  for (int y = 0; y < numberOfRowsPerSlice; ++y)
+    {
+    const vtkIdType firstRun = slab.RowOffsets[y];
+    const vtkIdType numberOfRuns = slab.RowOffsets[y + 1] - firstRun;
+    if (numberOfRuns == 0)
+      {
+      continue;
+      }
+    for (int neighborIndex = 0; neighborIndex < numberOfNeighborRows; ++neighborIndex)
+      {
+      const IslandNeighborRow& neighborRow = neighborRows[neighborIndex];
+      const int neighborY = y + neighborRow.RowOffset;
+      if (neighborRow.SliceOffset == 0 || neighborY < 0 || neighborY >= numberOfRowsPerSlice)
+        {
+        continue;
+        }
+      const int neighbor = previousLastSliceFirstRow + neighborY;
+      const vtkIdType firstNeighborRun = previousSlab.RowOffsets[neighbor];
+      vtkITKIslandMathForEachTouchingRun(&slab.Runs[firstRun], numberOfRuns,
+        previousSlab.Runs.data() + firstNeighborRun, previousSlab.RowOffsets[neighbor + 1] - firstNeighborRun,
+        neighborRow.Tolerance, [&](vtkIdType run, vtkIdType neighborRun)
+          {
+          vtkITKIslandMathMerge(parents,
+            firstIsland + slab.RunIslands[firstRun + run],
+            previousFirstIsland + previousSlab.RunIslands[firstNeighborRun + neighborRun]);
+          });
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Write the output label of each run of the slab
+template <class T>
+void vtkITKIslandMathWriteSlab(const IslandSlab& slab, const vtkIdType* islandLabels,
+                               vtkIdType inc1, vtkIdType inc2, const int extent[6], T* outPtr)
+{
+  int row = 0;
+  for (int z = slab.FirstSlice; z <= slab.LastSlice; ++z)
+    {
+    for (int y = extent[2]; y <= extent[3]; ++y, ++row)
+      {
+      T* rowPtr = outPtr + z * inc2 + y * inc1;
+      for (vtkIdType run = slab.RowOffsets[row]; run < slab.RowOffsets[row + 1]; ++run)
+        {
+        const vtkIdType label = islandLabels[slab.RunIslands[run]];
+        if (label != 0)
+          {
+          std::fill(rowPtr + slab.Runs[run].Begin, rowPtr + slab.Runs[run].End + 1, static_cast<T>(label));
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Bounding box of the non-zero voxels. Returns false if all voxels are zero.
+template <class T>
+bool vtkITKIslandMathGetEffectiveExtent(const T* inPtr, const int dims[3], int numberOfThreads, int extent[6])
+{
+  const vtkIdType inc1 = dims[0];
+  const vtkIdType inc2 = inc1 * dims[1];
+  // x min, x max, y min, y max of each slice, x min > x max if the slice is empty
+  std::vector<int> sliceExtents(4 * static_cast<size_t>(dims[2]));
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, dims[2], [&](int z)
+    {
+    int* sliceExtent = &sliceExtents[4 * static_cast<size_t>(z)];
+    sliceExtent[0] = dims[0];
+    sliceExtent[1] = -1;
+    sliceExtent[2] = dims[1];
+    sliceExtent[3] = -1;
+    for (int y = 0; y < dims[1]; ++y)
+      {
+      const T* rowPtr = inPtr + z * inc2 + y * inc1;
+      int first = 0;
+      while (first < dims[0] && rowPtr[first] == 0)
+        {
+        ++first;
+        }
+      if (first == dims[0])
+        {
+        continue;
+        }
+      // Only the part outside of the current extent has to be searched
+      int last = dims[0] - 1;
+      while (last > std::max(first, sliceExtent[1]) && rowPtr[last] == 0)
+        {
+        --last;
+        }
+      sliceExtent[0] = std::min(sliceExtent[0], first);
+      sliceExtent[1] = std::max(sliceExtent[1], last);
+      sliceExtent[2] = std::min(sliceExtent[2], y);
+      sliceExtent[3] = y;
+      }
+    });
+
+  extent[0] = dims[0];
+  extent[1] = -1;
+  extent[2] = dims[1];
+  extent[3] = -1;
+  extent[4] = dims[2];
+  extent[5] = -1;
+  for (int z = 0; z < dims[2]; ++z)
+    {
+    const int* sliceExtent = &sliceExtents[4 * static_cast<size_t>(z)];
+    if (sliceExtent[0] > sliceExtent[1])
+      {
+      continue;
+      }
+    extent[0] = std::min(extent[0], sliceExtent[0]);
+    extent[1] = std::max(extent[1], sliceExtent[1]);
+    extent[2] = std::min(extent[2], sliceExtent[2]);
+    extent[3] = std::max(extent[3], sliceExtent[3]);
+    extent[4] = std::min(extent[4], z);
+    extent[5] = z;
+    }
+  return extent[0] <= extent[1];
+}
+
+} // end of anonymous namespace
+
 template <class T>
 void vtkITKIslandMathExecute(vtkITKIslandMath *self, vtkImageData* input,
                 vtkImageData* vtkNotUsed(output),
-                T* inPtr, T* outPtr)
+                T* inPtr, T* outPtr, int numberOfThreads)
 {
-
   int dims[3];
   input->GetDimensions(dims);
-  double spacing[3];
-  input->GetSpacing(spacing);
-
-  // Wrap scalars into an ITK image
-  // - mostly rely on defaults for spacing, origin etc for this filter
-  typedef itk::Image<T, 3> ImageType;
-  typename ImageType::Pointer inImage = ImageType::New();
-  typename ImageType::RegionType region;
-  typename ImageType::IndexType index;
-  typename ImageType::SizeType size;
-
-  inImage->GetPixelContainer()->SetImportPointer(inPtr, dims[0]*dims[1]*dims[2], false);
-  index[0] = index[1] = index[2] = 0;
-  region.SetIndex(index);
-  size[0] = dims[0]; size[1] = dims[1]; size[2] = dims[2];
-  region.SetSize(size);
-  inImage->SetLargestPossibleRegion(region);
-  inImage->SetBufferedRegion(region);
-  inImage->SetSpacing(spacing);
-
-  // set up the progress callback
-  itk::CStyleCommand::Pointer progressCommand = itk::CStyleCommand::New();
-  progressCommand->SetClientData( static_cast<void *>(self) );
-  progressCommand->SetCallback( vtkITKIslandMathHandleProgressEvent );
-
-
-  // Calculate the island operation
-  // ccfilter - identifies the islands
-  // relabel - sorts them by size
-  typedef itk::ConnectedComponentImageFilter<ImageType, ImageType> ConnectedComponentType;
-  typename ConnectedComponentType::Pointer ccfilter = ConnectedComponentType::New();
-  typedef itk::RelabelComponentImageFilter<ImageType, ImageType> RelabelComponentType;
-  typename RelabelComponentType::Pointer relabel = RelabelComponentType::New();
-
-  ccfilter->AddObserver(itk::ProgressEvent(), progressCommand);
-  relabel->AddObserver(itk::ProgressEvent(), progressCommand);
-
-  ccfilter->SetFullyConnected(self->GetFullyConnected());
-  ccfilter->SetInput( inImage );
-  relabel->SetInput( ccfilter->GetOutput() );
-  relabel->SetMinimumObjectSize( self->GetMinimumSize() );
-  relabel->Update();
-  self->SetNumberOfIslands(relabel->GetNumberOfObjects());
-  self->SetOriginalNumberOfIslands(relabel->GetOriginalNumberOfObjects());
-
-  // Copy to the output
-  memcpy(outPtr, relabel->GetOutput()->GetBufferPointer(),
-         relabel->GetOutput()->GetBufferedRegion().GetNumberOfPixels() * sizeof(T));
+  const vtkIdType inc1 = dims[0];
+  const vtkIdType inc2 = inc1 * dims[1];
+  const bool fullyConnected = (self->GetFullyConnected() != 0);
+
+  // Voxels outside of the islands are zero
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, dims[2], [&](int z)
+    {
+    std::fill(outPtr + z * inc2, outPtr + (z + 1) * inc2, static_cast<T>(0));
+    });
+
+  self->SetNumberOfIslands(0);
+  self->SetOriginalNumberOfIslands(0);
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!vtkITKIslandMathGetEffectiveExtent(inPtr, dims, numberOfThreads, extent))
+    {
+    return;
+    }
+  self->UpdateProgress(0.1);
+
+  // Split the slices of the effective extent into slabs. Smaller slabs balance
+  // the load better, a few per thread is enough.
+  const int numberOfRowsPerSlice = extent[3] - extent[2] + 1;
+  const int numberOfSlices = extent[5] - extent[4] + 1;
+  int slabThickness = std::max(1, numberOfSlices / (4 * numberOfThreads));
+  if (self->GetStreaming())
+    {
+    const vtkIdType sliceVoxels = static_cast<vtkIdType>(extent[1] - extent[0] + 1) * numberOfRowsPerSlice;
+    slabThickness = static_cast<int>(std::max<vtkIdType>(1, std::min<vtkIdType>(slabThickness, StreamingSlabVoxels / sliceVoxels)));
+    }
+  const int numberOfSlabs = (numberOfSlices + slabThickness - 1) / slabThickness;
+  // Number of slabs that are kept in memory at once
+  const int numberOfSlabsInGroup = self->GetStreaming() ? numberOfThreads : numberOfSlabs;
+
+  std::vector<IslandSlab> slabs(numberOfSlabsInGroup);
+  IslandSlab previousSlab;
+  // Islands of all the slabs, merged where the slabs touch
+  std::vector<vtkIdType> slabFirstIslands(numberOfSlabs + 1, 0);
+  std::vector<vtkIdType> islandParents;
+  std::vector<vtkIdType> islandSizes;
+
+  for (int firstSlab = 0; firstSlab < numberOfSlabs; firstSlab += numberOfSlabsInGroup)
+    {
+    const int numberOfSlabsToLabel = std::min(numberOfSlabsInGroup, numberOfSlabs - firstSlab);
+    vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, numberOfSlabsToLabel, [&](int slabIndex)
+      {
+      IslandSlab& slab = slabs[slabIndex];
+      slab.FirstSlice = extent[4] + (firstSlab + slabIndex) * slabThickness;
+      slab.LastSlice = std::min(slab.FirstSlice + slabThickness - 1, extent[5]);
+      vtkITKIslandMathLabelSlab(inPtr, inc1, inc2, extent, fullyConnected, slab);
+      });
+
+    for (int slabIndex = 0; slabIndex < numberOfSlabsToLabel; ++slabIndex)
+      {
+      const int slab = firstSlab + slabIndex;
+      const vtkIdType firstIsland = slabFirstIslands[slab];
+      const std::vector<vtkIdType>& sizes = slabs[slabIndex].IslandSizes;
+      slabFirstIslands[slab + 1] = firstIsland + static_cast<vtkIdType>(sizes.size());
+      islandSizes.insert(islandSizes.end(), sizes.begin(), sizes.end());
+      islandParents.resize(islandSizes.size());
+      std::iota(islandParents.begin() + firstIsland, islandParents.end(), firstIsland);
+      if (slab > 0)
+        {
+        const IslandSlab& touchingSlab = (slabIndex > 0 ? slabs[slabIndex - 1] : previousSlab);
+        vtkITKIslandMathJoinSlabs(touchingSlab, slabFirstIslands[slab - 1], slabs[slabIndex], firstIsland,
+          numberOfRowsPerSlice, fullyConnected, islandParents);
+        }
+      }
 
+    if (self->GetStreaming())
+      {
+      std::swap(previousSlab, slabs[numberOfSlabsToLabel - 1]);
+      for (IslandSlab& slab : slabs)
+        {
+        slab.Clear();
+        }
+      }
+    }
+  previousSlab.Clear();
+  self->UpdateProgress(0.5);
+
+  // Sort the islands by decreasing size, then by their first voxel
+  const vtkIdType numberOfIslands = vtkITKIslandMathNumberSets(islandParents);
+  std::vector<vtkIdType> sizes(numberOfIslands, 0);
+  for (size_t island = 0; island < islandSizes.size(); ++island)
+    {
+    sizes[islandParents[island]] += islandSizes[island];
+    }
+  std::vector<vtkIdType>().swap(islandSizes);
+  std::vector<vtkIdType> order(numberOfIslands);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&sizes](vtkIdType island1, vtkIdType island2)
+    {
+    return sizes[island1] > sizes[island2] || (sizes[island1] == sizes[island2] && island1 < island2);
+    });
+  std::vector<vtkIdType> labels(numberOfIslands, 0);
+  vtkIdType numberOfLabels = 0;
+  for (vtkIdType island : order)
+    {
+    if (sizes[island] >= self->GetMinimumSize() && sizes[island] <= self->GetMaximumSize())
+      {
+      labels[island] = ++numberOfLabels;
+      }
+    }
+  self->SetOriginalNumberOfIslands(static_cast<unsigned long>(numberOfIslands));
+  if (numberOfLabels == 0)
+    {
+    return;
+    }
+  // Labels must not wrap around, that would merge islands or turn them into background
+  if (static_cast<unsigned long long>(numberOfLabels) > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+    {
+    vtkErrorWithObjectMacro(self, "vtkITKIslandMath: " << numberOfLabels << " islands were found, which is more than"
+      << " the maximum label value of the input scalar type (" << static_cast<vtkIdType>(std::numeric_limits<T>::max())
+      << "). Cast the input to a larger scalar type or increase the minimum island size.");
+    return;
+    }
+  self->SetNumberOfIslands(static_cast<unsigned long>(numberOfLabels));
+
+  // Label of each island of the slabs
+  for (vtkIdType& island : islandParents)
+    {
+    island = labels[island];
+    }
+
+  if (!self->GetStreaming())
+    {
+    vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, numberOfSlabs, [&](int slab)
+      {
+      vtkITKIslandMathWriteSlab(slabs[slab], &islandParents[slabFirstIslands[slab]], inc1, inc2, extent, outPtr);
+      });
+    return;
+    }
+
+  // Streaming: find the runs of each slab again, they get the same islands
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, numberOfSlabs, [&](int slabIndex)
+    {
+    IslandSlab slab;
+    slab.FirstSlice = extent[4] + slabIndex * slabThickness;
+    slab.LastSlice = std::min(slab.FirstSlice + slabThickness - 1, extent[5]);
+    vtkITKIslandMathLabelSlab(inPtr, inc1, inc2, extent, fullyConnected, slab);
+    vtkITKIslandMathWriteSlab(slab, &islandParents[slabFirstIslands[slabIndex]], inc1, inc2, extent, outPtr);
+    });
 }
 
 
@@ -154,13 +572,10 @@ void vtkITKIslandMath::SimpleExecute(vtkImageData *input, vtkImageData *output)
   if (inScalars->GetNumberOfComponents() == 1 )
     {
 
-////////// These types are not defined in itk ////////////
-#undef VTK_TYPE_USE_LONG_LONG
-#undef VTK_TYPE_USE___INT64
-
-#define CALL  vtkITKIslandMathExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr));
+#define CALL  vtkITKIslandMathExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr), numberOfThreads);
 
     void* inPtr = input->GetScalarPointer();
+    const int numberOfThreads = this->GetNumberOfThreadsToUse();
     void* outPtr = output->GetScalarPointer();
 
     switch (inScalars->GetDataType())
@@ -176,7 +591,7 @@ void vtkITKIslandMath::SimpleExecute(vtkImageData *input, vtkImageData *output)
       vtkTemplateMacroCase(VTK_UNSIGNED_CHAR, unsigned char, CALL);             \
       default:
         {
-        vtkErrorMacro(<< "Incompatible data type for this version of ITK.");
+        vtkErrorMacro(<< "Incompatible data type for island math.");
         }
       } //switch
     }
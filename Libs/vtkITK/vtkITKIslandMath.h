@@ -13,9 +13,15 @@
 #include "vtkITK.h"
 #include "vtkSimpleImageToImageFilter.h"
 
-/// \brief ITK-based utilities for manipulating connected regions in label maps.
-/// Limitation: The filter does not work correctly with input volume that has
-/// unsigned long scalar type on Linux and MacOSX.
+/// \brief Utilities for manipulating connected regions in label maps.
+///
+/// Non-zero voxels are grouped into islands (connected components), which are
+/// labeled in the output by decreasing size: the largest island gets label 1.
+/// Islands of equal size are ordered by their first voxel.
+///
+/// Islands are found by union-find on runs of non-zero voxels, in slabs of
+/// slices that are processed in parallel and then joined. Only the bounding
+/// box of the non-zero voxels is processed.
 ///
 class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
 {
@@ -31,12 +37,12 @@ class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
   vtkSetMacro(FullyConnected, int);
 
   ///
-  /// Minimum island size (in pixels).  Islands smaller than this are ignored.
+  /// Minimum island size (in pixels).  Islands smaller than this are removed.
   vtkGetMacro(MinimumSize, vtkIdType);
   vtkSetMacro(MinimumSize, vtkIdType);
 
   ///
-  /// Maximum island size (in pixels).  Islands larger than this are ignored.
+  /// Maximum island size (in pixels).  Islands larger than this are removed.
   vtkGetMacro(MaximumSize, vtkIdType);
   vtkSetMacro(MaximumSize, vtkIdType);
 
@@ -58,6 +64,23 @@ class VTK_ITK_EXPORT vtkITKIslandMath : public vtkSimpleImageToImageFilter
   vtkGetMacro(OriginalNumberOfIslands, unsigned long);
   vtkSetMacro(OriginalNumberOfIslands, unsigned long);
 
+  ///
+  /// Number of threads used for finding the islands.
+  /// 0 (default) uses all the available cores.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  ///
+  /// If enabled, the runs of non-zero voxels are only kept in memory for a few
+  /// slabs of slices at a time and are extracted again when the output is
+  /// written. Only the sizes and connections of the islands of each slab are
+  /// kept for the whole image. This is for images that are too large to keep
+  /// an intermediate representation of, at the cost of reading the input twice.
+  /// Disabled by default.
+  vtkSetMacro(Streaming, bool);
+  vtkGetMacro(Streaming, bool);
+  vtkBooleanMacro(Streaming, bool);
+
 
 protected:
   vtkITKIslandMath();
@@ -69,10 +92,15 @@ protected:
   int SliceBySlice;
   vtkIdType MinimumSize;
   vtkIdType MaximumSize;
+  int NumberOfThreads;
+  bool Streaming;
 
   unsigned long NumberOfIslands;
   unsigned long OriginalNumberOfIslands;
 
+  /// Number of threads resolved from NumberOfThreads, at least 1.
+  int GetNumberOfThreadsToUse();
+
 private:
   vtkITKIslandMath(const vtkITKIslandMath&) = delete;
   void operator=(const vtkITKIslandMath&) = delete;
@@ -27,21 +27,33 @@
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkLongArray.h>
+#include <vtkMath.h>
 #include <vtkObjectFactory.h>
 #include <vtkPoints.h>
 #include <vtkPointData.h>
 
+// vtkAddon includes
+#include <vtkAddonThreadingUtilities.h>
+
 // ITK includes
 #include <itkLabelImageToShapeLabelMapFilter.h>
 #include <itkShapeLabelObject.h>
 #include <itkVTKImageToImageFilter.h>
 
+// STD includes
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKLabelShapeStatistics);
 
 //----------------------------------------------------------------------------
 vtkITKLabelShapeStatistics::vtkITKLabelShapeStatistics()
 {
   this->Directions = nullptr;
+  this->MultiThreaded = false;
+  this->NumberOfThreads = 0;
 
   this->ComputedStatistics.push_back(this->GetShapeStatisticAsString(Centroid));
   this->ComputedStatistics.push_back(this->GetShapeStatisticAsString(Flatness));
@@ -57,6 +69,14 @@ vtkITKLabelShapeStatistics::~vtkITKLabelShapeStatistics()
 void vtkITKLabelShapeStatistics::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "MultiThreaded: " << this->MultiThreaded << std::endl;
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << std::endl;
+}
+
+//----------------------------------------------------------------------------
+int vtkITKLabelShapeStatistics::GetNumberOfThreadsToUse()
+{
+  return vtkAddonThreadingUtilities::GetNumberOfThreadsToUse(this->NumberOfThreads);
 }
 
 //----------------------------------------------------------------------------
@@ -90,6 +110,8 @@ std::string vtkITKLabelShapeStatistics::GetShapeStatisticAsString(ShapeStatistic
       return "PrincipalMoments";
     case PrincipalAxes:
       return "PrincipalAxes";
+    case Volume:
+      return "Volume";
     default:
       vtkErrorWithObjectMacro(nullptr, "GetShapeStatisticFromString: Cannot determine string for statistic: " << statistic);
       return "";
@@ -168,6 +190,31 @@ void vtkITKLabelShapeStatisticsHandleProgressEvent (itk::Object *caller,
     }
 };
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Shape statistics of a label, in physical coordinates
+struct LabelShape
+{
+  double Volume = 0.0;
+  double Centroid[3] = { 0.0, 0.0, 0.0 };
+  double FeretDiameter = 0.0;
+  double Perimeter = 0.0;
+  double Roundness = 0.0;
+  double Flatness = 0.0;
+  double Elongation = 0.0;
+  /// Sorted in ascending order
+  double PrincipalMoments[3] = { 0.0, 0.0, 0.0 };
+  /// Rows are the principal axes
+  double PrincipalAxes[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+  double OrientedBoundingBoxOrigin[3] = { 0.0, 0.0, 0.0 };
+  double OrientedBoundingBoxSize[3] = { 0.0, 0.0, 0.0 };
+  /// Rows are the directions of the box
+  double OrientedBoundingBoxDirection[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+};
+
 //----------------------------------------------------------------------------
 template <class T>
 T* GetArray(vtkTable* table, std::string name, int numberOfComponents, std::vector<std::string>* componentNames = nullptr)
@@ -199,6 +246,402 @@ T* GetArray(vtkTable* table, std::string name, int numberOfComponents, std::vect
   return array.GetPointer();
 }
 
+//----------------------------------------------------------------------------
+// Write the requested statistics of a label into a row of the output table
+void AddLabelShapeToTable(vtkITKLabelShapeStatistics* self, vtkTable* output, int rowIndex,
+  long labelValue, const LabelShape& shape)
+{
+  vtkLongArray* array = GetArray<vtkLongArray>(output, "LabelValue", 1);
+  array->InsertTuple1(rowIndex, labelValue);
+
+  for (std::string statisticName : self->GetComputedStatistics())
+    {
+    if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Centroid))
+      {
+      vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 3);
+      array->InsertTuple3(rowIndex, shape.Centroid[0], shape.Centroid[1], shape.Centroid[2]);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Roundness))
+      {
+      vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
+      array->InsertTuple1(rowIndex, shape.Roundness);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Flatness))
+      {
+      vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
+      array->InsertTuple1(rowIndex, shape.Flatness);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Elongation))
+      {
+      vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
+      array->InsertTuple1(rowIndex, shape.Elongation);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::FeretDiameter))
+      {
+      vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
+      array->InsertTuple1(rowIndex, shape.FeretDiameter);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Perimeter))
+      {
+      vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
+      array->InsertTuple1(rowIndex, shape.Perimeter);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Volume))
+      {
+      vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
+      array->InsertTuple1(rowIndex, shape.Volume);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::OrientedBoundingBox))
+      {
+      const double* boundingBoxOrigin = shape.OrientedBoundingBoxOrigin;
+      vtkDoubleArray* obbOriginArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxOrigin", 3);
+      obbOriginArray->InsertTuple3(rowIndex, boundingBoxOrigin[0], boundingBoxOrigin[1], boundingBoxOrigin[2]);
+
+      const double* boundingBoxSize = shape.OrientedBoundingBoxSize;
+      std::vector<std::string> componentNames = { "x", "y", "z" };
+      vtkDoubleArray* obbSizeArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxSize", 3, &componentNames);
+      obbSizeArray->InsertTuple3(rowIndex, boundingBoxSize[0], boundingBoxSize[1], boundingBoxSize[2]);
+
+      const double (*boundingBoxDirections)[3] = shape.OrientedBoundingBoxDirection;
+      vtkDoubleArray* obbDirectionXArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionX", 3);
+      obbDirectionXArray->InsertTuple(rowIndex, boundingBoxDirections[0]);
+      vtkDoubleArray* obbDirectionYArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionY", 3);
+      obbDirectionYArray->InsertTuple(rowIndex, boundingBoxDirections[1]);
+      vtkDoubleArray* obbDirectionZArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionZ", 3);
+      obbDirectionZArray->InsertTuple(rowIndex, boundingBoxDirections[2]);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::PrincipalMoments))
+      {
+      const double* principalMoments = shape.PrincipalMoments;
+      vtkDoubleArray* principalMomentsArray = GetArray<vtkDoubleArray>(output, statisticName, 3);
+      principalMomentsArray->InsertTuple3(rowIndex, principalMoments[0], principalMoments[1], principalMoments[2]);
+      }
+    else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::PrincipalAxes))
+      {
+      const double (*principalAxes)[3] = shape.PrincipalAxes;
+      vtkDoubleArray* principalAxisXArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisX", 3);
+      principalAxisXArray->InsertTuple(rowIndex, principalAxes[0]);
+      vtkDoubleArray* principalAxisYArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisY", 3);
+      principalAxisYArray->InsertTuple(rowIndex, principalAxes[1]);
+      vtkDoubleArray* principalAxisZArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisZ", 3);
+      principalAxisZArray->InsertTuple(rowIndex, principalAxes[2]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Line directions used for estimating the surface area by the Crofton formula,
+// see Legland et al., "Computation of Minkowski measures on 2D and 3D binary
+// images", Image Anal Stereol 2007. Each direction points to a voxel that is
+// processed before the current one (or to the next voxel in the row), so that
+// all the neighbors are in the current row, the previous row or the previous slice.
+// The weights are the areas of the Voronoi cells of the directions on the unit
+// sphere, same as in itk::ShapeLabelMapFilter (and as there, they are not
+// adjusted for anisotropic spacing).
+const int NumberOfCroftonDirections = 13;
+const int CroftonDirections[NumberOfCroftonDirections][3] =
+{
+  { 1, 0, 0 },
+  { -1, -1, 0 }, { 0, -1, 0 }, { 1, -1, 0 },
+  { -1, -1, -1 }, { 0, -1, -1 }, { 1, -1, -1 },
+  { -1, 0, -1 }, { 0, 0, -1 }, { 1, 0, -1 },
+  { -1, 1, -1 }, { 0, 1, -1 }, { 1, 1, -1 },
+};
+const double CroftonWeights[4] = { 0.0, 0.04577789120476 * 2, 0.03698062787608 * 2, 0.03519563978232 * 2 };
+
+//----------------------------------------------------------------------------
+// Sums of a label, in voxel index coordinates. Integer sums are exact and do
+// not depend on the order of accumulation, so results do not depend on the
+// number of threads.
+struct LabelAccumulator
+{
+  vtkTypeInt64 NumberOfVoxels = 0;
+  vtkTypeInt64 Sums[3] = { 0, 0, 0 };
+  /// xx, xy, xz, yy, yz, zz
+  vtkTypeInt64 SquareSums[6] = { 0, 0, 0, 0, 0, 0 };
+  /// Number of voxels of the label whose neighbor in a Crofton direction is not in the label
+  vtkTypeInt64 Intercepts[NumberOfCroftonDirections] = { 0 };
+  /// First and last voxel of each run of the label along x.
+  /// The convex hull of the label, and so its extreme points, are among them.
+  std::vector<vtkVector3i> RunEnds;
+
+  void AddRun(int begin, int end, int y, int z)
+    {
+    const vtkTypeInt64 length = end - begin + 1;
+    const vtkTypeInt64 sumX = (static_cast<vtkTypeInt64>(begin) + end) * length / 2;
+    const vtkTypeInt64 sumXX = SumOfSquares(end) - SumOfSquares(begin - 1);
+    this->NumberOfVoxels += length;
+    this->Sums[0] += sumX;
+    this->Sums[1] += length * y;
+    this->Sums[2] += length * z;
+    this->SquareSums[0] += sumXX;
+    this->SquareSums[1] += sumX * y;
+    this->SquareSums[2] += sumX * z;
+    this->SquareSums[3] += length * y * y;
+    this->SquareSums[4] += length * y * z;
+    this->SquareSums[5] += length * z * z;
+    this->RunEnds.push_back(vtkVector3i(begin, y, z));
+    if (end != begin)
+      {
+      this->RunEnds.push_back(vtkVector3i(end, y, z));
+      }
+    }
+
+  void Add(const LabelAccumulator& other)
+    {
+    this->NumberOfVoxels += other.NumberOfVoxels;
+    for (int i = 0; i < 3; ++i)
+      {
+      this->Sums[i] += other.Sums[i];
+      }
+    for (int i = 0; i < 6; ++i)
+      {
+      this->SquareSums[i] += other.SquareSums[i];
+      }
+    for (int i = 0; i < NumberOfCroftonDirections; ++i)
+      {
+      this->Intercepts[i] += other.Intercepts[i];
+      }
+    this->RunEnds.insert(this->RunEnds.end(), other.RunEnds.begin(), other.RunEnds.end());
+    }
+
+  static vtkTypeInt64 SumOfSquares(vtkTypeInt64 n)
+    {
+    // Sum of i*i for i in [0, n], also valid for negative n
+    return n * (n + 1) * (2 * n + 1) / 6;
+    }
+};
+
+//----------------------------------------------------------------------------
+// Remove the points that are not vertices of the convex hull of the points in
+// the same slice, perpendicular to sliceAxis. A vertex of the convex hull of all
+// the points is a vertex of the convex hull of any subset that contains it,
+// so vertices of the 3D convex hull are all kept.
+void KeepConvexHullVertices(std::vector<vtkVector3i>& points, int sliceAxis)
+{
+  const int u = (sliceAxis + 1) % 3;
+  const int v = (sliceAxis + 2) % 3;
+  std::sort(points.begin(), points.end(), [=](const vtkVector3i& a, const vtkVector3i& b)
+    {
+    if (a[sliceAxis] != b[sliceAxis])
+      {
+      return a[sliceAxis] < b[sliceAxis];
+      }
+    return a[u] < b[u] || (a[u] == b[u] && a[v] < b[v]);
+    });
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+
+  auto cross = [=](const vtkVector3i& o, const vtkVector3i& a, const vtkVector3i& b)
+    {
+    return static_cast<vtkTypeInt64>(a[u] - o[u]) * (b[v] - o[v])
+      - static_cast<vtkTypeInt64>(a[v] - o[v]) * (b[u] - o[u]);
+    };
+
+  std::vector<vtkVector3i> hullVertices;
+  std::vector<vtkVector3i> hull;
+  size_t first = 0;
+  while (first < points.size())
+    {
+    size_t last = first;
+    while (last < points.size() && points[last][sliceAxis] == points[first][sliceAxis])
+      {
+      ++last;
+      }
+    const size_t numberOfPoints = last - first;
+    if (numberOfPoints <= 2)
+      {
+      hullVertices.insert(hullVertices.end(), points.begin() + first, points.begin() + last);
+      first = last;
+      continue;
+      }
+    // Andrew's monotone chain, collinear points are removed
+    hull.resize(2 * numberOfPoints);
+    size_t k = 0;
+    for (size_t i = first; i < last; ++i)
+      {
+      while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0)
+        {
+        --k;
+        }
+      hull[k++] = points[i];
+      }
+    for (size_t i = last - 1, lowerSize = k + 1; i > first; --i)
+      {
+      while (k >= lowerSize && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0)
+        {
+        --k;
+        }
+      hull[k++] = points[i - 1];
+      }
+    hullVertices.insert(hullVertices.end(), hull.begin(), hull.begin() + (k - 1));
+    first = last;
+    }
+  points.swap(hullVertices);
+}
+
+//----------------------------------------------------------------------------
+// Compute the shape statistics of a label from its sums.
+// indexToPhysical maps voxel indices to physical positions.
+void ComputeLabelShape(LabelAccumulator& accumulator, const double indexToPhysical[3][4],
+  const double spacing[3], bool computeFeretDiameter, bool computeOrientedBoundingBox, LabelShape& shape)
+{
+  const double numberOfVoxels = static_cast<double>(accumulator.NumberOfVoxels);
+  const double voxelVolume = spacing[0] * spacing[1] * spacing[2];
+  shape.Volume = numberOfVoxels * voxelVolume;
+
+  // Centroid and covariance in index space. The second moment of a voxel
+  // around its center is added, as in itk::ShapeLabelMapFilter.
+  double indexCentroid[3] = { 0.0, 0.0, 0.0 };
+  for (int i = 0; i < 3; ++i)
+    {
+    indexCentroid[i] = accumulator.Sums[i] / numberOfVoxels;
+    }
+  double indexCovariance[3][3] = { { 0.0 } };
+  const int squareSumIndices[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } };
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      indexCovariance[i][j] = accumulator.SquareSums[squareSumIndices[i][j]] / numberOfVoxels
+        - indexCentroid[i] * indexCentroid[j] + (i == j ? 1.0 / 12.0 : 0.0);
+      }
+    }
+
+  // Transform to physical space
+  double linear[3][3] = { { 0.0 } };
+  for (int i = 0; i < 3; ++i)
+    {
+    shape.Centroid[i] = indexToPhysical[i][3];
+    for (int j = 0; j < 3; ++j)
+      {
+      linear[i][j] = indexToPhysical[i][j];
+      shape.Centroid[i] += linear[i][j] * indexCentroid[j];
+      }
+    }
+  double linearTranspose[3][3] = { { 0.0 } };
+  vtkMath::Transpose3x3(linear, linearTranspose);
+  double linearCovariance[3][3] = { { 0.0 } };
+  vtkMath::Multiply3x3(linear, indexCovariance, linearCovariance);
+  double covariance[3][3] = { { 0.0 } };
+  vtkMath::Multiply3x3(linearCovariance, linearTranspose, covariance);
+
+  // Principal moments in ascending order, the principal axes are the rows of a rotation matrix
+  double eigenvalues[3] = { 0.0, 0.0, 0.0 };
+  double eigenvectors[3][3] = { { 0.0 } };
+  double* covarianceRows[3] = { covariance[0], covariance[1], covariance[2] };
+  double* eigenvectorRows[3] = { eigenvectors[0], eigenvectors[1], eigenvectors[2] };
+  vtkMath::Jacobi(covarianceRows, eigenvalues, eigenvectorRows);
+  for (int i = 0; i < 3; ++i)
+    {
+    // Jacobi sorts in descending order and returns the eigenvectors in the columns
+    shape.PrincipalMoments[i] = eigenvalues[2 - i];
+    for (int j = 0; j < 3; ++j)
+      {
+      shape.PrincipalAxes[i][j] = eigenvectors[j][2 - i];
+      }
+    }
+  if (vtkMath::Determinant3x3(shape.PrincipalAxes) < 0.0)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      shape.PrincipalAxes[2][j] = -shape.PrincipalAxes[2][j];
+      }
+    }
+  shape.Flatness = shape.PrincipalMoments[0] > 0.0 ? sqrt(shape.PrincipalMoments[1] / shape.PrincipalMoments[0]) : 0.0;
+  shape.Elongation = shape.PrincipalMoments[1] > 0.0 ? sqrt(shape.PrincipalMoments[2] / shape.PrincipalMoments[1]) : 0.0;
+
+  // Surface area by the Crofton formula
+  shape.Perimeter = 0.0;
+  for (int direction = 0; direction < NumberOfCroftonDirections; ++direction)
+    {
+    const int* offset = CroftonDirections[direction];
+    const int numberOfNonZeroComponents = (offset[0] != 0) + (offset[1] != 0) + (offset[2] != 0);
+    const double physicalOffset[3] = { offset[0] * spacing[0], offset[1] * spacing[1], offset[2] * spacing[2] };
+    shape.Perimeter += CroftonWeights[numberOfNonZeroComponents] * accumulator.Intercepts[direction]
+      / vtkMath::Norm(physicalOffset);
+    }
+  shape.Perimeter *= 4.0 * voxelVolume;
+  // Ratio of the area of the sphere of same volume and the surface area
+  const double equivalentSphericalRadius = pow(3.0 * shape.Volume / (4.0 * vtkMath::Pi()), 1.0 / 3.0);
+  const double equivalentSphericalPerimeter = 4.0 * vtkMath::Pi() * equivalentSphericalRadius * equivalentSphericalRadius;
+  shape.Roundness = shape.Perimeter > 0.0 ? equivalentSphericalPerimeter / shape.Perimeter : 0.0;
+
+  if (!computeFeretDiameter && !computeOrientedBoundingBox)
+    {
+    return;
+    }
+
+  // Only the vertices of the convex hull can be the farthest points
+  // or extreme points along an axis.
+  std::vector<vtkVector3i>& points = accumulator.RunEnds;
+  for (int sliceAxis = 2; sliceAxis >= 0; --sliceAxis)
+    {
+    KeepConvexHullVertices(points, sliceAxis);
+    }
+  std::vector<vtkVector3d> physicalPoints(points.size());
+  for (size_t pointIndex = 0; pointIndex < points.size(); ++pointIndex)
+    {
+    for (int i = 0; i < 3; ++i)
+      {
+      physicalPoints[pointIndex][i] = indexToPhysical[i][3];
+      for (int j = 0; j < 3; ++j)
+        {
+        physicalPoints[pointIndex][i] += linear[i][j] * points[pointIndex][j];
+        }
+      }
+    }
+
+  if (computeFeretDiameter)
+    {
+    double maximumDistance2 = 0.0;
+    for (size_t i = 0; i < physicalPoints.size(); ++i)
+      {
+      for (size_t j = i + 1; j < physicalPoints.size(); ++j)
+        {
+        maximumDistance2 = std::max(maximumDistance2,
+          vtkMath::Distance2BetweenPoints(physicalPoints[i].GetData(), physicalPoints[j].GetData()));
+        }
+      }
+    shape.FeretDiameter = sqrt(maximumDistance2);
+    }
+
+  if (computeOrientedBoundingBox)
+    {
+    // Box of the voxel corners, aligned with the principal axes
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      const double* axisDirection = shape.PrincipalAxes[axis];
+      double halfVoxelExtent = 0.0;
+      for (int j = 0; j < 3; ++j)
+        {
+        halfVoxelExtent += 0.5 * fabs(axisDirection[0] * linear[0][j] + axisDirection[1] * linear[1][j] + axisDirection[2] * linear[2][j]);
+        }
+      double minimum = VTK_DOUBLE_MAX;
+      double maximum = VTK_DOUBLE_MIN;
+      for (const vtkVector3d& point : physicalPoints)
+        {
+        double centeredPoint[3] = { point[0] - shape.Centroid[0], point[1] - shape.Centroid[1], point[2] - shape.Centroid[2] };
+        const double projection = vtkMath::Dot(axisDirection, centeredPoint);
+        minimum = std::min(minimum, projection - halfVoxelExtent);
+        maximum = std::max(maximum, projection + halfVoxelExtent);
+        }
+      shape.OrientedBoundingBoxSize[axis] = maximum - minimum;
+      for (int i = 0; i < 3; ++i)
+        {
+        shape.OrientedBoundingBoxDirection[axis][i] = axisDirection[i];
+        // Origin is the corner with the minimum coordinates along all the axes
+        if (axis == 0)
+          {
+          shape.OrientedBoundingBoxOrigin[i] = shape.Centroid[i];
+          }
+        shape.OrientedBoundingBoxOrigin[i] += minimum * axisDirection[i];
+        }
+      }
+    }
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 template <class T>
 void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImageData* input, vtkTable* output,
@@ -275,83 +718,193 @@ void vtkITKLabelShapeStatisticsExecute(vtkITKLabelShapeStatistics* self, vtkImag
       continue;
       }
 
-    vtkLongArray* array = GetArray<vtkLongArray>(output, "LabelValue", 1);
-    array->InsertTuple1(rowIndex, labelValue);
-
-    for (std::string statisticName : self->GetComputedStatistics())
+    LabelShape shape;
+    shape.Volume = shapeObject->GetPhysicalSize();
+    typename ShapeLabelObjectType::CentroidType centroidObject = shapeObject->GetCentroid();
+    typename ShapeLabelObjectType::VectorType principalMoments = shapeObject->GetPrincipalMoments();
+    typename ShapeLabelObjectType::MatrixType principalAxes = shapeObject->GetPrincipalAxes();
+    for (unsigned int row = 0; row < 3; ++row)
       {
-      if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Centroid))
-        {
-        typename ShapeLabelObjectType::CentroidType centroidObject = shapeObject->GetCentroid();
-        vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 3);
-        array->InsertTuple3(rowIndex, centroidObject[0], centroidObject[1], centroidObject[2]);
-        }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Roundness))
-        {
-        double roundness = shapeObject->GetRoundness();
-        vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
-        array->InsertTuple1(rowIndex, roundness);
-        }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Flatness))
-        {
-        double flatness = shapeObject->GetFlatness();
-        vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
-        array->InsertTuple1(rowIndex, flatness);
-        }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Elongation))
-        {
-        double elongation = shapeObject->GetElongation();
-        vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
-        array->InsertTuple1(rowIndex, elongation);
-        }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::FeretDiameter))
-        {
-        double feretDiameter = shapeObject->GetFeretDiameter();
-        vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
-        array->InsertTuple1(rowIndex, feretDiameter);
-        }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::Perimeter))
+      shape.Centroid[row] = centroidObject[row];
+      shape.PrincipalMoments[row] = principalMoments[row];
+      for (unsigned int column = 0; column < 3; ++column)
         {
-        double perimeter = shapeObject->GetPerimeter();
-        vtkDoubleArray* array = GetArray<vtkDoubleArray>(output, statisticName, 1);
-        array->InsertTuple1(rowIndex, perimeter);
+        shape.PrincipalAxes[row][column] = principalAxes(row, column);
         }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::OrientedBoundingBox))
-        {
-        typename ShapeLabelObjectType::OrientedBoundingBoxPointType boundingBoxOrigin = shapeObject->GetOrientedBoundingBoxOrigin();
-        vtkDoubleArray* obbOriginArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxOrigin", 3);
-        obbOriginArray->InsertTuple3(rowIndex, boundingBoxOrigin[0], boundingBoxOrigin[1], boundingBoxOrigin[2]);
-
-        typename ShapeLabelObjectType::OrientedBoundingBoxPointType boundingBoxSize = shapeObject->GetOrientedBoundingBoxSize();
-        std::vector<std::string> componentNames = { "x", "y", "z" };
-        vtkDoubleArray* obbSizeArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxSize", 3, &componentNames);
-        obbSizeArray->InsertTuple3(rowIndex, boundingBoxSize[0], boundingBoxSize[1], boundingBoxSize[2]);
-
-        typename ShapeLabelObjectType::OrientedBoundingBoxDirectionType boundingBoxDirections = shapeObject->GetOrientedBoundingBoxDirection();
-        vtkDoubleArray* obbDirectionXArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionX", 3);
-        obbDirectionXArray->InsertTuple3(rowIndex, boundingBoxDirections(0, 0), boundingBoxDirections(0, 1), boundingBoxDirections(0, 2));
-        vtkDoubleArray* obbDirectionYArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionY", 3);
-        obbDirectionYArray->InsertTuple3(rowIndex, boundingBoxDirections(1, 0), boundingBoxDirections(1, 1), boundingBoxDirections(1, 2));
-        vtkDoubleArray* obbDirectionZArray = GetArray<vtkDoubleArray>(output, "OrientedBoundingBoxDirectionZ", 3);
-        obbDirectionZArray->InsertTuple3(rowIndex, boundingBoxDirections(2, 0), boundingBoxDirections(2, 1), boundingBoxDirections(2, 2));
-        }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::PrincipalMoments))
+      }
+    shape.Roundness = shapeObject->GetRoundness();
+    shape.Flatness = shapeObject->GetFlatness();
+    shape.Elongation = shapeObject->GetElongation();
+    shape.FeretDiameter = shapeObject->GetFeretDiameter();
+    shape.Perimeter = shapeObject->GetPerimeter();
+    if (computeOrientedBoundingBox)
+      {
+      typename ShapeLabelObjectType::OrientedBoundingBoxPointType boundingBoxOrigin = shapeObject->GetOrientedBoundingBoxOrigin();
+      typename ShapeLabelObjectType::OrientedBoundingBoxPointType boundingBoxSize = shapeObject->GetOrientedBoundingBoxSize();
+      typename ShapeLabelObjectType::OrientedBoundingBoxDirectionType boundingBoxDirections = shapeObject->GetOrientedBoundingBoxDirection();
+      for (unsigned int row = 0; row < 3; ++row)
         {
-        typename ShapeLabelObjectType::VectorType principalMoments = shapeObject->GetPrincipalMoments();
-        vtkDoubleArray* principalMomentsArray = GetArray<vtkDoubleArray>(output, statisticName, 3);
-        principalMomentsArray->InsertTuple3(rowIndex, principalMoments[0], principalMoments[1], principalMoments[2]);
+        shape.OrientedBoundingBoxOrigin[row] = boundingBoxOrigin[row];
+        shape.OrientedBoundingBoxSize[row] = boundingBoxSize[row];
+        for (unsigned int column = 0; column < 3; ++column)
+          {
+          shape.OrientedBoundingBoxDirection[row][column] = boundingBoxDirections(row, column);
+          }
         }
-      else if (statisticName == self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::PrincipalAxes))
+      }
+    AddLabelShapeToTable(self, output, rowIndex, labelValue, shape);
+    }
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void vtkITKLabelShapeStatisticsExecuteMultiThreaded(vtkITKLabelShapeStatistics* self, vtkImageData* input, vtkTable* output,
+  vtkMatrix4x4* directionMatrix, T* inPtr, int numberOfThreads)
+{
+  if (!self || !input || !output)
+    {
+    return;
+    }
+
+  // Clear current results
+  output->Initialize();
+
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  input->GetExtent(extent);
+  const int dims[3] = { extent[1] - extent[0] + 1, extent[3] - extent[2] + 1, extent[5] - extent[4] + 1 };
+  if (dims[0] <= 0 || dims[1] <= 0 || dims[2] <= 0)
+    {
+    return;
+    }
+  const vtkIdType inc1 = dims[0];
+  const vtkIdType inc2 = inc1 * dims[1];
+
+  // Split the slices between threads, a few slabs per thread balance the load
+  const int slabThickness = std::max(1, dims[2] / (4 * numberOfThreads));
+  const int numberOfSlabs = (dims[2] + slabThickness - 1) / slabThickness;
+  std::vector<std::map<T, LabelAccumulator>> slabAccumulators(numberOfSlabs);
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, numberOfSlabs, [&](int slab)
+    {
+    std::map<T, LabelAccumulator>& accumulators = slabAccumulators[slab];
+    T currentLabel = 0;
+    LabelAccumulator* accumulator = nullptr;
+    const int lastZ = std::min((slab + 1) * slabThickness, dims[2]) - 1;
+    for (int z = slab * slabThickness; z <= lastZ; ++z)
+      {
+      for (int y = 0; y < dims[1]; ++y)
         {
-        typename ShapeLabelObjectType::MatrixType principalAxes = shapeObject->GetPrincipalAxes();
-        vtkDoubleArray* principalAxisXArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisX", 3);
-        principalAxisXArray->InsertTuple3(rowIndex, principalAxes(0, 0), principalAxes(0, 1), principalAxes(0, 2));
-        vtkDoubleArray* principalAxisYArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisY", 3);
-        principalAxisYArray->InsertTuple3(rowIndex, principalAxes(1, 0), principalAxes(1, 1), principalAxes(1, 2));
-        vtkDoubleArray* principalAxisZArray = GetArray<vtkDoubleArray>(output, "PrincipalAxisZ", 3);
-        principalAxisZArray->InsertTuple3(rowIndex, principalAxes(2, 0), principalAxes(2, 1), principalAxes(2, 2));
+        const T* row = inPtr + z * inc2 + y * inc1;
+        // Neighbor row of each Crofton direction, nullptr if outside of the image
+        const T* neighborRows[NumberOfCroftonDirections] = { nullptr };
+        for (int direction = 0; direction < NumberOfCroftonDirections; ++direction)
+          {
+          const int* offset = CroftonDirections[direction];
+          const int neighborY = y + offset[1];
+          const int neighborZ = z + offset[2];
+          if (neighborY >= 0 && neighborY < dims[1] && neighborZ >= 0)
+            {
+            neighborRows[direction] = inPtr + neighborZ * inc2 + neighborY * inc1;
+            }
+          }
+
+        int x = 0;
+        while (x < dims[0])
+          {
+          const T label = row[x];
+          if (label == 0)
+            {
+            ++x;
+            continue;
+            }
+          const int begin = x;
+          while (x < dims[0] && row[x] == label)
+            {
+            ++x;
+            }
+          const int end = x - 1;
+          if (!accumulator || label != currentLabel)
+            {
+            accumulator = &accumulators[label];
+            currentLabel = label;
+            }
+          accumulator->AddRun(extent[0] + begin, extent[0] + end, extent[2] + y, extent[4] + z);
+
+          // The run ends at the voxel before a different label
+          accumulator->Intercepts[0] += 1;
+          for (int direction = 1; direction < NumberOfCroftonDirections; ++direction)
+            {
+            const T* neighborRow = neighborRows[direction];
+            const int offsetX = CroftonDirections[direction][0];
+            for (int runX = begin; runX <= end; ++runX)
+              {
+              const int neighborX = runX + offsetX;
+              if (!neighborRow || neighborX < 0 || neighborX >= dims[0] || neighborRow[neighborX] != label)
+                {
+                accumulator->Intercepts[direction] += 1;
+                }
+              }
+            }
+          }
         }
       }
+    });
+  self->UpdateProgress(0.5);
+
+  // Merge the slabs
+  std::map<T, LabelAccumulator> accumulators;
+  for (std::map<T, LabelAccumulator>& slabAccumulator : slabAccumulators)
+    {
+    for (auto& labelAccumulator : slabAccumulator)
+      {
+      accumulators[labelAccumulator.first].Add(labelAccumulator.second);
+      }
+    slabAccumulator.clear();
+    }
+
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  input->GetSpacing(spacing);
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  input->GetOrigin(origin);
+  double indexToPhysical[3][4] = { { 0.0 } };
+  for (int i = 0; i < 3; ++i)
+    {
+    for (int j = 0; j < 3; ++j)
+      {
+      const double direction = directionMatrix ? directionMatrix->GetElement(i, j) : (i == j ? 1.0 : 0.0);
+      indexToPhysical[i][j] = direction * spacing[j];
+      }
+    indexToPhysical[i][3] = origin[i];
+    }
+
+  bool computeFeretDiameter = self->GetComputeShapeStatistic(self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::ShapeStatistic::FeretDiameter));
+  bool computeOrientedBoundingBox =
+    self->GetComputeShapeStatistic(self->GetShapeStatisticAsString(vtkITKLabelShapeStatistics::ShapeStatistic::OrientedBoundingBox));
+
+  // Labels are processed in parallel, the largest ones first for better load balancing
+  std::vector<std::pair<T, LabelAccumulator*>> labels;
+  for (auto& labelAccumulator : accumulators)
+    {
+    labels.push_back(std::make_pair(labelAccumulator.first, &labelAccumulator.second));
+    }
+  std::vector<int> processingOrder(labels.size());
+  std::iota(processingOrder.begin(), processingOrder.end(), 0);
+  std::sort(processingOrder.begin(), processingOrder.end(), [&labels](int a, int b)
+    {
+    return labels[a].second->RunEnds.size() > labels[b].second->RunEnds.size();
+    });
+  std::vector<LabelShape> shapes(labels.size());
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, static_cast<int>(labels.size()), [&](int item)
+    {
+    const int labelIndex = processingOrder[item];
+    ComputeLabelShape(*labels[labelIndex].second, indexToPhysical, spacing,
+      computeFeretDiameter, computeOrientedBoundingBox, shapes[labelIndex]);
+    });
+
+  // Number of rows in the table is equal to the number of label values
+  output->SetNumberOfRows(labels.size());
+  for (size_t rowIndex = 0; rowIndex < labels.size(); ++rowIndex)
+    {
+    AddLabelShapeToTable(self, output, static_cast<int>(rowIndex), static_cast<long>(labels[rowIndex].first), shapes[rowIndex]);
     }
 }
 
@@ -397,9 +950,18 @@ int vtkITKLabelShapeStatistics::RequestData(
 #undef VTK_TYPE_USE_LONG_LONG
 #undef VTK_TYPE_USE___INT64
 
-#define CALL  vtkITKLabelShapeStatisticsExecute(this, input, output, this->Directions, static_cast<VTK_TT *>(inPtr));
+#define CALL \
+  if (this->MultiThreaded) \
+    { \
+    vtkITKLabelShapeStatisticsExecuteMultiThreaded(this, input, output, this->Directions, static_cast<VTK_TT *>(inPtr), numberOfThreads); \
+    } \
+  else \
+    { \
+    vtkITKLabelShapeStatisticsExecute(this, input, output, this->Directions, static_cast<VTK_TT *>(inPtr)); \
+    }
 
     void* inPtr = input->GetScalarPointer();
+    const int numberOfThreads = this->GetNumberOfThreadsToUse();
     switch (inScalars->GetDataType())
       {
       vtkTemplateMacroCase(VTK_LONG, long, CALL);                               \
@@ -45,6 +45,10 @@ class vtkPoints;
 /// For a list of availiable parameters, see: vtkITKLabelShapeStatistics::ShapeStatistic
 /// Calculated statistics can be changed using the SetComputeShapeStatistic/ComputeShapeStatisticOn/ComputeShapeStatisticOff methods.
 /// Output statistics are represented in a vtkTable where each column represents a statistic and each row is a different label value.
+///
+/// If MultiThreaded is enabled, the statistics of all the labels are computed without ITK,
+/// in a single pass over the image that is split between threads. This is much faster
+/// for labelmaps that contain many labels, such as shared labelmaps of segmentations.
 class VTK_ITK_EXPORT vtkITKLabelShapeStatistics : public vtkTableAlgorithm
 {
 public:
@@ -74,6 +78,8 @@ public:
     PrincipalMoments,
     // Principal axes of rotation
     PrincipalAxes,
+    /// Volume of the label in physical units
+    Volume,
     ShapeStatistic_Last,
   };
 
@@ -92,6 +98,19 @@ public:
   void ComputeShapeStatisticOn(std::string statisticName);
   void ComputeShapeStatisticOff(std::string statisticName);
 
+  ///
+  /// Compute the statistics of all the labels in a single multi-threaded pass
+  /// instead of using the ITK label shape filter. Disabled by default.
+  vtkSetMacro(MultiThreaded, bool);
+  vtkGetMacro(MultiThreaded, bool);
+  vtkBooleanMacro(MultiThreaded, bool);
+
+  ///
+  /// Number of threads used if MultiThreaded is enabled.
+  /// 0 (default) uses all the available cores.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkITKLabelShapeStatistics();
   ~vtkITKLabelShapeStatistics() override;
@@ -101,9 +120,14 @@ protected:
     vtkInformationVector** inputVector,
     vtkInformationVector* outputVector) override;
 
+  /// Number of threads resolved from NumberOfThreads, at least 1.
+  int GetNumberOfThreadsToUse();
+
 protected:
   std::vector<std::string> ComputedStatistics;
   vtkMatrix4x4* Directions;
+  bool MultiThreaded;
+  int NumberOfThreads;
 
 private:
   vtkITKLabelShapeStatistics(const vtkITKLabelShapeStatistics&) = delete;
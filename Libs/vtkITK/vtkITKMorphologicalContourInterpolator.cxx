@@ -19,8 +19,45 @@
 #include "vtkPointData.h"
 #include "vtkImageData.h"
 
+// vtkAddon includes
+#include <vtkAddonThreadingUtilities.h>
+
 #include "itkMorphologicalContourInterpolator.h"
 
+// STD includes
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Interpolation result of a label, in ProcessLabelsIndependently mode
+struct LabelCache
+{
+  /// Bounding box of the label, expanded by one voxel, in the input image
+  int Extent[6];
+  /// Input voxels within Extent that the result was computed from
+  std::vector<char> Input;
+  /// Voxels added by the interpolation, as offsets within Extent
+  std::vector<vtkIdType> InterpolatedVoxels;
+};
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkITKMorphologicalContourInterpolator::vtkInternal
+{
+public:
+  /// Results of each label in ProcessLabelsIndependently mode
+  std::map<long, LabelCache> LabelCaches;
+  /// Parameters that LabelCaches were computed with
+  std::string LabelCacheParameters;
+};
+
 vtkStandardNewMacro(vtkITKMorphologicalContourInterpolator);
 
 vtkITKMorphologicalContourInterpolator::vtkITKMorphologicalContourInterpolator()
@@ -29,24 +66,31 @@ vtkITKMorphologicalContourInterpolator::vtkITKMorphologicalContourInterpolator()
   , HeuristicAlignment(true)
   , UseDistanceTransform(false)
   , UseBallStructuringElement(false)
+  , ProcessLabelsIndependently(false)
+  , NumberOfThreads(0)
+  , NumberOfInterpolatedLabels(0)
 {
+  this->Internal = new vtkInternal;
 }
 
 vtkITKMorphologicalContourInterpolator::~vtkITKMorphologicalContourInterpolator()
-= default;
+{
+  delete this->Internal;
+}
 
+int vtkITKMorphologicalContourInterpolator::GetNumberOfThreadsToUse()
+{
+  return vtkAddonThreadingUtilities::GetNumberOfThreadsToUse(this->NumberOfThreads);
+}
 
+
+// Run the ITK filter on a buffer of dims voxels.
+// The ITK filter uses its default number of threads if numberOfThreads is 0.
 template <class T>
-void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInterpolator *self, vtkImageData* input,
-                vtkImageData* vtkNotUsed(output),
+void vtkITKMorphologicalContourInterpolatorRun(vtkITKMorphologicalContourInterpolator *self,
+                const int dims[3], const double spacing[3], long label, int numberOfThreads,
                 T* inPtr, T* outPtr)
 {
-
-  int dims[3];
-  input->GetDimensions(dims);
-  double spacing[3];
-  input->GetSpacing(spacing);
-
   // Wrap scalars into an ITK image
   // - mostly rely on defaults for spacing, origin etc for this filter
   typedef itk::Image<T, 3> ImageType;
@@ -70,11 +114,16 @@ void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInt
   typedef itk::MorphologicalContourInterpolator<ImageType> ContourInterpolatorType;
   typename ContourInterpolatorType::Pointer interpolatorFilter = ContourInterpolatorType::New();
 
-  interpolatorFilter->SetLabel(static_cast<T>(self->GetLabel()));
+  interpolatorFilter->SetLabel(static_cast<T>(label));
   interpolatorFilter->SetAxis(self->GetAxis());
   interpolatorFilter->SetHeuristicAlignment(self->GetHeuristicAlignment());
   interpolatorFilter->SetUseDistanceTransform(self->GetUseDistanceTransform());
   interpolatorFilter->SetUseBallStructuringElement(self->GetUseBallStructuringElement());
+  if (numberOfThreads > 0)
+    {
+    interpolatorFilter->GetMultiThreader()->SetMaximumNumberOfThreads(numberOfThreads);
+    interpolatorFilter->SetNumberOfWorkUnits(numberOfThreads);
+    }
 
   interpolatorFilter->SetInput( inImage );
   interpolatorFilter->Update();
@@ -85,6 +134,215 @@ void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInt
 
 }
 
+template <class T>
+void vtkITKMorphologicalContourInterpolatorExecute(vtkITKMorphologicalContourInterpolator *self, vtkImageData* input,
+                vtkImageData* vtkNotUsed(output),
+                T* inPtr, T* outPtr)
+{
+
+  int dims[3];
+  input->GetDimensions(dims);
+  double spacing[3];
+  input->GetSpacing(spacing);
+
+  vtkITKMorphologicalContourInterpolatorRun(self, dims, spacing, self->GetLabel(), 0, inPtr, outPtr);
+}
+
+// Interpolate each label within its bounding box, in parallel.
+// Results of labels whose bounding box and input voxels are the same as in labelCaches are reused.
+// Returns the number of labels that were interpolated.
+template <class T>
+int vtkITKMorphologicalContourInterpolatorExecuteIndependently(vtkITKMorphologicalContourInterpolator *self, vtkImageData* input,
+                T* inPtr, T* outPtr, int numberOfThreads, std::map<long, LabelCache>& labelCaches)
+{
+  int dims[3];
+  input->GetDimensions(dims);
+  double spacing[3];
+  input->GetSpacing(spacing);
+  int extent[6];
+  input->GetExtent(extent);
+  const vtkIdType inc1 = dims[0];
+  const vtkIdType inc2 = inc1 * dims[1];
+  const long onlyLabel = self->GetLabel();
+
+  // Input voxels are kept, interpolated voxels are added to them
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, dims[2], [&](int z)
+    {
+    std::copy(inPtr + z * inc2, inPtr + (z + 1) * inc2, outPtr + z * inc2);
+    });
+
+  // Bounding box of each label in each slice
+  typedef std::map<long, std::vector<int> > BoundingBoxesType;
+  std::vector<BoundingBoxesType> sliceBoundingBoxes(dims[2]);
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, dims[2], [&](int z)
+    {
+    BoundingBoxesType& boundingBoxes = sliceBoundingBoxes[z];
+    std::vector<int>* boundingBox = nullptr;
+    long currentLabel = 0;
+    for (int y = 0; y < dims[1]; ++y)
+      {
+      const T* row = inPtr + z * inc2 + y * inc1;
+      for (int x = 0; x < dims[0]; ++x)
+        {
+        const long label = static_cast<long>(row[x]);
+        if (label == 0 || (onlyLabel != 0 && label != onlyLabel))
+          {
+          continue;
+          }
+        if (!boundingBox || label != currentLabel)
+          {
+          currentLabel = label;
+          BoundingBoxesType::iterator boundingBoxIt = boundingBoxes.find(label);
+          if (boundingBoxIt == boundingBoxes.end())
+            {
+            boundingBoxIt = boundingBoxes.insert(std::make_pair(label, std::vector<int>{ x, x, y, y, z, z })).first;
+            }
+          boundingBox = &boundingBoxIt->second;
+          }
+        (*boundingBox)[0] = std::min((*boundingBox)[0], x);
+        (*boundingBox)[1] = std::max((*boundingBox)[1], x);
+        (*boundingBox)[3] = y;
+        }
+      }
+    });
+  BoundingBoxesType boundingBoxes;
+  for (BoundingBoxesType& sliceBoxes : sliceBoundingBoxes)
+    {
+    for (const auto& labelBox : sliceBoxes)
+      {
+      BoundingBoxesType::iterator boundingBoxIt = boundingBoxes.find(labelBox.first);
+      if (boundingBoxIt == boundingBoxes.end())
+        {
+        boundingBoxes.insert(labelBox);
+        continue;
+        }
+      std::vector<int>& boundingBox = boundingBoxIt->second;
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        boundingBox[2 * axis] = std::min(boundingBox[2 * axis], labelBox.second[2 * axis]);
+        boundingBox[2 * axis + 1] = std::max(boundingBox[2 * axis + 1], labelBox.second[2 * axis + 1]);
+        }
+      }
+    sliceBoxes.clear();
+    }
+
+  // Remove results of labels that are not in the input anymore
+  for (std::map<long, LabelCache>::iterator cacheIt = labelCaches.begin(); cacheIt != labelCaches.end();)
+    {
+    if (boundingBoxes.find(cacheIt->first) == boundingBoxes.end())
+      {
+      labelCaches.erase(cacheIt++);
+      }
+    else
+      {
+      ++cacheIt;
+      }
+    }
+
+  // Extract the bounding box of each label, expanded by one voxel so that the
+  // ITK filter sees the same neighbors as in the full image, and compare it to
+  // the input of the cached result
+  std::vector<long> labels;
+  std::vector<LabelCache*> caches;
+  for (const auto& labelBox : boundingBoxes)
+    {
+    labels.push_back(labelBox.first);
+    caches.push_back(&labelCaches[labelBox.first]);
+    }
+  std::vector<std::vector<T> > labelInputs(labels.size());
+  std::vector<int> changedLabels(labels.size(), 0);
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, static_cast<int>(labels.size()), [&](int labelIndex)
+    {
+    const std::vector<int>& boundingBox = boundingBoxes.find(labels[labelIndex])->second;
+    int labelExtent[6];
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      labelExtent[2 * axis] = std::max(boundingBox[2 * axis] - 1, 0) + extent[2 * axis];
+      labelExtent[2 * axis + 1] = std::min(boundingBox[2 * axis + 1] + 1, dims[axis] - 1) + extent[2 * axis];
+      }
+    std::vector<T>& labelInput = labelInputs[labelIndex];
+    const int rowLength = labelExtent[1] - labelExtent[0] + 1;
+    labelInput.reserve(static_cast<size_t>(rowLength) * (labelExtent[3] - labelExtent[2] + 1) * (labelExtent[5] - labelExtent[4] + 1));
+    for (int z = labelExtent[4]; z <= labelExtent[5]; ++z)
+      {
+      for (int y = labelExtent[2]; y <= labelExtent[3]; ++y)
+        {
+        const T* row = inPtr + (z - extent[4]) * inc2 + (y - extent[2]) * inc1 + (labelExtent[0] - extent[0]);
+        labelInput.insert(labelInput.end(), row, row + rowLength);
+        }
+      }
+
+    LabelCache& cache = *caches[labelIndex];
+    if (std::equal(labelExtent, labelExtent + 6, cache.Extent)
+      && cache.Input.size() == labelInput.size() * sizeof(T)
+      && memcmp(cache.Input.data(), labelInput.data(), cache.Input.size()) == 0)
+      {
+      // Same input as last time, the result is reused
+      std::vector<T>().swap(labelInput);
+      return;
+      }
+    std::copy(labelExtent, labelExtent + 6, cache.Extent);
+    cache.Input.resize(labelInput.size() * sizeof(T));
+    memcpy(cache.Input.data(), labelInput.data(), cache.Input.size());
+    changedLabels[labelIndex] = 1;
+    });
+
+  // Interpolate the changed labels. Threads that are not used for processing
+  // labels in parallel are used by the ITK filter.
+  std::vector<int> labelsToInterpolate;
+  for (size_t labelIndex = 0; labelIndex < labels.size(); ++labelIndex)
+    {
+    if (changedLabels[labelIndex])
+      {
+      labelsToInterpolate.push_back(static_cast<int>(labelIndex));
+      }
+    }
+  const int numberOfLabelsToInterpolate = static_cast<int>(labelsToInterpolate.size());
+  const int numberOfThreadsPerLabel = std::max(1, numberOfThreads / std::max(1, numberOfLabelsToInterpolate));
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, numberOfLabelsToInterpolate, [&](int item)
+    {
+    const int labelIndex = labelsToInterpolate[item];
+    const long label = labels[labelIndex];
+    LabelCache& cache = *caches[labelIndex];
+    std::vector<T>& labelInput = labelInputs[labelIndex];
+    const int labelDims[3] = { cache.Extent[1] - cache.Extent[0] + 1, cache.Extent[3] - cache.Extent[2] + 1, cache.Extent[5] - cache.Extent[4] + 1 };
+    std::vector<T> labelOutput(labelInput.size());
+    vtkITKMorphologicalContourInterpolatorRun(self, labelDims, spacing, label, numberOfThreadsPerLabel,
+      labelInput.data(), labelOutput.data());
+    cache.InterpolatedVoxels.clear();
+    for (size_t offset = 0; offset < labelOutput.size(); ++offset)
+      {
+      if (labelInput[offset] == 0 && static_cast<long>(labelOutput[offset]) == label)
+        {
+        cache.InterpolatedVoxels.push_back(static_cast<vtkIdType>(offset));
+        }
+      }
+    std::vector<T>().swap(labelInput);
+    });
+
+  // Add the interpolated voxels to the output, lower label values first
+  for (size_t labelIndex = 0; labelIndex < labels.size(); ++labelIndex)
+    {
+    const LabelCache& cache = *caches[labelIndex];
+    const T label = static_cast<T>(labels[labelIndex]);
+    const vtkIdType labelInc1 = cache.Extent[1] - cache.Extent[0] + 1;
+    const vtkIdType labelInc2 = labelInc1 * (cache.Extent[3] - cache.Extent[2] + 1);
+    T* labelOutPtr = outPtr + (cache.Extent[4] - extent[4]) * inc2 + (cache.Extent[2] - extent[2]) * inc1 + (cache.Extent[0] - extent[0]);
+    for (vtkIdType offset : cache.InterpolatedVoxels)
+      {
+      const vtkIdType z = offset / labelInc2;
+      const vtkIdType y = (offset % labelInc2) / labelInc1;
+      const vtkIdType x = offset % labelInc1;
+      T& voxel = labelOutPtr[z * inc2 + y * inc1 + x];
+      if (voxel == 0)
+        {
+        voxel = label;
+        }
+      }
+    }
+
+  return numberOfLabelsToInterpolate;
+}
 
 
 
@@ -119,11 +377,33 @@ void vtkITKMorphologicalContourInterpolator::SimpleExecute(vtkImageData *input,
 #undef VTK_TYPE_USE_LONG_LONG
 #undef VTK_TYPE_USE___INT64
 
-#define CALL  vtkITKMorphologicalContourInterpolatorExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr));
+#define CALL \
+  if (this->ProcessLabelsIndependently) \
+    { \
+    this->NumberOfInterpolatedLabels = vtkITKMorphologicalContourInterpolatorExecuteIndependently(this, input, \
+      static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr), this->GetNumberOfThreadsToUse(), this->Internal->LabelCaches); \
+    } \
+  else \
+    { \
+    vtkITKMorphologicalContourInterpolatorExecute(this, input, output, static_cast<VTK_TT *>(inPtr), static_cast<VTK_TT *>(outPtr)); \
+    }
 
     void* inPtr = input->GetScalarPointer();
     void* outPtr = output->GetScalarPointer();
 
+    // Cached results are only valid for the same parameters
+    std::ostringstream parameters;
+    double* spacing = input->GetSpacing();
+    parameters << inScalars->GetDataType() << " " << this->Axis << " " << this->HeuristicAlignment << " "
+      << this->UseDistanceTransform << " " << this->UseBallStructuringElement << " "
+      << spacing[0] << " " << spacing[1] << " " << spacing[2];
+    if (!this->ProcessLabelsIndependently || parameters.str() != this->Internal->LabelCacheParameters)
+      {
+      this->Internal->LabelCaches.clear();
+      this->Internal->LabelCacheParameters = this->ProcessLabelsIndependently ? parameters.str() : "";
+      }
+    this->NumberOfInterpolatedLabels = 0;
+
     switch (inScalars->GetDataType())
       {
       vtkTemplateMacroCase(VTK_LONG, long, CALL);                               \
@@ -151,4 +431,7 @@ void vtkITKMorphologicalContourInterpolator::PrintSelf(ostream& os, vtkIndent in
   os << indent << "HeuristicAlignment: " << HeuristicAlignment << std::endl;
   os << indent << "UseDistanceTransform: " << UseDistanceTransform << std::endl;
   os << indent << "UseBallStructuringElement: " << UseBallStructuringElement << std::endl;
+  os << indent << "ProcessLabelsIndependently: " << ProcessLabelsIndependently << std::endl;
+  os << indent << "NumberOfThreads: " << NumberOfThreads << std::endl;
+  os << indent << "NumberOfInterpolatedLabels: " << NumberOfInterpolatedLabels << std::endl;
 }
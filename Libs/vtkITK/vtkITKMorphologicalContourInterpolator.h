@@ -14,6 +14,11 @@
 #include "vtkSimpleImageToImageFilter.h"
 
 /// \brief Wrapper class around itk::MorphologicalContourInterpolator.
+///
+/// If ProcessLabelsIndependently is enabled, each label is interpolated separately,
+/// within its bounding box, and labels are processed in parallel. Results are kept
+/// between updates and a label is only interpolated again if its region of the input
+/// changed, which makes repeated updates after editing a few labels fast.
 class VTK_ITK_EXPORT vtkITKMorphologicalContourInterpolator : public vtkSimpleImageToImageFilter
 {
 public:
@@ -44,19 +49,46 @@ public:
   vtkGetMacro(UseBallStructuringElement, bool);
   vtkSetMacro(UseBallStructuringElement, bool);
 
+  /// Interpolate each label separately within its bounding box, in parallel,
+  /// and reuse results of labels whose input did not change since the last update.
+  /// Where interpolated regions of different labels overlap, the lower label value is kept.
+  /// Default is OFF (all labels are interpolated together in the whole image).
+  vtkGetMacro(ProcessLabelsIndependently, bool);
+  vtkSetMacro(ProcessLabelsIndependently, bool);
+  vtkBooleanMacro(ProcessLabelsIndependently, bool);
+
+  /// Number of labels processed in parallel if ProcessLabelsIndependently is enabled.
+  /// 0 (default) uses all the available cores.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  /// Number of labels that were interpolated in the last update,
+  /// the others were reused from the previous update.
+  /// Only set if ProcessLabelsIndependently is enabled.
+  vtkGetMacro(NumberOfInterpolatedLabels, int);
+
 protected:
   vtkITKMorphologicalContourInterpolator();
   ~vtkITKMorphologicalContourInterpolator() override;
 
   void SimpleExecute(vtkImageData* input, vtkImageData* output) override;
 
+  /// Number of threads resolved from NumberOfThreads, at least 1.
+  int GetNumberOfThreadsToUse();
+
   long Label;
   int Axis;
   bool HeuristicAlignment;
   bool UseDistanceTransform;
   bool UseBallStructuringElement;
+  bool ProcessLabelsIndependently;
+  int NumberOfThreads;
+  int NumberOfInterpolatedLabels;
 
 private:
+  class vtkInternal;
+  vtkInternal* Internal;
+
   vtkITKMorphologicalContourInterpolator(const vtkITKMorphologicalContourInterpolator&) = delete;
   void operator=(const vtkITKMorphologicalContourInterpolator&) = delete;
 };
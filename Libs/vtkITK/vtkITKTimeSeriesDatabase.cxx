@@ -16,9 +16,126 @@
 #include <vtkInformation.h>
 #include <vtkInformationVector.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
-#include <vtkUnsignedLongArray.h>
+
+// STD includes
+#include <algorithm>
+#include <cstring>
 
 vtkStandardNewMacro(vtkITKTimeSeriesDatabase);
+
+//----------------------------------------------------------------------------
+bool vtkITKTimeSeriesDatabase::Connect(const char* filename)
+{
+  this->StopPrefetch();
+  this->Connected = false;
+  if (!filename)
+    {
+    vtkErrorMacro("Connect: invalid filename");
+    return false;
+    }
+  try
+    {
+    this->m_Filter->Connect(filename);
+    }
+  catch (itk::ExceptionObject& e)
+    {
+    vtkErrorMacro("Connect: failed to open time series database " << filename << ": " << e.GetDescription());
+    return false;
+    }
+  this->Connected = true;
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::Disconnect()
+{
+  this->StopPrefetch();
+  this->m_Filter->Disconnect();
+  this->Connected = false;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::GetOutputOrigin(double origin[3])
+{
+  for (int i = 0; i < 3; i++)
+    {
+    origin[i] = this->m_Filter->GetOutputOrigin()[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::GetOutputSpacing(double spacing[3])
+{
+  for (int i = 0; i < 3; i++)
+    {
+    spacing[i] = this->m_Filter->GetOutputSpacing()[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::GetOutputDirection(double direction[3][3])
+{
+  for (int i = 0; i < 3; i++)
+    {
+    for (int j = 0; j < 3; j++)
+      {
+      direction[i][j] = this->m_Filter->GetOutputDirection()[i][j];
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::WaitForPrefetch()
+{
+  if (this->PrefetchThread.joinable())
+    {
+    this->PrefetchThread.join();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::StopPrefetch()
+{
+  if (this->PrefetchThread.joinable())
+    {
+    this->m_Filter->SetAbortPrefetch(true);
+    this->PrefetchThread.join();
+    }
+  this->m_Filter->SetAbortPrefetch(false);
+}
+
+//----------------------------------------------------------------------------
+void vtkITKTimeSeriesDatabase::StartPrefetch()
+{
+  this->StopPrefetch();
+  int numberOfVolumes = this->m_Filter->GetNumberOfVolumes();
+  unsigned long blocksPerImage = this->m_Filter->GetNumberOfBlocksPerImage();
+  if (numberOfVolumes < 2 || blocksPerImage == 0)
+    {
+    return;
+    }
+  // Prefetching more images than the cache holds would evict the current
+  // image and the first prefetched ones before they are used.
+  int imagesInCache = static_cast<int>(this->m_Filter->GetCacheSizeInBlocks() / blocksPerImage);
+  int numberOfImages = std::min(this->NumberOfPrefetchedImages, imagesInCache - 1);
+  numberOfImages = std::min(numberOfImages, numberOfVolumes - 1);
+  if (numberOfImages <= 0)
+    {
+    return;
+    }
+  SourceType::Pointer filter = this->m_Filter;
+  unsigned int currentImage = filter->GetCurrentImage();
+  // Cine playback loops, so wrap around at the end of the series
+  this->PrefetchThread = std::thread([filter, currentImage, numberOfImages, numberOfVolumes]()
+    {
+    for (int i = 1; i <= numberOfImages && !filter->GetAbortPrefetch(); i++)
+      {
+      filter->PrefetchImage((currentImage + i) % numberOfVolumes);
+      }
+    });
+}
 int vtkITKTimeSeriesDatabase::RequestInformation(
   vtkInformation * vtkNotUsed(request),
   vtkInformationVector ** vtkNotUsed(inputVector),
@@ -50,16 +167,35 @@ int vtkITKTimeSeriesDatabase::RequestInformation(
 };
 
 
-  // defined in the subclasses
+//----------------------------------------------------------------------------
 void vtkITKTimeSeriesDatabase::ExecuteDataWithInformation(vtkDataObject *output, vtkInformation* outInfo)
-  {
-    this->AllocateOutputData(output, outInfo);
-    itk::ImportImageContainer<itk::SizeValueType, OutputImagePixelType>::Pointer PixelContainerShort;
-    PixelContainerShort = this->m_Filter->GetOutput()->GetPixelContainer();
-    void *ptr = static_cast<void *> (PixelContainerShort->GetBufferPointer());
-    vtkUnsignedLongArray::SafeDownCast(
-      vtkImageData::SafeDownCast(output)->GetPointData()->GetScalars())
-      ->SetVoidArray(ptr, PixelContainerShort->Size(), 0,
-                     vtkAOSDataArrayTemplate<unsigned long>::VTK_DATA_ARRAY_DELETE);
-    PixelContainerShort->ContainerManageMemoryOff();
-  };
+{
+  vtkImageData* data = this->AllocateOutputData(output, outInfo);
+  if (!this->Connected)
+    {
+    vtkErrorMacro("ExecuteDataWithInformation: not connected to a time series database");
+    return;
+    }
+  // The prefetch thread competes for the same files, let the requested image go first
+  this->StopPrefetch();
+  try
+    {
+    this->m_Filter->UpdateLargestPossibleRegion();
+    }
+  catch (itk::ExceptionObject& e)
+    {
+    vtkErrorMacro("ExecuteDataWithInformation: failed to read image "
+      << this->m_Filter->GetCurrentImage() << ": " << e.GetDescription());
+    return;
+    }
+  OutputImageType* image = this->m_Filter->GetOutput();
+  vtkIdType numberOfPixels = static_cast<vtkIdType>(image->GetBufferedRegion().GetNumberOfPixels());
+  if (numberOfPixels != data->GetNumberOfPoints())
+    {
+    vtkErrorMacro("ExecuteDataWithInformation: image size mismatch");
+    return;
+    }
+  memcpy(data->GetScalarPointer(), image->GetBufferPointer(), numberOfPixels * sizeof(OutputImagePixelType));
+
+  this->StartPrefetch();
+}
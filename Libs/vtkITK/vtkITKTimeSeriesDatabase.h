@@ -15,6 +15,7 @@
 #ifndef __vtkITKTimeSeriesDatabase_h
 #define __vtkITKTimeSeriesDatabase_h
 
+#include <thread>
 #include <vector>
 
 #include "vtkImageData.h"
@@ -34,6 +35,11 @@
 /// stored on disk.  The database allows efficient access to volumes,
 /// slices and voxels through time.
 ///
+/// Blocks of the database are kept in a LRU cache.  After an image is
+/// generated, the following NumberOfPrefetchedImages images are read into
+/// the cache by a background thread so that browsing the series frame by
+/// frame (e.g. cine playback) does not wait on the disk.
+///
 /// \note
 /// This work is part of the National Alliance for Medical Image Computing
 /// (NAMIC), funded by the National Institutes of Health through the NIH Roadmap
@@ -53,19 +59,48 @@ public:
     itk::TimeSeriesDatabase<OutputImagePixelType>::CreateFromFileArchetype ( TSDFilename, ArchetypeFilename );
   };
 
-  /// Connect/Disconnect to a database
-  /// void Connect ( const char* filename ) { this->m_Filter->Connect ( filename ); this->Modified(); };
-  /// void Disconnect() { this->m_Filter->Disconnect(); }
+  /// Connect/Disconnect to a database.
+  /// Connect returns false if the database header could not be read.
+  bool Connect ( const char* filename );
+  void Disconnect();
+  bool IsConnected() { return this->Connected; }
 
   /// Get/Set the current time stamp to read
   void SetCurrentImage ( unsigned int value )
   { DelegateITKInputMacro ( SetCurrentImage, value); };
-  unsigned int GetCurrentImage ( unsigned int vtkNotUsed(value) )
+  unsigned int GetCurrentImage ()
   { DelegateITKOutputMacro ( GetCurrentImage ); };
 
   int GetNumberOfVolumes()
   { DelegateITKOutputMacro ( GetNumberOfVolumes ); };
 
+  /// Geometry of the images, in the LPS coordinate system of ITK.
+  void GetOutputOrigin ( double origin[3] );
+  void GetOutputSpacing ( double spacing[3] );
+  void GetOutputDirection ( double direction[3][3] );
+
+  /// Get/Set the size of the block cache in MiB
+  void SetCacheSizeInMiB ( float value )
+  { DelegateITKInputMacro ( SetCacheSizeInMiB, value ); };
+  float GetCacheSizeInMiB ()
+  { DelegateITKOutputMacro ( GetCacheSizeInMiB ); };
+
+  /// Fraction of the block lookups served from the cache, in [0,1]
+  double GetCacheHitRate ()
+  { DelegateITKOutputMacro ( GetCacheHitRate ); };
+  void ResetCacheStatistics ()
+  { this->m_Filter->ResetCacheStatistics(); };
+
+  /// Number of images following the current one that are read into the
+  /// cache in the background after each update. The count is clamped to
+  /// the number of images that fit in the cache. 0 disables prefetching.
+  /// Default is 0.
+  vtkSetClampMacro(NumberOfPrefetchedImages, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPrefetchedImages, int);
+
+  /// Wait for the background prefetch to complete.
+  void WaitForPrefetch();
+
 protected:
   vtkITKTimeSeriesDatabase()
     {
@@ -74,9 +109,13 @@ protected:
     this->vtkImporter = vtkImageImport::New();
     ConnectPipelines ( this->itkExporter, this->vtkImporter );
     this->itkExporter->SetInput ( m_Filter->GetOutput() );
+    this->Connected = false;
+    this->NumberOfPrefetchedImages = 0;
+    this->SetNumberOfInputPorts(0);
     };
   ~vtkITKTimeSeriesDatabase() override
     {
+    this->StopPrefetch();
     this->vtkImporter->Delete();
     }
   typedef short InputImagePixelType;
@@ -90,6 +129,15 @@ protected:
   ImageExportType::Pointer itkExporter;
   vtkImageImport* vtkImporter;
 
+  /// Abort and join the background prefetch thread, if any
+  void StopPrefetch();
+  /// Start reading the images following the current one in the background
+  void StartPrefetch();
+
+  bool Connected;
+  int NumberOfPrefetchedImages;
+  std::thread PrefetchThread;
+
   int RequestInformation(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   /// defined in the subclasses
   void ExecuteDataWithInformation(vtkDataObject *output, vtkInformation *outInfo) override;
@@ -0,0 +1,190 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkImageStencilData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkPolyDataToImageStencil.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkStripper.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+#include <vtkTriangleFilter.h>
+
+// SegmentationCore includes
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+#include <vtkOrientedImageData.h>
+#include <vtkSegment.h>
+#include <vtkSegmentation.h>
+#include <vtkSegmentationConverter.h>
+#include <vtkSegmentationConverterFactory.h>
+
+// STD includes
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Rasterize the surface the way the conversion rule used to: stencil of the whole labelmap extent
+int CountReferenceDifferences(vtkPolyData* closedSurface, vtkOrientedImageData* binaryLabelmap)
+{
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  binaryLabelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  vtkNew<vtkTransform> worldToImageTransform;
+  worldToImageTransform->SetMatrix(imageToWorldMatrix.GetPointer());
+  worldToImageTransform->Inverse();
+
+  vtkNew<vtkTransformPolyDataFilter> transformPolyDataFilter;
+  transformPolyDataFilter->SetInputData(closedSurface);
+  transformPolyDataFilter->SetTransform(worldToImageTransform.GetPointer());
+  vtkNew<vtkPolyDataNormals> normalFilter;
+  normalFilter->SetInputConnection(transformPolyDataFilter->GetOutputPort());
+  normalFilter->ConsistencyOn();
+  vtkNew<vtkTriangleFilter> triangle;
+  triangle->SetInputConnection(normalFilter->GetOutputPort());
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(triangle->GetOutputPort());
+  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
+  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
+  polyDataToImageStencil->SetOutputSpacing(1.0, 1.0, 1.0);
+  polyDataToImageStencil->SetOutputOrigin(0.0, 0.0, 0.0);
+  polyDataToImageStencil->SetOutputWholeExtent(binaryLabelmap->GetExtent());
+  polyDataToImageStencil->Update();
+  vtkImageStencilData* stencilData = polyDataToImageStencil->GetOutput();
+
+  int differences = 0;
+  int* extent = binaryLabelmap->GetExtent();
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        bool inside = stencilData->IsInside(i, j, k);
+        unsigned char value = *static_cast<unsigned char*>(binaryLabelmap->GetScalarPointer(i, j, k));
+        if (inside != (value != 0))
+          {
+          ++differences;
+          }
+        }
+      }
+    }
+  return differences;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkClosedSurfaceToBinaryLabelmapConversionTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkClosedSurfaceToBinaryLabelmapConversionRule>::New());
+
+  // Oblique reference geometry, larger than the segments
+  vtkNew<vtkOrientedImageData> referenceGeometry;
+  referenceGeometry->SetExtent(0, 119, 0, 99, 0, 79);
+  referenceGeometry->SetSpacing(0.9, 1.1, 1.5);
+  referenceGeometry->SetOrigin(-50.0, -40.0, -30.0);
+  vtkNew<vtkTransform> directions;
+  directions->RotateX(10.0);
+  directions->RotateZ(25.0);
+  vtkNew<vtkMatrix4x4> directionMatrix;
+  directions->GetMatrix(directionMatrix.GetPointer());
+  double directionArray[3][3];
+  for (int row = 0; row < 3; ++row)
+    {
+    for (int column = 0; column < 3; ++column)
+      {
+      directionArray[row][column] = directionMatrix->GetElement(row, column);
+      }
+    }
+  referenceGeometry->SetDirections(directionArray);
+
+  // Non-overlapping spheres of various sizes
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
+  segmentation->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(),
+    vtkSegmentationConverter::SerializeImageGeometry(referenceGeometry.GetPointer()));
+  const int numberOfSegments = 12;
+  std::vector<vtkSegment*> segments;
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetCenter(-20.0 + 15.0 * (segmentIndex % 4), -15.0 + 15.0 * (segmentIndex / 4), 5.0);
+    sphere->SetRadius(2.0 + segmentIndex * 0.5);
+    sphere->SetThetaResolution(24);
+    sphere->SetPhiResolution(16);
+    sphere->Update();
+    vtkNew<vtkSegment> segment;
+    std::stringstream segmentName;
+    segmentName << "sphere" << segmentIndex;
+    segment->SetName(segmentName.str().c_str());
+    segment->AddRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), sphere->GetOutput());
+    segmentation->AddSegment(segment.GetPointer());
+    segments.push_back(segment.GetPointer());
+    }
+
+  // Same result as a stencil of the whole extent, independently of the number of threads
+  for (int numberOfThreads = 1; numberOfThreads <= 4; numberOfThreads += 3)
+    {
+    vtkNew<vtkClosedSurfaceToBinaryLabelmapConversionRule> rule;
+    rule->SetConversionParameter(vtkSegmentationConverter::GetReferenceImageGeometryParameterName(),
+      vtkSegmentationConverter::SerializeImageGeometry(referenceGeometry.GetPointer()));
+    rule->SetNumberOfThreads(numberOfThreads);
+    if (!rule->ConvertSegments(segments))
+      {
+      std::cerr << __LINE__ << ": Conversion failed with " << numberOfThreads << " threads!" << std::endl;
+      return EXIT_FAILURE;
+      }
+    for (vtkSegment* segment : segments)
+      {
+      vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(
+        segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+      vtkPolyData* closedSurface = vtkPolyData::SafeDownCast(
+        segment->GetRepresentation(vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName()));
+      if (!binaryLabelmap || binaryLabelmap->IsEmpty())
+        {
+        std::cerr << __LINE__ << ": Segment " << segment->GetName() << " was not converted!" << std::endl;
+        return EXIT_FAILURE;
+        }
+      int differences = CountReferenceDifferences(closedSurface, binaryLabelmap);
+      if (differences != 0)
+        {
+        std::cerr << __LINE__ << ": Segment " << segment->GetName() << " has " << differences
+          << " voxels different from the reference with " << numberOfThreads << " threads!" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  // Segments are converted into a shared labelmap
+  segmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(), true);
+  if (segmentation->GetNumberOfLayers(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()) != 1)
+    {
+    std::cerr << __LINE__ << ": Non-overlapping segments are expected in one shared labelmap, got "
+      << segmentation->GetNumberOfLayers(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName())
+      << " layers!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Closed surface to binary labelmap conversion test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
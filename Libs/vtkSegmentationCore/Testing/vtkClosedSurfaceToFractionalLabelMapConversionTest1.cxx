@@ -52,6 +52,12 @@ int vtkClosedSurfaceToFractionalLabelMapConversionTest1(int vtkNotUsed(argc), ch
   sphereSegment->AddRepresentation(
     vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), spherePolyData.GetPointer());
 
+  // Second segment, so that the segments are converted together
+  vtkNew<vtkSegment> sphereSegment2;
+  sphereSegment2->SetName("sphere2");
+  sphereSegment2->AddRepresentation(
+    vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName(), spherePolyData.GetPointer());
+
   // Image geometry used for conversion
   std::string serializedImageGeometry = "1; 0; 0; 20.7521629333496;"
                                         "0; 1; 0; 20.7521629333496;"
@@ -65,6 +71,7 @@ int vtkClosedSurfaceToFractionalLabelMapConversionTest1(int vtkNotUsed(argc), ch
   sphereSegmentation->SetMasterRepresentationName(
     vtkSegmentationConverter::GetSegmentationClosedSurfaceRepresentationName());
   sphereSegmentation->AddSegment(sphereSegment.GetPointer());
+  sphereSegmentation->AddSegment(sphereSegment2.GetPointer());
 
   sphereSegmentation->CreateRepresentation(vtkSegmentationConverter::GetSegmentationFractionalLabelmapRepresentationName());
   if (!sphereSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationFractionalLabelmapRepresentationName()))
@@ -75,6 +82,11 @@ int vtkClosedSurfaceToFractionalLabelMapConversionTest1(int vtkNotUsed(argc), ch
 
   vtkOrientedImageData* fractionalLabelmap = vtkOrientedImageData::SafeDownCast(
     sphereSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationFractionalLabelmapRepresentationName()) );
+  if (!fractionalLabelmap || fractionalLabelmap->GetScalarType() != VTK_FRACTIONAL_DATA_TYPE)
+  {
+    std::cerr << __LINE__ << ": Fractional labelmap is not of type " << VTK_FRACTIONAL_DATA_TYPE << "!" << std::endl;
+    return EXIT_FAILURE;
+  }
 
   vtkNew<vtkImageAccumulate> imageAccumulate;
   imageAccumulate->SetInputData(fractionalLabelmap);
@@ -132,6 +144,24 @@ int vtkClosedSurfaceToFractionalLabelMapConversionTest1(int vtkNotUsed(argc), ch
     return EXIT_FAILURE;
   }
 
+  // Segments converted together produce the same labelmap as converted one by one
+  vtkOrientedImageData* fractionalLabelmap2 = vtkOrientedImageData::SafeDownCast(
+    sphereSegment2->GetRepresentation(vtkSegmentationConverter::GetSegmentationFractionalLabelmapRepresentationName()) );
+  if (!fractionalLabelmap2 || fractionalLabelmap2->GetScalarType() != VTK_FRACTIONAL_DATA_TYPE)
+  {
+    std::cerr << __LINE__ << ": Second fractional labelmap is not of type " << VTK_FRACTIONAL_DATA_TYPE << "!" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkImageAccumulate> imageAccumulate2;
+  imageAccumulate2->SetInputData(fractionalLabelmap2);
+  imageAccumulate2->Update();
+  if (imageAccumulate2->GetVoxelCount() != voxelCount || std::abs(imageAccumulate2->GetMean()[0] - meanValue) > 0.00001)
+  {
+    std::cerr << __LINE__ << ": Second fractional labelmap voxel count: " << imageAccumulate2->GetVoxelCount()
+      << " and mean: " << std::fixed << imageAccumulate2->GetMean()[0] << " do not match the first labelmap!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
   std::cout << "Closed surface to fractional labelmap conversion test passed." << std::endl;
   return EXIT_SUCCESS;
 }
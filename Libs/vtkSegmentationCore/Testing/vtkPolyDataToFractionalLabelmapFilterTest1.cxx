@@ -0,0 +1,194 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTimerLog.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+
+// SegmentationCore includes
+#include <vtkOrientedImageData.h>
+#include <vtkPolyDataToFractionalLabelmapFilter.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Region of interest of a synthetic RT structure set: an ellipsoid
+struct StructureInfo
+{
+  double Center[3];
+  double Radii[3];
+};
+
+//----------------------------------------------------------------------------
+// Structures similar to a DICOM-RT structure set: a large body contour,
+// organs of various sizes and many small targets and markers.
+std::vector<StructureInfo> CreateStructureSet(int numberOfStructures)
+{
+  std::vector<StructureInfo> structures;
+  StructureInfo body = { { 0.0, 0.0, 0.0 }, { 170.0, 120.0, 150.0 } };
+  structures.push_back(body);
+  vtkMath::RandomSeed(7);
+  for (int i = 1; i < numberOfStructures; ++i)
+    {
+    // Every fourth structure is an organ, the others are small
+    double size = (i % 4 == 0) ? vtkMath::Random(25.0, 60.0) : vtkMath::Random(5.0, 15.0);
+    StructureInfo structure;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      structure.Radii[axis] = size * vtkMath::Random(0.7, 1.3);
+      structure.Center[axis] = vtkMath::Random(-0.5, 0.5) * (body.Radii[axis] - structure.Radii[axis]);
+      }
+    structures.push_back(structure);
+    }
+  return structures;
+}
+
+//----------------------------------------------------------------------------
+void CreateStructurePolyData(const StructureInfo& structure, vtkPolyData* polyData)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(1.0);
+  sphere->SetThetaResolution(48);
+  sphere->SetPhiResolution(32);
+  vtkNew<vtkTransform> transform;
+  transform->Translate(structure.Center);
+  transform->Scale(structure.Radii);
+  vtkNew<vtkTransformPolyDataFilter> transformFilter;
+  transformFilter->SetInputConnection(sphere->GetOutputPort());
+  transformFilter->SetTransform(transform.GetPointer());
+  transformFilter->Update();
+  polyData->DeepCopy(transformFilter->GetOutput());
+}
+
+//----------------------------------------------------------------------------
+// Convert all the structures on a CT-like grid, return the elapsed time
+double ConvertStructures(const std::vector<vtkSmartPointer<vtkPolyData> >& structures, int numberOfThreads,
+  std::vector<vtkSmartPointer<vtkOrientedImageData> >& labelmaps)
+{
+  const double spacing[3] = { 1.17, 1.17, 3.0 };
+  labelmaps.clear();
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  for (vtkPolyData* structure : structures)
+    {
+    double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    structure->GetBounds(bounds);
+    int extent[6] = { 0, -1, 0, -1, 0, -1 };
+    vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      imageToWorldMatrix->SetElement(axis, axis, spacing[axis]);
+      imageToWorldMatrix->SetElement(axis, 3, bounds[2 * axis]);
+      extent[2 * axis] = -1;
+      extent[2 * axis + 1] = static_cast<int>((bounds[2 * axis + 1] - bounds[2 * axis]) / spacing[axis]) + 2;
+      }
+
+    vtkNew<vtkPolyDataToFractionalLabelmapFilter> filter;
+    filter->SetInputData(structure);
+    filter->SetOutputImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+    filter->SetOutputWholeExtent(extent);
+    filter->SetNumberOfThreads(numberOfThreads);
+    filter->Update();
+    vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    labelmap->DeepCopy(filter->GetOutput());
+    labelmaps.push_back(labelmap);
+    }
+  timer->StopTimer();
+  return timer->GetElapsedTime();
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Converts a synthetic RT structure set and reports the conversion time.
+// Optional argument: number of structures (default 16, use 100+ for benchmarking)
+int vtkPolyDataToFractionalLabelmapFilterTest1(int argc, char* argv[])
+{
+  int numberOfStructures = 16;
+  if (argc > 1)
+    {
+    numberOfStructures = std::max(1, atoi(argv[1]));
+    }
+
+  std::vector<StructureInfo> structureInfos = CreateStructureSet(numberOfStructures);
+  std::vector<vtkSmartPointer<vtkPolyData> > structures;
+  for (const StructureInfo& structureInfo : structureInfos)
+    {
+    vtkSmartPointer<vtkPolyData> structure = vtkSmartPointer<vtkPolyData>::New();
+    CreateStructurePolyData(structureInfo, structure);
+    structures.push_back(structure);
+    }
+
+  std::vector<vtkSmartPointer<vtkOrientedImageData> > singleThreadedLabelmaps;
+  double singleThreadedTime = ConvertStructures(structures, 1, singleThreadedLabelmaps);
+  std::vector<vtkSmartPointer<vtkOrientedImageData> > multiThreadedLabelmaps;
+  double multiThreadedTime = ConvertStructures(structures, 0, multiThreadedLabelmaps);
+  std::cout << "Fractional labelmap conversion of " << numberOfStructures << " structures: "
+    << singleThreadedTime << "s on 1 thread, " << multiThreadedTime << "s on all threads" << std::endl;
+
+  for (int structureIndex = 0; structureIndex < numberOfStructures; ++structureIndex)
+    {
+    vtkOrientedImageData* labelmap = multiThreadedLabelmaps[structureIndex];
+    vtkOrientedImageData* singleThreadedLabelmap = singleThreadedLabelmaps[structureIndex];
+
+    // Same result independently of the number of threads
+    int* dimensions = labelmap->GetDimensions();
+    size_t numberOfVoxels = static_cast<size_t>(dimensions[0]) * dimensions[1] * dimensions[2];
+    if (numberOfVoxels != static_cast<size_t>(singleThreadedLabelmap->GetNumberOfPoints())
+      || memcmp(labelmap->GetScalarPointer(), singleThreadedLabelmap->GetScalarPointer(),
+        numberOfVoxels * labelmap->GetScalarSize()) != 0)
+      {
+      std::cerr << __LINE__ << ": Multi-threaded conversion of structure " << structureIndex
+        << " does not match single-threaded conversion!" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Volume of the fractional labelmap is close to the volume of the ellipsoid
+    FRACTIONAL_DATA_TYPE* voxels = static_cast<FRACTIONAL_DATA_TYPE*>(labelmap->GetScalarPointer());
+    double fractionalVoxelCount = 0.0;
+    for (size_t i = 0; i < numberOfVoxels; ++i)
+      {
+      fractionalVoxelCount += static_cast<double>(voxels[i] - FRACTIONAL_MIN) / (FRACTIONAL_MAX - FRACTIONAL_MIN);
+      }
+    double* spacing = labelmap->GetSpacing();
+    double volume = fractionalVoxelCount * spacing[0] * spacing[1] * spacing[2];
+    const double* radii = structureInfos[structureIndex].Radii;
+    double expectedVolume = 4.0 / 3.0 * vtkMath::Pi() * radii[0] * radii[1] * radii[2];
+    if (std::abs(volume - expectedVolume) > 0.1 * expectedVolume)
+      {
+      std::cerr << __LINE__ << ": Volume of structure " << structureIndex << ": " << volume
+        << " does not match expected value: " << expectedVolume << "!" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Poly data to fractional labelmap filter test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
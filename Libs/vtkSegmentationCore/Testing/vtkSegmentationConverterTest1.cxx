@@ -45,6 +45,9 @@
 //----------------------------------------------------------------------------
 // Conversion graph
 
+// Number of conversion cost queries, used for checking that conversion paths are cached
+static int NumberOfConversionCostEvaluations = 0;
+
 // Convenience macro for defining a converter rule class with a single line
 #define RULE(from, to, weight) \
 class vtkRep##from##ToRep##to##Rule: public vtkSegmentationConverterRule \
@@ -65,6 +68,7 @@ public: \
   { \
     (void)sourceRepresentation; \
     (void)targetRepresentation; \
+    ++NumberOfConversionCostEvaluations; \
     return weight; \
   }; \
   virtual const char* GetName() override { return "Rep " #from " to Rep " #to; } \
@@ -198,6 +202,31 @@ int vtkSegmentationConverterTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[]
   PrintPath(shortestPath);
   VERIFY_EQUAL("number of paths from representation C to D", shortestPath.size(), 1);
 
+  // Paths are cached, conversion costs are not evaluated again
+  std::cout << "Conversion path caching" << std::endl;
+  int numberOfConversionCostEvaluations = NumberOfConversionCostEvaluations;
+  converter->GetPossibleConversions("RepA", "RepE", pathsCosts);
+  VERIFY_EQUAL("number of cached paths from representation A to E", pathsCosts.size(), 3);
+  shortestPath = converter->GetCheapestConversionPath("RepB", "RepD");
+  VERIFY_EQUAL("number of rules in cached cheapest path from representation B to D", shortestPath.size(), 2);
+  VERIFY_EQUAL("number of cost evaluations for cached paths", NumberOfConversionCostEvaluations, numberOfConversionCostEvaluations);
+  shortestPath = converter->GetCheapestConversionPath("RepE", "RepA");
+  VERIFY_EQUAL("number of rules in cheapest path from representation E to A", shortestPath.size(), 0);
+
+  // Changing a conversion parameter of a rule invalidates the cache
+  converter->GetPossibleConversions("RepC", "RepD", pathsCosts);
+  pathsCosts[0].first[0]->SetConversionParameter("Test parameter", "1");
+  numberOfConversionCostEvaluations = NumberOfConversionCostEvaluations;
+  converter->GetPossibleConversions("RepA", "RepE", pathsCosts);
+  VERIFY_EQUAL("number of paths from representation A to E after parameter change", pathsCosts.size(), 3);
+  VERIFY_EQUAL("cost evaluations after parameter change", NumberOfConversionCostEvaluations > numberOfConversionCostEvaluations, true);
+
+  // Setting the same value again keeps the cache
+  pathsCosts[0].first[0]->SetConversionParameter("Test parameter", "1");
+  numberOfConversionCostEvaluations = NumberOfConversionCostEvaluations;
+  converter->GetPossibleConversions("RepA", "RepE", pathsCosts);
+  VERIFY_EQUAL("number of cost evaluations after setting unchanged parameter", NumberOfConversionCostEvaluations, numberOfConversionCostEvaluations);
+
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
 }
@@ -27,33 +27,70 @@
 
 // Slicer includes
 #include "vtkLoggingMacros.h"
+#include <vtkAddonThreadingUtilities.h>
 
 // VTK includes
 #include <vtkObjectFactory.h>
 #include <vtkVersion.h>
 #include <vtkSmartPointer.h>
 #include <vtkNew.h>
+#include <vtkDataArray.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
-#include <vtkImageCast.h>
-#include <vtkImageStencil.h>
+#include <vtkImageStencilData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkStripper.h>
 #include <vtkTriangleFilter.h>
 #include <vtkPolyDataToImageStencil.h>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <sstream>
 
 int DEFAULT_LABEL_VALUE = 1;
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Conversion of one segment. Set up in the main thread, rasterized in worker threads.
+struct SegmentConversion
+{
+  vtkSegment* Segment;
+  vtkSmartPointer<vtkOrientedImageData> BinaryLabelmap;
+  /// Shallow copy of the closed surface, so that it is not connected to pipelines in worker threads
+  vtkSmartPointer<vtkPolyData> ClosedSurface;
+  vtkSmartPointer<vtkTransform> WorldToImageTransform;
+  /// Closed surface in IJK space, as triangle strips
+  vtkSmartPointer<vtkPolyData> ImageSurface;
+  /// Extent of the labelmap within the bounds of the surface
+  int SurfaceExtent[6];
+};
+
+//----------------------------------------------------------------------------
+// Slab of slices of one segment, rasterized by one thread
+struct SlabConversion
+{
+  int SegmentIndex;
+  int Extent[6];
+  /// Shallow copy of the surface of the segment, owned by the slab
+  vtkSmartPointer<vtkPolyData> ImageSurface;
+};
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkSegmentationConverterRuleNewMacro(vtkClosedSurfaceToBinaryLabelmapConversionRule);
 
 //----------------------------------------------------------------------------
 vtkClosedSurfaceToBinaryLabelmapConversionRule::vtkClosedSurfaceToBinaryLabelmapConversionRule()
   : UseOutputImageDataGeometry(false)
+  , NumberOfThreads(0)
 {
   this->ReplaceTargetRepresentation = true;
 
@@ -79,6 +116,12 @@ vtkClosedSurfaceToBinaryLabelmapConversionRule::vtkClosedSurfaceToBinaryLabelmap
 vtkClosedSurfaceToBinaryLabelmapConversionRule::~vtkClosedSurfaceToBinaryLabelmapConversionRule()
 = default;
 
+//----------------------------------------------------------------------------
+int vtkClosedSurfaceToBinaryLabelmapConversionRule::GetNumberOfThreadsToUse()
+{
+  return vtkAddonThreadingUtilities::GetNumberOfThreadsToUse(this->NumberOfThreads);
+}
+
 //----------------------------------------------------------------------------
 unsigned int vtkClosedSurfaceToBinaryLabelmapConversionRule::GetConversionCost(
   vtkDataObject* vtkNotUsed(sourceRepresentation)/*=nullptr*/,
@@ -125,126 +168,211 @@ vtkDataObject* vtkClosedSurfaceToBinaryLabelmapConversionRule::ConstructRepresen
 //----------------------------------------------------------------------------
 bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment)
 {
-  this->CreateTargetRepresentation(segment);
+  std::vector<vtkSegment*> segments;
+  segments.push_back(segment);
+  return this->ConvertSegments(segments);
+}
 
-  // Check validity of source and target representation objects
-  vtkPolyData* closedSurfacePolyData = vtkPolyData::SafeDownCast(segment->GetRepresentation(this->GetSourceRepresentationName()));
-  if (!closedSurfacePolyData)
-    {
-    vtkErrorMacro("Convert: Source representation is not a poly data!");
-    return false;
-    }
+//----------------------------------------------------------------------------
+bool vtkClosedSurfaceToBinaryLabelmapConversionRule::ConvertSegments(const std::vector<vtkSegment*>& segments)
+{
+  bool success = true;
 
-  if (closedSurfacePolyData->GetNumberOfPoints() < 2 || closedSurfacePolyData->GetNumberOfCells() < 2)
+  // Set up output labelmaps. Segments and representations are only modified in the main thread,
+  // as they invoke events.
+  std::vector<SegmentConversion> conversions;
+  for (vtkSegment* segment : segments)
     {
-    vtkDebugMacro("Convert: Cannot create binary labelmap from surface with number of points: "
-      << closedSurfacePolyData->GetNumberOfPoints() << " and number of cells: " << closedSurfacePolyData->GetNumberOfCells());
-    return false;
-    }
+    this->CreateTargetRepresentation(segment);
 
-  vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(this->GetTargetRepresentationName()));
-  if (!binaryLabelmap)
-    {
-    vtkErrorMacro("Convert: Target representation is not an oriented image data!");
-    return false;
-    }
+    // Check validity of source and target representation objects
+    vtkPolyData* closedSurfacePolyData = vtkPolyData::SafeDownCast(segment->GetRepresentation(this->GetSourceRepresentationName()));
+    if (!closedSurfacePolyData)
+      {
+      vtkErrorMacro("Convert: Source representation is not a poly data!");
+      success = false;
+      continue;
+      }
 
-  // Setup output labelmap
+    if (closedSurfacePolyData->GetNumberOfPoints() < 2 || closedSurfacePolyData->GetNumberOfCells() < 2)
+      {
+      vtkDebugMacro("Convert: Cannot create binary labelmap from surface with number of points: "
+        << closedSurfacePolyData->GetNumberOfPoints() << " and number of cells: " << closedSurfacePolyData->GetNumberOfCells());
+      success = false;
+      continue;
+      }
 
-  // Compute output labelmap geometry based on poly data, an reference image
-  // geometry, and store the calculated geometry in output labelmap image data
-  if (!this->UseOutputImageDataGeometry)
-    {
-    if (!this->CalculateOutputGeometry(closedSurfacePolyData, binaryLabelmap))
+    vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(segment->GetRepresentation(this->GetTargetRepresentationName()));
+    if (!binaryLabelmap)
       {
-      vtkErrorMacro("Convert: Failed to calculate output image geometry!");
-      return false;
+      vtkErrorMacro("Convert: Target representation is not an oriented image data!");
+      success = false;
+      continue;
       }
+
+    // Setup output labelmap
+
+    // Compute output labelmap geometry based on poly data, an reference image
+    // geometry, and store the calculated geometry in output labelmap image data
+    if (!this->UseOutputImageDataGeometry)
+      {
+      if (!this->CalculateOutputGeometry(closedSurfacePolyData, binaryLabelmap))
+        {
+        vtkErrorMacro("Convert: Failed to calculate output image geometry!");
+        success = false;
+        continue;
+        }
+      }
+
+    // Allocate output image data
+    binaryLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+
+    void* binaryLabelmapVoxelsPointer = binaryLabelmap->GetScalarPointerForExtent(binaryLabelmap->GetExtent());
+    if (!binaryLabelmapVoxelsPointer)
+      {
+      vtkErrorMacro("Convert: Failed to allocate memory for output labelmap image!");
+      success = false;
+      continue;
+      }
+    else
+      {
+      // Set voxel values to 0
+      int extent[6] = {0,-1,0,-1,0,-1};
+      binaryLabelmap->GetExtent(extent);
+      memset(binaryLabelmapVoxelsPointer, 0, ((extent[1]-extent[0]+1)*(extent[3]-extent[2]+1)*(extent[5]-extent[4]+1) *
+        binaryLabelmap->GetScalarSize() * binaryLabelmap->GetNumberOfScalarComponents()));
+      }
+
+    // Now the output labelmap image data contains the right geometry.
+    // We need to apply inverse of geometry matrix to the input poly data so that we can perform
+    // the conversion in IJK space, because the filters do not support oriented image data.
+    vtkSmartPointer<vtkMatrix4x4> outputLabelmapImageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+    binaryLabelmap->GetImageToWorldMatrix(outputLabelmapImageToWorldMatrix);
+
+    SegmentConversion conversion;
+    conversion.Segment = segment;
+    conversion.BinaryLabelmap = binaryLabelmap;
+    conversion.ClosedSurface = vtkSmartPointer<vtkPolyData>::New();
+    conversion.ClosedSurface->ShallowCopy(closedSurfacePolyData);
+    conversion.WorldToImageTransform = vtkSmartPointer<vtkTransform>::New();
+    conversion.WorldToImageTransform->SetMatrix(outputLabelmapImageToWorldMatrix);
+    conversion.WorldToImageTransform->Inverse();
+    conversions.push_back(conversion);
     }
 
-  // Allocate output image data
-  binaryLabelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  const int numberOfThreads = this->GetNumberOfThreadsToUse();
 
-  void* binaryLabelmapVoxelsPointer = binaryLabelmap->GetScalarPointerForExtent(binaryLabelmap->GetExtent());
-  if (!binaryLabelmapVoxelsPointer)
+  // Transform the surfaces to IJK space and find their extent, one segment per thread
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, static_cast<int>(conversions.size()), [&](int conversionIndex)
     {
-    vtkErrorMacro("Convert: Failed to allocate memory for output labelmap image!");
-    return false;
-    }
-  else
+    SegmentConversion& conversion = conversions[conversionIndex];
+
+    vtkSmartPointer<vtkTransformPolyDataFilter> transformPolyDataFilter =
+      vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+    transformPolyDataFilter->SetInputData(conversion.ClosedSurface);
+    transformPolyDataFilter->SetTransform(conversion.WorldToImageTransform);
+
+    // Compute polydata normals
+    vtkNew<vtkPolyDataNormals> normalFilter;
+    normalFilter->SetInputConnection(transformPolyDataFilter->GetOutputPort());
+    normalFilter->ConsistencyOn();
+
+    // Make sure that we have a clean triangle polydata
+    vtkNew<vtkTriangleFilter> triangle;
+    triangle->SetInputConnection(normalFilter->GetOutputPort());
+
+    // Convert to triangle strip
+    vtkSmartPointer<vtkStripper> stripper=vtkSmartPointer<vtkStripper>::New();
+    stripper->SetInputConnection(triangle->GetOutputPort());
+    stripper->Update();
+    conversion.ImageSurface = stripper->GetOutput();
+
+    // Only rasterize the part of the labelmap that the surface covers.
+    // Bounds are computed here, so that slabs sharing the points do not compute them concurrently.
+    int* extent = conversion.SurfaceExtent;
+    conversion.BinaryLabelmap->GetExtent(extent);
+    if (!conversion.ImageSurface->GetPoints() || conversion.ImageSurface->GetNumberOfPoints() == 0)
+      {
+      extent[1] = extent[0] - 1;
+      return;
+      }
+    double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+    conversion.ImageSurface->GetPoints()->GetBounds(bounds);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      extent[2 * axis] = static_cast<int>(std::max(static_cast<double>(extent[2 * axis]), std::floor(bounds[2 * axis])));
+      extent[2 * axis + 1] = static_cast<int>(std::min(static_cast<double>(extent[2 * axis + 1]), std::ceil(bounds[2 * axis + 1])));
+      }
+    });
+
+  // Split each surface extent into slabs of slices, so that a few large segments are
+  // rasterized on all the threads as well
+  const int minimumNumberOfSlicesPerSlab = 4;
+  std::vector<SlabConversion> slabs;
+  for (int conversionIndex = 0; conversionIndex < static_cast<int>(conversions.size()); ++conversionIndex)
     {
-    // Set voxel values to 0
-    int extent[6] = {0,-1,0,-1,0,-1};
-    binaryLabelmap->GetExtent(extent);
-    memset(binaryLabelmapVoxelsPointer, 0, ((extent[1]-extent[0]+1)*(extent[3]-extent[2]+1)*(extent[5]-extent[4]+1) *
-      binaryLabelmap->GetScalarSize() * binaryLabelmap->GetNumberOfScalarComponents()));
+    const int* extent = conversions[conversionIndex].SurfaceExtent;
+    if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+      {
+      continue;
+      }
+    int numberOfSlices = extent[5] - extent[4] + 1;
+    int numberOfSlabs = std::max(1, std::min(numberOfThreads, numberOfSlices / minimumNumberOfSlicesPerSlab));
+    for (int slabIndex = 0; slabIndex < numberOfSlabs; ++slabIndex)
+      {
+      SlabConversion slab;
+      slab.SegmentIndex = conversionIndex;
+      std::copy(extent, extent + 6, slab.Extent);
+      slab.Extent[4] = extent[4] + numberOfSlices * slabIndex / numberOfSlabs;
+      slab.Extent[5] = extent[4] + numberOfSlices * (slabIndex + 1) / numberOfSlabs - 1;
+      slab.ImageSurface = vtkSmartPointer<vtkPolyData>::New();
+      slab.ImageSurface->ShallowCopy(conversions[conversionIndex].ImageSurface);
+      slabs.push_back(slab);
+      }
     }
 
-  // Perform conversion
-
-  // Now the output labelmap image data contains the right geometry.
-  // We need to apply inverse of geometry matrix to the input poly data so that we can perform
-  // the conversion in IJK space, because the filters do not support oriented image data.
-  vtkSmartPointer<vtkMatrix4x4> outputLabelmapImageToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-  binaryLabelmap->GetImageToWorldMatrix(outputLabelmapImageToWorldMatrix);
-  vtkSmartPointer<vtkTransform> inverseOutputLabelmapGeometryTransform = vtkSmartPointer<vtkTransform>::New();
-  inverseOutputLabelmapGeometryTransform->SetMatrix(outputLabelmapImageToWorldMatrix);
-  inverseOutputLabelmapGeometryTransform->Inverse();
+  // Rasterize the slabs. Slabs of a segment cover distinct slices of the labelmap.
+  vtkAddonThreadingUtilities::ParallelFor(numberOfThreads, static_cast<int>(slabs.size()), [&](int slabIndex)
+    {
+    SlabConversion& slab = slabs[slabIndex];
+    vtkOrientedImageData* binaryLabelmap = conversions[slab.SegmentIndex].BinaryLabelmap;
+
+    // Convert polydata to stencil in IJK space
+    vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
+    polyDataToImageStencil->SetInputData(slab.ImageSurface);
+    polyDataToImageStencil->SetOutputSpacing(1.0, 1.0, 1.0);
+    polyDataToImageStencil->SetOutputOrigin(0.0, 0.0, 0.0);
+    polyDataToImageStencil->SetOutputWholeExtent(slab.Extent);
+    polyDataToImageStencil->Update();
+    vtkImageStencilData* stencilData = polyDataToImageStencil->GetOutput();
+
+    // Fill the voxels inside the stencil with the label value
+    for (int idxZ = slab.Extent[4]; idxZ <= slab.Extent[5]; ++idxZ)
+      {
+      for (int idxY = slab.Extent[2]; idxY <= slab.Extent[3]; ++idxY)
+        {
+        int r1 = 0;
+        int r2 = 0;
+        int iter = 0;
+        while (stencilData->GetNextExtent(r1, r2, slab.Extent[0], slab.Extent[1], idxY, idxZ, iter))
+          {
+          unsigned char* voxels = static_cast<unsigned char*>(binaryLabelmap->GetScalarPointer(r1, idxY, idxZ));
+          memset(voxels, DEFAULT_LABEL_VALUE, r2 - r1 + 1);
+          }
+        }
+      }
+    });
 
-  // Set geometry to identity for the volume so that we can perform the stencil operation in IJK space
-  vtkSmartPointer<vtkMatrix4x4> identityMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-  identityMatrix->Identity();
-  binaryLabelmap->SetGeometryFromImageToWorldMatrix(identityMatrix);
+  for (SegmentConversion& conversion : conversions)
+    {
+    conversion.BinaryLabelmap->GetPointData()->GetScalars()->Modified();
+    conversion.BinaryLabelmap->Modified();
 
-  vtkSmartPointer<vtkTransformPolyDataFilter> transformPolyDataFilter =
-    vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  transformPolyDataFilter->SetInputData(closedSurfacePolyData);
-  transformPolyDataFilter->SetTransform(inverseOutputLabelmapGeometryTransform);
-
-  // Compute polydata normals
-  vtkNew<vtkPolyDataNormals> normalFilter;
-  normalFilter->SetInputConnection(transformPolyDataFilter->GetOutputPort());
-  normalFilter->ConsistencyOn();
-
-  // Make sure that we have a clean triangle polydata
-  vtkNew<vtkTriangleFilter> triangle;
-  triangle->SetInputConnection(normalFilter->GetOutputPort());
-
-  // Convert to triangle strip
-  vtkSmartPointer<vtkStripper> stripper=vtkSmartPointer<vtkStripper>::New();
-  stripper->SetInputConnection(triangle->GetOutputPort());
-
-  // Convert polydata to stencil
-  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
-  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
-  polyDataToImageStencil->SetOutputSpacing(binaryLabelmap->GetSpacing());
-  polyDataToImageStencil->SetOutputOrigin(binaryLabelmap->GetOrigin());
-  polyDataToImageStencil->SetOutputWholeExtent(binaryLabelmap->GetExtent());
-
-  // Convert stencil to image
-  vtkNew<vtkImageStencil> stencil;
-  stencil->SetInputData(binaryLabelmap);
-  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
-  stencil->ReverseStencilOn();
-  // If the output labelmap was to required to be unsigned char, we could use the segment label value.
-  // To ensure that the label value is < 255, we set it to 1. Collapsing the labelmaps during post-conversion may assign new a value regardless.
-  stencil->SetBackgroundValue(DEFAULT_LABEL_VALUE); // General foreground value is 1 (background value because of reverse stencil)
-
-  // Save result to output
-  vtkNew<vtkImageCast> imageCast;
-  imageCast->SetInputConnection(stencil->GetOutputPort());
-  imageCast->SetOutputScalarTypeToUnsignedChar();
-  imageCast->Update();
-  binaryLabelmap->ShallowCopy(imageCast->GetOutput());
-
-  // Restore geometry of the labelmap that we set to identity before conversion
-  // (so that we can perform the stencil operations in IJK space)
-  binaryLabelmap->SetGeometryFromImageToWorldMatrix(outputLabelmapImageToWorldMatrix);
-
-  // Set segment value to 1
-  segment->SetLabelValue(DEFAULT_LABEL_VALUE);
+    // Set segment value to 1
+    conversion.Segment->SetLabelValue(DEFAULT_LABEL_VALUE);
+    }
 
-  return true;
+  return success;
 }
 
 //----------------------------------------------------------------------------
@@ -32,7 +32,8 @@ class vtkPolyData;
 /// \ingroup SegmentationCore
 /// \brief Convert closed surface representation (vtkPolyData type) to binary
 ///   labelmap representation (vtkOrientedImageData type). The conversion algorithm
-///   is based on image stencil.
+///   is based on image stencil. Each surface is only rasterized within its bounds,
+///   and segments and slabs of slices of each segment are rasterized in parallel.
 class vtkSegmentationCore_EXPORT vtkClosedSurfaceToBinaryLabelmapConversionRule
   : public vtkSegmentationConverterRule
 {
@@ -65,6 +66,9 @@ public:
   /// Update the target representation based on the source representation
   bool Convert(vtkSegment* segment) override;
 
+  /// Update the target representation of multiple segments, rasterizing them in parallel
+  bool ConvertSegments(const std::vector<vtkSegment*>& segments) override;
+
   /// Perform postprocesing steps on the output
   /// Collapses the segments to as few labelmaps as is possible
   bool PostConvert(vtkSegmentation* segmentation) override;
@@ -83,6 +87,11 @@ public:
 
   vtkSetMacro(UseOutputImageDataGeometry, bool);
 
+  /// Number of threads that surfaces are rasterized on.
+  /// 0 (default) uses all the available cores.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   /// Calculate actual geometry of the output labelmap volume by verifying that the reference image geometry
   /// encompasses the input surface model, and extending it to the proper directions if necessary.
@@ -98,6 +107,9 @@ protected:
   /// \return Serialized image geometry for input poly data with identity directions and 1 mm spacing.
   std::string GetDefaultImageGeometryStringForPolyData(vtkPolyData* polyData);
 
+  /// Number of threads resolved from NumberOfThreads, at least 1.
+  int GetNumberOfThreadsToUse();
+
 protected:
   /// Flag determining whether to use the geometry of the given output oriented image data as is,
   /// or use the conversion parameters and the extent of the input surface. False by default,
@@ -106,6 +118,8 @@ protected:
   /// then stitching them back together).
   bool UseOutputImageDataGeometry;
 
+  int NumberOfThreads;
+
 protected:
   vtkClosedSurfaceToBinaryLabelmapConversionRule();
   ~vtkClosedSurfaceToBinaryLabelmapConversionRule() override;
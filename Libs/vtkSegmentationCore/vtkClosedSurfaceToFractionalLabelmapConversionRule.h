@@ -61,6 +61,11 @@ public:
   /// Update the target representation based on the source representation
   bool Convert(vtkSegment* segment)  override;
 
+  /// Overridden to convert the segments one by one using Convert, as the parallel
+  /// rasterization of vtkClosedSurfaceToBinaryLabelmapConversionRule creates binary labelmaps
+  bool ConvertSegments(const std::vector<vtkSegment*>& segments) override
+    { return vtkSegmentationConverterRule::ConvertSegments(segments); };
+
   /// Overridden to prevent vtkClosedSurfaceToBinaryLabelmapConversionRule::PostConvert
   bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) override { return true; };
 
@@ -37,11 +37,17 @@
 #include <vtkPolyDataNormals.h>
 #include <vtkTriangleFilter.h>
 #include <vtkStripper.h>
-#include <vtkImageStencil.h>
-#include <vtkImageCast.h>
+#include <vtkIdTypeArray.h>
+
+// vtkAddon includes
+#include <vtkAddonThreadingUtilities.h>
 
 // std includes
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <map>
+#include <thread>
 
 vtkStandardNewMacro(vtkPolyDataToFractionalLabelmapFilter);
 
@@ -49,14 +55,7 @@ vtkStandardNewMacro(vtkPolyDataToFractionalLabelmapFilter);
 vtkPolyDataToFractionalLabelmapFilter::vtkPolyDataToFractionalLabelmapFilter()
 {
   this->NumberOfOffsets = 6;
-
-  this->LinesCache = std::map<double, vtkSmartPointer<vtkCellArray> >();
-  this->SliceCache = std::map<double, vtkSmartPointer<vtkPolyData> >();
-  this->PointIdsCache = std::map<double, vtkIdType*>();
-  this->NptsCache = std::map<double, vtkIdType>();
-  this->PointNeighborCountsCache = std::map<double,  vtkSmartPointer<vtkIdTypeArray> >();
-
-  this->CellLocator = vtkCellLocator::New();
+  this->NumberOfThreads = 0;
 
   this->OutputImageTransformData = vtkOrientedImageData::New();
 
@@ -72,7 +71,19 @@ vtkPolyDataToFractionalLabelmapFilter::vtkPolyDataToFractionalLabelmapFilter()
 vtkPolyDataToFractionalLabelmapFilter::~vtkPolyDataToFractionalLabelmapFilter()
 {
   this->OutputImageTransformData->Delete();
-  this->CellLocator->Delete();
+}
+
+//----------------------------------------------------------------------------
+int vtkPolyDataToFractionalLabelmapFilter::GetNumberOfThreadsToUse()
+{
+  return vtkAddonThreadingUtilities::GetNumberOfThreadsToUse(this->NumberOfThreads);
+}
+
+//----------------------------------------------------------------------------
+// Deprecated method - kept temporarily for compatibility with extensions that are not yet updated
+void vtkPolyDataToFractionalLabelmapFilter::DeleteCache()
+{
+  vtkWarningMacro("vtkPolyDataToFractionalLabelmapFilter::DeleteCache method is deprecated. The filter does not cache contours anymore, the call can be removed.");
 }
 
 //----------------------------------------------------------------------------
@@ -419,465 +430,451 @@ int vtkPolyDataToFractionalLabelmapFilter::RequestData(
   // PolyData of the closed surface in IJK space
   vtkSmartPointer<vtkPolyData> transformedClosedSurface = stripper->GetOutput();
 
-  this->CellLocator->SetDataSet(transformedClosedSurface);
-  this->CellLocator->BuildLocator();
-
   int extent[6];
   outputData->GetExtent(extent);
 
-  vtkSmartPointer<vtkImageData> emptyImageData = vtkSmartPointer<vtkImageData>::New();
-  emptyImageData->SetExtent(extent);
-  emptyImageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
-
-  void* emptyImageDataPointer = emptyImageData->GetScalarPointerForExtent(emptyImageData->GetExtent());
-  if (!emptyImageDataPointer)
-  {
-    vtkErrorMacro("Convert: Failed to allocate memory for output labelmap image!");
-    return false;
-  }
-  else
-  {
-    memset(emptyImageDataPointer, 0, ((extent[1]-extent[0]+1)*(extent[3]-extent[2]+1)*(extent[5]-extent[4]+1) * emptyImageData->GetScalarSize() * emptyImageData->GetNumberOfScalarComponents()));
-  }
+  // if we have no data then return
+  if (!transformedClosedSurface->GetNumberOfPoints())
+    {
+    return 1;
+    }
 
+  // Index the cells of the surface by slice. Each slice is cut at NumberOfOffsets z positions
+  // within half a voxel of the slice, so a cell is listed in all the slices that its z range reaches.
+  // A cell locator is not used for this, as it cannot be queried from multiple threads.
+  const int numberOfSlices = extent[5] - extent[4] + 1;
+  std::vector<std::vector<vtkIdType> > sliceCellIds(std::max(numberOfSlices, 0));
+  vtkPoints* surfacePoints = transformedClosedSurface->GetPoints();
+  vtkIdType numberOfCells = transformedClosedSurface->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numberOfCells; ++cellId)
+    {
+    int cellType = transformedClosedSurface->GetCellType(cellId);
+    if (cellType != VTK_TRIANGLE && cellType != VTK_TRIANGLE_STRIP)
+      {
+      continue;
+      }
+    vtkIdType npts = 0;
+    vtkIdType* ptIds = nullptr;
+    transformedClosedSurface->GetCellPoints(cellId, npts, ptIds);
+    if (npts == 0)
+      {
+      continue;
+      }
+    double zMin = VTK_DOUBLE_MAX;
+    double zMax = VTK_DOUBLE_MIN;
+    for (vtkIdType i = 0; i < npts; ++i)
+      {
+      double point[3] = { 0.0, 0.0, 0.0 };
+      surfacePoints->GetPoint(ptIds[i], point);
+      zMin = std::min(zMin, point[2]);
+      zMax = std::max(zMax, point[2]);
+      }
+    double firstSlice = std::max(static_cast<double>(extent[4]), std::ceil(zMin - 0.5));
+    double lastSlice = std::min(static_cast<double>(extent[5]), std::floor(zMax + 0.5));
+    for (int idxZ = static_cast<int>(firstSlice); idxZ <= lastSlice; ++idxZ)
+      {
+      sliceCellIds[idxZ - extent[4]].push_back(cellId);
+      }
+    }
 
   // The magnitude of the offset step size ( n-1 / 2n )
   double offsetStepSize = (double)(this->NumberOfOffsets-1.0)/(2 * this->NumberOfOffsets);
 
-  vtkSmartPointer<vtkImageStencilData> imageStencilData = vtkSmartPointer<vtkImageStencilData>::New();
-  imageStencilData->SetExtent(extent);
-  imageStencilData->SetSpacing(1.0, 1.0, 1.0);
-
-  vtkNew<vtkImageStencil> imageStencil;
-  imageStencil->SetInputData(emptyImageData);
-  imageStencil->SetStencilData(imageStencilData);
-  imageStencil->ReverseStencilOn();
-  imageStencil->SetBackgroundValue(1); // General foreground value is 1 (background value because of reverse stencil)
-
-  vtkNew<vtkImageCast> imageCast;
-  imageCast->SetInputConnection(imageStencil->GetOutputPort());
-  imageCast->SetOutputScalarTypeToUnsignedChar();
+  // Slices are processed in parallel. For each of the "NumberOfOffsets" offsets in the z dimension
+  // the surface is cut once, and the contour is rasterized at each of the offsets in the other
+  // two dimensions. Binary labelmaps are added to the output directly, slice by slice.
+  const std::thread::id mainThreadId = std::this_thread::get_id();
+  std::atomic<int> numberOfProcessedSlices(0);
+  vtkAddonThreadingUtilities::ParallelFor(this->GetNumberOfThreadsToUse(), numberOfSlices, [&](int sliceIndex)
+    {
+    int idxZ = extent[4] + sliceIndex;
+    int sliceExtent[6] = { extent[0], extent[1], extent[2], extent[3], idxZ, idxZ };
 
-  // Iterate through "NumberOfOffsets" in each of the dimensions and create a binary labelmap at each offset
-  for (int k = 0; k < this->NumberOfOffsets; ++k)
-  {
-    double kOffset = ( (double) k / this->NumberOfOffsets - offsetStepSize );
+    vtkNew<vtkImageStencilData> imageStencilData;
+    imageStencilData->SetExtent(sliceExtent);
+    imageStencilData->SetSpacing(1.0, 1.0, 1.0);
 
-    for (int j = 0; j < this->NumberOfOffsets; ++j)
-    {
-      double jOffset = ( (double) j / this->NumberOfOffsets - offsetStepSize );
+    vtkNew<vtkPolyData> contour;
+    vtkNew<vtkIdTypeArray> pointNeighborCounts;
 
-      for (int i = 0; i < this->NumberOfOffsets; ++i)
+    for (int k = 0; k < this->NumberOfOffsets; ++k)
       {
-        double iOffset = ( (double) i / this->NumberOfOffsets - offsetStepSize );
+      double kOffset = ( (double) k / this->NumberOfOffsets - offsetStepSize );
+      double z = idxZ * 1.0 + kOffset;
 
-        // Create stencil for the current binary labelmap offset
-        imageStencilData->AllocateExtents();
-        imageStencilData->SetOrigin(iOffset, jOffset, kOffset);
-        this->FillImageStencilData(imageStencilData, transformedClosedSurface, extent);
-
-        // Save result to output
-        imageCast->Update();
-        this->AddBinaryLabelMapToFractionalLabelMap(imageCast->GetOutput(), outputData);
+      this->CreateSliceContour(transformedClosedSurface, sliceCellIds[sliceIndex], z,
+        contour.GetPointer(), pointNeighborCounts.GetPointer());
+      if (!contour->GetNumberOfLines())
+        {
+        continue;
+        }
 
-        this->UpdateProgress(((i+1)*(j+1)*(k+1))/(this->NumberOfOffsets*this->NumberOfOffsets*this->NumberOfOffsets));
+      for (int j = 0; j < this->NumberOfOffsets; ++j)
+        {
+        double jOffset = ( (double) j / this->NumberOfOffsets - offsetStepSize );
 
-      } // i
-    } // j
-  } // k
+        for (int i = 0; i < this->NumberOfOffsets; ++i)
+          {
+          double iOffset = ( (double) i / this->NumberOfOffsets - offsetStepSize );
+
+          // Create stencil for the current binary labelmap offset
+          imageStencilData->SetOrigin(iOffset, jOffset, kOffset);
+          imageStencilData->AllocateExtents();
+          this->FillImageStencilData(imageStencilData.GetPointer(), contour.GetPointer(),
+            pointNeighborCounts.GetPointer(), sliceExtent);
+
+          // Save result to output
+          this->AddImageStencilDataToFractionalLabelMap(imageStencilData.GetPointer(), outputData, sliceExtent);
+          } // i
+        } // j
+      } // k
+
+    // Observers are only notified in the thread that executes the filter
+    ++numberOfProcessedSlices;
+    if (std::this_thread::get_id() == mainThreadId)
+      {
+      this->UpdateProgress(static_cast<double>(numberOfProcessedSlices) / numberOfSlices);
+      }
+    });
 
   return 1;
 }
 
 //----------------------------------------------------------------------------
-void vtkPolyDataToFractionalLabelmapFilter::AddBinaryLabelMapToFractionalLabelMap(vtkImageData* binaryLabelMap, vtkImageData* fractionalLabelMap)
+void vtkPolyDataToFractionalLabelmapFilter::AddImageStencilDataToFractionalLabelMap(
+  vtkImageStencilData* stencilData, vtkImageData* fractionalLabelMap, int sliceExtent[6])
 {
-
-  if (!binaryLabelMap)
+  if (!stencilData)
   {
-    vtkErrorMacro("AddBinaryLabelMapToFractionalLabelMap: Invalid vtkImageData!");
+    vtkErrorMacro("AddImageStencilDataToFractionalLabelMap: Invalid vtkImageStencilData!");
     return;
   }
 
   if (!fractionalLabelMap)
   {
-    vtkErrorMacro("AddBinaryLabelMapToFractionalLabelMap: Invalid vtkImageData!");
+    vtkErrorMacro("AddImageStencilDataToFractionalLabelMap: Invalid vtkImageData!");
     return;
   }
 
-  int binaryExtent[6] = {0,-1,0,-1,0,-1};
-  binaryLabelMap->GetExtent(binaryExtent);
-
-  int fractionalExtent[6] = {0,-1,0,-1,0,-1};
-  fractionalLabelMap->GetExtent(fractionalExtent);
-
-  // Get points to the extent in both the binary and fractional labelmaps
-  char* binaryLabelMapPointer = (char*)binaryLabelMap->GetScalarPointerForExtent(binaryExtent);
-  FRACTIONAL_DATA_TYPE* fractionalLabelMapPointer = (FRACTIONAL_DATA_TYPE*)fractionalLabelMap->GetScalarPointerForExtent(fractionalExtent);
-
-  int dimensions[6] = {0,0,0};
-  fractionalLabelMap->GetDimensions(dimensions);
-
-  int numberOfVoxels = dimensions[0]*dimensions[1]*dimensions[2];
-
-  for (int i = 0; i < numberOfVoxels; ++i)
-  {
-    (*fractionalLabelMapPointer) += (*binaryLabelMapPointer) * FRACTIONAL_STEP_SIZE;
-    ++binaryLabelMapPointer;
-    ++fractionalLabelMapPointer;
-  }
-
+  for (int idxY = sliceExtent[2]; idxY <= sliceExtent[3]; ++idxY)
+    {
+    FRACTIONAL_DATA_TYPE* rowPointer = static_cast<FRACTIONAL_DATA_TYPE*>(
+      fractionalLabelMap->GetScalarPointer(sliceExtent[0], idxY, sliceExtent[4]));
+    int r1 = 0;
+    int r2 = 0;
+    int iter = 0;
+    while (stencilData->GetNextExtent(r1, r2, sliceExtent[0], sliceExtent[1], idxY, sliceExtent[4], iter))
+      {
+      for (int idxX = r1; idxX <= r2; ++idxX)
+        {
+        rowPointer[idxX - sliceExtent[0]] += FRACTIONAL_STEP_SIZE;
+        }
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
-void vtkPolyDataToFractionalLabelmapFilter::FillImageStencilData(
-  vtkImageStencilData *data, vtkPolyData* closedSurface,
-  int extent[6])
+void vtkPolyDataToFractionalLabelmapFilter::CreateSliceContour(
+  vtkPolyData* closedSurface, const std::vector<vtkIdType>& cellIds, double z,
+  vtkPolyData* slice, vtkIdTypeArray* pointNeighborCountsArray)
 {
-  // Description of algorithm:
-  // 1) cut the polydata at each z slice to create polylines
-  // 2) find all "loose ends" and connect them to make polygons
-  //    (if the input polydata is closed, there will be no loose ends)
-  // 3) go through all line segments, and for each integer y value on
-  //    a line segment, store the x value at that point in a bucket
-  // 4) for each z integer index, find all the stored x values
-  //    and use them to create one z slice of the vtkStencilData
+  slice->Initialize();
+  pointNeighborCountsArray->Reset();
 
-  // the spacing and origin of the generated stencil
-  double *spacing = data->GetSpacing();
-  double *origin = data->GetOrigin();
+  // Step 1: Cut the data into slices
+  if (closedSurface->GetNumberOfPolys() > 0 || closedSurface->GetNumberOfStrips() > 0)
+    {
+    this->PolyDataCutter(closedSurface, cellIds, slice, z);
+    }
+  else
+    {
+    // if no polys, select polylines instead
+    this->PolyDataSelector(closedSurface, slice, z, 1.0);
+    }
 
-  // if we have no data then return
-  if (!this->GetInput()->GetNumberOfPoints())
+  if (!slice->GetNumberOfLines())
     {
     return;
     }
 
-  // Only divide once
-  double invspacing[3];
-  invspacing[0] = 1.0/spacing[0];
-  invspacing[1] = 1.0/spacing[1];
-  invspacing[2] = 1.0/spacing[2];
-
-  // get the input data
-  vtkPolyData *input = closedSurface;
-
-  // the output produced by cutting the polydata with the Z plane
-  vtkSmartPointer<vtkPolyData> slice;
-
-  // This raster stores all line segments by recording all "x"
-  // positions on the surface for each y integer position.
-  vtkImageStencilRaster raster(&extent[2]);
-  raster.SetTolerance(this->Tolerance);
+  vtkIdType numberOfPoints = slice->GetNumberOfPoints();
 
-  // The extent for one slice of the image
-  int sliceExtent[6];
-  sliceExtent[0] = extent[0]; sliceExtent[1] = extent[1];
-  sliceExtent[2] = extent[2]; sliceExtent[3] = extent[3];
-  sliceExtent[4] = extent[4]; sliceExtent[5] = extent[4];
+  // Step 2: Find and connect all the loose ends
+  std::vector<vtkIdType> pointNeighbors(numberOfPoints);
+  pointNeighborCountsArray->SetNumberOfValues(numberOfPoints);
+  vtkIdType* pointNeighborCounts = pointNeighborCountsArray->GetPointer(0);
+  memset(pointNeighborCounts, 0, numberOfPoints*sizeof(vtkIdType));
 
-  // Loop through the slices
-  for (int idxZ = extent[4]; idxZ <= extent[5]; idxZ++)
+  // get the connectivity count for each point
+  vtkCellArray* lines = slice->GetLines();
+  vtkIdType npts = 0;
+  vtkIdType *pointIds = nullptr;
+  vtkIdType count = lines->GetNumberOfConnectivityEntries();
+  for (vtkIdType loc = 0; loc < count; loc += npts + 1)
     {
-
-    double z = idxZ*spacing[2] + origin[2];
-
-    raster.PrepareForNewData();
-
-    if ( this->SliceCache.count(z) == 0 )
+    lines->GetCell(loc, npts, pointIds);
+    if (npts > 0)
       {
-
-      slice = vtkSmartPointer<vtkPolyData>::New();
-
-      // Step 1: Cut the data into slices
-      if (input->GetNumberOfPolys() > 0 || input->GetNumberOfStrips() > 0)
-        {
-
-        this->PolyDataCutter(input, slice, z);
-        }
-      else
+      pointNeighborCounts[pointIds[0]] += 1;
+      for (vtkIdType j = 1; j < npts-1; j++)
         {
-        // if no polys, select polylines instead
-        this->PolyDataSelector(input, slice, z, spacing[2]);
+        pointNeighborCounts[pointIds[j]] += 2;
         }
-
-      if (!slice->GetNumberOfLines())
+      pointNeighborCounts[pointIds[npts-1]] += 1;
+      if (pointIds[0] != pointIds[npts-1])
         {
-        continue;
+        // store the neighbors for end points, because these are
+        // potentially loose ends that will have to be dealt with later
+        pointNeighbors[pointIds[0]] = pointIds[1];
+        pointNeighbors[pointIds[npts-1]] = pointIds[npts-2];
         }
-
-      this->SliceCache.insert(std::pair<double, vtkPolyData*>(z, slice));
-
       }
+    }
 
-    slice = this->SliceCache[z];
-
-    // convert to structured coords via origin and spacing
-    vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-    points->DeepCopy(slice->GetPoints());
-    vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  // use connectivity count to identify loose ends and branch points
+  std::vector<vtkIdType> looseEndIds;
+  std::vector<vtkIdType> branchIds;
 
-    for (vtkIdType j = 0; j < numberOfPoints; j++)
+  for (vtkIdType j = 0; j < numberOfPoints; j++)
+    {
+    if (pointNeighborCounts[j] == 1)
       {
-      double tempPoint[3];
-      points->GetPoint(j, tempPoint);
-      tempPoint[0] = (tempPoint[0] - origin[0])*invspacing[0];
-      tempPoint[1] = (tempPoint[1] - origin[1])*invspacing[1];
-      tempPoint[2] = (tempPoint[2] - origin[2])*invspacing[2];
-      points->SetPoint(j, tempPoint);
+      looseEndIds.push_back(j);
       }
+    else if (pointNeighborCounts[j] > 2)
+      {
+      branchIds.push_back(j);
+      }
+    }
 
-    if (this->LinesCache.count(z) == 0)
+  // remove any spurs
+  for (size_t b = 0; b < branchIds.size(); b++)
     {
-
-      // Step 2: Find and connect all the loose ends
-      std::vector<vtkIdType> pointNeighbors(numberOfPoints);
-      vtkSmartPointer<vtkIdTypeArray> pointNeighborCountsArray = vtkSmartPointer<vtkIdTypeArray>::New();
-      pointNeighborCountsArray->Allocate(numberOfPoints, 1);
-      vtkIdType* pointNeighborCounts = pointNeighborCountsArray->GetPointer(0);
-      memset(pointNeighborCounts, 0, numberOfPoints*sizeof(vtkIdType));
-
-      // get the connectivity count for each point
-      vtkSmartPointer<vtkCellArray> lines = slice->GetLines();
-      vtkIdType npts = 0;
-      vtkIdType *pointIds = nullptr;
-      vtkIdType count = lines->GetNumberOfConnectivityEntries();
-      for (vtkIdType loc = 0; loc < count; loc += npts + 1)
+    for (size_t i = 0; i < looseEndIds.size(); i++)
+      {
+      if (pointNeighbors[looseEndIds[i]] == branchIds[b])
         {
-        lines->GetCell(loc, npts, pointIds);
-        if (npts > 0)
+        // mark this pointId as removed
+        pointNeighborCounts[looseEndIds[i]] = 0;
+        looseEndIds.erase(looseEndIds.begin() + i);
+        i--;
+        if (--pointNeighborCounts[branchIds[b]] <= 2)
           {
-          pointNeighborCounts[pointIds[0]] += 1;
-          for (vtkIdType j = 1; j < npts-1; j++)
-            {
-            pointNeighborCounts[pointIds[j]] += 2;
-            }
-          pointNeighborCounts[pointIds[npts-1]] += 1;
-          if (pointIds[0] != pointIds[npts-1])
-            {
-            // store the neighbors for end points, because these are
-            // potentially loose ends that will have to be dealt with later
-            pointNeighbors[pointIds[0]] = pointIds[1];
-            pointNeighbors[pointIds[npts-1]] = pointIds[npts-2];
-            }
+          break;
           }
         }
+      }
+    }
 
-      // use connectivity count to identify loose ends and branch points
-      std::vector<vtkIdType> looseEndIds;
-      std::vector<vtkIdType> branchIds;
+  // join any loose ends
+  while (looseEndIds.size() >= 2)
+    {
+    size_t n = looseEndIds.size();
 
-      for (vtkIdType j = 0; j < numberOfPoints; j++)
-        {
-        if (pointNeighborCounts[j] == 1)
-          {
-          looseEndIds.push_back(j);
-          }
-        else if (pointNeighborCounts[j] > 2)
-          {
-          branchIds.push_back(j);
-          }
-        }
+    // search for the two closest loose ends
+    double maxval = -VTK_FLOAT_MAX;
+    vtkIdType firstIndex = 0;
+    vtkIdType secondIndex = 1;
+    bool isCoincident = false;
+    bool isOnHull = false;
 
-      // remove any spurs
-      for (size_t b = 0; b < branchIds.size(); b++)
+    for (size_t i = 0; i < n && !isCoincident; i++)
+      {
+      // first loose end
+      vtkIdType firstLooseEndId = looseEndIds[i];
+      vtkIdType neighborId = pointNeighbors[firstLooseEndId];
+
+      double firstLooseEnd[3];
+      slice->GetPoint(firstLooseEndId, firstLooseEnd);
+      double neighbor[3];
+      slice->GetPoint(neighborId, neighbor);
+
+      for (size_t j = i+1; j < n; j++)
         {
-        for (size_t i = 0; i < looseEndIds.size(); i++)
+        vtkIdType secondLooseEndId = looseEndIds[j];
+        if (secondLooseEndId != neighborId)
           {
-          if (pointNeighbors[looseEndIds[i]] == branchIds[b])
+          double currentLooseEnd[3];
+          slice->GetPoint(secondLooseEndId, currentLooseEnd);
+
+          // When connecting loose ends, use dot product to favor
+          // continuing in same direction as the line already
+          // connected to the loose end, but also favour short
+          // distances by dividing dotprod by square of distance.
+          double v1[2], v2[2];
+          v1[0] = firstLooseEnd[0] - neighbor[0];
+          v1[1] = firstLooseEnd[1] - neighbor[1];
+          v2[0] = currentLooseEnd[0] - firstLooseEnd[0];
+          v2[1] = currentLooseEnd[1] - firstLooseEnd[1];
+          double dotprod = v1[0]*v2[0] + v1[1]*v2[1];
+          double distance2 = v2[0]*v2[0] + v2[1]*v2[1];
+
+          // check if points are coincident
+          if (distance2 == 0)
             {
-            // mark this pointId as removed
-            pointNeighborCounts[looseEndIds[i]] = 0;
-            looseEndIds.erase(looseEndIds.begin() + i);
-            i--;
-            if (--pointNeighborCounts[branchIds[b]] <= 2)
-              {
-              break;
-              }
+            firstIndex = i;
+            secondIndex = j;
+            isCoincident = true;
+            break;
             }
-          }
-        }
-
-      // join any loose ends
-      while (looseEndIds.size() >= 2)
-        {
-        size_t n = looseEndIds.size();
-
-        // search for the two closest loose ends
-        double maxval = -VTK_FLOAT_MAX;
-        vtkIdType firstIndex = 0;
-        vtkIdType secondIndex = 1;
-        bool isCoincident = false;
-        bool isOnHull = false;
-
-        for (size_t i = 0; i < n && !isCoincident; i++)
-          {
-          // first loose end
-          vtkIdType firstLooseEndId = looseEndIds[i];
-          vtkIdType neighborId = pointNeighbors[firstLooseEndId];
 
-          double firstLooseEnd[3];
-          slice->GetPoint(firstLooseEndId, firstLooseEnd);
-          double neighbor[3];
-          slice->GetPoint(neighborId, neighbor);
-
-          for (size_t j = i+1; j < n; j++)
+          // prefer adding segments that lie on hull
+          double midpoint[2], normal[2];
+          midpoint[0] = 0.5*(currentLooseEnd[0] + firstLooseEnd[0]);
+          midpoint[1] = 0.5*(currentLooseEnd[1] + firstLooseEnd[1]);
+          normal[0] = currentLooseEnd[1] - firstLooseEnd[1];
+          normal[1] = -(currentLooseEnd[0] - firstLooseEnd[0]);
+          double sidecheck = 0.0;
+          bool checkOnHull = true;
+          for (size_t k = 0; k < n; k++)
             {
-            vtkIdType secondLooseEndId = looseEndIds[j];
-            if (secondLooseEndId != neighborId)
+            if (k != i && k != j)
               {
-              double currentLooseEnd[3];
-              slice->GetPoint(secondLooseEndId, currentLooseEnd);
-
-              // When connecting loose ends, use dot product to favor
-              // continuing in same direction as the line already
-              // connected to the loose end, but also favour short
-              // distances by dividing dotprod by square of distance.
-              double v1[2], v2[2];
-              v1[0] = firstLooseEnd[0] - neighbor[0];
-              v1[1] = firstLooseEnd[1] - neighbor[1];
-              v2[0] = currentLooseEnd[0] - firstLooseEnd[0];
-              v2[1] = currentLooseEnd[1] - firstLooseEnd[1];
-              double dotprod = v1[0]*v2[0] + v1[1]*v2[1];
-              double distance2 = v2[0]*v2[0] + v2[1]*v2[1];
-
-              // check if points are coincident
-              if (distance2 == 0)
-                {
-                firstIndex = i;
-                secondIndex = j;
-                isCoincident = true;
-                break;
-                }
-
-              // prefer adding segments that lie on hull
-              double midpoint[2], normal[2];
-              midpoint[0] = 0.5*(currentLooseEnd[0] + firstLooseEnd[0]);
-              midpoint[1] = 0.5*(currentLooseEnd[1] + firstLooseEnd[1]);
-              normal[0] = currentLooseEnd[1] - firstLooseEnd[1];
-              normal[1] = -(currentLooseEnd[0] - firstLooseEnd[0]);
-              double sidecheck = 0.0;
-              bool checkOnHull = true;
-              for (size_t k = 0; k < n; k++)
-                {
-                if (k != i && k != j)
-                  {
-                  double checkEnd[3];
-                  slice->GetPoint(looseEndIds[k], checkEnd);
-                  double dotprod2 = ((checkEnd[0] - midpoint[0])*normal[0] +
-                                     (checkEnd[1] - midpoint[1])*normal[1]);
-                  if (dotprod2*sidecheck < 0)
-                    {
-                    checkOnHull = false;
-                    }
-                  sidecheck = dotprod2;
-                  }
-                }
-
-              // check if new candidate is better than previous one
-              if ((checkOnHull && !isOnHull) ||
-                  (checkOnHull == isOnHull && dotprod > maxval*distance2))
+              double checkEnd[3];
+              slice->GetPoint(looseEndIds[k], checkEnd);
+              double dotprod2 = ((checkEnd[0] - midpoint[0])*normal[0] +
+                                 (checkEnd[1] - midpoint[1])*normal[1]);
+              if (dotprod2*sidecheck < 0)
                 {
-                firstIndex = i;
-                secondIndex = j;
-                isOnHull |= checkOnHull;
-                maxval = dotprod/distance2;
+                checkOnHull = false;
                 }
+              sidecheck = dotprod2;
               }
             }
-          }
 
-        // get info about the two loose ends and their neighbors
-        vtkIdType firstLooseEndId = looseEndIds[firstIndex];
-        vtkIdType neighborId = pointNeighbors[firstLooseEndId];
-        double firstLooseEnd[3];
-        slice->GetPoint(firstLooseEndId, firstLooseEnd);
-        double neighbor[3];
-        slice->GetPoint(neighborId, neighbor);
-
-        vtkIdType secondLooseEndId = looseEndIds[secondIndex];
-        vtkIdType secondNeighborId = pointNeighbors[secondLooseEndId];
-        double secondLooseEnd[3];
-        slice->GetPoint(secondLooseEndId, secondLooseEnd);
-        double secondNeighbor[3];
-        slice->GetPoint(secondNeighborId, secondNeighbor);
-
-        // remove these loose ends from the list
-        looseEndIds.erase(looseEndIds.begin() + secondIndex);
-        looseEndIds.erase(looseEndIds.begin() + firstIndex);
-
-        if (!isCoincident)
-          {
-          // create a new line segment by connecting these two points
-          lines->InsertNextCell(2);
-          lines->InsertCellPoint(firstLooseEndId);
-          lines->InsertCellPoint(secondLooseEndId);
+          // check if new candidate is better than previous one
+          if ((checkOnHull && !isOnHull) ||
+              (checkOnHull == isOnHull && dotprod > maxval*distance2))
+            {
+            firstIndex = i;
+            secondIndex = j;
+            isOnHull |= checkOnHull;
+            maxval = dotprod/distance2;
+            }
           }
         }
+      }
 
-        this->LinesCache.insert(std::pair<double, vtkCellArray*>(z, lines));
-        this->NptsCache.insert(std::pair<double, vtkIdType>(z, npts));
-        this->PointNeighborCountsCache.insert(std::pair<double, vtkSmartPointer<vtkIdTypeArray> >(z, pointNeighborCountsArray));
-
+    // get info about the two loose ends and their neighbors
+    vtkIdType firstLooseEndId = looseEndIds[firstIndex];
+    vtkIdType neighborId = pointNeighbors[firstLooseEndId];
+    double firstLooseEnd[3];
+    slice->GetPoint(firstLooseEndId, firstLooseEnd);
+    double neighbor[3];
+    slice->GetPoint(neighborId, neighbor);
+
+    vtkIdType secondLooseEndId = looseEndIds[secondIndex];
+    vtkIdType secondNeighborId = pointNeighbors[secondLooseEndId];
+    double secondLooseEnd[3];
+    slice->GetPoint(secondLooseEndId, secondLooseEnd);
+    double secondNeighbor[3];
+    slice->GetPoint(secondNeighborId, secondNeighbor);
+
+    // remove these loose ends from the list
+    looseEndIds.erase(looseEndIds.begin() + secondIndex);
+    looseEndIds.erase(looseEndIds.begin() + firstIndex);
+
+    if (!isCoincident)
+      {
+      // create a new line segment by connecting these two points
+      lines->InsertNextCell(2);
+      lines->InsertCellPoint(firstLooseEndId);
+      lines->InsertCellPoint(secondLooseEndId);
       }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyDataToFractionalLabelmapFilter::FillImageStencilData(
+  vtkImageStencilData *data, vtkPolyData* slice, vtkIdTypeArray* pointNeighborCountsArray,
+  int sliceExtent[6])
+{
+  // Description of algorithm:
+  // 1) cut the polydata at each z slice to create polylines (CreateSliceContour)
+  // 2) find all "loose ends" and connect them to make polygons (CreateSliceContour)
+  //    (if the input polydata is closed, there will be no loose ends)
+  // 3) go through all line segments, and for each integer y value on
+  //    a line segment, store the x value at that point in a bucket
+  // 4) find all the stored x values and use them to create the z slice
+  //    of the vtkStencilData
+
+  // the spacing and origin of the generated stencil
+  double *spacing = data->GetSpacing();
+  double *origin = data->GetOrigin();
+
+  // Only divide once
+  double invspacing[3];
+  invspacing[0] = 1.0/spacing[0];
+  invspacing[1] = 1.0/spacing[1];
+  invspacing[2] = 1.0/spacing[2];
+
+  // This raster stores all line segments by recording all "x"
+  // positions on the surface for each y integer position.
+  vtkImageStencilRaster raster(&sliceExtent[2]);
+  raster.SetTolerance(this->Tolerance);
+  raster.PrepareForNewData();
+
+  // convert to structured coords via origin and spacing
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->DeepCopy(slice->GetPoints());
+  vtkIdType numberOfPoints = points->GetNumberOfPoints();
 
-   if (this->LinesCache.count(z) == 0)
+  for (vtkIdType j = 0; j < numberOfPoints; j++)
     {
-     continue;
+    double tempPoint[3];
+    points->GetPoint(j, tempPoint);
+    tempPoint[0] = (tempPoint[0] - origin[0])*invspacing[0];
+    tempPoint[1] = (tempPoint[1] - origin[1])*invspacing[1];
+    tempPoint[2] = (tempPoint[2] - origin[2])*invspacing[2];
+    points->SetPoint(j, tempPoint);
     }
 
-    vtkCellArray* lines = this->LinesCache[z];
-    vtkIdType count = lines->GetNumberOfConnectivityEntries();
-    vtkIdType* pointIds = this->PointIdsCache[z];
-    vtkIdType npts = this->NptsCache[z];
-    vtkIdTypeArray* pointNeighborCountsArray = this->PointNeighborCountsCache[z];
-    vtkIdType* pointNeighborCounts = pointNeighborCountsArray->GetPointer(0);
-
-    // Step 3: Go through all the line segments for this slice,
-    // and for each integer y position on the line segment,
-    // drop the corresponding x position into the y raster line.
-    for (vtkIdType loc = 0; loc < count; loc += npts + 1)
+  vtkCellArray* lines = slice->GetLines();
+  vtkIdType count = lines->GetNumberOfConnectivityEntries();
+  vtkIdType* pointIds = nullptr;
+  vtkIdType npts = 0;
+  vtkIdType* pointNeighborCounts = pointNeighborCountsArray->GetPointer(0);
+
+  // Step 3: Go through all the line segments for this slice,
+  // and for each integer y position on the line segment,
+  // drop the corresponding x position into the y raster line.
+  for (vtkIdType loc = 0; loc < count; loc += npts + 1)
+    {
+    lines->GetCell(loc, npts, pointIds);
+    if (npts > 0)
       {
-      lines->GetCell(loc, npts, pointIds);
-      if (npts > 0)
+      vtkIdType pointId0 = pointIds[0];
+      double point0[3];
+      points->GetPoint(pointId0, point0);
+      for (vtkIdType j = 1; j < npts; j++)
         {
-        vtkIdType pointId0 = pointIds[0];
-        double point0[3];
-        points->GetPoint(pointId0, point0);
-        for (vtkIdType j = 1; j < npts; j++)
-          {
-          vtkIdType pointId1 = pointIds[j];
-          double point1[3];
-          points->GetPoint(pointId1, point1);
+        vtkIdType pointId1 = pointIds[j];
+        double point1[3];
+        points->GetPoint(pointId1, point1);
 
-          // make sure points aren't flagged for removal
-          if (pointNeighborCounts[pointId0] > 0 &&
-              pointNeighborCounts[pointId1] > 0)
-            {
-            raster.InsertLine(point0, point1);
-            }
-
-          pointId0 = pointId1;
-          point0[0] = point1[0];
-          point0[1] = point1[1];
-          point0[2] = point1[2];
+        // make sure points aren't flagged for removal
+        if (pointNeighborCounts[pointId0] > 0 &&
+            pointNeighborCounts[pointId1] > 0)
+          {
+          raster.InsertLine(point0, point1);
           }
+
+        pointId0 = pointId1;
+        point0[0] = point1[0];
+        point0[1] = point1[1];
+        point0[2] = point1[2];
         }
       }
-
-    // Step 4: Use the x values stored in the xy raster to create
-    // one z slice of the vtkStencilData
-    sliceExtent[4] = idxZ;
-    sliceExtent[5] = idxZ;
-    raster.FillStencilData(data, sliceExtent);
-
     }
 
+  // Step 4: Use the x values stored in the xy raster to create
+  // one z slice of the vtkStencilData
+  raster.FillStencilData(data, sliceExtent);
 }
 
 //----------------------------------------------------------------------------
 void vtkPolyDataToFractionalLabelmapFilter::PolyDataCutter(
-  vtkPolyData *input, vtkPolyData *output, double z)
+  vtkPolyData *input, const std::vector<vtkIdType>& cellIds, vtkPolyData *output, double z)
 {
   vtkPoints *points = input->GetPoints();
   vtkPoints *newPoints = vtkPoints::New();
@@ -889,26 +886,14 @@ void vtkPolyDataToFractionalLabelmapFilter::PolyDataCutter(
   // An edge locator to avoid point duplication while clipping
   EdgeLocator edgeLocator;
 
-  vtkSmartPointer<vtkIdList> cells = vtkSmartPointer<vtkIdList>::New();
-  cells->Initialize();
-
-  double bounds[6] = {0,0,0,0,0,0};
-  input->GetBounds(bounds);
-  bounds[4] = z;
-  bounds[5] = z;
-
-  // Find cells that intersect with the current slice.
-  this->CellLocator->FindCellsWithinBounds(bounds, cells);
-
-  // Go through all cells and clip them.
-  vtkIdType numCells = cells->GetNumberOfIds();
-
+  // Go through all cells that may intersect with the current slice and clip them.
+  vtkIdType numCells = static_cast<vtkIdType>(cellIds.size());
 
   vtkIdType loc = 0;
   for (vtkIdType cellId = 0; cellId < numCells; cellId++)
     {
 
-    vtkIdType id = cells->GetId(cellId);
+    vtkIdType id = cellIds[cellId];
 
     if (input->GetCellType(id) != VTK_TRIANGLE &&
         input->GetCellType(id) != VTK_TRIANGLE_STRIP)
@@ -982,15 +967,3 @@ void vtkPolyDataToFractionalLabelmapFilter::PolyDataCutter(
   newPoints->Delete();
   newLines->Delete();
 }
-
-//----------------------------------------------------------------------------
-void vtkPolyDataToFractionalLabelmapFilter::DeleteCache()
-{
-
-  this->SliceCache.clear();
-  this->LinesCache.clear();
-  this->NptsCache.clear();
-  this->PointIdsCache.clear();
-  this->PointNeighborCountsCache.clear();
-
-}
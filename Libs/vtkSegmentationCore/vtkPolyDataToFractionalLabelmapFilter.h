@@ -30,13 +30,12 @@
 #include <vtkCellArray.h>
 #include <vtkSetGet.h>
 #include <vtkMatrix4x4.h>
-#include <vtkCellLocator.h>
 
 // Segmentations includes
 #include <vtkOrientedImageData.h>
 
 // std includes
-#include <map>
+#include <vector>
 
 #include "vtkSegmentationCoreConfigure.h"
 
@@ -64,16 +63,9 @@ class vtkSegmentationCore_EXPORT vtkPolyDataToFractionalLabelmapFilter :
   public vtkPolyDataToImageStencil
 {
 private:
-  std::map<double, vtkSmartPointer<vtkCellArray> > LinesCache;
-  std::map<double, vtkSmartPointer<vtkPolyData> > SliceCache;
-  std::map<double, vtkIdType*> PointIdsCache;
-  std::map<double, vtkIdType> NptsCache;
-  std::map<double,  vtkSmartPointer<vtkIdTypeArray> > PointNeighborCountsCache;
-
-  vtkCellLocator* CellLocator;
-
   vtkOrientedImageData* OutputImageTransformData;
   int NumberOfOffsets;
+  int NumberOfThreads;
 
 public:
   static vtkPolyDataToFractionalLabelmapFilter* New();
@@ -99,13 +91,18 @@ public:
   void SetOutputSpacing(double spacing[3]) override;
   void SetOutputSpacing(double x, double y, double z) override;
 
-
-  /// This method deletes the currently stored cache variables
+  /// \deprecated The filter no longer stores cached contours between executions,
+  /// there is nothing to delete. Kept for backward compatibility.
   void DeleteCache();
 
   vtkSetMacro(NumberOfOffsets, int);
   vtkGetMacro(NumberOfOffsets, int);
 
+  /// Number of threads that slices are rasterized on.
+  /// 0 (default) uses all the available cores.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   vtkPolyDataToFractionalLabelmapFilter();
   ~vtkPolyDataToFractionalLabelmapFilter() override;
@@ -115,24 +112,42 @@ protected:
   vtkOrientedImageData *AllocateOutputData(vtkDataObject *out, int* updateExt);
   int FillOutputPortInformation(int, vtkInformation*) override;
 
-  /// Create a binary image stencil for the closed surface within the current extent
-  /// This method is a modified version of vtkPolyDataToImageStencil::ThreadedExecute
-  /// \param output Output stencil data
-  /// \param closedSurface The input surface to be converted
-  /// \param extent The extent region that is being converted
-  void FillImageStencilData(vtkImageStencilData *output, vtkPolyData* closedSurface, int extent[6]);
+  /// Number of threads resolved from NumberOfThreads, at least 1.
+  int GetNumberOfThreadsToUse();
 
-  /// Add the values of the binary labelmap to the fractional labelmap.
-  /// \param binaryLabelMap Binary labelmap that will be added to the fractional labelmap
+  /// Cut the closed surface at the specified z coordinate and connect the loose ends of the contour.
+  /// This method is a modified version of steps 1 and 2 of vtkPolyDataToImageStencil::ThreadedExecute
+  /// \param closedSurface The input surface to be converted
+  /// \param cellIds Cells of the surface that may intersect the z plane
+  /// \param z The z coordinate for the cutting plane
+  /// \param slice Output contour lines
+  /// \param pointNeighborCountsArray Output number of neighbors of each contour point, 0 for removed points
+  void CreateSliceContour(vtkPolyData* closedSurface, const std::vector<vtkIdType>& cellIds, double z,
+    vtkPolyData* slice, vtkIdTypeArray* pointNeighborCountsArray);
+
+  /// Create a binary image stencil of one slice from a contour created by CreateSliceContour.
+  /// This method is a modified version of steps 3 and 4 of vtkPolyDataToImageStencil::ThreadedExecute
+  /// \param output Output stencil data, its origin is the offset of the binary labelmap
+  /// \param slice Contour of the slice
+  /// \param pointNeighborCountsArray Number of neighbors of each contour point
+  /// \param sliceExtent The extent of the slice that is being converted
+  void FillImageStencilData(vtkImageStencilData *output, vtkPolyData* slice,
+    vtkIdTypeArray* pointNeighborCountsArray, int sliceExtent[6]);
+
+  /// Add one step to the voxels of the fractional labelmap that are inside the stencil.
+  /// \param stencilData Binary labelmap of one slice, as a stencil
   /// \param fractionalLabelMap The fractional labelmap that the binary labelmap is added to
-  void AddBinaryLabelMapToFractionalLabelMap(vtkImageData* binaryLabelMap, vtkImageData* fractionalLabelMap);
+  /// \param sliceExtent The extent of the slice
+  void AddImageStencilDataToFractionalLabelMap(vtkImageStencilData* stencilData, vtkImageData* fractionalLabelMap,
+    int sliceExtent[6]);
 
   /// Clip the polydata at the specified z coordinate to create a planar contour.
   /// This method is a modified version of vtkPolyDataToImageStencil::PolyDataCutter to decrease execution time
   /// \param input The closed surface that is being cut
+  /// \param cellIds Cells of the surface that may intersect the z plane
   /// \param output Polydata containing the contour lines
   /// \param z The z coordinate for the cutting plane
-  void PolyDataCutter(vtkPolyData *input, vtkPolyData *output,
+  void PolyDataCutter(vtkPolyData *input, const std::vector<vtkIdType>& cellIds, vtkPolyData *output,
                              double z);
 
 private:
@@ -439,10 +439,8 @@ bool vtkSegmentation::AddSegment(vtkSegment* segment, std::string segmentId/*=""
             }
 
           // Convert using the cheapest available path
-          vtkSegmentationConverter::ConversionPathAndCostListType pathsToCurrentRepresentation;
-          this->Converter->GetPossibleConversions(this->MasterRepresentationName, (*reprIt), pathsToCurrentRepresentation);
           vtkSegmentationConverter::ConversionPathType cheapestPath =
-            vtkSegmentationConverter::GetCheapestPath(pathsToCurrentRepresentation);
+            this->Converter->GetCheapestConversionPath(this->MasterRepresentationName, (*reprIt));
           if (cheapestPath.empty())
             {
             vtkErrorMacro("AddSegment: Unable to perform conversion"); // Sanity check, it should never happen
@@ -1027,6 +1025,7 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
 
     // Perform conversion step
     currentConversionRule->PreConvert(this);
+    std::vector<vtkSegment*> segmentsToConvert;
     for (auto segmentID : segmentIDs)
       {
       vtkSegment* segment = this->GetSegment(segmentID);
@@ -1049,8 +1048,9 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
         {
         continue;
         }
-      currentConversionRule->Convert(segment);
+      segmentsToConvert.push_back(segment);
       }
+    currentConversionRule->ConvertSegments(segmentsToConvert);
     currentConversionRule->PostConvert(this);
 
   }
@@ -2109,11 +2109,9 @@ bool vtkSegmentation::ConvertSingleSegment(std::string segmentId, std::string ta
     return false;
     }
 
-  // Get possible conversion paths from master to the requested target representation
-  vtkSegmentationConverter::ConversionPathAndCostListType pathCosts;
-  this->Converter->GetPossibleConversions(this->MasterRepresentationName, targetRepresentationName, pathCosts);
-  // Get cheapest path from found conversion paths
-  vtkSegmentationConverter::ConversionPathType cheapestPath = vtkSegmentationConverter::GetCheapestPath(pathCosts);
+  // Get cheapest conversion path from master to the requested target representation
+  vtkSegmentationConverter::ConversionPathType cheapestPath =
+    this->Converter->GetCheapestConversionPath(this->MasterRepresentationName, targetRepresentationName);
   if (cheapestPath.empty())
     {
     return false;
@@ -332,9 +332,47 @@ vtkSegmentationConverter::ConversionPathType vtkSegmentationConverter::GetCheape
 //----------------------------------------------------------------------------
 void vtkSegmentationConverter::GetPossibleConversions(const std::string& sourceRepresentationName, const std::string& targetRepresentationName, ConversionPathAndCostListType &pathsCosts)
 {
-  pathsCosts.clear();
+  pathsCosts = this->GetConversionPathCacheEntry(sourceRepresentationName, targetRepresentationName).PathsCosts;
+}
+
+//----------------------------------------------------------------------------
+vtkSegmentationConverter::ConversionPathType vtkSegmentationConverter::GetCheapestConversionPath(
+  const std::string& sourceRepresentationName, const std::string& targetRepresentationName)
+{
+  return this->GetConversionPathCacheEntry(sourceRepresentationName, targetRepresentationName).CheapestPath;
+}
+
+//----------------------------------------------------------------------------
+const vtkSegmentationConverter::ConversionPathCacheEntry& vtkSegmentationConverter::GetConversionPathCacheEntry(
+  const std::string& sourceRepresentationName, const std::string& targetRepresentationName)
+{
+  this->UpdateConversionPathCache();
+  std::pair<std::string, std::string> sourceTarget(sourceRepresentationName, targetRepresentationName);
+  ConversionPathCacheType::iterator cacheIt = this->ConversionPathCache.find(sourceTarget);
+  if (cacheIt != this->ConversionPathCache.end())
+    {
+    return cacheIt->second;
+    }
+  ConversionPathCacheEntry& entry = this->ConversionPathCache[sourceTarget];
   std::set<std::string> skipRepresentations;
-  this->FindPath(sourceRepresentationName, targetRepresentationName, pathsCosts, skipRepresentations);
+  this->FindPath(sourceRepresentationName, targetRepresentationName, entry.PathsCosts, skipRepresentations);
+  entry.CheapestPath = vtkSegmentationConverter::GetCheapestPath(entry.PathsCosts);
+  return entry;
+}
+
+//----------------------------------------------------------------------------
+void vtkSegmentationConverter::UpdateConversionPathCache()
+{
+  // Conversion costs may depend on rule parameters, therefore any rule modification invalidates the cache
+  for (ConverterRulesListType::iterator ruleIt = this->ConverterRules.begin(); ruleIt != this->ConverterRules.end(); ++ruleIt)
+    {
+    if ((*ruleIt)->GetMTime() > this->ConversionPathCacheTime.GetMTime())
+      {
+      this->ConversionPathCache.clear();
+      break;
+      }
+    }
+  this->ConversionPathCacheTime.Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -452,6 +490,7 @@ void vtkSegmentationConverter::FindPath(const std::string& sourceRepresentationN
 void vtkSegmentationConverter::RebuildRulesGraph()
 {
   this->RulesGraph.clear();
+  this->ConversionPathCache.clear();
   for (ConverterRulesListType::iterator ruleIt = this->ConverterRules.begin(); ruleIt != this->ConverterRules.end(); ++ruleIt)
     {
     this->RulesGraph[ruleIt->GetPointer()->GetSourceRepresentationName()].push_back(ruleIt->GetPointer());
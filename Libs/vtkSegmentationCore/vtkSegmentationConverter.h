@@ -24,6 +24,7 @@
 // VTK includes
 #include <vtkObject.h>
 #include <vtkSmartPointer.h>
+#include <vtkTimeStamp.h>
 
 // STD includes
 #include <map>
@@ -86,9 +87,16 @@ public:
   /// Get all representations supported by the converter
   void GetAvailableRepresentationNames(std::set<std::string>& representationNames);
 
-  /// Get all possible conversions between two representations
+  /// Get all possible conversions between two representations.
+  /// Paths are cached per source and target representation and only searched again
+  /// if the rules or their conversion parameters have been modified.
   void GetPossibleConversions(const std::string& sourceRepresentationName, const std::string& targetRepresentationName, ConversionPathAndCostListType &pathsCosts);
 
+  /// Get the cheapest conversion path between two representations.
+  /// Same as calling GetCheapestPath on the result of GetPossibleConversions, but the result is cached.
+  /// \return Cheapest path, empty if the target representation cannot be reached from the source
+  ConversionPathType GetCheapestConversionPath(const std::string& sourceRepresentationName, const std::string& targetRepresentationName);
+
   /// Get all conversion parameters used by the selected conversion path
   void GetConversionParametersForPath(vtkSegmentationConverterRule::ConversionParameterListType& conversionParameters, const ConversionPathType& path);
 
@@ -153,7 +161,8 @@ public:
   static bool DeserializeImageGeometry(std::string geometryString, vtkMatrix4x4* geometryMatrix, int extent[6]);
 
 protected:
-  /// Build a graph from ConverterRules list to facilitate faster finding of rules from a specific representation
+  /// Build a graph from ConverterRules list to facilitate faster finding of rules from a specific representation.
+  /// Clears the conversion path cache.
   void RebuildRulesGraph();
 
   /// Find a transform path between the specified coordinate frames.
@@ -185,6 +194,26 @@ protected:
 
   /// Source representation to target representation rule graph
   RepresentationToRepresentationToRuleMapType RulesGraph;
+
+  /// All paths and the cheapest path found between a source (first) and target (second) representation
+  struct ConversionPathCacheEntry
+    {
+    ConversionPathAndCostListType PathsCosts;
+    ConversionPathType CheapestPath;
+    };
+  typedef std::map<std::pair<std::string, std::string>, ConversionPathCacheEntry> ConversionPathCacheType;
+
+  /// Get cached conversion paths between two representations. Paths are searched if not found in the cache.
+  const ConversionPathCacheEntry& GetConversionPathCacheEntry(const std::string& sourceRepresentationName, const std::string& targetRepresentationName);
+
+  /// Clear cached conversion paths if any of the rules has been modified since they were computed
+  void UpdateConversionPathCache();
+
+  /// Cached conversion paths. Invalidated when the rules graph is rebuilt or a rule is modified
+  /// (e.g., a conversion parameter is changed), as that may change conversion costs.
+  ConversionPathCacheType ConversionPathCache;
+  /// Time when the conversion path cache was last validated
+  vtkTimeStamp ConversionPathCacheTime;
 };
 
 #endif // __vtkSegmentationConverter_h
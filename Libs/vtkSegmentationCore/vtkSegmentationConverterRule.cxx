@@ -65,6 +65,20 @@ bool vtkSegmentationConverterRule::CreateTargetRepresentation(vtkSegment* segmen
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkSegmentationConverterRule::ConvertSegments(const std::vector<vtkSegment*>& segments)
+{
+  bool success = true;
+  for (vtkSegment* segment : segments)
+    {
+    if (!this->Convert(segment))
+      {
+      success = false;
+      }
+    }
+  return success;
+}
+
 //----------------------------------------------------------------------------
 void vtkSegmentationConverterRule::GetRuleConversionParameters(ConversionParameterListType& conversionParameters)
 {
@@ -79,12 +93,23 @@ void vtkSegmentationConverterRule::GetRuleConversionParameters(ConversionParamet
 //----------------------------------------------------------------------------
 void vtkSegmentationConverterRule::SetConversionParameter(const std::string& name, const std::string& value, const std::string& description/*=""*/)
 {
+  ConversionParameterListType::iterator paramIt = this->ConversionParameters.find(name);
+  if (paramIt != this->ConversionParameters.end() && paramIt->second.first == value
+    && (description.empty() || paramIt->second.second == description))
+    {
+    // No change
+    return;
+    }
+
   this->ConversionParameters[name].first = value;
 
   if (!description.empty())
     {
     this->ConversionParameters[name].second = description;
     }
+
+  // Conversion costs may depend on parameters, notify the converter to update cached conversion paths
+  this->Modified();
 }
 
 //----------------------------------------------------------------------------
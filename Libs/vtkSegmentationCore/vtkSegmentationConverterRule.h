@@ -92,6 +92,12 @@ public:
   /// \sa ConvertInternal
   virtual bool Convert(vtkSegment* segment) = 0;
 
+  /// Update the target representation of multiple segments of a segmentation.
+  /// Called between PreConvert and PostConvert. The default implementation calls Convert
+  /// for each segment, rules may override it to convert the segments in parallel.
+  /// \return True if all the segments were converted successfully
+  virtual bool ConvertSegments(const std::vector<vtkSegment*>& segments);
+
   /// Perform post-conversion steps across the specified segments in the segmentation
   /// This step should be unneccessary if only converting a single segment
   virtual bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) { return true; };
@@ -41,8 +41,12 @@
 // VTK includes
 #include <vtkBoundingBox.h>
 #include <vtkGeneralTransform.h>
+#include <vtkImageBSplineCoefficients.h>
+#include <vtkImageBSplineInterpolator.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageData.h>
+#include <vtkImageReslice.h>
+#include <vtkImageSincInterpolator.h>
 #include <vtkNew.h>
 #include <vtkMatrix4x4.h>
 #include <vtkMatrix3x3.h>
@@ -65,6 +69,7 @@ public:
 
   vtkSlicerVolumesLogic* VolumesLogic;
   vtkSlicerCLIModuleLogic* ResampleLogic;
+  bool UseResampleCLI;
 };
 
 //----------------------------------------------------------------------------
@@ -72,6 +77,7 @@ vtkSlicerCropVolumeLogic::vtkInternal::vtkInternal()
 {
   this->VolumesLogic = nullptr;
   this->ResampleLogic = nullptr;
+  this->UseResampleCLI = false;
 }
 
 //----------------------------------------------------------------------------
@@ -113,11 +119,24 @@ vtkSlicerCLIModuleLogic* vtkSlicerCropVolumeLogic::GetResampleLogic()
   return this->Internal->ResampleLogic;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerCropVolumeLogic::SetUseResampleCLI(bool use)
+{
+  this->Internal->UseResampleCLI = use;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerCropVolumeLogic::GetUseResampleCLI()
+{
+  return this->Internal->UseResampleCLI;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCropVolumeLogic::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->vtkObject::PrintSelf(os, indent);
   os << indent << "vtkSlicerCropVolumeLogic:             " << this->GetClassName() << "\n";
+  os << indent << "UseResampleCLI: " << (this->Internal->UseResampleCLI ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -419,6 +438,70 @@ bool vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputGeometry(vtkMRMLAnnotati
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputIJKToRAS(vtkMRMLAnnotationROINode* roi,
+  vtkMRMLVolumeNode* outputVolume, const int outputExtent[6], const double outputSpacing[3], vtkMatrix4x4* outputIJKToRAS)
+{
+  if (!roi || !outputVolume || !outputIJKToRAS)
+    {
+    return false;
+    }
+
+  double roiXYZ[3] = { 0 };
+  roi->GetXYZ(roiXYZ);
+  double roiRadius[3] = { 0 };
+  roi->GetRadiusXYZ(roiRadius);
+
+  outputIJKToRAS->Identity();
+  outputIJKToRAS->SetElement(0, 0, outputSpacing[0]);
+  outputIJKToRAS->SetElement(1, 1, outputSpacing[1]);
+  outputIJKToRAS->SetElement(2, 2, outputSpacing[2]);
+  outputIJKToRAS->SetElement(0, 3, roiXYZ[0] - roiRadius[0]);
+  outputIJKToRAS->SetElement(1, 3, roiXYZ[1] - roiRadius[1]);
+  outputIJKToRAS->SetElement(2, 3, roiXYZ[2] - roiRadius[2]);
+
+  // account for the ROI parent transform, if present
+  vtkMRMLTransformNode *roiTransform = roi->GetParentTransformNode();
+  vtkMRMLTransformNode *outputTransform = outputVolume->GetParentTransformNode();
+  if (roiTransform && !roiTransform->IsTransformToWorldLinear())
+    {
+    return false;
+    }
+  if (outputTransform && !outputTransform->IsTransformToWorldLinear())
+    {
+    return false;
+    }
+
+  vtkNew<vtkMatrix4x4> roiMatrix;
+  vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(roiTransform, outputTransform, roiMatrix.GetPointer());
+  vtkMatrix4x4::Multiply4x4(roiMatrix.GetPointer(), outputIJKToRAS, outputIJKToRAS);
+
+  // Center the output image in the ROI. For that, compute the size difference between
+  // the ROI and the output image.
+  double sizeDifference_IJK[3] =
+    {
+    roiRadius[0] * 2 / outputSpacing[0] - (outputExtent[1] - outputExtent[0] + 1),
+    roiRadius[1] * 2 / outputSpacing[1] - (outputExtent[3] - outputExtent[2] + 1),
+    roiRadius[2] * 2 / outputSpacing[2] - (outputExtent[5] - outputExtent[4] + 1)
+    };
+  // Origin is in the voxel's center. Shift the origin by half voxel
+  // to have the ROI edge at the output image voxel edge.
+  double outputOrigin_IJK[4] =
+    {
+    0.5 + sizeDifference_IJK[0] / 2,
+    0.5 + sizeDifference_IJK[1] / 2,
+    0.5 + sizeDifference_IJK[2] / 2,
+    1.0
+    };
+  double outputOrigin_RAS[4] = { 0.0, 0.0, 0.0, 1.0 };
+  outputIJKToRAS->MultiplyPoint(outputOrigin_IJK, outputOrigin_RAS);
+  for (int row = 0; row < 3; row++)
+    {
+    outputIJKToRAS->SetElement(row, 3, outputOrigin_RAS[row]);
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputVolume,
   bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue)
@@ -428,6 +511,149 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
     return -1;
     }
 
+  // Diffusion weighted volumes need gradient directions and measurement frame to be updated,
+  // which is only implemented in the resample CLI module.
+  if (this->Internal->UseResampleCLI || vtkMRMLDiffusionWeightedVolumeNode::SafeDownCast(inputVolume))
+    {
+    return this->CropInterpolatedUsingResampleCLI(roi, inputVolume, outputVolume,
+      isotropicResampling, spacingScale, interpolationMode, fillValue);
+    }
+
+  return vtkSlicerCropVolumeLogic::CropInterpolatedInProcess(roi, inputVolume, outputVolume,
+    isotropicResampling, spacingScale, interpolationMode, fillValue);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCropVolumeLogic::CropInterpolatedInProcess(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
+  vtkMRMLVolumeNode* outputVolume, bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue)
+{
+  if (!roi || !inputVolume || !outputVolume)
+    {
+    return -1;
+    }
+  if (!inputVolume->GetImageData())
+    {
+    vtkGenericWarningMacro("vtkSlicerCropVolumeLogic::CropInterpolatedInProcess: input image is empty");
+    outputVolume->SetAndObserveImageData(nullptr);
+    return 0;
+    }
+
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  double outputSpacing[3] = { 0 };
+  vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputGeometry(roi, inputVolume, isotropicResampling, spacingScale, outputExtent, outputSpacing);
+
+  vtkMRMLTransformNode *roiTransform = roi->GetParentTransformNode();
+  if (roiTransform && !roiTransform->IsTransformToWorldLinear())
+    {
+    vtkGenericWarningMacro("vtkSlicerCropVolumeLogic::CropInterpolatedInProcess: ROI is under a non-linear transform");
+    return -5;
+    }
+  vtkMRMLTransformNode *outputTransform = outputVolume->GetParentTransformNode();
+  if (outputTransform && !outputTransform->IsTransformToWorldLinear())
+    {
+    vtkGenericWarningMacro("vtkSlicerCropVolumeLogic::CropInterpolatedInProcess: output volume is under a non-linear transform");
+    return -6;
+    }
+
+  vtkNew<vtkMatrix4x4> outputIJKToRAS;
+  if (!vtkSlicerCropVolumeLogic::GetInterpolatedCropOutputIJKToRAS(roi, outputVolume, outputExtent, outputSpacing, outputIJKToRAS.GetPointer()))
+    {
+    vtkGenericWarningMacro("vtkSlicerCropVolumeLogic::CropInterpolatedInProcess: failed to get output geometry");
+    return -1;
+    }
+
+  // Output IJK -> output RAS -> input RAS -> input IJK
+  vtkNew<vtkMatrix4x4> inputRASToIJK;
+  inputVolume->GetRASToIJKMatrix(inputRASToIJK.GetPointer());
+  vtkNew<vtkGeneralTransform> outputToInputTransform;
+  vtkMRMLTransformNode::GetTransformBetweenNodes(outputTransform, inputVolume->GetParentTransformNode(),
+    outputToInputTransform.GetPointer());
+
+  vtkNew<vtkImageReslice> reslice;
+  reslice->SetInputData(inputVolume->GetImageData());
+  vtkNew<vtkTransform> outputToInputTransformLinear;
+  if (vtkMRMLTransformNode::IsGeneralTransformLinear(outputToInputTransform.GetPointer(), outputToInputTransformLinear.GetPointer()))
+    {
+    // Linear transform: a single matrix maps output voxels to input voxels,
+    // which allows vtkImageReslice to use its fast path.
+    vtkNew<vtkMatrix4x4> outputIJKToInputIJK;
+    vtkMatrix4x4::Multiply4x4(outputToInputTransformLinear->GetMatrix(), outputIJKToRAS.GetPointer(), outputIJKToInputIJK.GetPointer());
+    vtkMatrix4x4::Multiply4x4(inputRASToIJK.GetPointer(), outputIJKToInputIJK.GetPointer(), outputIJKToInputIJK.GetPointer());
+    reslice->SetResliceAxes(outputIJKToInputIJK.GetPointer());
+    }
+  else
+    {
+    vtkNew<vtkGeneralTransform> resliceTransform;
+    resliceTransform->PostMultiply();
+    resliceTransform->Concatenate(outputToInputTransform.GetPointer());
+    resliceTransform->Concatenate(inputRASToIJK.GetPointer());
+    reslice->SetResliceAxes(outputIJKToRAS.GetPointer());
+    reslice->SetResliceTransform(resliceTransform.GetPointer());
+    }
+
+  // Interpolating label values would create non-existing labels
+  if (vtkMRMLLabelMapVolumeNode::SafeDownCast(inputVolume))
+    {
+    interpolationMode = vtkMRMLCropVolumeParametersNode::InterpolationNearestNeighbor;
+    }
+  switch (interpolationMode)
+    {
+    case vtkMRMLCropVolumeParametersNode::InterpolationNearestNeighbor:
+      reslice->SetInterpolationModeToNearestNeighbor();
+      break;
+    case vtkMRMLCropVolumeParametersNode::InterpolationWindowedSinc:
+      {
+      vtkNew<vtkImageSincInterpolator> sincInterpolator;
+      sincInterpolator->SetWindowFunctionToHamming();
+      reslice->SetInterpolator(sincInterpolator.GetPointer());
+      break;
+      }
+    case vtkMRMLCropVolumeParametersNode::InterpolationBSpline:
+      {
+      vtkNew<vtkImageBSplineCoefficients> bSplineCoefficients;
+      bSplineCoefficients->SetInputData(inputVolume->GetImageData());
+      bSplineCoefficients->SetSplineDegree(3);
+      reslice->SetInputConnection(bSplineCoefficients->GetOutputPort());
+      vtkNew<vtkImageBSplineInterpolator> bSplineInterpolator;
+      bSplineInterpolator->SetSplineDegree(3);
+      reslice->SetInterpolator(bSplineInterpolator.GetPointer());
+      // B-spline coefficients are computed as double, restore input scalar type
+      reslice->SetOutputScalarType(inputVolume->GetImageData()->GetScalarType());
+      break;
+      }
+    case vtkMRMLCropVolumeParametersNode::InterpolationLinear:
+    default:
+      reslice->SetInterpolationModeToLinear();
+      break;
+    }
+
+  reslice->SetOutputOrigin(0.0, 0.0, 0.0);
+  reslice->SetOutputSpacing(1.0, 1.0, 1.0);
+  reslice->SetOutputExtent(outputExtent);
+  reslice->SetBackgroundLevel(fillValue);
+  // vtkImageReslice splits the output extent between threads
+  reslice->Update();
+
+  vtkNew<vtkImageData> outputImageData;
+  outputImageData->ShallowCopy(reslice->GetOutput());
+
+  int wasModified = outputVolume->StartModify();
+  outputVolume->SetAndObserveImageData(outputImageData.GetPointer());
+  outputVolume->SetIJKToRASMatrix(outputIJKToRAS.GetPointer());
+  outputVolume->EndModify(wasModified);
+
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCropVolumeLogic::CropInterpolatedUsingResampleCLI(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
+  vtkMRMLVolumeNode* outputVolume, bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue)
+{
+  if (!roi || !inputVolume || !outputVolume)
+    {
+    return -1;
+    }
+
   if (this->Internal->ResampleLogic == nullptr)
     {
     vtkErrorMacro("CropVolume: resample logic is not set");
@@ -438,19 +664,6 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
   double outputSpacing[3] = { 0 };
   this->GetInterpolatedCropOutputGeometry(roi, inputVolume, isotropicResampling, spacingScale, outputExtent, outputSpacing);
 
-  double roiXYZ[3] = { 0 };
-  roi->GetXYZ(roiXYZ);
-  double roiRadius[3] = { 0 };
-  roi->GetRadiusXYZ(roiRadius);
-
-  vtkNew<vtkMatrix4x4> outputIJKToRAS;
-  outputIJKToRAS->SetElement(0, 0, outputSpacing[0]);
-  outputIJKToRAS->SetElement(1, 1, outputSpacing[1]);
-  outputIJKToRAS->SetElement(2, 2, outputSpacing[2]);
-  outputIJKToRAS->SetElement(0, 3, roiXYZ[0] - roiRadius[0]);
-  outputIJKToRAS->SetElement(1, 3, roiXYZ[1] - roiRadius[1]);
-  outputIJKToRAS->SetElement(2, 3, roiXYZ[2] - roiRadius[2]);
-
   // account for the ROI parent transform, if present
   vtkMRMLTransformNode *roiTransform = roi->GetParentTransformNode();
   vtkMRMLTransformNode *outputTransform = outputVolume->GetParentTransformNode();
@@ -468,10 +681,8 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
     return -6;
     }
 
-  vtkNew<vtkMatrix4x4> roiMatrix;
-  vtkMRMLTransformNode::GetMatrixTransformBetweenNodes(roiTransform, outputTransform, roiMatrix.GetPointer());
-  outputIJKToRAS->Multiply4x4(roiMatrix.GetPointer(), outputIJKToRAS.GetPointer(),
-    outputIJKToRAS.GetPointer());
+  vtkNew<vtkMatrix4x4> outputIJKToRAS;
+  this->GetInterpolatedCropOutputIJKToRAS(roi, outputVolume, outputExtent, outputSpacing, outputIJKToRAS.GetPointer());
 
   vtkNew<vtkMatrix4x4> rasToLPS;
   rasToLPS->SetElement(0, 0, -1);
@@ -507,29 +718,9 @@ int vtkSlicerCropVolumeLogic::CropInterpolated(vtkMRMLAnnotationROINode* roi, vt
     << (outputExtent[5] - outputExtent[4] + 1);
   cmdNode->SetParameterAsString("outputImageSize", sizeStream.str());
 
-  // Center the output image in the ROI. For that, compute the size difference between
-  // the ROI and the output image.
-  double sizeDifference_IJK[3] =
-    {
-    roiRadius[0] * 2 / outputSpacing[0] - (outputExtent[1] - outputExtent[0] + 1),
-    roiRadius[1] * 2 / outputSpacing[1] - (outputExtent[3] - outputExtent[2] + 1),
-    roiRadius[2] * 2 / outputSpacing[2] - (outputExtent[5] - outputExtent[4] + 1)
-    };
-  // Origin is in the voxel's center. Shift the origin by half voxel
-  // to have the ROI edge at the output image voxel edge.
-  double outputOrigin_IJK[4] =
-    {
-    0.5 + sizeDifference_IJK[0] / 2,
-    0.5 + sizeDifference_IJK[1] / 2,
-    0.5 + sizeDifference_IJK[2] / 2,
-    1.0
-    };
-  double outputOrigin_RAS[4] = { 0.0, 0.0, 0.0, 1.0 };
-  outputIJKToRAS->MultiplyPoint(outputOrigin_IJK, outputOrigin_RAS);
-
   vtkNew<vtkMRMLMarkupsFiducialNode> originMarkupNode;
   // Markups are transformed from RAS to LPS by the CLI infrastructure, so we pass them in RAS
-  originMarkupNode->AddFiducial(outputOrigin_RAS[0], outputOrigin_RAS[1], outputOrigin_RAS[2]);
+  originMarkupNode->AddFiducial(outputIJKToRAS->GetElement(0, 3), outputIJKToRAS->GetElement(1, 3), outputIJKToRAS->GetElement(2, 3));
   this->GetMRMLScene()->AddNode(originMarkupNode.GetPointer());
   cmdNode->SetParameterAsString("outputImageOrigin", originMarkupNode->GetID());
 
@@ -77,6 +77,11 @@ public:
   void SetResampleLogic(vtkSlicerCLIModuleLogic* logic);
   vtkSlicerCLIModuleLogic* GetResampleLogic();
 
+  /// If enabled, interpolated cropping of all volume types is performed using the resample CLI module,
+  /// as in earlier versions. Disabled by default: only diffusion weighted volumes use the CLI module.
+  void SetUseResampleCLI(bool use);
+  bool GetUseResampleCLI();
+
   /// Crop input volume using the specified ROI node.
   int Apply(vtkMRMLCropVolumeParametersNode*);
 
@@ -91,9 +96,17 @@ public:
     int outputExtent[6], bool limitToInputExtent=false);
 
   /// Perform interpolated cropping.
+  /// Scalar, vector, and labelmap volumes are resampled in-process (see CropInterpolatedInProcess),
+  /// diffusion weighted volumes are resampled using the resample CLI module (see SetUseResampleCLI).
   int CropInterpolated(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputNode,
     bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue);
 
+  /// Perform interpolated cropping using multi-threaded vtkImageReslice, without temporary files
+  /// or spawning a CLI process. The ROI may be arbitrarily oriented and the input volume may be
+  /// under a non-linear transform. Labelmap volumes are always resampled with nearest neighbor interpolation.
+  static int CropInterpolatedInProcess(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputNode,
+    bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue);
+
   /// Computes output volume geometry for interpolated cropping (without actually cropping the image).
   static bool GetInterpolatedCropOutputGeometry(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume,
     bool isotropicResampling, double spacingScale, int outputExtent[6], double outputSpacing[3]);
@@ -112,6 +125,16 @@ protected:
   vtkSlicerCropVolumeLogic();
   ~vtkSlicerCropVolumeLogic() override;
 
+  /// Perform interpolated cropping using the resample CLI module.
+  /// The output geometry is the same as CropInterpolatedInProcess. Requires the resample logic to be set.
+  int CropInterpolatedUsingResampleCLI(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* inputVolume, vtkMRMLVolumeNode* outputNode,
+    bool isotropicResampling, double spacingScale, int interpolationMode, double fillValue);
+
+  /// Compute IJK to RAS matrix of the interpolated cropping output volume
+  /// (in the coordinate system of the output volume's parent transform).
+  static bool GetInterpolatedCropOutputIJKToRAS(vtkMRMLAnnotationROINode* roi, vtkMRMLVolumeNode* outputVolume,
+    const int outputExtent[6], const double outputSpacing[3], vtkMatrix4x4* outputIJKToRAS);
+
 private:
   vtkSlicerCropVolumeLogic(const vtkSlicerCropVolumeLogic&) = delete;
   void operator=(const vtkSlicerCropVolumeLogic&) = delete;
@@ -0,0 +1,230 @@
+import unittest
+import numpy
+import vtk, slicer
+from vtk.util import numpy_support
+
+"""
+Compare interpolated cropping performed in-process (vtkImageReslice) with the
+result of the resample CLI module, which was used for all volume types before.
+"""
+
+class CropVolumeInProcessResamplingTest(unittest.TestCase):
+
+  #------------------------------------------------------------------------------
+  def setUp(self):
+    slicer.mrmlScene.Clear(0)
+    self.logic = slicer.modules.cropvolume.logic()
+    self.assertIsNotNone(self.logic.GetResampleLogic())
+    self.logic.SetUseResampleCLI(False)
+
+  #------------------------------------------------------------------------------
+  def tearDown(self):
+    self.logic.SetUseResampleCLI(False)
+
+  #------------------------------------------------------------------------------
+  def runTest(self):
+    self.setUp()
+    self.test_Interpolators()
+    self.setUp()
+    self.test_RotatedROI()
+    self.setUp()
+    self.test_LabelmapNearestNeighbor()
+    self.setUp()
+    self.test_NonLinearTransform()
+
+  #------------------------------------------------------------------------------
+  def createInputVolume(self):
+    """Create a smooth, obliquely oriented volume. Dimensions are (I, J, K) = (40, 48, 36)."""
+    k, j, i = numpy.mgrid[0:36, 0:48, 0:40].astype(numpy.float32)
+    voxels = 3 * i + 2 * j + k + 20 * numpy.sin(i / 5.0) * numpy.cos(j / 7.0)
+    ijkToRAS = vtk.vtkMatrix4x4()
+    rotation = vtk.vtkTransform()
+    rotation.RotateZ(20)
+    rotation.RotateX(-10)
+    rotation.Translate(-20.0, 15.0, -30.0)
+    rotation.Scale(1.2, 0.9, 1.5)
+    ijkToRAS.DeepCopy(rotation.GetMatrix())
+    return slicer.util.addVolumeFromArray(voxels, ijkToRAS, "Input")
+
+  #------------------------------------------------------------------------------
+  def createROI(self, volumeNode, transformNode=None):
+    """Create an ROI at the center of the volume, small enough to not reach the
+    volume boundary, even if rotated."""
+    ijkToRAS = vtk.vtkMatrix4x4()
+    volumeNode.GetIJKToRASMatrix(ijkToRAS)
+    dimensions = volumeNode.GetImageData().GetDimensions()
+    center = ijkToRAS.MultiplyPoint([(dimensions[0] - 1) / 2.0, (dimensions[1] - 1) / 2.0, (dimensions[2] - 1) / 2.0, 1.0])[:3]
+    roi = slicer.vtkMRMLAnnotationROINode()
+    roi.Initialize(slicer.mrmlScene)
+    roi.SetXYZ(center)
+    roi.SetRadiusXYZ(8.0, 7.0, 9.0)
+    if transformNode:
+      roi.SetAndObserveTransformNodeID(transformNode.GetID())
+    return roi, center
+
+  #------------------------------------------------------------------------------
+  def crop(self, roi, inputVolume, interpolationMode, inProcess, isotropicResampling=False, spacingScale=0.8):
+    outputVolume = slicer.mrmlScene.AddNewNodeByClass(inputVolume.GetClassName(), "Output")
+    self.logic.SetUseResampleCLI(not inProcess)
+    errorCode = self.logic.CropInterpolated(roi, inputVolume, outputVolume,
+      isotropicResampling, spacingScale, interpolationMode, 0.0)
+    self.logic.SetUseResampleCLI(False)
+    self.assertEqual(errorCode, 0)
+    self.assertIsNotNone(outputVolume.GetImageData())
+    return outputVolume
+
+  #------------------------------------------------------------------------------
+  def assertSameGeometry(self, volume1, volume2):
+    self.assertEqual(volume1.GetImageData().GetDimensions(), volume2.GetImageData().GetDimensions())
+    ijkToRAS1 = vtk.vtkMatrix4x4()
+    volume1.GetIJKToRASMatrix(ijkToRAS1)
+    ijkToRAS2 = vtk.vtkMatrix4x4()
+    volume2.GetIJKToRASMatrix(ijkToRAS2)
+    for row in range(4):
+      for column in range(4):
+        self.assertAlmostEqual(ijkToRAS1.GetElement(row, column), ijkToRAS2.GetElement(row, column), places=4)
+
+  #------------------------------------------------------------------------------
+  def assertSimilarVoxels(self, volume1, volume2, meanTolerance, maxTolerance=None):
+    """Tolerances are relative to the value range of the first volume"""
+    voxels1 = slicer.util.arrayFromVolume(volume1).astype(numpy.float64)
+    voxels2 = slicer.util.arrayFromVolume(volume2).astype(numpy.float64)
+    valueRange = voxels1.max() - voxels1.min()
+    self.assertGreater(valueRange, 0.0)
+    difference = numpy.abs(voxels1 - voxels2)
+    self.assertLess(difference.mean(), meanTolerance * valueRange)
+    if maxTolerance is not None:
+      self.assertLess(difference.max(), maxTolerance * valueRange)
+
+  #------------------------------------------------------------------------------
+  def test_Interpolators(self):
+    inputVolume = self.createInputVolume()
+    roi, center = self.createROI(inputVolume)
+
+    p = slicer.vtkMRMLCropVolumeParametersNode
+    for interpolationMode, meanTolerance, maxTolerance in [
+        (p.InterpolationNearestNeighbor, 0.01, None),  # ties between voxels may be broken differently
+        (p.InterpolationLinear, 1e-4, 1e-3),
+        (p.InterpolationWindowedSinc, 0.01, 0.05),  # different kernel implementation
+        (p.InterpolationBSpline, 0.005, 0.02),
+        ]:
+      for isotropicResampling in [False, True]:
+        inProcessVolume = self.crop(roi, inputVolume, interpolationMode, True, isotropicResampling)
+        cliVolume = self.crop(roi, inputVolume, interpolationMode, False, isotropicResampling)
+        self.assertSameGeometry(inProcessVolume, cliVolume)
+        self.assertSimilarVoxels(inProcessVolume, cliVolume, meanTolerance, maxTolerance)
+        # The output is centered in the ROI
+        ijkToRAS = vtk.vtkMatrix4x4()
+        inProcessVolume.GetIJKToRASMatrix(ijkToRAS)
+        dimensions = inProcessVolume.GetImageData().GetDimensions()
+        outputCenter = ijkToRAS.MultiplyPoint([(dimensions[0] - 1) / 2.0, (dimensions[1] - 1) / 2.0, (dimensions[2] - 1) / 2.0, 1.0])[:3]
+        for axis in range(3):
+          self.assertAlmostEqual(outputCenter[axis], center[axis], places=4)
+
+  #------------------------------------------------------------------------------
+  def test_RotatedROI(self):
+    inputVolume = self.createInputVolume()
+
+    # Rotate the ROI around its center
+    ijkToRAS = vtk.vtkMatrix4x4()
+    inputVolume.GetIJKToRASMatrix(ijkToRAS)
+    dimensions = inputVolume.GetImageData().GetDimensions()
+    center = ijkToRAS.MultiplyPoint([(dimensions[0] - 1) / 2.0, (dimensions[1] - 1) / 2.0, (dimensions[2] - 1) / 2.0, 1.0])[:3]
+    roiToWorld = vtk.vtkTransform()
+    roiToWorld.Translate(center)
+    roiToWorld.RotateZ(35)
+    roiToWorld.RotateY(-25)
+    roiToWorld.Translate(-center[0], -center[1], -center[2])
+    roiTransformNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLinearTransformNode")
+    roiTransformNode.SetMatrixTransformToParent(roiToWorld.GetMatrix())
+    roi, center = self.createROI(inputVolume, roiTransformNode)
+
+    inProcessVolume = self.crop(roi, inputVolume, slicer.vtkMRMLCropVolumeParametersNode.InterpolationLinear, True)
+    cliVolume = self.crop(roi, inputVolume, slicer.vtkMRMLCropVolumeParametersNode.InterpolationLinear, False)
+    self.assertSameGeometry(inProcessVolume, cliVolume)
+    self.assertSimilarVoxels(inProcessVolume, cliVolume, 1e-4, 1e-3)
+
+    # Output axes are aligned with the ROI axes
+    outputIJKToRAS = vtk.vtkMatrix4x4()
+    inProcessVolume.GetIJKToRASMatrix(outputIJKToRAS)
+    for column in range(3):
+      axis = [outputIJKToRAS.GetElement(row, column) for row in range(3)]
+      vtk.vtkMath.Normalize(axis)
+      for row in range(3):
+        self.assertAlmostEqual(axis[row], roiToWorld.GetMatrix().GetElement(row, column), places=4)
+
+  #------------------------------------------------------------------------------
+  def test_LabelmapNearestNeighbor(self):
+    k, j, i = numpy.mgrid[0:36, 0:48, 0:40]
+    labels = numpy.zeros((36, 48, 40), numpy.int16)
+    labels[i < 20] = 5
+    labels[j > 24] = 7
+    labels[(k > 10) & (k < 20) & (i > 10) & (i < 30)] = 12
+    ijkToRAS = vtk.vtkMatrix4x4()
+    inputVolume = self.createInputVolume()
+    inputVolume.GetIJKToRASMatrix(ijkToRAS)
+    labelmapVolume = slicer.util.addVolumeFromArray(labels, ijkToRAS, "Labels", "vtkMRMLLabelMapVolumeNode")
+    roi, center = self.createROI(labelmapVolume)
+
+    # Interpolation mode is ignored for labelmaps, labels must not be mixed
+    p = slicer.vtkMRMLCropVolumeParametersNode
+    linearVolume = self.crop(roi, labelmapVolume, p.InterpolationLinear, True)
+    nearestVolume = self.crop(roi, labelmapVolume, p.InterpolationNearestNeighbor, True)
+    linearLabels = slicer.util.arrayFromVolume(linearVolume)
+    self.assertEqual(linearLabels.dtype, numpy.int16)
+    self.assertTrue(numpy.array_equal(linearLabels, slicer.util.arrayFromVolume(nearestVolume)))
+    self.assertTrue(set(numpy.unique(linearLabels)).issubset({0, 5, 7, 12}))
+    self.assertTrue(set(numpy.unique(linearLabels)).issuperset({5, 7, 12}))
+
+    cliVolume = self.crop(roi, labelmapVolume, p.InterpolationNearestNeighbor, False)
+    self.assertSameGeometry(nearestVolume, cliVolume)
+    # Ties at label boundaries may be broken differently
+    mismatchFraction = numpy.count_nonzero(linearLabels != slicer.util.arrayFromVolume(cliVolume)) / float(linearLabels.size)
+    self.assertLess(mismatchFraction, 0.01)
+
+  #------------------------------------------------------------------------------
+  def test_NonLinearTransform(self):
+    inputVolume = self.createInputVolume()
+    roi, center = self.createROI(inputVolume)
+    displacement = [1.5, -2.0, 2.5]
+
+    # Constant displacement field: the same result is expected as with a linear translation
+    bounds = [0.0] * 6
+    inputVolume.GetRASBounds(bounds)
+    displacementField = vtk.vtkImageData()
+    displacementField.SetOrigin(bounds[0] - 20.0, bounds[2] - 20.0, bounds[4] - 20.0)
+    displacementField.SetSpacing(5.0, 5.0, 5.0)
+    displacementField.SetDimensions(
+      int((bounds[1] - bounds[0] + 40.0) / 5.0) + 1,
+      int((bounds[3] - bounds[2] + 40.0) / 5.0) + 1,
+      int((bounds[5] - bounds[4] + 40.0) / 5.0) + 1)
+    displacementField.AllocateScalars(vtk.VTK_DOUBLE, 3)
+    displacementVoxels = numpy_support.vtk_to_numpy(displacementField.GetPointData().GetScalars())
+    displacementVoxels[:] = displacement
+    gridTransform = vtk.vtkGridTransform()
+    gridTransform.SetDisplacementGridData(displacementField)
+    gridTransform.SetInterpolationModeToLinear()
+    gridTransformNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLGridTransformNode")
+    gridTransformNode.SetAndObserveTransformToParent(gridTransform)
+    self.assertFalse(gridTransformNode.IsTransformToWorldLinear())
+
+    p = slicer.vtkMRMLCropVolumeParametersNode
+    inputVolume.SetAndObserveTransformNodeID(gridTransformNode.GetID())
+    nonLinearVolume = self.crop(roi, inputVolume, p.InterpolationLinear, True)
+    cliVolume = self.crop(roi, inputVolume, p.InterpolationLinear, False)
+    self.assertSameGeometry(nonLinearVolume, cliVolume)
+    self.assertSimilarVoxels(nonLinearVolume, cliVolume, 1e-3, 0.01)
+
+    translation = vtk.vtkTransform()
+    translation.Translate(displacement)
+    linearTransformNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLLinearTransformNode")
+    linearTransformNode.SetMatrixTransformToParent(translation.GetMatrix())
+    inputVolume.SetAndObserveTransformNodeID(linearTransformNode.GetID())
+    linearVolume = self.crop(roi, inputVolume, p.InterpolationLinear, True)
+    self.assertSameGeometry(nonLinearVolume, linearVolume)
+    self.assertSimilarVoxels(nonLinearVolume, linearVolume, 1e-4, 1e-3)
+
+    # ROI must not be under a non-linear transform
+    roi.SetAndObserveTransformNodeID(gridTransformNode.GetID())
+    outputVolume = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScalarVolumeNode", "Output")
+    self.assertEqual(self.logic.CropInterpolated(roi, inputVolume, outputVolume, False, 1.0, p.InterpolationLinear, 0.0), -5)
@@ -18,15 +18,20 @@
 #include "vtkMRMLMarkupsFiducialStorageNode.h"
 #include "vtkMRMLMarkupsNode.h"
 
+#include "vtkMRMLMappedFile.h"
 #include "vtkMRMLScene.h"
 #include "vtkSlicerVersionConfigure.h"
 
+#include "vtkByteSwap.h"
 #include "vtkObjectFactory.h"
 #include "vtkStringArray.h"
 #include <vtksys/SystemTools.hxx>
 
 #include "itkNumberToString.h"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <sstream>
 
 // CSV table field indexes
@@ -213,6 +218,61 @@ protected:
   std::vector<std::string> Fields;
 };
 
+//------------------------------------------------------------------------------
+// Binary markups file (.mrkb) layout. All values are little endian.
+//
+//   char[8]   magic ("MRKBIN\0\0")
+//   uint32    version
+//   int32     coordinate system (RAS or LPS)
+//   uint64    number of control points (N)
+//   uint64    string table size in bytes
+//   double    positions[3*N]
+//   double    orientation matrices[9*N]
+//   uint8     flags[N], padded to a multiple of 8 bytes
+//   uint64    string offsets[4*N+1] (ID, label, description, associated node ID of each point)
+//   char      string table
+//
+// Fixed size arrays are aligned to 8 bytes so that they can be accessed directly
+// in a memory-mapped file.
+
+static const char BINARY_MAGIC[8] = { 'M', 'R', 'K', 'B', 'I', 'N', 0, 0 };
+static const vtkTypeUInt32 BINARY_VERSION = 1;
+static const size_t BINARY_HEADER_SIZE = 32;
+static const int BINARY_NUMBER_OF_STRINGS_PER_POINT = 4;
+
+static const vtkTypeUInt8 BINARY_FLAG_VISIBILITY = 0x01;
+static const vtkTypeUInt8 BINARY_FLAG_SELECTED = 0x02;
+static const vtkTypeUInt8 BINARY_FLAG_LOCKED = 0x04;
+static const int BINARY_FLAG_POSITION_STATUS_SHIFT = 3;
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+size_t GetPaddedSize(size_t size)
+{
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+//------------------------------------------------------------------------------
+template<class T> void AppendLE(std::vector<char>& buffer, size_t& offset, T value)
+{
+  vtkByteSwap::SwapLE(&value);
+  memcpy(&buffer[offset], &value, sizeof(T));
+  offset += sizeof(T);
+}
+
+//------------------------------------------------------------------------------
+template<class T> T ReadLE(const char* data)
+{
+  T value;
+  memcpy(&value, data, sizeof(T));
+  vtkByteSwap::SwapLE(&value);
+  return value;
+}
+
+} // end of anonymous namespace
+
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLMarkupsFiducialStorageNode);
 
@@ -275,10 +335,53 @@ bool vtkMRMLMarkupsFiducialStorageNode::SetPointFromString(vtkMRMLMarkupsNode *m
     return false;
     }
 
+  vtkMRMLMarkupsNode::ControlPoint controlPoint;
+  if (!this->GetControlPointFromString(line, &controlPoint))
+    {
+    return false;
+    }
+
+  if (pointIndex >= markupsNode->GetNumberOfControlPoints())
+    {
+    vtkVector3d point(0, 0, 0);
+    markupsNode->AddControlPoint(point);
+    }
+
+  std::string id = controlPoint.ID;
+  if (id.empty())
+    {
+    if (this->GetScene())
+      {
+      id = markupsNode->GenerateUniqueControlPointID();
+      }
+    }
+
+  markupsNode->SetNthControlPointID(pointIndex, id);
+  markupsNode->SetNthControlPointPositionFromArray(pointIndex, controlPoint.Position);
+  markupsNode->SetNthControlPointOrientationMatrix(pointIndex, controlPoint.OrientationMatrix);
+  markupsNode->SetNthControlPointVisibility(pointIndex, controlPoint.Visibility);
+  markupsNode->SetNthControlPointSelected(pointIndex, controlPoint.Selected);
+  markupsNode->SetNthControlPointLocked(pointIndex, controlPoint.Locked);
+  markupsNode->SetNthControlPointLabel(pointIndex, controlPoint.Label);
+  markupsNode->SetNthControlPointDescription(pointIndex, controlPoint.Description);
+  markupsNode->SetNthControlPointAssociatedNodeID(pointIndex, controlPoint.AssociatedNodeID);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString(const char* line, vtkMRMLMarkupsNode::ControlPoint* controlPoint)
+{
+  if (!controlPoint)
+    {
+    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString failed: invalid control point");
+    return false;
+    }
+
   if (this->GetCoordinateSystem() != vtkMRMLStorageNode::CoordinateSystemRAS
     && this->GetCoordinateSystem() != vtkMRMLStorageNode::CoordinateSystemLPS)
     {
-    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::SetMarkupFromString failed: invalid coordinate system");
+    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString failed: invalid coordinate system");
     return false;
     }
 
@@ -302,7 +405,7 @@ bool vtkMRMLMarkupsFiducialStorageNode::SetPointFromString(vtkMRMLMarkupsNode *m
     {
     if (!parser.GetDoubleField(FIELD_XYZ + i, xyz[i]))
       {
-      vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::SetMarkupFromString failed:"
+      vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString failed:"
         << " numeric values expected for xyz, got instead: "<<parser.GetField(FIELD_XYZ + i));
       return false;
       }
@@ -314,7 +417,7 @@ bool vtkMRMLMarkupsFiducialStorageNode::SetPointFromString(vtkMRMLMarkupsNode *m
     {
     if (!parser.GetDoubleField(FIELD_WXYZ + i, wxyz[i], wxyz[i]))
       {
-      vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::SetMarkupFromString failed:"
+      vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString failed:"
         " numeric values expected for wxyz, got instead: " << parser.GetField(FIELD_WXYZ + i));
       return false;
       }
@@ -324,21 +427,21 @@ bool vtkMRMLMarkupsFiducialStorageNode::SetPointFromString(vtkMRMLMarkupsNode *m
   int visibility = 1;
   if (!parser.GetIntField(FIELD_VISIBILITY, visibility, visibility))
     {
-    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::SetMarkupFromString failed:"
+    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString failed:"
       " numeric values expected for visibility field, got instead: " << parser.GetField(FIELD_VISIBILITY));
     return false;
     }
   int selected = 1;
   if (!parser.GetIntField(FIELD_SELECTED, selected, selected))
     {
-    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::SetMarkupFromString failed:"
+    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString failed:"
       " numeric values expected for selected field, got instead: " << parser.GetField(FIELD_SELECTED));
     return false;
     }
   int locked = 0;
   if (!parser.GetIntField(FIELD_LOCKED, locked, locked))
     {
-    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::SetMarkupFromString failed:"
+    vtkGenericWarningMacro("vtkMRMLMarkupsFiducialStorageNode::GetControlPointFromString failed:"
       " numeric values expected for locked field, got instead: " << parser.GetField(FIELD_LOCKED));
     return false;
     }
@@ -350,39 +453,21 @@ bool vtkMRMLMarkupsFiducialStorageNode::SetPointFromString(vtkMRMLMarkupsNode *m
   std::string associatedNodeID;
   parser.GetStringField(FIELD_ASSOCIATED_NODE_ID, associatedNodeID);
 
-  if (pointIndex >= markupsNode->GetNumberOfControlPoints())
-    {
-    vtkVector3d point(0, 0, 0);
-    markupsNode->AddControlPoint(point);
-    }
-
-  if (id.empty())
-    {
-    if (this->GetScene())
-      {
-      id = markupsNode->GenerateUniqueControlPointID();
-      }
-    }
-
-  markupsNode->SetNthControlPointID(pointIndex, id);
-
-  if (this->GetCoordinateSystem() == vtkMRMLStorageNode::CoordinateSystemRAS)
-    {
-    markupsNode->SetNthControlPointPosition(pointIndex, xyz[0], xyz[1], xyz[2]);
-    }
-  else if (this->GetCoordinateSystem() == vtkMRMLStorageNode::CoordinateSystemLPS)
+  controlPoint->ID = id;
+  if (this->GetCoordinateSystem() == vtkMRMLStorageNode::CoordinateSystemLPS)
     {
-    markupsNode->SetNthControlPointPosition(pointIndex, -xyz[0], -xyz[1], xyz[2]);
+    xyz[0] = -xyz[0];
+    xyz[1] = -xyz[1];
     }
-
-  markupsNode->SetNthControlPointOrientation(pointIndex, wxyz[0], wxyz[1], wxyz[2], wxyz[3]);
-
-  markupsNode->SetNthControlPointVisibility(pointIndex, visibility);
-  markupsNode->SetNthControlPointSelected(pointIndex, selected);
-  markupsNode->SetNthControlPointLocked(pointIndex, locked);
-  markupsNode->SetNthControlPointLabel(pointIndex, label);
-  markupsNode->SetNthControlPointDescription(pointIndex, description);
-  markupsNode->SetNthControlPointAssociatedNodeID(pointIndex, associatedNodeID);
+  std::copy_n(xyz, 3, controlPoint->Position);
+  controlPoint->PositionStatus = vtkMRMLMarkupsNode::PositionDefined;
+  vtkMRMLMarkupsNode::ConvertOrientationWXYZToMatrix(wxyz, controlPoint->OrientationMatrix);
+  controlPoint->Visibility = (visibility != 0);
+  controlPoint->Selected = (selected != 0);
+  controlPoint->Locked = (locked != 0);
+  controlPoint->Label = label;
+  controlPoint->Description = description;
+  controlPoint->AssociatedNodeID = associatedNodeID;
 
   return true;
 }
@@ -473,9 +558,14 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   MRMLNodeModifyBlocker blocker(markupsNode);
 
+  std::string ext = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fullName);
+  if (ext.compare(".mrkb") == 0)
+    {
+    return this->ReadBinaryDataInternal(markupsNode, fullName);
+    }
+
   // check if it's an annotation csv file
   bool parseAsAnnotationFiducial = false;
-  std::string ext = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fullName);
   if (ext.compare(".acsv") == 0)
     {
     parseAsAnnotationFiducial = true;
@@ -498,6 +588,8 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
     // save the valid lines in a vector, parse them once know the max id
     std::vector<std::string>lines;
+    // control points read from versioned files, added to the markups node in one step
+    vtkMRMLMarkupsNode::ControlPointsListType controlPoints;
     int thisMarkupNumber = 0;
 
     // check for the version
@@ -640,7 +732,16 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
           else
             {
             vtkDebugMacro("\n\n\n\nVersion = " << version << ", got a line: \n\"" << line << "\"");
-            this->SetPointFromString(markupsNode, markupsNode->GetNumberOfControlPoints(), line);
+            // Collect control points and add them to the markups node at once
+            vtkMRMLMarkupsNode::ControlPoint* controlPoint = new vtkMRMLMarkupsNode::ControlPoint;
+            if (this->GetControlPointFromString(line, controlPoint))
+              {
+              controlPoints.push_back(controlPoint);
+              }
+            else
+              {
+              delete controlPoint;
+              }
 
             thisMarkupNumber++;
             } // point line
@@ -648,6 +749,19 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
         }
       }
     fstr.close();
+
+    if (!controlPoints.empty())
+      {
+      // Labels are read from file as is (empty labels are not replaced by generated ones)
+      if (markupsNode->AddControlPoints(controlPoints, false) < 0)
+        {
+        for (vtkMRMLMarkupsNode::ControlPointsListType::iterator controlPointIt = controlPoints.begin();
+          controlPointIt != controlPoints.end(); ++controlPointIt)
+          {
+          delete *controlPointIt;
+          }
+        }
+      }
     }
   else
     {
@@ -682,6 +796,12 @@ int vtkMRMLMarkupsFiducialStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     return 0;
     }
 
+  std::string ext = vtkMRMLStorageNode::GetLowercaseExtensionFromFileName(fullName);
+  if (ext.compare(".mrkb") == 0)
+    {
+    return this->WriteBinaryDataInternal(markupsNode, fullName);
+    }
+
   // open the file for writing
   fstream of;
 
@@ -728,10 +848,241 @@ void vtkMRMLMarkupsFiducialStorageNode::InitializeSupportedReadFileTypes()
 {
   this->SupportedReadFileTypes->InsertNextValue("Markups Fiducial CSV (.fcsv)");
   this->SupportedReadFileTypes->InsertNextValue("Annotation Fiducial CSV (.acsv)");
+  this->SupportedReadFileTypes->InsertNextValue("Markups Binary (.mrkb)");
 }
 
 //----------------------------------------------------------------------------
 void vtkMRMLMarkupsFiducialStorageNode::InitializeSupportedWriteFileTypes()
 {
   this->SupportedWriteFileTypes->InsertNextValue("Markups Fiducial CSV (.fcsv)");
+  this->SupportedWriteFileTypes->InsertNextValue("Markups Binary (.mrkb)");
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsFiducialStorageNode::ReadBinaryDataInternal(vtkMRMLMarkupsNode* markupsNode, const std::string& fullName)
+{
+  vtkMRMLMappedFile fileView;
+  if (!fileView.Open(fullName))
+    {
+    vtkErrorMacro("ReadBinaryDataInternal: failed to open markups file " << fullName);
+    return 0;
+    }
+  const char* data = fileView.GetData();
+  size_t dataSize = fileView.GetSize();
+
+  if (dataSize < BINARY_HEADER_SIZE || memcmp(data, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+    {
+    vtkErrorMacro("ReadBinaryDataInternal: " << fullName << " is not a binary markups file");
+    return 0;
+    }
+  vtkTypeUInt32 version = ReadLE<vtkTypeUInt32>(data + 8);
+  if (version > BINARY_VERSION)
+    {
+    vtkErrorMacro("ReadBinaryDataInternal: unsupported binary markups file version " << version);
+    return 0;
+    }
+  int coordinateSystem = static_cast<int>(ReadLE<vtkTypeInt32>(data + 12));
+  if (coordinateSystem != vtkMRMLStorageNode::CoordinateSystemRAS
+    && coordinateSystem != vtkMRMLStorageNode::CoordinateSystemLPS)
+    {
+    vtkErrorMacro("ReadBinaryDataInternal: invalid coordinate system " << coordinateSystem);
+    return 0;
+    }
+  vtkTypeUInt64 numberOfControlPoints = ReadLE<vtkTypeUInt64>(data + 16);
+  vtkTypeUInt64 stringTableSize = ReadLE<vtkTypeUInt64>(data + 24);
+
+  size_t n = static_cast<size_t>(numberOfControlPoints);
+  size_t positionsOffset = BINARY_HEADER_SIZE;
+  size_t orientationsOffset = positionsOffset + 3 * n * sizeof(double);
+  size_t flagsOffset = orientationsOffset + 9 * n * sizeof(double);
+  size_t stringOffsetsOffset = flagsOffset + GetPaddedSize(n);
+  size_t stringTableOffset = stringOffsetsOffset + (BINARY_NUMBER_OF_STRINGS_PER_POINT * n + 1) * sizeof(vtkTypeUInt64);
+  if (numberOfControlPoints > dataSize || stringTableOffset > dataSize
+    || stringTableSize > dataSize - stringTableOffset)
+    {
+    vtkErrorMacro("ReadBinaryDataInternal: binary markups file " << fullName << " is truncated");
+    return 0;
+    }
+  this->SetCoordinateSystem(coordinateSystem);
+
+  if (markupsNode->GetNumberOfControlPoints() > 0)
+    {
+    markupsNode->RemoveAllControlPoints();
+    }
+  if (n == 0)
+    {
+    return 1;
+    }
+
+  const char* positions = data + positionsOffset;
+  const char* orientations = data + orientationsOffset;
+  const vtkTypeUInt8* flags = reinterpret_cast<const vtkTypeUInt8*>(data + flagsOffset);
+  const char* stringOffsets = data + stringOffsetsOffset;
+  const char* stringTable = data + stringTableOffset;
+
+  vtkMRMLMarkupsNode::ControlPointsListType controlPoints;
+  controlPoints.reserve(n);
+  bool valid = true;
+  for (size_t pointIndex = 0; pointIndex < n && valid; pointIndex++)
+    {
+    vtkMRMLMarkupsNode::ControlPoint* controlPoint = new vtkMRMLMarkupsNode::ControlPoint;
+    controlPoints.push_back(controlPoint);
+
+    memcpy(controlPoint->Position, positions + 3 * pointIndex * sizeof(double), 3 * sizeof(double));
+    vtkByteSwap::SwapLERange(controlPoint->Position, 3);
+    if (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS)
+      {
+      controlPoint->Position[0] = -controlPoint->Position[0];
+      controlPoint->Position[1] = -controlPoint->Position[1];
+      }
+    memcpy(controlPoint->OrientationMatrix, orientations + 9 * pointIndex * sizeof(double), 9 * sizeof(double));
+    vtkByteSwap::SwapLERange(controlPoint->OrientationMatrix, 9);
+
+    vtkTypeUInt8 pointFlags = flags[pointIndex];
+    controlPoint->Visibility = (pointFlags & BINARY_FLAG_VISIBILITY) != 0;
+    controlPoint->Selected = (pointFlags & BINARY_FLAG_SELECTED) != 0;
+    controlPoint->Locked = (pointFlags & BINARY_FLAG_LOCKED) != 0;
+    controlPoint->PositionStatus = (pointFlags >> BINARY_FLAG_POSITION_STATUS_SHIFT) & 0x03;
+
+    std::string* strings[BINARY_NUMBER_OF_STRINGS_PER_POINT] =
+      { &controlPoint->ID, &controlPoint->Label, &controlPoint->Description, &controlPoint->AssociatedNodeID };
+    for (int stringIndex = 0; stringIndex < BINARY_NUMBER_OF_STRINGS_PER_POINT; stringIndex++)
+      {
+      size_t offsetIndex = BINARY_NUMBER_OF_STRINGS_PER_POINT * pointIndex + stringIndex;
+      vtkTypeUInt64 stringStart = ReadLE<vtkTypeUInt64>(stringOffsets + offsetIndex * sizeof(vtkTypeUInt64));
+      vtkTypeUInt64 stringEnd = ReadLE<vtkTypeUInt64>(stringOffsets + (offsetIndex + 1) * sizeof(vtkTypeUInt64));
+      if (stringStart > stringEnd || stringEnd > stringTableSize)
+        {
+        vtkErrorMacro("ReadBinaryDataInternal: invalid string table in binary markups file " << fullName);
+        valid = false;
+        break;
+        }
+      strings[stringIndex]->assign(stringTable + stringStart, static_cast<size_t>(stringEnd - stringStart));
+      }
+    }
+
+  if (!valid || markupsNode->AddControlPoints(controlPoints, false) < 0)
+    {
+    for (vtkMRMLMarkupsNode::ControlPointsListType::iterator controlPointIt = controlPoints.begin();
+      controlPointIt != controlPoints.end(); ++controlPointIt)
+      {
+      delete *controlPointIt;
+      }
+    return 0;
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsFiducialStorageNode::WriteBinaryDataInternal(vtkMRMLMarkupsNode* markupsNode, const std::string& fullName)
+{
+  int coordinateSystem = this->GetCoordinateSystem();
+  if (coordinateSystem != vtkMRMLStorageNode::CoordinateSystemRAS
+    && coordinateSystem != vtkMRMLStorageNode::CoordinateSystemLPS)
+    {
+    vtkErrorMacro("WriteBinaryDataInternal: invalid coordinate system index " << coordinateSystem);
+    return 0;
+    }
+
+  vtkMRMLMarkupsNode::ControlPointsListType* controlPoints = markupsNode->GetControlPoints();
+  size_t n = controlPoints->size();
+
+  // Compute string table size first so that the whole file can be assembled in one buffer
+  vtkTypeUInt64 stringTableSize = 0;
+  for (vtkMRMLMarkupsNode::ControlPointsListType::iterator controlPointIt = controlPoints->begin();
+    controlPointIt != controlPoints->end(); ++controlPointIt)
+    {
+    vtkMRMLMarkupsNode::ControlPoint* controlPoint = *controlPointIt;
+    stringTableSize += controlPoint->ID.size() + controlPoint->Label.size()
+      + controlPoint->Description.size() + controlPoint->AssociatedNodeID.size();
+    }
+
+  size_t flagsOffset = BINARY_HEADER_SIZE + 12 * n * sizeof(double);
+  size_t stringOffsetsOffset = flagsOffset + GetPaddedSize(n);
+  size_t stringTableOffset = stringOffsetsOffset + (BINARY_NUMBER_OF_STRINGS_PER_POINT * n + 1) * sizeof(vtkTypeUInt64);
+  std::vector<char> buffer(stringTableOffset + static_cast<size_t>(stringTableSize), 0);
+
+  size_t offset = 0;
+  memcpy(&buffer[offset], BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  offset += sizeof(BINARY_MAGIC);
+  AppendLE<vtkTypeUInt32>(buffer, offset, BINARY_VERSION);
+  AppendLE<vtkTypeInt32>(buffer, offset, static_cast<vtkTypeInt32>(coordinateSystem));
+  AppendLE<vtkTypeUInt64>(buffer, offset, static_cast<vtkTypeUInt64>(n));
+  AppendLE<vtkTypeUInt64>(buffer, offset, stringTableSize);
+
+  // positions
+  for (vtkMRMLMarkupsNode::ControlPointsListType::iterator controlPointIt = controlPoints->begin();
+    controlPointIt != controlPoints->end(); ++controlPointIt)
+    {
+    double* position = (*controlPointIt)->Position;
+    double sign = (coordinateSystem == vtkMRMLStorageNode::CoordinateSystemLPS ? -1.0 : 1.0);
+    AppendLE<double>(buffer, offset, sign * position[0]);
+    AppendLE<double>(buffer, offset, sign * position[1]);
+    AppendLE<double>(buffer, offset, position[2]);
+    }
+  // orientations
+  for (vtkMRMLMarkupsNode::ControlPointsListType::iterator controlPointIt = controlPoints->begin();
+    controlPointIt != controlPoints->end(); ++controlPointIt)
+    {
+    for (int i = 0; i < 9; i++)
+      {
+      AppendLE<double>(buffer, offset, (*controlPointIt)->OrientationMatrix[i]);
+      }
+    }
+  // flags
+  for (vtkMRMLMarkupsNode::ControlPointsListType::iterator controlPointIt = controlPoints->begin();
+    controlPointIt != controlPoints->end(); ++controlPointIt)
+    {
+    vtkMRMLMarkupsNode::ControlPoint* controlPoint = *controlPointIt;
+    vtkTypeUInt8 pointFlags = static_cast<vtkTypeUInt8>((controlPoint->PositionStatus & 0x03) << BINARY_FLAG_POSITION_STATUS_SHIFT);
+    if (controlPoint->Visibility)
+      {
+      pointFlags |= BINARY_FLAG_VISIBILITY;
+      }
+    if (controlPoint->Selected)
+      {
+      pointFlags |= BINARY_FLAG_SELECTED;
+      }
+    if (controlPoint->Locked)
+      {
+      pointFlags |= BINARY_FLAG_LOCKED;
+      }
+    buffer[offset++] = static_cast<char>(pointFlags);
+    }
+  // string offsets and string table
+  offset = stringOffsetsOffset;
+  size_t stringOffset = stringTableOffset;
+  for (vtkMRMLMarkupsNode::ControlPointsListType::iterator controlPointIt = controlPoints->begin();
+    controlPointIt != controlPoints->end(); ++controlPointIt)
+    {
+    vtkMRMLMarkupsNode::ControlPoint* controlPoint = *controlPointIt;
+    const std::string* strings[BINARY_NUMBER_OF_STRINGS_PER_POINT] =
+      { &controlPoint->ID, &controlPoint->Label, &controlPoint->Description, &controlPoint->AssociatedNodeID };
+    for (int stringIndex = 0; stringIndex < BINARY_NUMBER_OF_STRINGS_PER_POINT; stringIndex++)
+      {
+      AppendLE<vtkTypeUInt64>(buffer, offset, static_cast<vtkTypeUInt64>(stringOffset - stringTableOffset));
+      if (!strings[stringIndex]->empty())
+        {
+        memcpy(&buffer[stringOffset], strings[stringIndex]->data(), strings[stringIndex]->size());
+        stringOffset += strings[stringIndex]->size();
+        }
+      }
+    }
+  AppendLE<vtkTypeUInt64>(buffer, offset, static_cast<vtkTypeUInt64>(stringOffset - stringTableOffset));
+
+  // Write the file in one sequential write
+  std::ofstream of(fullName.c_str(), std::ios::out | std::ios::binary);
+  if (!of.is_open())
+    {
+    vtkErrorMacro("WriteBinaryDataInternal: unable to open file " << fullName << " for writing");
+    return 0;
+    }
+  of.write(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+  of.close();
+  if (of.fail())
+    {
+    vtkErrorMacro("WriteBinaryDataInternal: failed to write file " << fullName);
+    return 0;
+    }
+  return 1;
 }
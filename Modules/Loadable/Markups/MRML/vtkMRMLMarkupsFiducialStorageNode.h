@@ -21,16 +21,18 @@
 ///
 /// vtkMRMLMarkupsFiducialStorageNode nodes describe the markups storage
 /// node that allows to read/write fiducial point data from/to file.
+/// Control points are stored in a CSV text file (.fcsv) or, for large point
+/// sets, in a binary file (.mrkb) that stores positions, orientations, and flags
+/// as typed arrays.
 
 #ifndef __vtkMRMLMarkupsFiducialStorageNode_h
 #define __vtkMRMLMarkupsFiducialStorageNode_h
 
 // Markups includes
 #include "vtkSlicerMarkupsModuleMRMLExport.h"
+#include "vtkMRMLMarkupsNode.h"
 #include "vtkMRMLMarkupsStorageNode.h"
 
-class vtkMRMLMarkupsNode;
-
 /// \ingroup Slicer_QtModules_Markups
 class VTK_SLICER_MARKUPS_MODULE_MRML_EXPORT vtkMRMLMarkupsFiducialStorageNode : public vtkMRMLMarkupsStorageNode
 {
@@ -91,6 +93,19 @@ protected:
   /// necessary, same with the description
   int WriteDataInternal(vtkMRMLNode *refNode) override;
 
+  /// Read control points from a binary markups file (.mrkb).
+  /// Fixed-size fields are stored as typed arrays and labels/descriptions in a
+  /// string table, so the file can be memory-mapped and parsed without string conversion.
+  int ReadBinaryDataInternal(vtkMRMLMarkupsNode* markupsNode, const std::string& fullName);
+
+  /// Write control points to a binary markups file (.mrkb) in a single sequential write.
+  int WriteBinaryDataInternal(vtkMRMLMarkupsNode* markupsNode, const std::string& fullName);
+
+  /// Parse a control point line of a versioned fcsv file into controlPoint.
+  /// Position is converted to RAS coordinate system.
+  /// Returns false if the line could not be parsed.
+  bool GetControlPointFromString(const char* line, vtkMRMLMarkupsNode::ControlPoint* controlPoint);
+
   std::string FieldDelimiterCharacters;
 };
 
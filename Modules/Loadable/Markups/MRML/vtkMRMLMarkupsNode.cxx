@@ -43,6 +43,7 @@
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
 #include <vtkStringArray.h>
+#include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkTrivialProducer.h>
 
@@ -499,6 +500,87 @@ int vtkMRMLMarkupsNode::AddControlPoint(ControlPoint *controlPoint)
   return controlPointIndex;
 }
 
+//-----------------------------------------------------------
+int vtkMRMLMarkupsNode::AddControlPoints(const ControlPointsListType& controlPoints, bool generateMissingLabels /*=true*/)
+{
+  if (controlPoints.empty())
+    {
+    return -1;
+    }
+  int numberOfNewControlPoints = static_cast<int>(controlPoints.size());
+  if (this->MaximumNumberOfControlPoints != 0 &&
+      this->GetNumberOfControlPoints() + numberOfNewControlPoints > this->MaximumNumberOfControlPoints)
+    {
+    vtkErrorMacro("AddControlPoints: number of points major than maximum number of control points allowed.");
+    return -1;
+    }
+
+  int firstControlPointIndex = this->GetNumberOfControlPoints();
+  bool positionDefinedAdded = false;
+  this->ControlPoints.reserve(this->ControlPoints.size() + controlPoints.size());
+  for (ControlPointsListType::const_iterator controlPointIt = controlPoints.begin();
+    controlPointIt != controlPoints.end(); ++controlPointIt)
+    {
+    ControlPoint* controlPoint = *controlPointIt;
+    if (!controlPoint)
+      {
+      continue;
+      }
+    if (controlPoint->ID.empty())
+      {
+      controlPoint->ID = this->GenerateUniqueControlPointID();
+      }
+    if (generateMissingLabels && controlPoint->Label.empty())
+      {
+      controlPoint->Label = this->GenerateControlPointLabel(this->LastUsedControlPointNumber);
+      }
+    if (controlPoint->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
+      {
+      positionDefinedAdded = true;
+      }
+    this->ControlPoints.push_back(controlPoint);
+    }
+
+  this->UpdateCurvePolyFromControlPoints();
+  this->InvokeControlPointsReplacedEvents(true, false, positionDefinedAdded, false);
+  return firstControlPointIndex;
+}
+
+//-----------------------------------------------------------
+int vtkMRMLMarkupsNode::AddControlPointsWorld(vtkPoints* pointsWorld, std::string label /*=std::string()*/)
+{
+  if (!pointsWorld || pointsWorld->GetNumberOfPoints() == 0)
+    {
+    return -1;
+    }
+  vtkNew<vtkPoints> pointsLocal;
+  this->TransformPointsFromWorld(pointsWorld, pointsLocal);
+
+  ControlPointsListType controlPoints;
+  vtkIdType numberOfPoints = pointsLocal->GetNumberOfPoints();
+  controlPoints.reserve(numberOfPoints);
+  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    ControlPoint* controlPoint = new ControlPoint;
+    controlPoint->Label = label;
+    pointsLocal->GetPoint(pointIndex, controlPoint->Position);
+    controlPoint->PositionStatus = PositionDefined;
+    controlPoints.push_back(controlPoint);
+    }
+
+  int firstControlPointIndex = this->AddControlPoints(controlPoints);
+  if (firstControlPointIndex < 0)
+    {
+    // ownership was not transferred
+    for (ControlPointsListType::iterator controlPointIt = controlPoints.begin();
+      controlPointIt != controlPoints.end(); ++controlPointIt)
+      {
+      delete *controlPointIt;
+      }
+    }
+  return firstControlPointIndex;
+}
+
 //-----------------------------------------------------------
 int vtkMRMLMarkupsNode::AddNControlPoints(int n, std::string label /*=std::string()*/, vtkVector3d* point /*=nullptr*/)
 {
@@ -642,6 +724,42 @@ void vtkMRMLMarkupsNode::RemoveNthControlPoint(int pointIndex)
   this->UpdateMeasurements();
 }
 
+//-----------------------------------------------------------
+void vtkMRMLMarkupsNode::RemoveControlPoints(int startIndex, int numberOfControlPoints)
+{
+  if (numberOfControlPoints <= 0)
+    {
+    return;
+    }
+  if (startIndex < 0 || startIndex + numberOfControlPoints > this->GetNumberOfControlPoints())
+    {
+    vtkErrorMacro("RemoveControlPoints failed: control point range " << startIndex << " - "
+      << startIndex + numberOfControlPoints - 1 << " is out of bounds");
+    return;
+    }
+  if (startIndex == 0 && numberOfControlPoints == this->GetNumberOfControlPoints())
+    {
+    this->RemoveAllControlPoints();
+    return;
+    }
+
+  bool positionDefinedRemoved = false;
+  ControlPointsListType::iterator firstIt = this->ControlPoints.begin() + startIndex;
+  ControlPointsListType::iterator lastIt = firstIt + numberOfControlPoints;
+  for (ControlPointsListType::iterator controlPointIt = firstIt; controlPointIt != lastIt; ++controlPointIt)
+    {
+    if ((*controlPointIt)->PositionStatus == vtkMRMLMarkupsNode::PositionDefined)
+      {
+      positionDefinedRemoved = true;
+      }
+    delete *controlPointIt;
+    }
+  this->ControlPoints.erase(firstIt, lastIt);
+
+  this->UpdateCurvePolyFromControlPoints();
+  this->InvokeControlPointsReplacedEvents(false, true, false, positionDefinedRemoved);
+}
+
 //-----------------------------------------------------------
 bool vtkMRMLMarkupsNode::InsertControlPoint(ControlPoint *controlPoint, int targetIndex)
 {
@@ -1787,28 +1905,131 @@ void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
     return;
     }
   int wasModified = this->StartModify();
-  vtkIdType numberOfPoints = points->GetNumberOfPoints();
-  for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+
+  vtkNew<vtkPoints> pointsLocal;
+  this->TransformPointsFromWorld(points, pointsLocal);
+  int numberOfPoints = static_cast<int>(pointsLocal->GetNumberOfPoints());
+  if (this->MaximumNumberOfControlPoints != 0 && numberOfPoints > this->MaximumNumberOfControlPoints)
     {
-    double* posWorld = points->GetPoint(pointIndex);
-    if (pointIndex < this->GetNumberOfControlPoints())
+    vtkErrorMacro("SetControlPointPositionsWorld: number of points " << numberOfPoints <<
+      " major than maximum number of control points allowed : " << this->MaximumNumberOfControlPoints);
+    numberOfPoints = this->MaximumNumberOfControlPoints;
+    }
+  int numberOfExistingControlPoints = this->GetNumberOfControlPoints();
+
+  bool positionDefinedAdded = false;
+  bool positionDefinedRemoved = false;
+
+  // Update existing control points
+  int numberOfUpdatedControlPoints = std::min(numberOfPoints, numberOfExistingControlPoints);
+  for (int pointIndex = 0; pointIndex < numberOfUpdatedControlPoints; pointIndex++)
+    {
+    ControlPoint* controlPoint = this->ControlPoints[pointIndex];
+    pointsLocal->GetPoint(pointIndex, controlPoint->Position);
+    if (controlPoint->PositionStatus != PositionDefined)
       {
-      // point already exists, just update it
-      this->SetNthControlPointPositionWorldFromArray(pointIndex, posWorld);
+      controlPoint->PositionStatus = PositionDefined;
+      positionDefinedAdded = true;
       }
-    else
+    }
+
+  // Remove extra control points
+  for (int pointIndex = numberOfPoints; pointIndex < numberOfExistingControlPoints; pointIndex++)
+    {
+    if (this->ControlPoints[pointIndex]->PositionStatus == PositionDefined)
       {
-      // need to add a new point
-      vtkMRMLMarkupsNode::AddControlPointWorld(vtkVector3d(posWorld));
+      positionDefinedRemoved = true;
       }
+    delete this->ControlPoints[pointIndex];
     }
-  while (this->GetNumberOfControlPoints() > numberOfPoints)
+  if (numberOfExistingControlPoints > numberOfPoints)
+    {
+    this->ControlPoints.resize(numberOfPoints);
+    }
+
+  // Add new control points
+  if (numberOfPoints > numberOfExistingControlPoints)
     {
-    this->RemoveNthControlPoint(this->GetNumberOfControlPoints() - 1);
+    this->ControlPoints.reserve(numberOfPoints);
+    for (int pointIndex = numberOfExistingControlPoints; pointIndex < numberOfPoints; pointIndex++)
+      {
+      ControlPoint* controlPoint = new ControlPoint;
+      pointsLocal->GetPoint(pointIndex, controlPoint->Position);
+      controlPoint->PositionStatus = PositionDefined;
+      controlPoint->ID = this->GenerateUniqueControlPointID();
+      controlPoint->Label = this->GenerateControlPointLabel(this->LastUsedControlPointNumber);
+      this->ControlPoints.push_back(controlPoint);
+      }
+    positionDefinedAdded = true;
     }
+
+  this->UpdateCurvePolyFromControlPoints();
+  this->InvokeControlPointsReplacedEvents(numberOfPoints > numberOfExistingControlPoints,
+    numberOfPoints < numberOfExistingControlPoints, positionDefinedAdded, positionDefinedRemoved);
+
   this->EndModify(wasModified);
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::TransformPointsFromWorld(vtkPoints* pointsWorld, vtkPoints* pointsLocal)
+{
+  if (!pointsWorld || !pointsLocal)
+    {
+    return;
+    }
+  pointsLocal->SetDataTypeToDouble();
+  pointsLocal->Reset();
+  vtkMRMLTransformNode* transformNode = this->GetParentTransformNode();
+  if (!transformNode)
+    {
+    // not transformed
+    pointsLocal->GetData()->DeepCopy(pointsWorld->GetData());
+    pointsLocal->Modified();
+    return;
+    }
+  if (transformNode->IsTransformToWorldLinear())
+    {
+    // Linear transforms process the whole point array in one pass
+    vtkNew<vtkMatrix4x4> matrixFromWorld;
+    transformNode->GetMatrixTransformFromWorld(matrixFromWorld);
+    vtkNew<vtkTransform> transformFromWorld;
+    transformFromWorld->SetMatrix(matrixFromWorld);
+    transformFromWorld->TransformPoints(pointsWorld, pointsLocal);
+    }
+  else
+    {
+    vtkNew<vtkGeneralTransform> transformFromWorld;
+    transformNode->GetTransformFromWorld(transformFromWorld);
+    transformFromWorld->TransformPoints(pointsWorld, pointsLocal);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::InvokeControlPointsReplacedEvents(bool pointsAdded, bool pointsRemoved,
+  bool positionDefinedAdded, bool positionDefinedRemoved)
+{
+  // nullptr call data indicates that more than one control point has changed
+  if (pointsAdded)
+    {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointAddedEvent);
+    }
+  if (pointsRemoved)
+    {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointRemovedEvent);
+    }
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent);
+  if (positionDefinedAdded)
+    {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionDefinedEvent);
+    }
+  if (positionDefinedRemoved)
+    {
+    this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointPositionUndefinedEvent);
+    }
+  this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointsReplacedEvent);
+  this->UpdateMeasurements();
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
 {
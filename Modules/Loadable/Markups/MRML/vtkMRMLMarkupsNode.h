@@ -189,6 +189,9 @@ public:
   /// - PointStartInteractionEvent when starting interacting with a control point.
   /// - PointEndInteractionEvent when an interaction eith a control point process finishes.
   /// - CenterPointModifiedEvent when position of the centerpoint is changed (displayed for example for closed curves)
+  /// - PointsReplacedEvent: control points were added, removed, or modified in bulk (by SetControlPointPositionsWorld,
+  ///   AddControlPoints, AddControlPointsWorld, or RemoveControlPoints). Invoked once per bulk operation, after
+  ///   PointAddedEvent/PointRemovedEvent/PointModifiedEvent are invoked with nullptr call data.
   ///
   /// Event data for Point* events: Event callData is control point index address (int*). If the pointer is nullptr
   /// then one or more points are added/removed/modified.
@@ -207,6 +210,7 @@ public:
     PointStartInteractionEvent,
     PointEndInteractionEvent,
     CenterPointModifiedEvent,
+    PointsReplacedEvent,
   };
 
   /// Placement status of a control point.
@@ -274,6 +278,18 @@ public:
   /// of new controlPoint, -1 on failure.
   /// Markups node takes over ownership of the pointer (markups node will delete it).
   int AddControlPoint(ControlPoint *controlPoint);
+  /// Add a list of control points to the end of the list.
+  /// Unlike calling AddControlPoint for each point, storage is allocated once
+  /// and events are only invoked once for the whole list.
+  /// IDs are generated for control points that do not have one. Labels are generated
+  /// for control points with empty label if generateMissingLabels is true.
+  /// Markups node takes over ownership of the pointers if the operation is successful.
+  /// Return index of the first added control point, -1 on failure.
+  int AddControlPoints(const ControlPointsListType& controlPoints, bool generateMissingLabels = true);
+  /// Add a new control point for each point in pointsWorld (defined in the world coordinate system).
+  /// World to local transform is computed once and applied to all the points at once.
+  /// Return index of the first added control point, -1 on failure.
+  int AddControlPointsWorld(vtkPoints* pointsWorld, std::string label = std::string());
 
   /// Get the position of the Nth control point
   /// returning it as a vtkVector3d, return (0,0,0) if not found
@@ -302,6 +318,10 @@ public:
   /// Remove Nth Control Point
   void RemoveNthControlPoint(int pointIndex);
 
+  /// Remove numberOfControlPoints control points starting at startIndex.
+  /// Events are only invoked once for the whole range.
+  void RemoveControlPoints(int startIndex, int numberOfControlPoints);
+
   /// \deprecated Use RemoveNthControlPoint instead.
   void RemoveMarkup(int pointIndex) { this->RemoveNthControlPoint(pointIndex); };
 
@@ -556,6 +576,8 @@ public:
   /// New control points are added if needed.
   /// Existing control points are updated with the new positions.
   /// Any extra existing control points are removed.
+  /// Points are transformed to the local coordinate system at once and
+  /// only a single set of events is invoked (see PointsReplacedEvent).
   void SetControlPointPositionsWorld(vtkPoints* points);
 
   /// Get a copy of all control point positions in world coordinate system
@@ -598,6 +620,14 @@ protected:
 
   virtual void UpdateCurvePolyFromControlPoints();
 
+  /// Transform all points from world coordinate system to local coordinate system
+  /// using a single transform computation.
+  void TransformPointsFromWorld(vtkPoints* pointsWorld, vtkPoints* pointsLocal);
+
+  /// Invoke the events that notify observers about a bulk change of control points.
+  void InvokeControlPointsReplacedEvents(bool pointsAdded, bool pointsRemoved,
+    bool positionDefinedAdded, bool positionDefinedRemoved);
+
   void OnTransformNodeReferenceChanged(vtkMRMLTransformNode* transformNode) override;
 
   virtual void UpdateMeasurements();
@@ -210,5 +210,48 @@ int vtkMRMLMarkupsFiducialStorageNodeTest1(int argc, char * argv[] )
   numQuotes = std::count(descWithQuotes.begin(), descWithQuotes.end(), '"');
   CHECK_INT(numQuotes, 2);
 
+  //
+  // test binary format
+  //
+  std::string binaryFileName = fileName + ".mrkb";
+  node1->UseLPSOn();
+  node1->SetFileName(binaryFileName.c_str());
+  std::cout << "Writing binary file " << node1->GetFileName() << std::endl;
+  retval = node1->WriteData(markupsNode.GetPointer());
+  CHECK_BOOL(retval, true);
+
+  vtkNew<vtkMRMLMarkupsFiducialStorageNode> snode3;
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode3;
+  scene2->AddNode(snode3.GetPointer());
+  scene2->AddNode(markupsNode3.GetPointer());
+  markupsNode3->SetAndObserveStorageNodeID(snode3->GetID());
+  snode3->SetFileName(binaryFileName.c_str());
+  snode3->UseRASOn();
+  retval = snode3->ReadData(markupsNode3.GetPointer());
+  CHECK_BOOL(retval, true);
+  CHECK_BOOL(snode3->GetUseLPS(), true);
+
+  CHECK_INT(markupsNode3->GetNumberOfControlPoints(), markupsNode->GetNumberOfControlPoints());
+  index = 0;
+  markupsNode3->GetNthControlPointPosition(index, outputPoint);
+  CHECK_DOUBLE_TOLERANCE(outputPoint[0], inputPoint[0], 1e-9);
+  CHECK_DOUBLE_TOLERANCE(outputPoint[1], inputPoint[1], 1e-9);
+  CHECK_DOUBLE_TOLERANCE(outputPoint[2], inputPoint[2], 1e-9);
+  markupsNode3->GetNthControlPointOrientation(index, newOrientation);
+  for (int r = 0; r < 4; r++)
+    {
+    CHECK_DOUBLE_TOLERANCE(newOrientation[r], orientation[r], 1e-3);
+    }
+  CHECK_STD_STRING(markupsNode3->GetNthControlPointID(index), markupsNode->GetNthControlPointID(index));
+  CHECK_STD_STRING(markupsNode3->GetNthControlPointAssociatedNodeID(index), associatedNodeID);
+  CHECK_BOOL(markupsNode3->GetNthControlPointSelected(index), false);
+  CHECK_BOOL(markupsNode3->GetNthControlPointVisibility(index), false);
+  CHECK_BOOL(markupsNode3->GetNthControlPointLocked(index), true);
+  CHECK_STD_STRING(markupsNode3->GetNthControlPointLabel(index), label);
+  CHECK_STD_STRING(markupsNode3->GetNthControlPointDescription(index), desc);
+  CHECK_STD_STRING(markupsNode3->GetNthControlPointLabel(2), "");
+  CHECK_STD_STRING(markupsNode3->GetNthControlPointLabel(commaIndex), markupsNode->GetNthControlPointLabel(commaIndex));
+  CHECK_STD_STRING(markupsNode3->GetNthControlPointDescription(quotesIndex), markupsNode->GetNthControlPointDescription(quotesIndex));
+
   return EXIT_SUCCESS;
 }
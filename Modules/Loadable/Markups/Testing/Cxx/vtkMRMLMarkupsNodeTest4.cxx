@@ -0,0 +1,131 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLLinearTransformNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTestingOutputWindow.h>
+
+// STL includes
+#include <map>
+
+// Test bulk control point operations
+
+namespace
+{
+std::map<unsigned long, int> EventCounts;
+
+void CountEvents(vtkObject* vtkNotUsed(caller), unsigned long eid, void* vtkNotUsed(clientData), void* vtkNotUsed(callData))
+{
+  EventCounts[eid]++;
+}
+}
+
+int vtkMRMLMarkupsNodeTest4(int , char * [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLMarkupsFiducialNode* markupsNode = vtkMRMLMarkupsFiducialNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLMarkupsFiducialNode"));
+  CHECK_NOT_NULL(markupsNode);
+
+  vtkNew<vtkCallbackCommand> callback;
+  callback->SetCallback(CountEvents);
+  markupsNode->AddObserver(vtkMRMLMarkupsNode::PointAddedEvent, callback);
+  markupsNode->AddObserver(vtkMRMLMarkupsNode::PointRemovedEvent, callback);
+  markupsNode->AddObserver(vtkMRMLMarkupsNode::PointModifiedEvent, callback);
+  markupsNode->AddObserver(vtkMRMLMarkupsNode::PointsReplacedEvent, callback);
+
+  const int numberOfPoints = 1000;
+  vtkNew<vtkPoints> pointsWorld;
+  for (int pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
+    {
+    pointsWorld->InsertNextPoint(pointIndex, 2.0 * pointIndex, -pointIndex);
+    }
+
+  // Set positions on a transformed node: a single set of events is expected
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->SetElement(0, 3, 10.0);
+  matrix->SetElement(1, 3, -20.0);
+  vtkMRMLLinearTransformNode* transformNode = vtkMRMLLinearTransformNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLLinearTransformNode"));
+  transformNode->SetMatrixTransformToParent(matrix);
+  markupsNode->SetAndObserveTransformNodeID(transformNode->GetID());
+
+  EventCounts.clear();
+  markupsNode->SetControlPointPositionsWorld(pointsWorld);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointAddedEvent], 1);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointModifiedEvent], 1);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointsReplacedEvent], 1);
+
+  double positionLocal[3] = { 0.0 };
+  markupsNode->GetNthControlPointPosition(10, positionLocal);
+  CHECK_DOUBLE_TOLERANCE(positionLocal[0], 0.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(positionLocal[1], 40.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(positionLocal[2], -10.0, 1e-6);
+  double positionWorld[3] = { 0.0 };
+  markupsNode->GetNthControlPointPositionWorld(10, positionWorld);
+  CHECK_DOUBLE_TOLERANCE(positionWorld[0], 10.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(positionWorld[1], 20.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(positionWorld[2], -10.0, 1e-6);
+  CHECK_INT(markupsNode->GetCurvePoints()->GetNumberOfPoints(), numberOfPoints);
+
+  // Remove a range of control points
+  EventCounts.clear();
+  markupsNode->RemoveControlPoints(100, 400);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints - 400);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointRemovedEvent], 1);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointsReplacedEvent], 1);
+  markupsNode->GetNthControlPointPositionWorld(100, positionWorld);
+  CHECK_DOUBLE_TOLERANCE(positionWorld[0], 500.0, 1e-6);
+
+  // Invalid range is rejected
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  markupsNode->RemoveControlPoints(500, 200);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints - 400);
+
+  // Add control points in bulk
+  EventCounts.clear();
+  int firstIndex = markupsNode->AddControlPointsWorld(pointsWorld);
+  CHECK_INT(firstIndex, numberOfPoints - 400);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 2 * numberOfPoints - 400);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointAddedEvent], 1);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointsReplacedEvent], 1);
+  CHECK_BOOL(markupsNode->GetNthControlPointID(firstIndex).empty(), false);
+  CHECK_BOOL(markupsNode->GetNthControlPointLabel(firstIndex).empty(), false);
+
+  // Shrink the list
+  EventCounts.clear();
+  pointsWorld->SetNumberOfPoints(5);
+  markupsNode->SetControlPointPositionsWorld(pointsWorld);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 5);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointRemovedEvent], 1);
+  CHECK_INT(EventCounts[vtkMRMLMarkupsNode::PointsReplacedEvent], 1);
+
+  std::cout << "Success." << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -12,6 +12,11 @@ class SegmentEditorFillBetweenSlicesEffect(AbstractScriptedSegmentEditorAutoComp
   def __init__(self, scriptedEffect):
     AbstractScriptedSegmentEditorAutoCompleteEffect.__init__(self, scriptedEffect)
     scriptedEffect.name = 'Fill between slices'
+    # Interpolator is kept between preview updates so that only segments that were modified are interpolated again.
+    # It keeps a copy of the input labelmap of each segment, therefore it is released when the preview is
+    # cancelled or applied, when the effect is deactivated, and when the segmentation node changes.
+    self.interpolator = None
+    self.interpolatorSegmentationNode = None
 
   def clone(self):
     import qSlicerSegmentationsEditorEffectsPythonQt as effects
@@ -38,9 +43,34 @@ Masking settings are ignored. If segments overlap, segment higher in the segment
 The effect uses  <a href="http://insight-journal.org/browse/publication/977">morphological contour interpolation method</a>.
 <p></html>"""
 
+  def deactivate(self):
+    self.releaseInterpolator()
+
+  def reset(self):
+    AbstractScriptedSegmentEditorAutoCompleteEffect.reset(self)
+    self.releaseInterpolator()
+
+  def referenceGeometryChanged(self):
+    # Called when another segmentation node is selected
+    parameterSetNode = self.scriptedEffect.parameterSetNode()
+    if parameterSetNode is None or self.interpolatorSegmentationNode != parameterSetNode.GetSegmentationNode():
+      self.releaseInterpolator()
+
+  def releaseInterpolator(self):
+    self.interpolator = None
+    self.interpolatorSegmentationNode = None
+
   def computePreviewLabelmap(self, mergedImage, outputLabelmap):
     import vtkITK
-    interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
-    interpolator.SetInputData(mergedImage)
-    interpolator.Update()
-    outputLabelmap.DeepCopy(interpolator.GetOutput())
+    segmentationNode = self.scriptedEffect.parameterSetNode().GetSegmentationNode()
+    if self.interpolatorSegmentationNode != segmentationNode:
+      # Cached labelmaps belong to another segmentation
+      self.releaseInterpolator()
+    if not self.interpolator:
+      self.interpolator = vtkITK.vtkITKMorphologicalContourInterpolator()
+      self.interpolator.ProcessLabelsIndependentlyOn()
+      self.interpolatorSegmentationNode = segmentationNode
+    self.interpolator.SetInputData(mergedImage)
+    self.interpolator.Update()
+    outputLabelmap.DeepCopy(self.interpolator.GetOutput())
+    self.interpolator.SetInputData(None)
@@ -225,14 +225,12 @@ public:
       this->ImageThreshold->SetOutValue(1);
       this->ImageThreshold->SetInValue(0);
 
-      // Image outline
+      // Image outline (and fill, if both are shown for a binary labelmap).
+      // The label outline filter maps the labels to colors directly.
       this->LabelOutline->SetInputConnection(this->Reslice->GetOutputPort());
-      vtkSmartPointer<vtkImageMapToRGBA> outlineColorMapper = vtkSmartPointer<vtkImageMapToRGBA>::New();
-      outlineColorMapper->SetInputConnection(this->LabelOutline->GetOutputPort());
-      outlineColorMapper->SetOutputFormatToRGBA();
-      outlineColorMapper->SetLookupTable(this->LookupTableOutline);
+      this->LabelOutline->SetLookupTable(this->LookupTableOutline);
       vtkSmartPointer<vtkImageMapper> imageOutlineMapper = vtkSmartPointer<vtkImageMapper>::New();
-      imageOutlineMapper->SetInputConnection(outlineColorMapper->GetOutputPort());
+      imageOutlineMapper->SetInputConnection(this->LabelOutline->GetOutputPort());
       imageOutlineMapper->SetColorWindow(255);
       imageOutlineMapper->SetColorLevel(127.5);
       this->ImageOutlineActor->SetMapper(imageOutlineMapper);
@@ -796,10 +794,15 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
         }
       }
 
+    // Segments in a shared labelmap have the same bounds, so checking one of them is enough
     bool pipelineVisiblity = false;
-    for (std::string segmentId : sharedSegmentIds)
+    for (const std::string& segmentId : sharedSegmentIds)
       {
-      pipelineVisiblity |= this->IsSegmentVisibleInCurrentSlice(displayNode, pipeline, segmentId);
+      pipelineVisiblity = this->IsSegmentVisibleInCurrentSlice(displayNode, pipeline, segmentId);
+      if (pipelineVisiblity || imageData)
+        {
+        break;
+        }
       }
 
     if (!pipelineVisiblity)
@@ -944,10 +947,16 @@ void vtkMRMLSegmentationsDisplayableManager2D::vtkInternal::UpdateDisplayNodePip
           }
         }
 
+      // Binary labelmaps that are both filled and outlined are colorized by the label
+      // outline filter in a single pass over the resliced labels and shown by one actor
+      bool fractionalLabelmap = (displayNode->GetDisplayRepresentationName2D() == vtkSegmentationConverter::GetFractionalLabelmapRepresentationName());
+      bool combinedFillAndOutline = outlineVisible && fillVisible && !fractionalLabelmap;
+      pipeline->LabelOutline->SetFillLookupTable(combinedFillAndOutline ? pipeline->LookupTableFill.GetPointer() : nullptr);
+
       // Update pipeline actors
       pipeline->ImageOutlineActor->SetVisibility(outlineVisible);
       pipeline->ImageOutlineActor->SetPosition(0, 0);
-      pipeline->ImageFillActor->SetVisibility(fillVisible);
+      pipeline->ImageFillActor->SetVisibility(fillVisible && !combinedFillAndOutline);
       pipeline->ImageFillActor->SetPosition(0, 0);
 
       if (!outlineVisible && !fillVisible)
@@ -0,0 +1,196 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+#include <QStandardItem>
+
+// SubjectHierarchy includes
+#include "qMRMLSubjectHierarchyModel.h"
+#include "qMRMLSubjectHierarchyModel_p.h"
+#include "qSlicerSubjectHierarchyFolderPlugin.h"
+#include "qSlicerSubjectHierarchyPluginHandler.h"
+
+// CTK includes
+#include <ctkCoreTestingMacros.h>
+
+// MRML includes
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSubjectHierarchyNode.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include "qMRMLWidget.h"
+
+// STD includes
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+class qMRMLSubjectHierarchyModelTester : public qMRMLSubjectHierarchyModel
+{
+public:
+  qMRMLSubjectHierarchyModelPrivate* privateData()
+    {
+    return this->d_ptr.data();
+    }
+};
+
+//-----------------------------------------------------------------------------
+vtkIdType createFolder(vtkMRMLSubjectHierarchyNode* shNode, vtkIdType parentItemID, const std::string& name)
+{
+  vtkIdType itemID = shNode->CreateFolderItem(parentItemID, name);
+  // Not done by the plugin handler if another observer processed the added event first
+  shNode->SetItemOwnerPluginName(itemID, "Folder");
+  return itemID;
+}
+
+//-----------------------------------------------------------------------------
+int checkItem(qMRMLSubjectHierarchyModelTester& model, vtkMRMLSubjectHierarchyNode* shNode, vtkIdType itemID)
+{
+  QStandardItem* item = model.itemFromSubjectHierarchyItem(itemID);
+  CHECK_NOT_NULL(item);
+  CHECK_QSTRING(item->text(), QString::fromStdString(shNode->GetItemName(itemID)));
+  CHECK_INT(model.subjectHierarchyItemFromItem(item->parent()), shNode->GetItemParent(itemID));
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qMRMLSubjectHierarchyModelTest1(int argc, char * argv [] )
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSubjectHierarchyNode* shNode = vtkMRMLSubjectHierarchyNode::ResolveSubjectHierarchy(scene.GetPointer());
+  CHECK_NOT_NULL(shNode);
+
+  qSlicerSubjectHierarchyPluginHandler* pluginHandler = qSlicerSubjectHierarchyPluginHandler::instance();
+  pluginHandler->setMRMLScene(scene.GetPointer());
+  pluginHandler->registerPlugin(new qSlicerSubjectHierarchyFolderPlugin());
+  qSlicerSubjectHierarchyAbstractPlugin* folderPlugin = pluginHandler->pluginByName("Folder");
+  CHECK_NOT_NULL(folderPlugin);
+
+  {
+  const int numberOfFolders = 30;
+  std::vector<vtkIdType> folderItemIDs;
+  for (int i = 0; i < numberOfFolders; ++i)
+    {
+    std::stringstream name;
+    name << "Folder" << i;
+    folderItemIDs.push_back(createFolder(shNode, shNode->GetSceneItemID(), name.str()));
+    }
+
+  qMRMLSubjectHierarchyModelTester model;
+  model.setMRMLScene(scene.GetPointer());
+  qMRMLSubjectHierarchyModelPrivate* modelPrivate = model.privateData();
+  CHECK_INT(model.rowCount(model.subjectHierarchySceneIndex()), numberOfFolders);
+  for (vtkIdType itemID : folderItemIDs)
+    {
+    CHECK_EXIT_SUCCESS(checkItem(model, shNode, itemID));
+    // Owner plugin is looked up once and then cached
+    CHECK_POINTER(modelPrivate->OwnerPluginCache.value(itemID, nullptr), folderPlugin);
+    }
+
+  //
+  // Changes during batch processing are applied at the end of the batch,
+  // without rebuilding the model.
+  //
+  QStandardItem* unchangedItem = model.itemFromSubjectHierarchyItem(folderItemIDs[0]);
+  CHECK_NOT_NULL(unchangedItem);
+
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+
+  vtkIdType childItemID = createFolder(shNode, folderItemIDs[1], "Child");
+  vtkIdType addedItemID = createFolder(shNode, shNode->GetSceneItemID(), "Added");
+  vtkIdType addedAndRemovedItemID = createFolder(shNode, shNode->GetSceneItemID(), "AddedAndRemoved");
+  CHECK_BOOL(shNode->RemoveItem(addedAndRemovedItemID), true);
+  CHECK_BOOL(shNode->RemoveItem(folderItemIDs[9]), true);
+  shNode->SetItemName(folderItemIDs[2], "Renamed");
+
+  // Model is not updated yet
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(childItemID));
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(addedItemID));
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(addedAndRemovedItemID));
+  CHECK_NOT_NULL(model.itemFromSubjectHierarchyItem(folderItemIDs[9]));
+  CHECK_QSTRING(model.itemFromSubjectHierarchyItem(folderItemIDs[2])->text(), QString("Folder2"));
+  CHECK_BOOL(modelPrivate->PendingAddedItems.contains(childItemID), true);
+  CHECK_BOOL(modelPrivate->PendingAddedItems.contains(addedItemID), true);
+  CHECK_BOOL(modelPrivate->PendingAddedItems.contains(addedAndRemovedItemID), false);
+  CHECK_BOOL(modelPrivate->PendingRemovedItems.contains(folderItemIDs[9]), true);
+  CHECK_BOOL(modelPrivate->PendingModifiedItems.contains(folderItemIDs[2]), true);
+  // Cache entries of removed and modified items are dropped immediately
+  CHECK_BOOL(modelPrivate->OwnerPluginCache.contains(folderItemIDs[9]), false);
+  CHECK_BOOL(modelPrivate->OwnerPluginCache.contains(folderItemIDs[2]), false);
+  CHECK_BOOL(modelPrivate->OwnerPluginCache.contains(addedAndRemovedItemID), false);
+
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+
+  CHECK_BOOL(modelPrivate->PendingAddedItems.isEmpty(), true);
+  CHECK_BOOL(modelPrivate->PendingRemovedItems.isEmpty(), true);
+  CHECK_BOOL(modelPrivate->PendingModifiedItems.isEmpty(), true);
+  CHECK_POINTER(model.itemFromSubjectHierarchyItem(folderItemIDs[0]), unchangedItem);
+  CHECK_EXIT_SUCCESS(checkItem(model, shNode, childItemID));
+  CHECK_EXIT_SUCCESS(checkItem(model, shNode, addedItemID));
+  CHECK_EXIT_SUCCESS(checkItem(model, shNode, folderItemIDs[2]));
+  CHECK_QSTRING(model.itemFromSubjectHierarchyItem(folderItemIDs[2])->text(), QString("Renamed"));
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(addedAndRemovedItemID));
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(folderItemIDs[9]));
+  CHECK_INT(model.rowCount(model.subjectHierarchySceneIndex()), numberOfFolders);
+  CHECK_POINTER(modelPrivate->OwnerPluginCache.value(folderItemIDs[2], nullptr), folderPlugin);
+  CHECK_POINTER(modelPrivate->OwnerPluginCache.value(childItemID, nullptr), folderPlugin);
+  CHECK_BOOL(modelPrivate->OwnerPluginCache.contains(folderItemIDs[9]), false);
+
+  //
+  // Removal outside of batch processing
+  //
+  CHECK_BOOL(shNode->RemoveItem(folderItemIDs[3]), true);
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(folderItemIDs[3]));
+  CHECK_BOOL(modelPrivate->OwnerPluginCache.contains(folderItemIDs[3]), false);
+  CHECK_INT(model.rowCount(model.subjectHierarchySceneIndex()), numberOfFolders - 1);
+
+  //
+  // Removing a branch during batch processing
+  //
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  CHECK_BOOL(shNode->RemoveItem(folderItemIDs[1]), true);
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(folderItemIDs[1]));
+  CHECK_NULL(model.itemFromSubjectHierarchyItem(childItemID));
+  CHECK_BOOL(modelPrivate->OwnerPluginCache.contains(folderItemIDs[1]), false);
+  CHECK_BOOL(modelPrivate->OwnerPluginCache.contains(childItemID), false);
+  CHECK_INT(model.rowCount(model.subjectHierarchySceneIndex()), numberOfFolders - 2);
+  for (int i = 0; i < numberOfFolders; ++i)
+    {
+    if (i != 1 && i != 3 && i != 9)
+      {
+      CHECK_EXIT_SUCCESS(checkItem(model, shNode, folderItemIDs[i]));
+      }
+    }
+  CHECK_EXIT_SUCCESS(checkItem(model, shNode, addedItemID));
+  }
+
+  pluginHandler->setMRMLScene(nullptr);
+  qSlicerSubjectHierarchyPluginHandler::setInstance(nullptr);
+
+  return EXIT_SUCCESS;
+}
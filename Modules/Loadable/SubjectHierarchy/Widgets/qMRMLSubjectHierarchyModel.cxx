@@ -170,6 +170,11 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
       return nullptr;
       }
     }
+  if (index < 0 || index > parentItem->rowCount())
+    {
+    // Siblings preceding the item may not have been inserted yet
+    index = parentItem->rowCount();
+    }
   item = q->insertSubjectHierarchyItem(itemID, parentItem, index);
   if (q->itemFromSubjectHierarchyItem(itemID) != item)
     {
@@ -179,6 +184,83 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
   return item;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::clearPendingChanges()
+{
+  this->PendingAddedItems.clear();
+  this->PendingRemovedItems.clear();
+  this->PendingModifiedItems.clear();
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModelPrivate::applyPendingChanges()
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+  if (!this->SubjectHierarchyNode || !q->subjectHierarchySceneItem())
+    {
+    q->rebuildFromSubjectHierarchy();
+    return;
+    }
+  int numberOfChanges = this->PendingAddedItems.count()
+    + this->PendingRemovedItems.count() + this->PendingModifiedItems.count();
+  // Each change requires updating items individually, it is faster to rebuild
+  // the model if most of the subject hierarchy has changed.
+  if (numberOfChanges > this->SubjectHierarchyNode->GetNumberOfItems() / 2)
+    {
+    q->rebuildFromSubjectHierarchy();
+    return;
+    }
+
+  // Removed items
+  foreach (vtkIdType itemID, this->PendingRemovedItems)
+    {
+    QModelIndex index = q->indexFromSubjectHierarchyItem(itemID);
+    if (!index.isValid())
+      {
+      continue;
+      }
+    if (q->itemFromIndex(index)->rowCount() > 0)
+      {
+      // Children of the removed item would have to be reparented
+      q->rebuildFromSubjectHierarchy();
+      return;
+      }
+    q->removeRow(index.row(), index.parent());
+    this->RowCache.remove(itemID);
+    }
+
+  // Added items
+  QSet<vtkIdType> addedItems;
+  foreach (vtkIdType itemID, this->PendingAddedItems)
+    {
+    this->insertSubjectHierarchyItem(itemID, this->SubjectHierarchyNode->GetItemPositionUnderParent(itemID));
+    addedItems.insert(itemID);
+    }
+  // Update expanded states (during inserting the update calls did not find valid indices)
+  foreach (vtkIdType itemID, this->PendingAddedItems)
+    {
+    QStandardItem* item = q->itemFromSubjectHierarchyItem(itemID, q->nameColumn());
+    if (item)
+      {
+      q->updateItemDataFromSubjectHierarchyItem(item, itemID, q->nameColumn());
+      }
+    }
+
+  // Modified items, added items are already up-to-date
+  QSet<vtkIdType> modifiedItems = this->PendingModifiedItems;
+  this->clearPendingChanges();
+  foreach (vtkIdType itemID, modifiedItems)
+    {
+    if (!addedItems.contains(itemID))
+      {
+      this->OwnerPluginCache.remove(itemID);
+      q->updateModelItems(itemID);
+      }
+    }
+
+  emit q->subjectHierarchyUpdated();
+}
+
 //------------------------------------------------------------------------------
 vtkSlicerTerminologiesModuleLogic* qMRMLSubjectHierarchyModelPrivate::terminologiesModuleLogic()
 {
@@ -683,6 +765,8 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
   Q_D(qMRMLSubjectHierarchyModel);
 
   d->RowCache.clear();
+  d->OwnerPluginCache.clear();
+  d->clearPendingChanges();
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -952,11 +1036,16 @@ void qMRMLSubjectHierarchyModel::updateItemDataFromSubjectHierarchyItem(QStandar
     return;
     }
 
-  qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin = nullptr;
-  if (!d->SubjectHierarchyNode->GetItemOwnerPluginName(shItemID).empty())
+  // The owner plugin is cached, as it would be looked up for each column
+  qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin = d->OwnerPluginCache.value(shItemID, nullptr);
+  if (ownerPlugin == nullptr && !d->SubjectHierarchyNode->GetItemOwnerPluginName(shItemID).empty())
     {
     ownerPlugin = qSlicerSubjectHierarchyPluginHandler::instance()->getOwnerPluginForSubjectHierarchyItem(shItemID);
-    if (!ownerPlugin)
+    if (ownerPlugin)
+      {
+      d->OwnerPluginCache[shItemID] = ownerPlugin;
+      }
+    else
       {
       if (column == this->nameColumn())
         {
@@ -970,7 +1059,7 @@ void qMRMLSubjectHierarchyModel::updateItemDataFromSubjectHierarchyItem(QStandar
         return;
       }
     }
-  else
+  else if (ownerPlugin == nullptr)
     {
     qDebug() << Q_FUNC_INFO << ": No owner plugin for subject hierarchy item '" << d->subjectHierarchyItemName(shItemID);
 
@@ -1333,10 +1422,16 @@ void qMRMLSubjectHierarchyModel::updateSubjectHierarchyItemFromItemData(vtkIdTyp
 void qMRMLSubjectHierarchyModel::updateModelItems(vtkIdType itemID)
 {
   Q_D(qMRMLSubjectHierarchyModel);
-  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsBatchProcessing())
+  if (d->MRMLScene->IsClosing())
     {
     return;
     }
+  if (d->MRMLScene->IsBatchProcessing())
+    {
+    // Items are updated at the end of the batch processing
+    d->PendingModifiedItems.insert(itemID);
+    return;
+    }
 
   QModelIndexList itemIndexes = this->indexes(itemID);
   if (!itemIndexes.count())
@@ -1439,6 +1534,13 @@ void qMRMLSubjectHierarchyModel::onEvent(
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAdded(vtkIdType itemID)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (d->MRMLScene && d->MRMLScene->IsBatchProcessing())
+    {
+    // Items are inserted at the end of the batch processing
+    d->PendingAddedItems << itemID;
+    return;
+    }
   this->insertSubjectHierarchyItem(itemID);
 }
 
@@ -1446,8 +1548,20 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAdded(vtkIdType itemID)
 void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdType itemID)
 {
   Q_D(qMRMLSubjectHierarchyModel);
-  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsBatchProcessing())
+  d->OwnerPluginCache.remove(itemID);
+  d->PendingModifiedItems.remove(itemID);
+  if (d->PendingAddedItems.removeAll(itemID))
     {
+    // The item was added during the batch processing, it is not in the model yet
+    return;
+    }
+  if (d->MRMLScene->IsClosing())
+    {
+    return;
+    }
+  if (d->MRMLScene->IsBatchProcessing())
+    {
+    d->PendingRemovedItems << itemID;
     return;
     }
 
@@ -1510,6 +1624,9 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemRemoved(vtkIdType removed
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemModified(vtkIdType itemID)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
+  // The owner plugin may have changed
+  d->OwnerPluginCache.remove(itemID);
   this->updateModelItems(itemID);
 }
 
@@ -1543,8 +1660,9 @@ void qMRMLSubjectHierarchyModel::onMRMLSceneStartBatchProcess(vtkMRMLScene* scen
 //------------------------------------------------------------------------------
 void qMRMLSubjectHierarchyModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
 {
+  Q_D(qMRMLSubjectHierarchyModel);
   Q_UNUSED(scene);
-  this->updateFromSubjectHierarchy();
+  d->applyPendingChanges();
 }
 
 //------------------------------------------------------------------------------
@@ -36,7 +36,9 @@
 
 // Qt includes
 #include <QFlags>
+#include <QHash>
 #include <QMap>
+#include <QSet>
 
 // SubjectHierarchy includes
 #include "qSlicerSubjectHierarchyModuleWidgetsExport.h"
@@ -52,6 +54,7 @@
 #include <vtkSmartPointer.h>
 
 class QStandardItemModel;
+class qSlicerSubjectHierarchyAbstractPlugin;
 class vtkSlicerTerminologiesModuleLogic;
 
 //------------------------------------------------------------------------------
@@ -79,6 +82,12 @@ public:
   /// Get terminologies module logic. If not found in cache get from module object
   vtkSlicerTerminologiesModuleLogic* terminologiesModuleLogic();
 
+  /// Apply the subject hierarchy items added, removed and modified during batch processing.
+  /// Falls back to rebuilding the model if most of the items have changed or if the
+  /// changes cannot be applied individually.
+  void applyPendingChanges();
+  void clearPendingChanges();
+
 public:
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   int PendingItemModified;
@@ -119,6 +128,17 @@ public:
   // not guaranteed to contain up-to-date information, should be just used as a search hint.
   // If the item cannot be found at the given index then we need to browse through all model items.
   mutable QMap<vtkIdType, QPersistentModelIndex> RowCache;
+
+  // Owner plugin of the subject hierarchy items, to avoid looking up the plugin for each column.
+  // An entry is removed when the item is modified, as its owner plugin may have changed.
+  // Icons and visibility are not cached: they are queried once per item update, and they
+  // depend on data node and branch states that may change without notifying this item.
+  QHash<vtkIdType, qSlicerSubjectHierarchyAbstractPlugin*> OwnerPluginCache;
+
+  // Subject hierarchy changes recorded during batch processing
+  QList<vtkIdType> PendingAddedItems;
+  QList<vtkIdType> PendingRemovedItems;
+  QSet<vtkIdType> PendingModifiedItems;
 };
 
 #endif
@@ -102,6 +102,7 @@ QStringList qSlicerTablesReader::extensions()const
     << "Table (*.tsv)"
     << "Table (*.csv)"
     << "Table (*.txt)"
+    << "Table (*.ctbl)"
     << "Table (*.db)"
     << "Table (*.db3)"
     << "Table (*.sqlite)"
@@ -25,17 +25,28 @@
 
 // MRML includes
 #include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLScalarVolumeNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLVolumeNode.h>
 
 // VTK includes
+#include <vtkColorTransferFunction.h>
 #include <vtkImageData.h>
+#include <vtkLookupTable.h>
 #include <vtkNew.h>
+#include <vtkPiecewiseFunction.h>
 #include <vtkSmartPointer.h>
+#include <vtkVolumeProperty.h>
+
+// STD includes
+#include <chrono>
+#include <thread>
 
 //----------------------------------------------------------------------------
 int testDefaultRenderingMethod(const std::string& moduleShareDirectory);
 int testPresets(const std::string &moduleShareDirectory);
+int testMultiResolution();
+int testTransferFunctionCache();
 
 //----------------------------------------------------------------------------
 int vtkSlicerVolumeRenderingLogicTest(int argc, char* argv[])
@@ -49,6 +60,8 @@ int vtkSlicerVolumeRenderingLogicTest(int argc, char* argv[])
 
   CHECK_EXIT_SUCCESS(testDefaultRenderingMethod(moduleShareDirectory));
   CHECK_EXIT_SUCCESS(testPresets(moduleShareDirectory));
+  CHECK_EXIT_SUCCESS(testMultiResolution());
+  CHECK_EXIT_SUCCESS(testTransferFunctionCache());
   return EXIT_SUCCESS;
 }
 
@@ -106,3 +119,152 @@ int testPresets(const std::string& moduleShareDirectory)
 
   return EXIT_SUCCESS;
 }
+
+//----------------------------------------------------------------------------
+int testMultiResolution()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkSlicerVolumeRenderingLogic> logic;
+  logic->SetMRMLScene(scene.GetPointer());
+  logic->SetBrickSize(16);
+
+  // 64^3 volume, non-zero only in [40, 50]
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(64, 64, 64);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* scalars = static_cast<short*>(imageData->GetScalarPointer());
+  for (int k = 0; k < 64; ++k)
+    {
+    for (int j = 0; j < 64; ++j)
+      {
+      for (int i = 0; i < 64; ++i, ++scalars)
+        {
+        bool inside = (i >= 40 && i <= 50 && j >= 40 && j <= 50 && k >= 40 && k <= 50);
+        *scalars = (inside ? 100 : 0);
+        }
+      }
+    }
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode"));
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+
+  // Pyramid levels
+  CHECK_POINTER(logic->GetMultiResolutionLevel(volumeNode, 0), imageData.GetPointer());
+  vtkImageData* level1 = logic->GetMultiResolutionLevel(volumeNode, 1);
+  CHECK_NOT_NULL(level1);
+  int dimensions[3] = { 0, 0, 0 };
+  level1->GetDimensions(dimensions);
+  CHECK_INT(dimensions[0], 32);
+  CHECK_INT(dimensions[1], 32);
+  CHECK_INT(dimensions[2], 32);
+  CHECK_DOUBLE(level1->GetSpacing()[0], 2.0);
+  CHECK_DOUBLE(level1->GetOrigin()[0], 0.5);
+  CHECK_POINTER(logic->GetMultiResolutionLevel(volumeNode, 1), level1);
+  CHECK_INT(logic->GetMultiResolutionLevelForNumberOfVoxels(volumeNode, 64 * 64 * 64), 0);
+  CHECK_INT(logic->GetMultiResolutionLevelForNumberOfVoxels(volumeNode, 32 * 32 * 32), 1);
+  CHECK_INT(logic->GetMultiResolutionLevelForNumberOfVoxels(volumeNode, 1), 6);
+
+  // Empty space skipping
+  vtkNew<vtkPiecewiseFunction> opacity;
+  opacity->AddPoint(0.0, 0.0);
+  opacity->AddPoint(50.0, 0.0);
+  opacity->AddPoint(100.0, 1.0);
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  CHECK_BOOL(logic->GetNonEmptyExtent(volumeNode, opacity.GetPointer(), extent), true);
+  for (int i = 0; i < 3; ++i)
+    {
+    CHECK_INT(extent[2 * i], 31);
+    CHECK_INT(extent[2 * i + 1], 63);
+    }
+  opacity->AddPoint(0.0, 0.5);
+  CHECK_BOOL(logic->GetNonEmptyExtent(volumeNode, opacity.GetPointer(), extent), true);
+  CHECK_INT(extent[0], 0);
+  CHECK_INT(extent[1], 63);
+
+  // Cache is invalidated when the image is modified
+  imageData->Modified();
+  CHECK_BOOL(logic->GetMultiResolutionLevel(volumeNode, 1) != level1, true);
+
+  // Levels computed in the background
+  CHECK_POINTER(logic->RequestMultiResolutionLevel(volumeNode, 0), imageData.GetPointer());
+  CHECK_NOT_NULL(logic->RequestMultiResolutionLevel(volumeNode, 1));
+  vtkImageData* level3 = nullptr;
+  for (int attempt = 0; attempt < 1000 && !level3; ++attempt)
+    {
+    level3 = logic->RequestMultiResolutionLevel(volumeNode, 3);
+    if (!level3)
+      {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+  CHECK_NOT_NULL(level3);
+  level3->GetDimensions(dimensions);
+  CHECK_INT(dimensions[0], 8);
+  CHECK_INT(dimensions[1], 8);
+  CHECK_INT(dimensions[2], 8);
+  CHECK_DOUBLE(level3->GetSpacing()[0], 8.0);
+  CHECK_POINTER(logic->GetMultiResolutionLevel(volumeNode, 3), level3);
+
+  scene->RemoveNode(volumeNode);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int testTransferFunctionCache()
+{
+  vtkNew<vtkSlicerVolumeRenderingLogic> logic;
+  vtkNew<vtkLookupTable> lut;
+  lut->SetNumberOfTableValues(256);
+  lut->Build();
+
+  double scalarRange[2] = { 0.0, 1000.0 };
+  double windowLevel[2] = { 400.0, 200.0 };
+  vtkNew<vtkVolumeProperty> volumeProperty1;
+  vtkNew<vtkVolumeProperty> volumeProperty2;
+  logic->SetWindowLevelToVolumeProp(scalarRange, windowLevel, lut.GetPointer(), volumeProperty1.GetPointer());
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 1);
+
+  // Same input: cached functions are reused and the property is not modified
+  vtkMTimeType colorMTime = volumeProperty1->GetRGBTransferFunction()->GetMTime();
+  logic->SetWindowLevelToVolumeProp(scalarRange, windowLevel, lut.GetPointer(), volumeProperty1.GetPointer());
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 1);
+  CHECK_BOOL(volumeProperty1->GetRGBTransferFunction()->GetMTime() == colorMTime, true);
+
+  logic->SetWindowLevelToVolumeProp(scalarRange, windowLevel, lut.GetPointer(), volumeProperty2.GetPointer());
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 1);
+  CHECK_BOOL(logic->IsDifferentFunction(volumeProperty1->GetRGBTransferFunction(), volumeProperty2->GetRGBTransferFunction()), false);
+
+  // Modified lookup table invalidates the cached function
+  lut->SetTableValue(0, 1.0, 0.0, 0.0);
+  logic->SetWindowLevelToVolumeProp(scalarRange, windowLevel, lut.GetPointer(), volumeProperty2.GetPointer());
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 2);
+  CHECK_BOOL(logic->IsDifferentFunction(volumeProperty1->GetRGBTransferFunction(), volumeProperty2->GetRGBTransferFunction()), true);
+
+  double threshold[2] = { 100.0, 500.0 };
+  logic->SetThresholdToVolumeProp(scalarRange, threshold, volumeProperty1.GetPointer());
+  logic->SetThresholdToVolumeProp(scalarRange, threshold, volumeProperty2.GetPointer());
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 3);
+  CHECK_BOOL(logic->IsDifferentFunction(volumeProperty1->GetScalarOpacity(), volumeProperty2->GetScalarOpacity()), false);
+
+  // Volume property functions are edited in place (e.g. by transfer function widgets):
+  // the cached function must not be affected, and is applied again for the same input.
+  volumeProperty1->GetScalarOpacity()->AddPoint(300.0, 0.5);
+  CHECK_BOOL(logic->IsDifferentFunction(volumeProperty1->GetScalarOpacity(), volumeProperty2->GetScalarOpacity()), true);
+  logic->SetThresholdToVolumeProp(scalarRange, threshold, volumeProperty1.GetPointer());
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 3);
+  CHECK_BOOL(logic->IsDifferentFunction(volumeProperty1->GetScalarOpacity(), volumeProperty2->GetScalarOpacity()), false);
+  vtkMTimeType opacityMTime = volumeProperty1->GetScalarOpacity()->GetMTime();
+  logic->SetThresholdToVolumeProp(scalarRange, threshold, volumeProperty1.GetPointer());
+  CHECK_BOOL(volumeProperty1->GetScalarOpacity()->GetMTime() == opacityMTime, true);
+
+  // Threshold is part of the key
+  double otherThreshold[2] = { 100.0, 600.0 };
+  logic->SetThresholdToVolumeProp(scalarRange, otherThreshold, volumeProperty2.GetPointer());
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 4);
+  CHECK_BOOL(logic->IsDifferentFunction(volumeProperty1->GetScalarOpacity(), volumeProperty2->GetScalarOpacity()), true);
+
+  logic->ClearTransferFunctionCache();
+  CHECK_INT(logic->GetNumberOfCachedTransferFunctions(), 0);
+
+  return EXIT_SUCCESS;
+}
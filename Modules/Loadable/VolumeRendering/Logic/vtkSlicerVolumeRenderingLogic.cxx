@@ -44,12 +44,15 @@
 // VTK includes
 #include <vtkColorTransferFunction.h>
 #include <vtkImageData.h>
+#include <vtkImageShrink3D.h>
 #include <vtkLookupTable.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPiecewiseFunction.h>
 #include <vtkPointData.h>
+#include <vtkSmartPointer.h>
 #include <vtkVolumeProperty.h>
+#include <vtkWeakPointer.h>
 
 #if defined(Slicer_VTK_RENDERING_USE_OpenGL_BACKEND)
 #include <vtkOpenGLExtensionManager.h>
@@ -59,16 +62,353 @@
 // STD includes
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <tuple>
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerVolumeRenderingLogic);
 
+//----------------------------------------------------------------------------
+class vtkSlicerVolumeRenderingLogic::vtkInternal
+{
+public:
+  vtkInternal(vtkSlicerVolumeRenderingLogic* external);
+
+  vtkSlicerVolumeRenderingLogic* External;
+
+  /// Multiresolution pyramid and brick scalar ranges of a volume.
+  /// The cache is valid as long as the image data of the volume and its
+  /// modification time are unchanged.
+  struct MultiResolutionCache
+    {
+    vtkWeakPointer<vtkImageData> ImageData;
+    vtkMTimeType ImageDataMTime{0};
+    /// Downsampled levels, index 0 corresponds to level 1
+    std::vector< vtkSmartPointer<vtkImageData> > Levels;
+    /// Minimum and maximum scalar value of each brick (2 values per brick)
+    std::vector<double> BrickScalarRanges;
+    int BrickSize{0};
+    int NumberOfBricks[3]{0, 0, 0};
+    /// Levels that are being computed in a background thread, appended to Levels when ready.
+    /// Destroying the cache entry waits for the computation to finish.
+    std::future< std::vector< vtkSmartPointer<vtkImageData> > > PendingLevels;
+    /// Number of levels that can be computed, known after a computation failed
+    int MaximumLevel{VTK_INT_MAX};
+    };
+
+  /// Return the up-to-date cache entry for the volume, nullptr if the volume has no image data.
+  MultiResolutionCache* GetMultiResolutionCache(vtkMRMLVolumeNode* volumeNode);
+
+  /// Move levels computed in the background to the cache.
+  /// If wait is false then levels are only moved if the computation is already finished.
+  static void CollectPendingLevels(MultiResolutionCache* cache, bool wait);
+
+  std::map<vtkMRMLVolumeNode*, MultiResolutionCache> MultiResolutionCaches;
+
+  /// Inputs of a generated transfer function. Values are compared exactly.
+  struct TransferFunctionCacheKey
+    {
+    enum FunctionType
+      {
+      Threshold,
+      WindowLevel,
+      LabelMap
+      };
+    int Type{Threshold};
+    /// Scalar range followed by threshold or window/level
+    double Values[4]{0.0, 0.0, 0.0, 0.0};
+    /// Linear ramp and stay up at upper limit flags of threshold
+    int Flags{0};
+    /// Colors and their modification time
+    vtkScalarsToColors* Colors{nullptr};
+    vtkMTimeType ColorsMTime{0};
+
+    std::tuple<int, double, double, double, double, int, vtkScalarsToColors*, vtkMTimeType> AsTuple()const
+      {
+      return std::make_tuple(this->Type, this->Values[0], this->Values[1], this->Values[2], this->Values[3],
+        this->Flags, this->Colors, this->ColorsMTime);
+      }
+    bool operator<(const TransferFunctionCacheKey& other)const
+      {
+      return this->AsTuple() < other.AsTuple();
+      }
+    bool operator==(const TransferFunctionCacheKey& other)const
+      {
+      return this->AsTuple() == other.AsTuple();
+      }
+    };
+
+  /// Transfer functions generated from volume display properties.
+  /// They are shared by all the display nodes and views so that functions
+  /// are only computed once for the same input.
+  struct TransferFunctionCacheEntry
+    {
+    vtkSmartPointer<vtkPiecewiseFunction> ScalarOpacity;
+    vtkSmartPointer<vtkColorTransferFunction> Color;
+    };
+
+  /// Return the cache entry for the key, a new (empty) entry is added if not found.
+  /// Oldest entries are removed when the cache is full.
+  TransferFunctionCacheEntry& GetTransferFunctionCacheEntry(const TransferFunctionCacheKey& key);
+
+  static const size_t MaximumNumberOfCachedTransferFunctions = 64;
+  std::map<TransferFunctionCacheKey, TransferFunctionCacheEntry> TransferFunctionCache;
+  /// Cache keys in the order they were added
+  std::deque<TransferFunctionCacheKey> TransferFunctionCacheKeys;
+
+  /// Cached functions last copied to a volume property, with the modification
+  /// time of the property functions right after the copy. Copying again the
+  /// same cached function is skipped (not even compared) as long as the
+  /// property function is not modified.
+  struct AppliedTransferFunctions
+    {
+    vtkWeakPointer<vtkVolumeProperty> VolumeProperty;
+    TransferFunctionCacheKey ScalarOpacityKey;
+    vtkWeakPointer<vtkPiecewiseFunction> ScalarOpacity;
+    vtkMTimeType ScalarOpacityMTime{0};
+    TransferFunctionCacheKey ColorKey;
+    vtkWeakPointer<vtkColorTransferFunction> Color;
+    vtkMTimeType ColorMTime{0};
+    };
+  AppliedTransferFunctions& GetAppliedTransferFunctions(vtkVolumeProperty* volumeProp);
+
+  /// Copy the cached function to the volume property if its content is different
+  void ApplyScalarOpacity(const TransferFunctionCacheKey& key, vtkPiecewiseFunction* function, vtkVolumeProperty* volumeProp);
+  void ApplyColor(const TransferFunctionCacheKey& key, vtkColorTransferFunction* function, vtkVolumeProperty* volumeProp);
+
+  std::map<vtkVolumeProperty*, AppliedTransferFunctions> AppliedTransferFunctionsMap;
+};
+
+//----------------------------------------------------------------------------
+vtkSlicerVolumeRenderingLogic::vtkInternal::vtkInternal(vtkSlicerVolumeRenderingLogic* external)
+  : External(external)
+{
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerVolumeRenderingLogic::vtkInternal::MultiResolutionCache*
+vtkSlicerVolumeRenderingLogic::vtkInternal::GetMultiResolutionCache(vtkMRMLVolumeNode* volumeNode)
+{
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!imageData)
+    {
+    return nullptr;
+    }
+  MultiResolutionCache& cache = this->MultiResolutionCaches[volumeNode];
+  if (cache.ImageData.GetPointer() != imageData || cache.ImageDataMTime != imageData->GetMTime())
+    {
+    cache = MultiResolutionCache();
+    cache.ImageData = imageData;
+    cache.ImageDataMTime = imageData->GetMTime();
+    }
+  return &cache;
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerVolumeRenderingLogic::vtkInternal::TransferFunctionCacheEntry&
+vtkSlicerVolumeRenderingLogic::vtkInternal::GetTransferFunctionCacheEntry(const TransferFunctionCacheKey& key)
+{
+  std::map<TransferFunctionCacheKey, TransferFunctionCacheEntry>::iterator entryIt = this->TransferFunctionCache.find(key);
+  if (entryIt != this->TransferFunctionCache.end())
+    {
+    return entryIt->second;
+    }
+  while (this->TransferFunctionCacheKeys.size() >= MaximumNumberOfCachedTransferFunctions)
+    {
+    this->TransferFunctionCache.erase(this->TransferFunctionCacheKeys.front());
+    this->TransferFunctionCacheKeys.pop_front();
+    }
+  this->TransferFunctionCacheKeys.push_back(key);
+  return this->TransferFunctionCache[key];
+}
+
+//----------------------------------------------------------------------------
+vtkSlicerVolumeRenderingLogic::vtkInternal::AppliedTransferFunctions&
+vtkSlicerVolumeRenderingLogic::vtkInternal::GetAppliedTransferFunctions(vtkVolumeProperty* volumeProp)
+{
+  std::map<vtkVolumeProperty*, AppliedTransferFunctions>::iterator appliedIt = this->AppliedTransferFunctionsMap.find(volumeProp);
+  if (appliedIt != this->AppliedTransferFunctionsMap.end() && appliedIt->second.VolumeProperty.GetPointer() == volumeProp)
+    {
+    return appliedIt->second;
+    }
+  if (appliedIt == this->AppliedTransferFunctionsMap.end()
+    && this->AppliedTransferFunctionsMap.size() >= MaximumNumberOfCachedTransferFunctions)
+    {
+    // Forget about deleted volume properties
+    for (appliedIt = this->AppliedTransferFunctionsMap.begin(); appliedIt != this->AppliedTransferFunctionsMap.end();)
+      {
+      if (!appliedIt->second.VolumeProperty)
+        {
+        this->AppliedTransferFunctionsMap.erase(appliedIt++);
+        }
+      else
+        {
+        ++appliedIt;
+        }
+      }
+    }
+  // New volume property (or a new one allocated at the address of a deleted one)
+  AppliedTransferFunctions& applied = this->AppliedTransferFunctionsMap[volumeProp];
+  applied = AppliedTransferFunctions();
+  applied.VolumeProperty = volumeProp;
+  return applied;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingLogic::vtkInternal::ApplyScalarOpacity(const TransferFunctionCacheKey& key,
+  vtkPiecewiseFunction* function, vtkVolumeProperty* volumeProp)
+{
+  AppliedTransferFunctions& applied = this->GetAppliedTransferFunctions(volumeProp);
+  vtkPiecewiseFunction* volumePropOpacity = volumeProp->GetScalarOpacity();
+  if (applied.ScalarOpacityKey == key && applied.ScalarOpacity.GetPointer() == volumePropOpacity
+    && applied.ScalarOpacityMTime == volumePropOpacity->GetMTime())
+    {
+    return;
+    }
+  if (this->External->IsDifferentFunction(function, volumePropOpacity))
+    {
+    volumePropOpacity->DeepCopy(function);
+    }
+  applied.ScalarOpacityKey = key;
+  applied.ScalarOpacity = volumePropOpacity;
+  applied.ScalarOpacityMTime = volumePropOpacity->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingLogic::vtkInternal::ApplyColor(const TransferFunctionCacheKey& key,
+  vtkColorTransferFunction* function, vtkVolumeProperty* volumeProp)
+{
+  AppliedTransferFunctions& applied = this->GetAppliedTransferFunctions(volumeProp);
+  vtkColorTransferFunction* volumePropColorTransfer = volumeProp->GetRGBTransferFunction();
+  if (applied.ColorKey == key && applied.Color.GetPointer() == volumePropColorTransfer
+    && applied.ColorMTime == volumePropColorTransfer->GetMTime())
+    {
+    return;
+    }
+  if (this->External->IsDifferentFunction(function, volumePropColorTransfer))
+    {
+    volumePropColorTransfer->DeepCopy(function);
+    }
+  applied.ColorKey = key;
+  applied.Color = volumePropColorTransfer;
+  applied.ColorMTime = volumePropColorTransfer->GetMTime();
+}
+
+namespace
+{
+//----------------------------------------------------------------------------
+/// Append levels of the multiresolution pyramid to \a levels, each computed from
+/// the previous one (\a imageData for the first level), until there are
+/// \a numberOfLevels levels.
+/// \return false if the image is too small to be downsampled that many times.
+bool ComputeMultiResolutionLevels(vtkImageData* imageData,
+  std::vector< vtkSmartPointer<vtkImageData> >& levels, int numberOfLevels)
+{
+  while (static_cast<int>(levels.size()) < numberOfLevels)
+    {
+    vtkImageData* previousLevel = levels.empty() ? imageData : levels.back().GetPointer();
+    int dimensions[3] = { 0, 0, 0 };
+    previousLevel->GetDimensions(dimensions);
+    if (dimensions[0] <= 1 && dimensions[1] <= 1 && dimensions[2] <= 1)
+      {
+      return false;
+      }
+    vtkNew<vtkImageShrink3D> shrink;
+    shrink->SetInputData(previousLevel);
+    shrink->SetShrinkFactors(dimensions[0] > 1 ? 2 : 1, dimensions[1] > 1 ? 2 : 1, dimensions[2] > 1 ? 2 : 1);
+    shrink->AveragingOn();
+    shrink->Update();
+    vtkSmartPointer<vtkImageData> levelImage = vtkSmartPointer<vtkImageData>::New();
+    levelImage->ShallowCopy(shrink->GetOutput());
+    // Averaged voxel is centered between the input voxels
+    double origin[3] = { 0.0, 0.0, 0.0 };
+    double spacing[3] = { 1.0, 1.0, 1.0 };
+    previousLevel->GetOrigin(origin);
+    previousLevel->GetSpacing(spacing);
+    for (int i = 0; i < 3; ++i)
+      {
+      if (dimensions[i] > 1)
+        {
+        origin[i] += 0.5 * spacing[i];
+        }
+      }
+    levelImage->SetOrigin(origin);
+    levels.push_back(levelImage);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void ComputeBrickScalarRanges(vtkImageData* imageData, T* scalars, int brickSize,
+  const int numberOfBricks[3], std::vector<double>& brickScalarRanges)
+{
+  int dimensions[3] = { 0, 0, 0 };
+  imageData->GetDimensions(dimensions);
+  int numberOfComponents = imageData->GetNumberOfScalarComponents();
+  vtkIdType numberOfBricksInSlice = static_cast<vtkIdType>(numberOfBricks[0]) * numberOfBricks[1];
+  brickScalarRanges.resize(2 * numberOfBricksInSlice * numberOfBricks[2]);
+  for (vtkIdType brickIndex = 0; brickIndex < numberOfBricksInSlice * numberOfBricks[2]; ++brickIndex)
+    {
+    brickScalarRanges[2 * brickIndex] = VTK_DOUBLE_MAX;
+    brickScalarRanges[2 * brickIndex + 1] = VTK_DOUBLE_MIN;
+    }
+  const T* voxel = scalars;
+  for (int k = 0; k < dimensions[2]; ++k)
+    {
+    for (int j = 0; j < dimensions[1]; ++j)
+      {
+      double* rowBrickRanges = &brickScalarRanges[2 * ((k / brickSize) * numberOfBricksInSlice
+        + (j / brickSize) * numberOfBricks[0])];
+      for (int i = 0; i < dimensions[0]; ++i, voxel += numberOfComponents)
+        {
+        double* brickRange = rowBrickRanges + 2 * (i / brickSize);
+        double value = static_cast<double>(*voxel);
+        if (value < brickRange[0])
+          {
+          brickRange[0] = value;
+          }
+        if (value > brickRange[1])
+          {
+          brickRange[1] = value;
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool IsOpacityNonZeroInRange(vtkPiecewiseFunction* scalarOpacity, double minimum, double maximum)
+{
+  // The function is piecewise linear, therefore it is enough to check
+  // the range end points and the function nodes within the range.
+  if (scalarOpacity->GetValue(minimum) > 0.0 || scalarOpacity->GetValue(maximum) > 0.0)
+    {
+    return true;
+    }
+  double node[4] = { 0.0, 0.0, 0.0, 0.0 };
+  for (int nodeIndex = 0; nodeIndex < scalarOpacity->GetSize(); ++nodeIndex)
+    {
+    scalarOpacity->GetNodeValue(nodeIndex, node);
+    if (node[0] > minimum && node[0] < maximum && node[1] > 0.0)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkSlicerVolumeRenderingLogic::vtkSlicerVolumeRenderingLogic()
 {
   this->DefaultRenderingMethod = nullptr;
   this->UseLinearRamp = true;
   this->PresetsScene = nullptr;
+  this->BrickSize = 32;
+  this->Internal = new vtkInternal(this);
 
   this->RegisterRenderingMethod("VTK CPU Ray Casting",
                                 "vtkMRMLCPURayCastVolumeRenderingDisplayNode");
@@ -90,6 +430,7 @@ vtkSlicerVolumeRenderingLogic::~vtkSlicerVolumeRenderingLogic()
     this->PresetsScene->Delete();
     }
   this->RemoveAllVolumeRenderingDisplayNodes();
+  delete this->Internal;
 }
 
 //----------------------------------------------------------------------------
@@ -332,6 +673,11 @@ void vtkSlicerVolumeRenderingLogic::OnMRMLSceneNodeRemoved(vtkMRMLNode* node)
     {
     this->RemoveVolumeRenderingDisplayNode(vrDisplayNode);
     }
+  vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(node);
+  if (volumeNode)
+    {
+    this->RemoveMultiResolutionCache(volumeNode);
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -410,29 +756,37 @@ void vtkSlicerVolumeRenderingLogic::SetThresholdToVolumeProp(
   threshold[1] = std::min(std::max(threshold[1], scalarRange[0]), scalarRange[1]);
   vtkDebugMacro("Threshold: " << threshold[0] << " " << threshold[1]);
 
-  double previous = VTK_DOUBLE_MIN;
-
-  vtkNew<vtkPiecewiseFunction> opacity;
-  // opacity doesn't support duplicate points
-  opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[0], previous), 0.0);
-  opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[0], previous), 0.0);
-  if (!linearRamp)
-    {
-    opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[0], previous), 1.0);
-    }
-  opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[1], previous), 1.0);
-  double endValue = stayUpAtUpperLimit ? 1.0 : 0.0;
-  if (!stayUpAtUpperLimit)
-    {
-    opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[1], previous), endValue);
+  vtkInternal::TransferFunctionCacheKey key;
+  key.Type = vtkInternal::TransferFunctionCacheKey::Threshold;
+  key.Values[0] = scalarRange[0];
+  key.Values[1] = scalarRange[1];
+  key.Values[2] = threshold[0];
+  key.Values[3] = threshold[1];
+  key.Flags = (linearRamp ? 1 : 0) | (stayUpAtUpperLimit ? 2 : 0);
+  vtkInternal::TransferFunctionCacheEntry& cachedFunctions = this->Internal->GetTransferFunctionCacheEntry(key);
+  if (!cachedFunctions.ScalarOpacity)
+    {
+    double previous = VTK_DOUBLE_MIN;
+
+    vtkSmartPointer<vtkPiecewiseFunction> opacity = vtkSmartPointer<vtkPiecewiseFunction>::New();
+    // opacity doesn't support duplicate points
+    opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[0], previous), 0.0);
+    opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[0], previous), 0.0);
+    if (!linearRamp)
+      {
+      opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[0], previous), 1.0);
+      }
+    opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[1], previous), 1.0);
+    double endValue = stayUpAtUpperLimit ? 1.0 : 0.0;
+    if (!stayUpAtUpperLimit)
+      {
+      opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(threshold[1], previous), endValue);
+      }
+    opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[1], previous), endValue);
+    cachedFunctions.ScalarOpacity = opacity;
     }
-  opacity->AddPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[1], previous), endValue);
 
-  vtkPiecewiseFunction *volumePropOpacity = volumeProp->GetScalarOpacity();
-  if (this->IsDifferentFunction(opacity.GetPointer(), volumePropOpacity))
-    {
-    volumePropOpacity->DeepCopy(opacity.GetPointer());
-    }
+  this->Internal->ApplyScalarOpacity(key, cachedFunctions.ScalarOpacity, volumeProp);
 }
 
 //----------------------------------------------------------------------------
@@ -445,68 +799,77 @@ void vtkSlicerVolumeRenderingLogic::SetWindowLevelToVolumeProp(
   windowLevelMinMax[0] = windowLevel[1] - 0.5 * windowLevel[0];
   windowLevelMinMax[1] = windowLevel[1] + 0.5 * windowLevel[0];
 
-  double previous = VTK_DOUBLE_MIN;
+  vtkInternal::TransferFunctionCacheKey key;
+  key.Type = vtkInternal::TransferFunctionCacheKey::WindowLevel;
+  key.Values[0] = scalarRange[0];
+  key.Values[1] = scalarRange[1];
+  key.Values[2] = windowLevel[0];
+  key.Values[3] = windowLevel[1];
+  key.Colors = lut;
+  key.ColorsMTime = (lut ? lut->GetMTime() : 0);
+  vtkInternal::TransferFunctionCacheEntry& cachedFunctions = this->Internal->GetTransferFunctionCacheEntry(key);
+  if (!cachedFunctions.Color)
+    {
+    double previous = VTK_DOUBLE_MIN;
 
-  vtkNew<vtkColorTransferFunction> colorTransfer;
+    vtkSmartPointer<vtkColorTransferFunction> colorTransfer = vtkSmartPointer<vtkColorTransferFunction>::New();
 
-  const int size = lut ? lut->GetNumberOfTableValues() : 0;
-  if (size == 0)
-    {
-    const double black[3] = {0., 0., 0.};
-    const double white[3] = {1., 1., 1.};
-    colorTransfer->AddRGBPoint(scalarRange[0], black[0], black[1], black[2]);
-    colorTransfer->AddRGBPoint(windowLevelMinMax[0], black[0], black[1], black[2]);
-    colorTransfer->AddRGBPoint(windowLevelMinMax[1], white[0], white[1], white[2]);
-    colorTransfer->AddRGBPoint(scalarRange[1], white[0], white[1], white[2]);
-    }
-  else if (size == 1)
-    {
-    double color[4];
-    lut->GetTableValue(0, color);
+    const int size = lut ? lut->GetNumberOfTableValues() : 0;
+    if (size == 0)
+      {
+      const double black[3] = {0., 0., 0.};
+      const double white[3] = {1., 1., 1.};
+      colorTransfer->AddRGBPoint(scalarRange[0], black[0], black[1], black[2]);
+      colorTransfer->AddRGBPoint(windowLevelMinMax[0], black[0], black[1], black[2]);
+      colorTransfer->AddRGBPoint(windowLevelMinMax[1], white[0], white[1], white[2]);
+      colorTransfer->AddRGBPoint(scalarRange[1], white[0], white[1], white[2]);
+      }
+    else if (size == 1)
+      {
+      double color[4];
+      lut->GetTableValue(0, color);
 
-    colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[0], previous),
-                               color[0], color[1], color[2]);
-    colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(windowLevelMinMax[0], previous),
-                               color[0], color[1], color[2]);
-    colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(windowLevelMinMax[1], previous),
-                               color[0], color[1], color[2]);
-    colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[1], previous),
-                               color[0], color[1], color[2]);
-    }
-  else // if (size > 1)
-    {
-    previous = VTK_DOUBLE_MIN;
+      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[0], previous),
+                                 color[0], color[1], color[2]);
+      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(windowLevelMinMax[0], previous),
+                                 color[0], color[1], color[2]);
+      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(windowLevelMinMax[1], previous),
+                                 color[0], color[1], color[2]);
+      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[1], previous),
+                                 color[0], color[1], color[2]);
+      }
+    else // if (size > 1)
+      {
+      previous = VTK_DOUBLE_MIN;
+
+      double color[4];
+      lut->GetTableValue(0, color);
+      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[0], previous),
+                                 color[0], color[1], color[2]);
 
-    double color[4];
-    lut->GetTableValue(0, color);
-    colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[0], previous),
-                               color[0], color[1], color[2]);
+      double value = windowLevelMinMax[0];
 
-    double value = windowLevelMinMax[0];
+      double step = windowLevel[0] / (size - 1);
 
-    double step = windowLevel[0] / (size - 1);
+      int downSamplingFactor = 64;
+      for (int i = 0; i < size; i += downSamplingFactor,
+                                value += downSamplingFactor*step)
+        {
+        lut->GetTableValue(i, color);
+        colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(value, previous),
+                                   color[0], color[1], color[2]);
+        }
 
-    int downSamplingFactor = 64;
-    for (int i = 0; i < size; i += downSamplingFactor,
-                              value += downSamplingFactor*step)
-      {
-      lut->GetTableValue(i, color);
-      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(value, previous),
+      lut->GetTableValue(size - 1, color);
+      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(windowLevelMinMax[1], previous),
+                                 color[0], color[1], color[2]);
+      colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[1], previous),
                                  color[0], color[1], color[2]);
       }
-
-    lut->GetTableValue(size - 1, color);
-    colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(windowLevelMinMax[1], previous),
-                               color[0], color[1], color[2]);
-    colorTransfer->AddRGBPoint(vtkMRMLVolumePropertyNode::HigherAndUnique(scalarRange[1], previous),
-                               color[0], color[1], color[2]);
+    cachedFunctions.Color = colorTransfer;
     }
 
-  vtkColorTransferFunction *volumePropColorTransfer = volumeProp->GetRGBTransferFunction();
-  if (this->IsDifferentFunction(colorTransfer.GetPointer(), volumePropColorTransfer))
-    {
-    volumePropColorTransfer->DeepCopy(colorTransfer.GetPointer());
-    }
+  this->Internal->ApplyColor(key, cachedFunctions.Color, volumeProp);
 
   volumeProp->SetInterpolationTypeToLinear();
   volumeProp->ShadeOn();
@@ -539,42 +902,43 @@ void vtkSlicerVolumeRenderingLogic::SetLabelMapToVolumeProp(vtkScalarsToColors*
 {
   assert(colors && volumeProp);
 
-  vtkNew<vtkPiecewiseFunction> opacity;
-  vtkNew<vtkColorTransferFunction> colorTransfer;
-
-  vtkLookupTable* lut = vtkLookupTable::SafeDownCast(colors);
-  const int colorCount = colors->GetNumberOfAvailableColors();
-  double value = colors->GetRange()[0];
-  double step = (colors->GetRange()[1] - colors->GetRange()[0] + 1.) / colorCount;
-  double color[4] = {0., 0., 0., 1.};
-  const double midPoint = 0.5;
-  const double sharpness = 1.0;
-  for (int i = 0; i < colorCount; ++i, value += step)
-    {
-    // Short circuit for luts as it is faster
-    if (lut)
+  vtkInternal::TransferFunctionCacheKey key;
+  key.Type = vtkInternal::TransferFunctionCacheKey::LabelMap;
+  key.Colors = colors;
+  key.ColorsMTime = colors->GetMTime();
+  vtkInternal::TransferFunctionCacheEntry& cachedFunctions = this->Internal->GetTransferFunctionCacheEntry(key);
+  if (!cachedFunctions.ScalarOpacity || !cachedFunctions.Color)
+    {
+    vtkSmartPointer<vtkPiecewiseFunction> opacity = vtkSmartPointer<vtkPiecewiseFunction>::New();
+    vtkSmartPointer<vtkColorTransferFunction> colorTransfer = vtkSmartPointer<vtkColorTransferFunction>::New();
+
+    vtkLookupTable* lut = vtkLookupTable::SafeDownCast(colors);
+    const int colorCount = colors->GetNumberOfAvailableColors();
+    double value = colors->GetRange()[0];
+    double step = (colors->GetRange()[1] - colors->GetRange()[0] + 1.) / colorCount;
+    double color[4] = {0., 0., 0., 1.};
+    const double midPoint = 0.5;
+    const double sharpness = 1.0;
+    for (int i = 0; i < colorCount; ++i, value += step)
       {
-      lut->GetTableValue(i, color);
-      }
-    else
-      {
-      colors->GetColor(value, color);
+      // Short circuit for luts as it is faster
+      if (lut)
+        {
+        lut->GetTableValue(i, color);
+        }
+      else
+        {
+        colors->GetColor(value, color);
+        }
+      opacity->AddPoint(value, color[3], midPoint, sharpness);
+      colorTransfer->AddRGBPoint(value, color[0], color[1], color[2], midPoint, sharpness);
       }
-    opacity->AddPoint(value, color[3], midPoint, sharpness);
-    colorTransfer->AddRGBPoint(value, color[0], color[1], color[2], midPoint, sharpness);
-    }
-
-  vtkPiecewiseFunction *volumePropOpacity = volumeProp->GetScalarOpacity();
-  if (this->IsDifferentFunction(opacity.GetPointer(), volumePropOpacity))
-    {
-    volumePropOpacity->DeepCopy(opacity.GetPointer());
+    cachedFunctions.ScalarOpacity = opacity;
+    cachedFunctions.Color = colorTransfer;
     }
 
-  vtkColorTransferFunction *volumePropColorTransfer = volumeProp->GetRGBTransferFunction();
-  if (this->IsDifferentFunction(colorTransfer.GetPointer(), volumePropColorTransfer))
-    {
-    volumePropColorTransfer->DeepCopy(colorTransfer.GetPointer());
-    }
+  this->Internal->ApplyScalarOpacity(key, cachedFunctions.ScalarOpacity, volumeProp);
+  this->Internal->ApplyColor(key, cachedFunctions.Color, volumeProp);
 
   volumeProp->SetInterpolationTypeToNearest();
   volumeProp->ShadeOn();
@@ -1343,3 +1707,237 @@ int vtkSlicerVolumeRenderingLogic::LoadCustomPresetsScene(const char* sceneFileP
   this->PresetsScene->SetURL(sceneFilePath);
   return this->PresetsScene->Import();
 }
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingLogic::SetBrickSize(int brickSize)
+{
+  brickSize = std::max(brickSize, 1);
+  if (this->BrickSize == brickSize)
+    {
+    return;
+    }
+  this->BrickSize = brickSize;
+  // Brick scalar ranges are recomputed on next request
+  std::map<vtkMRMLVolumeNode*, vtkInternal::MultiResolutionCache>::iterator cacheIt;
+  for (cacheIt = this->Internal->MultiResolutionCaches.begin(); cacheIt != this->Internal->MultiResolutionCaches.end(); ++cacheIt)
+    {
+    cacheIt->second.BrickScalarRanges.clear();
+    }
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkImageData* vtkSlicerVolumeRenderingLogic::GetMultiResolutionLevel(vtkMRMLVolumeNode* volumeNode, int level)
+{
+  if (level < 0)
+    {
+    vtkErrorMacro("GetMultiResolutionLevel: Invalid level " << level);
+    return nullptr;
+    }
+  vtkInternal::MultiResolutionCache* cache = this->Internal->GetMultiResolutionCache(volumeNode);
+  if (!cache)
+    {
+    return nullptr;
+    }
+  if (level == 0)
+    {
+    return cache->ImageData;
+    }
+  // Compute missing levels, each from the previous one
+  vtkInternal::CollectPendingLevels(cache, true);
+  if (level > cache->MaximumLevel
+    || !ComputeMultiResolutionLevels(cache->ImageData, cache->Levels, level))
+    {
+    vtkErrorMacro("GetMultiResolutionLevel: Level " << level << " is not available for volume " << volumeNode->GetName());
+    return nullptr;
+    }
+  return cache->Levels[level - 1];
+}
+
+//---------------------------------------------------------------------------
+vtkImageData* vtkSlicerVolumeRenderingLogic::RequestMultiResolutionLevel(vtkMRMLVolumeNode* volumeNode, int level)
+{
+  if (level < 0)
+    {
+    vtkErrorMacro("RequestMultiResolutionLevel: Invalid level " << level);
+    return nullptr;
+    }
+  vtkInternal::MultiResolutionCache* cache = this->Internal->GetMultiResolutionCache(volumeNode);
+  if (!cache)
+    {
+    return nullptr;
+    }
+  if (level == 0)
+    {
+    return cache->ImageData;
+    }
+  vtkInternal::CollectPendingLevels(cache, false);
+  if (level <= static_cast<int>(cache->Levels.size()))
+    {
+    return cache->Levels[level - 1];
+    }
+  if (cache->PendingLevels.valid() || level > cache->MaximumLevel)
+    {
+    // Already being computed or not available
+    return nullptr;
+    }
+
+  // The background thread works on its own shallow copy of the last available
+  // level so that the pipeline information of the volume is not accessed.
+  // Levels are discarded if the volume is modified in the meantime, as the
+  // cache entry is then replaced.
+  vtkSmartPointer<vtkImageData> input = vtkSmartPointer<vtkImageData>::New();
+  input->ShallowCopy(cache->Levels.empty() ? cache->ImageData.GetPointer() : cache->Levels.back().GetPointer());
+  int numberOfLevels = level - static_cast<int>(cache->Levels.size());
+  cache->PendingLevels = std::async(std::launch::async, [input, numberOfLevels]()
+    {
+    std::vector< vtkSmartPointer<vtkImageData> > levels;
+    ComputeMultiResolutionLevels(input, levels, numberOfLevels);
+    return levels;
+    });
+  return nullptr;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingLogic::vtkInternal::CollectPendingLevels(MultiResolutionCache* cache, bool wait)
+{
+  if (!cache->PendingLevels.valid())
+    {
+    return;
+    }
+  if (!wait && cache->PendingLevels.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+    return;
+    }
+  int numberOfExistingLevels = static_cast<int>(cache->Levels.size());
+  std::vector< vtkSmartPointer<vtkImageData> > levels = cache->PendingLevels.get();
+  cache->Levels.insert(cache->Levels.end(), levels.begin(), levels.end());
+  if (levels.empty())
+    {
+    // Not even one more level could be computed
+    cache->MaximumLevel = numberOfExistingLevels;
+    }
+}
+
+//---------------------------------------------------------------------------
+int vtkSlicerVolumeRenderingLogic::GetMultiResolutionLevelForNumberOfVoxels(
+  vtkMRMLVolumeNode* volumeNode, vtkIdType maximumNumberOfVoxels)
+{
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!imageData)
+    {
+    return 0;
+    }
+  int dimensions[3] = { 0, 0, 0 };
+  imageData->GetDimensions(dimensions);
+  int level = 0;
+  while (static_cast<vtkIdType>(dimensions[0]) * dimensions[1] * dimensions[2] > maximumNumberOfVoxels
+    && (dimensions[0] > 1 || dimensions[1] > 1 || dimensions[2] > 1))
+    {
+    for (int i = 0; i < 3; ++i)
+      {
+      dimensions[i] = (dimensions[i] + 1) / 2;
+      }
+    ++level;
+    }
+  return level;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSlicerVolumeRenderingLogic::GetNonEmptyExtent(vtkMRMLVolumeNode* volumeNode,
+  vtkPiecewiseFunction* scalarOpacity, int extent[6])
+{
+  vtkInternal::MultiResolutionCache* cache = this->Internal->GetMultiResolutionCache(volumeNode);
+  if (!cache || !scalarOpacity)
+    {
+    return false;
+    }
+  vtkImageData* imageData = cache->ImageData;
+  if (imageData->GetNumberOfScalarComponents() != 1 || !imageData->GetPointData()->GetScalars())
+    {
+    return false;
+    }
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  imageData->GetExtent(wholeExtent);
+
+  if (cache->BrickScalarRanges.empty() || cache->BrickSize != this->BrickSize)
+    {
+    cache->BrickSize = this->BrickSize;
+    int dimensions[3] = { 0, 0, 0 };
+    imageData->GetDimensions(dimensions);
+    for (int i = 0; i < 3; ++i)
+      {
+      cache->NumberOfBricks[i] = (dimensions[i] + cache->BrickSize - 1) / cache->BrickSize;
+      }
+    void* scalars = imageData->GetScalarPointer();
+    switch (imageData->GetScalarType())
+      {
+      vtkTemplateMacro(ComputeBrickScalarRanges(imageData, static_cast<VTK_TT*>(scalars),
+        cache->BrickSize, cache->NumberOfBricks, cache->BrickScalarRanges));
+      default:
+        vtkErrorMacro("GetNonEmptyExtent: Unsupported scalar type " << imageData->GetScalarTypeAsString());
+        return false;
+      }
+    }
+
+  int nonEmptyBricks[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+  const double* brickRange = cache->BrickScalarRanges.data();
+  for (int k = 0; k < cache->NumberOfBricks[2]; ++k)
+    {
+    for (int j = 0; j < cache->NumberOfBricks[1]; ++j)
+      {
+      for (int i = 0; i < cache->NumberOfBricks[0]; ++i, brickRange += 2)
+        {
+        if (!IsOpacityNonZeroInRange(scalarOpacity, brickRange[0], brickRange[1]))
+          {
+          continue;
+          }
+        nonEmptyBricks[0] = std::min(nonEmptyBricks[0], i);
+        nonEmptyBricks[1] = std::max(nonEmptyBricks[1], i);
+        nonEmptyBricks[2] = std::min(nonEmptyBricks[2], j);
+        nonEmptyBricks[3] = std::max(nonEmptyBricks[3], j);
+        nonEmptyBricks[4] = std::min(nonEmptyBricks[4], k);
+        nonEmptyBricks[5] = std::max(nonEmptyBricks[5], k);
+        }
+      }
+    }
+  if (nonEmptyBricks[0] > nonEmptyBricks[1])
+    {
+    // Fully transparent
+    extent[0] = extent[2] = extent[4] = 0;
+    extent[1] = extent[3] = extent[5] = -1;
+    return true;
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    // Add a one voxel margin so that interpolation at the brick boundary is not affected
+    extent[2 * i] = std::max(wholeExtent[2 * i], wholeExtent[2 * i] + nonEmptyBricks[2 * i] * cache->BrickSize - 1);
+    extent[2 * i + 1] = std::min(wholeExtent[2 * i + 1], wholeExtent[2 * i] + (nonEmptyBricks[2 * i + 1] + 1) * cache->BrickSize);
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingLogic::RemoveMultiResolutionCache(vtkMRMLVolumeNode* volumeNode)
+{
+  if (!volumeNode)
+    {
+    this->Internal->MultiResolutionCaches.clear();
+    return;
+    }
+  this->Internal->MultiResolutionCaches.erase(volumeNode);
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerVolumeRenderingLogic::ClearTransferFunctionCache()
+{
+  this->Internal->TransferFunctionCache.clear();
+  this->Internal->TransferFunctionCacheKeys.clear();
+  this->Internal->AppliedTransferFunctionsMap.clear();
+}
+
+//---------------------------------------------------------------------------
+int vtkSlicerVolumeRenderingLogic::GetNumberOfCachedTransferFunctions()
+{
+  return static_cast<int>(this->Internal->TransferFunctionCache.size());
+}
@@ -36,6 +36,7 @@ class vtkMRMLShaderPropertyNode;
 
 // VTK includes
 class vtkColorTransferFunction;
+class vtkImageData;
 class vtkLookupTable;
 class vtkPiecewiseFunction;
 class vtkScalarsToColors;
@@ -315,6 +316,62 @@ public:
   bool IsDifferentFunction(vtkColorTransferFunction* function1,
                            vtkColorTransferFunction* function2) const;
 
+  /// Get a level of the multiresolution pyramid of the volume, used for
+  /// level-of-detail rendering of large volumes.
+  /// Level 0 is the image data of the volume node, each subsequent level
+  /// is downsampled by voxel averaging by a factor of 2 along each axis.
+  /// Levels are computed when first requested and kept until the image data
+  /// of the volume is modified or \a RemoveMultiResolutionCache is called.
+  /// Origin and spacing of the returned images are set so that they can be
+  /// rendered using the IJKToRAS matrix of the volume node.
+  /// \return nullptr if the volume has no image data or level is invalid.
+  /// \sa GetMultiResolutionLevelForNumberOfVoxels
+  vtkImageData* GetMultiResolutionLevel(vtkMRMLVolumeNode* volumeNode, int level);
+
+  /// Get a level of the multiresolution pyramid of the volume without blocking.
+  /// If the level is not computed yet then its computation is started in a
+  /// background thread and nullptr is returned. Call the method again later
+  /// (for example, before the next render) to get the level once it is ready.
+  /// \sa GetMultiResolutionLevel
+  vtkImageData* RequestMultiResolutionLevel(vtkMRMLVolumeNode* volumeNode, int level);
+
+  /// Get the finest level of the multiresolution pyramid that has at most
+  /// \a maximumNumberOfVoxels voxels. The pyramid is not computed by this call.
+  /// \sa GetMultiResolutionLevel
+  int GetMultiResolutionLevelForNumberOfVoxels(vtkMRMLVolumeNode* volumeNode, vtkIdType maximumNumberOfVoxels);
+
+  /// Compute the IJK extent of the region of the volume that contains all
+  /// the bricks that are not fully transparent with the \a scalarOpacity
+  /// transfer function. It can be used for skipping empty space in rendering.
+  /// Minimum and maximum scalar value of each brick are computed when first
+  /// requested and cached with the multiresolution pyramid.
+  /// \return false if the extent cannot be computed (no image data or
+  /// multi-component image). If all bricks are transparent then the returned
+  /// extent is empty (extent[0] > extent[1]).
+  /// \sa BrickSize
+  bool GetNonEmptyExtent(vtkMRMLVolumeNode* volumeNode, vtkPiecewiseFunction* scalarOpacity, int extent[6]);
+
+  /// Remove cached multiresolution pyramid and brick scalar ranges of the volume.
+  /// If volumeNode is nullptr then the cache of all volumes is removed.
+  void RemoveMultiResolutionCache(vtkMRMLVolumeNode* volumeNode = nullptr);
+
+  /// Transfer functions generated by \a SetThresholdToVolumeProp,
+  /// \a SetWindowLevelToVolumeProp and \a SetLabelMapToVolumeProp are cached,
+  /// keyed by their input values (and lookup table modification time), and
+  /// shared by all display nodes and views.
+  /// Volume properties are only modified if the cached function differs from
+  /// the current one, which avoids recomputing rendering tables in the mappers.
+  /// Cached functions are copied to the volume properties, never assigned,
+  /// as volume property functions are edited in place.
+  void ClearTransferFunctionCache();
+  int GetNumberOfCachedTransferFunctions();
+
+  /// Size of bricks (number of voxels along each axis) used for skipping empty space.
+  /// Default is 32.
+  /// \sa GetNonEmptyExtent
+  void SetBrickSize(int brickSize);
+  vtkGetMacro(BrickSize, int);
+
 protected:
   vtkSlicerVolumeRenderingLogic();
   ~vtkSlicerVolumeRenderingLogic() override;
@@ -349,6 +406,11 @@ protected:
   bool LoadPresets(vtkMRMLScene* scene);
   vtkMRMLScene* PresetsScene;
 
+  int BrickSize;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+
 private:
   vtkSlicerVolumeRenderingLogic(const vtkSlicerVolumeRenderingLogic&) = delete;
   void operator=(const vtkSlicerVolumeRenderingLogic&) = delete;
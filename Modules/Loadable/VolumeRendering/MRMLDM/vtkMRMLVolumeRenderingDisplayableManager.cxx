@@ -29,6 +29,7 @@
 
 // MRML includes
 #include "vtkMRMLAnnotationROINode.h"
+#include "vtkMRMLApplicationLogic.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLTransformNode.h"
@@ -59,8 +60,8 @@
 #include <vtkDoubleArray.h>
 #include <vtkVolumePicker.h>
 
-#include <vtkImageData.h> //TODO: Used for workaround. Remove when fixed
-#include <vtkTrivialProducer.h> //TODO: Used for workaround. Remove when fixed
+#include <vtkImageData.h>
+#include <vtkTrivialProducer.h>
 #include <vtkPiecewiseFunction.h> //TODO: Used for workaround. Remove when fixed
 
 //---------------------------------------------------------------------------
@@ -69,6 +70,9 @@ vtkStandardNewMacro(vtkMRMLVolumeRenderingDisplayableManager);
 //---------------------------------------------------------------------------
 int vtkMRMLVolumeRenderingDisplayableManager::DefaultGPUMemorySize = 256;
 
+//---------------------------------------------------------------------------
+vtkIdType vtkMRMLVolumeRenderingDisplayableManager::InteractiveMaximumNumberOfVoxels = 256 * 256 * 256;
+
 //---------------------------------------------------------------------------
 class vtkMRMLVolumeRenderingDisplayableManager::vtkInternal
 {
@@ -84,11 +88,17 @@ public:
     {
       this->VolumeActor = vtkSmartPointer<vtkVolume>::New();
       this->IJKToWorldMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+      this->LevelOfDetailProducer = vtkSmartPointer<vtkTrivialProducer>::New();
+      this->ClippingPlanesInputMTime = 0;
     }
     virtual ~Pipeline()  = default;
 
     vtkSmartPointer<vtkVolume> VolumeActor;
     vtkSmartPointer<vtkMatrix4x4> IJKToWorldMatrix;
+    /// Provides the coarse level of the multiresolution pyramid rendered during interaction
+    vtkSmartPointer<vtkTrivialProducer> LevelOfDetailProducer;
+    /// Latest modification time of the inputs of the clipping planes when they were last set
+    mutable vtkMTimeType ClippingPlanesInputMTime;
   };
 
   //-------------------------------------------------------------------------
@@ -142,6 +152,24 @@ public:
 
   // ROIs
   void UpdatePipelineROIs(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
+  /// Add clipping planes around the bricks that are not fully transparent
+  void UpdatePipelineEmptySpaceClipping(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
+  /// Get the latest modification time of the objects the clipping planes are computed from:
+  /// image data, opacity transfer function, ROI, volume transform and view node.
+  vtkMTimeType GetClippingPlanesInputMTime(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
+
+  // Level of detail
+  /// Set the level of the multiresolution pyramid used as mapper input.
+  /// \return The rendered level
+  int UpdatePipelineLevelOfDetail(vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline);
+  /// Set the coarsest level that may be rendered and update all pipelines.
+  /// The value is clamped to the coarsest level that is actually rendered.
+  void SetMaximumLevelOfDetail(int level);
+  /// Refine rendering after each rendered frame until full resolution is reached
+  static void OnRenderEnd(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
+  /// Update clipping planes that are out of date and switch to levels of detail
+  /// that became available, before each rendered frame
+  static void OnRenderStart(vtkObject* caller, unsigned long eid, void* clientData, void* callData);
 
   // Display Nodes
   void AddDisplayNode(vtkMRMLVolumeNode* volumeNode, vtkMRMLVolumeRenderingDisplayNode* displayNode);
@@ -192,6 +220,23 @@ public:
   /// Last picked volume rendering display node ID
   std::string PickedNodeID;
 
+  /// Flag indicating whether the camera is being interacted with
+  bool CameraInteraction;
+
+  /// Coarsest level of the multiresolution pyramid that may be rendered.
+  /// Set to the coarsest level when camera interaction starts and then decreased
+  /// after each rendered frame until full resolution (level 0) is reached.
+  int MaximumLevelOfDetail;
+
+  /// Flag indicating that a level of detail is requested but is still being
+  /// computed in the background, full resolution is rendered until it is ready.
+  bool LevelOfDetailPending;
+
+  /// Callback for progressive refinement when the camera stops
+  vtkSmartPointer<vtkCallbackCommand> RenderEndCallbackCommand;
+  /// Callback for updating the pipelines before rendering
+  vtkSmartPointer<vtkCallbackCommand> RenderStartCallbackCommand;
+
 private:
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
   /// Multi-volume actor using a common mapper for rendering the multiple volumes
@@ -216,6 +261,9 @@ vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::vtkInternal(vtkMRMLVolume
   //TODO: Change back to 0 once the VTK issue https://gitlab.kitware.com/vtk/vtk/issues/17325 is fixed
 , NextMultiVolumeActorPortIndex(1)
 , PickedNodeID("")
+, CameraInteraction(false)
+, MaximumLevelOfDetail(0)
+, LevelOfDetailPending(false)
 {
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
   this->MultiVolumeActor = vtkSmartPointer<vtkMultiVolume>::New();
@@ -248,6 +296,14 @@ vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::vtkInternal(vtkMRMLVolume
 
   this->VolumePicker = vtkSmartPointer<vtkVolumePicker>::New();
   this->VolumePicker->SetTolerance(0.005);
+
+  this->RenderEndCallbackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->RenderEndCallbackCommand->SetClientData(this);
+  this->RenderEndCallbackCommand->SetCallback(vtkInternal::OnRenderEnd);
+
+  this->RenderStartCallbackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->RenderStartCallbackCommand->SetClientData(this);
+  this->RenderStartCallbackCommand->SetCallback(vtkInternal::OnRenderStart);
 }
 
 //---------------------------------------------------------------------------
@@ -547,11 +603,13 @@ bool vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdatePipelineTransf
       {
       vtkMRMLVolumeRenderingDisplayNode* currentDisplayNode = pipelineIt->first;
       const Pipeline* currentPipeline = pipelineIt->second;
-      this->UpdateDisplayNodePipeline(currentDisplayNode, currentPipeline);
 
       // Calculate and apply transform matrix
+      // (before updating the pipeline, as empty space clipping planes are computed from it)
       this->GetVolumeTransformToWorld(volumeNode, currentPipeline->IJKToWorldMatrix);
       currentPipeline->VolumeActor->SetUserMatrix(currentPipeline->IJKToWorldMatrix.GetPointer());
+
+      this->UpdateDisplayNodePipeline(currentDisplayNode, currentPipeline);
       pipelineModified = true;
       }
     }
@@ -710,12 +768,8 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
 
     // Make sure the correct mapper is set to the volume
     pipeline->VolumeActor->SetMapper(mapper);
-    // Make sure the correct volume is set to the mapper
-    // Reconnection is expensive operation, therefore only do it if needed
-    if (mapper->GetInputConnection(0, 0) != volumeNode->GetImageDataConnection())
-      {
-      mapper->SetInputConnection(0, volumeNode->GetImageDataConnection());
-      }
+    // Make sure the correct volume (or level of detail) is set to the mapper
+    this->UpdatePipelineLevelOfDetail(displayNode, pipeline);
     }
   else if (displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode"))
     {
@@ -747,12 +801,8 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdateDisplayNodePip
 
     // Make sure the correct mapper is set to the volume
     pipeline->VolumeActor->SetMapper(mapper);
-    // Make sure the correct volume is set to the mapper
-    // Reconnection is expensive operation, therefore only do it if needed
-    if (mapper->GetInputConnection(0, 0) != volumeNode->GetImageDataConnection())
-      {
-      mapper->SetInputConnection(0, volumeNode->GetImageDataConnection());
-      }
+    // Make sure the correct volume (or level of detail) is set to the mapper
+    this->UpdatePipelineLevelOfDetail(displayNode, pipeline);
     }
   else if (displayNode->IsA("vtkMRMLMultiVolumeRenderingDisplayNode"))
     {
@@ -842,19 +892,246 @@ void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdatePipelineROIs(
     vtkErrorWithObjectMacro(this->External, "UpdatePipelineROIs: Unable to get volume mapper");
     return;
     }
-  if (!displayNode || displayNode->GetROINode() == nullptr || !displayNode->GetCroppingEnabled())
+  if (!displayNode)
     {
     volumeMapper->RemoveAllClippingPlanes();
     return;
     }
+  if (displayNode->GetROINode() == nullptr || !displayNode->GetCroppingEnabled())
+    {
+    volumeMapper->RemoveAllClippingPlanes();
+    }
+  else
+    {
+    // Make sure the ROI node's inside out flag is on
+    displayNode->GetROINode()->InsideOutOn();
+
+    // Calculate and set clipping planes
+    vtkNew<vtkPlanes> planes;
+    displayNode->GetROINode()->GetTransformedPlanes(planes.GetPointer());
+    volumeMapper->SetClippingPlanes(planes.GetPointer());
+    }
+
+  this->UpdatePipelineEmptySpaceClipping(displayNode, pipeline);
+  pipeline->ClippingPlanesInputMTime = this->GetClippingPlanesInputMTime(displayNode, pipeline);
+}
+
+//---------------------------------------------------------------------------
+vtkMTimeType vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::GetClippingPlanesInputMTime(
+  vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline)
+{
+  vtkMTimeType mtime = std::max(displayNode->GetMTime(), pipeline->IJKToWorldMatrix->GetMTime());
+  vtkMRMLViewNode* viewNode = this->External->GetMRMLViewNode();
+  if (viewNode)
+    {
+    mtime = std::max(mtime, viewNode->GetMTime());
+    }
+  vtkMRMLVolumeNode* volumeNode = displayNode->GetVolumeNode();
+  if (volumeNode && volumeNode->GetImageData())
+    {
+    mtime = std::max(mtime, volumeNode->GetImageData()->GetMTime());
+    }
+  vtkMRMLVolumePropertyNode* volumePropertyNode = displayNode->GetVolumePropertyNode();
+  if (volumePropertyNode && volumePropertyNode->GetVolumeProperty())
+    {
+    mtime = std::max(mtime, volumePropertyNode->GetVolumeProperty()->GetMTime());
+    if (volumePropertyNode->GetVolumeProperty()->GetScalarOpacity())
+      {
+      mtime = std::max(mtime, volumePropertyNode->GetVolumeProperty()->GetScalarOpacity()->GetMTime());
+      }
+    }
+  vtkMRMLAnnotationROINode* roiNode = displayNode->GetROINode();
+  if (roiNode)
+    {
+    mtime = std::max(mtime, roiNode->GetMTime());
+    if (roiNode->GetParentTransformNode())
+      {
+      mtime = std::max(mtime, roiNode->GetParentTransformNode()->GetMTime());
+      }
+    }
+  return mtime;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdatePipelineEmptySpaceClipping(
+  vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline)
+{
+  if ( !displayNode->IsA("vtkMRMLCPURayCastVolumeRenderingDisplayNode")
+    && !displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode") )
+    {
+    return;
+    }
+  // Voxels that are mapped to zero opacity only leave the result unchanged in composite mode
+  vtkMRMLViewNode* viewNode = this->External->GetMRMLViewNode();
+  if (!viewNode || viewNode->GetRaycastTechnique() != vtkMRMLViewNode::Composite)
+    {
+    return;
+    }
+  vtkMRMLVolumeNode* volumeNode = displayNode->GetVolumeNode();
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  vtkVolumeProperty* volumeProperty = displayNode->GetVolumePropertyNode() ? displayNode->GetVolumePropertyNode()->GetVolumeProperty() : nullptr;
+  if (!imageData || !volumeProperty)
+    {
+    return;
+    }
+  vtkSlicerVolumeRenderingLogic* volumeRenderingLogic = this->External->GetVolumeRenderingLogic();
+  if (!volumeRenderingLogic)
+    {
+    return;
+    }
+  int nonEmptyExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (!volumeRenderingLogic->GetNonEmptyExtent(volumeNode, volumeProperty->GetScalarOpacity(), nonEmptyExtent)
+    || nonEmptyExtent[0] > nonEmptyExtent[1])
+    {
+    return;
+    }
+  int wholeExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  imageData->GetExtent(wholeExtent);
+
+  // Normals are transformed by the inverse transpose of the IJK to world matrix
+  vtkNew<vtkMatrix4x4> worldToIjkTransposed;
+  vtkMatrix4x4::Invert(pipeline->IJKToWorldMatrix, worldToIjkTransposed.GetPointer());
+  worldToIjkTransposed->Transpose();
+
+  vtkVolumeMapper* volumeMapper = this->GetVolumeMapper(displayNode);
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    for (int side = 0; side < 2; ++side)
+      {
+      int boundIndex = 2 * axis + side;
+      if (nonEmptyExtent[boundIndex] == wholeExtent[boundIndex])
+        {
+        continue;
+        }
+      // Planes are at the voxel boundary, normal is pointing towards the region to keep
+      double pointIjk[4] = { 0.0, 0.0, 0.0, 1.0 };
+      double normalIjk[4] = { 0.0, 0.0, 0.0, 0.0 };
+      pointIjk[axis] = nonEmptyExtent[boundIndex] + (side == 0 ? -0.5 : 0.5);
+      normalIjk[axis] = (side == 0 ? 1.0 : -1.0);
+      double pointWorld[4] = { 0.0, 0.0, 0.0, 1.0 };
+      double normalWorld[4] = { 0.0, 0.0, 0.0, 0.0 };
+      pipeline->IJKToWorldMatrix->MultiplyPoint(pointIjk, pointWorld);
+      worldToIjkTransposed->MultiplyPoint(normalIjk, normalWorld);
+      vtkNew<vtkPlane> plane;
+      plane->SetOrigin(pointWorld);
+      plane->SetNormal(normalWorld);
+      volumeMapper->AddClippingPlane(plane.GetPointer());
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::UpdatePipelineLevelOfDetail(
+  vtkMRMLVolumeRenderingDisplayNode* displayNode, const Pipeline* pipeline)
+{
+  if ( !displayNode->IsA("vtkMRMLCPURayCastVolumeRenderingDisplayNode")
+    && !displayNode->IsA("vtkMRMLGPURayCastVolumeRenderingDisplayNode") )
+    {
+    return 0;
+    }
+  vtkVolumeMapper* mapper = this->GetVolumeMapper(displayNode);
+  vtkMRMLVolumeNode* volumeNode = displayNode->GetVolumeNode();
+  if (!mapper || !volumeNode)
+    {
+    return 0;
+    }
 
-  // Make sure the ROI node's inside out flag is on
-  displayNode->GetROINode()->InsideOutOn();
+  int level = 0;
+  vtkSlicerVolumeRenderingLogic* volumeRenderingLogic = nullptr;
+  if (this->MaximumLevelOfDetail > 0 && vtkMRMLVolumeRenderingDisplayableManager::InteractiveMaximumNumberOfVoxels > 0)
+    {
+    volumeRenderingLogic = this->External->GetVolumeRenderingLogic();
+    if (volumeRenderingLogic)
+      {
+      level = std::min(this->MaximumLevelOfDetail, volumeRenderingLogic->GetMultiResolutionLevelForNumberOfVoxels(
+        volumeNode, vtkMRMLVolumeRenderingDisplayableManager::InteractiveMaximumNumberOfVoxels));
+      }
+    }
+  vtkAlgorithmOutput* inputConnection = volumeNode->GetImageDataConnection();
+  if (level > 0)
+    {
+    // The pyramid is computed in the background, render full resolution until it is ready
+    vtkImageData* levelImage = volumeRenderingLogic->RequestMultiResolutionLevel(volumeNode, level);
+    if (levelImage)
+      {
+      pipeline->LevelOfDetailProducer->SetOutput(levelImage);
+      inputConnection = pipeline->LevelOfDetailProducer->GetOutputPort();
+      }
+    else
+      {
+      this->LevelOfDetailPending = true;
+      level = 0;
+      }
+    }
+
+  // Reconnection is expensive operation, therefore only do it if needed
+  if (mapper->GetInputConnection(0, 0) != inputConnection)
+    {
+    mapper->SetInputConnection(0, inputConnection);
+    }
+  return level;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::SetMaximumLevelOfDetail(int level)
+{
+  this->MaximumLevelOfDetail = std::max(level, 0);
+  this->LevelOfDetailPending = false;
+  int renderedLevel = 0;
+  PipelinesCacheType::iterator pipelineIt;
+  for (pipelineIt = this->DisplayPipelines.begin(); pipelineIt != this->DisplayPipelines.end(); ++pipelineIt)
+    {
+    if (this->IsVisible(pipelineIt->first))
+      {
+      renderedLevel = std::max(renderedLevel, this->UpdatePipelineLevelOfDetail(pipelineIt->first, pipelineIt->second));
+      }
+    }
+  // Keep the requested level while the camera moves, so that pending levels
+  // are used as soon as they are ready (see OnRenderStart)
+  if (!this->CameraInteraction || !this->LevelOfDetailPending)
+    {
+    this->MaximumLevelOfDetail = std::min(this->MaximumLevelOfDetail, renderedLevel);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::OnRenderEnd(
+  vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  vtkInternal* self = reinterpret_cast<vtkInternal*>(clientData);
+  if (!self || self->CameraInteraction || self->MaximumLevelOfDetail <= 0)
+    {
+    return;
+    }
+  // Camera stopped, render the next finer level
+  self->SetMaximumLevelOfDetail(self->MaximumLevelOfDetail - 1);
+  self->External->RequestRender();
+}
 
-  // Calculate and set clipping planes
-  vtkNew<vtkPlanes> planes;
-  displayNode->GetROINode()->GetTransformedPlanes(planes.GetPointer());
-  volumeMapper->SetClippingPlanes(planes.GetPointer());
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::vtkInternal::OnRenderStart(
+  vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  vtkInternal* self = reinterpret_cast<vtkInternal*>(clientData);
+  if (!self)
+    {
+    return;
+    }
+  if (self->CameraInteraction && self->LevelOfDetailPending)
+    {
+    self->SetMaximumLevelOfDetail(self->MaximumLevelOfDetail);
+    }
+  // Volume, transfer function or ROI may be modified without the pipeline being
+  // updated (for example, during interaction), refresh empty space clipping planes.
+  PipelinesCacheType::iterator pipelineIt;
+  for (pipelineIt = self->DisplayPipelines.begin(); pipelineIt != self->DisplayPipelines.end(); ++pipelineIt)
+    {
+    if (self->IsVisible(pipelineIt->first)
+      && self->GetClippingPlanesInputMTime(pipelineIt->first, pipelineIt->second) > pipelineIt->second->ClippingPlanesInputMTime)
+      {
+      self->UpdatePipelineROIs(pipelineIt->first, pipelineIt->second);
+      }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -1100,8 +1377,14 @@ vtkMRMLVolumeRenderingDisplayableManager::vtkMRMLVolumeRenderingDisplayableManag
 //---------------------------------------------------------------------------
 vtkMRMLVolumeRenderingDisplayableManager::~vtkMRMLVolumeRenderingDisplayableManager()
 {
+  if (this->GetRenderer())
+    {
+    this->GetRenderer()->RemoveObserver(this->Internal->RenderEndCallbackCommand);
+    this->GetRenderer()->RemoveObserver(this->Internal->RenderStartCallbackCommand);
+    }
   delete this->Internal;
   this->Internal=nullptr;
+  this->SetVolumeRenderingLogic(nullptr);
 }
 
 //---------------------------------------------------------------------------
@@ -1117,6 +1400,36 @@ void vtkMRMLVolumeRenderingDisplayableManager::Create()
   Superclass::Create();
   this->ObserveGraphicalResourcesCreatedEvent();
   this->SetUpdateFromMRMLRequested(1);
+
+  // Observe rendering for progressive refinement of the level of detail
+  if (!this->GetRenderer()->HasObserver(vtkCommand::EndEvent, this->Internal->RenderEndCallbackCommand))
+    {
+    this->GetRenderer()->AddObserver(vtkCommand::EndEvent, this->Internal->RenderEndCallbackCommand);
+    }
+  if (!this->GetRenderer()->HasObserver(vtkCommand::StartEvent, this->Internal->RenderStartCallbackCommand))
+    {
+    this->GetRenderer()->AddObserver(vtkCommand::StartEvent, this->Internal->RenderStartCallbackCommand);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeRenderingDisplayableManager::SetVolumeRenderingLogic(vtkSlicerVolumeRenderingLogic* logic)
+{
+  vtkSetObjectBodyMacro(VolumeRenderingLogic, vtkSlicerVolumeRenderingLogic, logic);
+}
+
+//---------------------------------------------------------------------------
+vtkSlicerVolumeRenderingLogic* vtkMRMLVolumeRenderingDisplayableManager::GetVolumeRenderingLogic()
+{
+  if (this->VolumeRenderingLogic)
+    {
+    return this->VolumeRenderingLogic;
+    }
+  // Use the logic of the module, shared by all the views
+  vtkMRMLApplicationLogic* applicationLogic = this->GetMRMLApplicationLogic();
+  // Not an error: the displayable manager can be used without the module
+  return vtkSlicerVolumeRenderingLogic::SafeDownCast(
+    applicationLogic ? applicationLogic->GetModuleLogic("VolumeRendering") : nullptr);
 }
 
 //----------------------------------------------------------------------------
@@ -1377,6 +1690,18 @@ void vtkMRMLVolumeRenderingDisplayableManager::OnInteractorStyleEvent(int eventI
         {
         this->Internal->UpdatePipelineTransforms(volumeIt->first);
         }
+      // Render large volumes at coarse level of detail while the camera moves,
+      // then refine progressively (see vtkInternal::OnRenderEnd)
+      this->Internal->CameraInteraction = (eventID == vtkCommand::StartInteractionEvent);
+      if (this->Internal->CameraInteraction)
+        {
+        this->Internal->SetMaximumLevelOfDetail(VTK_INT_MAX);
+        }
+      else
+        {
+        this->Internal->SetMaximumLevelOfDetail(this->Internal->MaximumLevelOfDetail - 1);
+        this->RequestRender();
+        }
       break;
       }
     default:
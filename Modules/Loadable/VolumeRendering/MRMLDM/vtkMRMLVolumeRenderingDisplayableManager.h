@@ -66,9 +66,26 @@ public:
   /// Get the MRML ID of the picked node, returns empty string if no pick
   const char* GetPickedNodeID() override;
 
+  /// Volume rendering logic used for computing the multiresolution pyramid
+  /// of large volumes and for skipping empty space.
+  /// If not set, then the logic of the VolumeRendering module is retrieved
+  /// from the MRML application logic, so that the cache is shared by all views.
+  /// Returns nullptr if no logic is available (for example if the displayable manager is
+  /// used without the module), then volumes are rendered at full resolution without cropping
+  /// to the non-empty region.
+  void SetVolumeRenderingLogic(vtkSlicerVolumeRenderingLogic* logic);
+  vtkSlicerVolumeRenderingLogic* GetVolumeRenderingLogic();
+
 public:
   static int DefaultGPUMemorySize;
 
+  /// Maximum number of voxels rendered during camera interaction.
+  /// Volumes that have more voxels are rendered using a coarser level of the
+  /// multiresolution pyramid while the camera is moving and the rendering is
+  /// progressively refined to full resolution when interaction ends.
+  /// Set to 0 to always render at full resolution.
+  static vtkIdType InteractiveMaximumNumberOfVoxels;
+
 protected:
   vtkMRMLVolumeRenderingDisplayableManager();
   ~vtkMRMLVolumeRenderingDisplayableManager() override;
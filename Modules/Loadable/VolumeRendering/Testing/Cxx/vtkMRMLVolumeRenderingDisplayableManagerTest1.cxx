@@ -133,6 +133,8 @@ int vtkMRMLVolumeRenderingDisplayableManagerTest1(int argc, char* argv[])
   vtkNew<vtkSlicerVolumeRenderingLogic> vrLogic;
   vrLogic->SetDefaultRenderingMethod("vtkMRMLGPURayCastVolumeRenderingDisplayNode");
   vrLogic->SetMRMLScene(scene);
+  // The displayable manager uses the module logic registered in the application logic
+  applicationLogic->SetModuleLogic("VolumeRendering", vrLogic.GetPointer());
 
   vrLogic->CreateDefaultVolumeRenderingNodes(volumeNode.GetPointer());
   vtkMRMLVolumeRenderingDisplayNode* vrDisplayNode = vrLogic->GetFirstVolumeRenderingDisplayNode(volumeNode.GetPointer());
@@ -35,6 +35,7 @@
 #include "vtkMRMLLabelMapVolumeNode.h"
 #include "vtkMRMLNRRDStorageNode.h"
 #include "vtkMRMLScene.h"
+#include "vtkMRMLTimeSeriesDatabaseStorageNode.h"
 #include "vtkMRMLVectorVolumeDisplayNode.h"
 #include "vtkMRMLVectorVolumeNode.h"
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
@@ -389,6 +390,34 @@ ArchetypeVolumeNodeSet ScalarVolumeNodeSetFactory(std::string& volumeName, vtkMR
   return nodeSet;
 }
 
+//----------------------------------------------------------------------------
+ArchetypeVolumeNodeSet TimeSeriesDatabaseVolumeNodeSetFactory(std::string& volumeName, vtkMRMLScene* scene, int vtkNotUsed(options))
+{
+  ArchetypeVolumeNodeSet nodeSet(scene);
+
+  // A time series database is loaded as a scalar volume showing one frame
+  // at a time, the storage node keeps the database open to switch frames.
+  vtkMRMLScalarVolumeDisplayNode* sdisplayNode =
+      vtkMRMLScalarVolumeDisplayNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLScalarVolumeDisplayNode"));
+
+  vtkMRMLScalarVolumeNode* scalarNode =
+      vtkMRMLScalarVolumeNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLScalarVolumeNode", volumeName));
+  scalarNode->SetAndObserveDisplayNodeID(sdisplayNode->GetID());
+
+  vtkMRMLTimeSeriesDatabaseStorageNode* storageNode =
+      vtkMRMLTimeSeriesDatabaseStorageNode::SafeDownCast(
+        nodeSet.Scene->AddNewNodeByClass("vtkMRMLTimeSeriesDatabaseStorageNode"));
+  scalarNode->SetAndObserveStorageNodeID(storageNode->GetID());
+
+  nodeSet.StorageNode = storageNode;
+  nodeSet.DisplayNode = sdisplayNode;
+  nodeSet.Node = scalarNode;
+
+  return nodeSet;
+}
+
 } // end of anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -401,6 +430,8 @@ vtkSlicerVolumesLogic::vtkSlicerVolumesLogic()
   this->RegisterArchetypeVolumeNodeSetFactory( ArchetypeVectorVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( LabelMapVolumeNodeSetFactory );
   this->RegisterArchetypeVolumeNodeSetFactory( ScalarVolumeNodeSetFactory );
+  // last, so that regular volumes never pay for the extension check
+  this->RegisterArchetypeVolumeNodeSetFactory( TimeSeriesDatabaseVolumeNodeSetFactory );
 
   this->CompareVolumeGeometryEpsilon = 0.000001;
   this->CompareVolumeGeometryPrecision = 6;
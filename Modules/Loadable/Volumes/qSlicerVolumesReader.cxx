@@ -107,6 +107,7 @@ QStringList qSlicerVolumesReader::extensions()const
     << "Volume (*.hdr *.nhdr *.nrrd *.mhd *.mha *.mnc *.vti *.nii *.nii.gz *.mgh *.mgz *.mgh.gz *.img *.img.gz *.pic)"
     << "Dicom (*.dcm *.ima)"
     << "Image (*.png *.tif *.tiff *.jpg *.jpeg)"
+    << "Time series database (*.tsd)"
     << "All Files (*)";
 }
 
@@ -67,6 +67,13 @@ This work is supported by NA-MIC, NAC, BIRN, NCIGT, and the Slicer Community. Se
       slicer.mrmlScene.RegisterNodeClass(vtkMRMLScriptedModuleNode())
 
     self.initializeDICOMDatabase()
+    # Instances removed from the database must be removed from the header index as well.
+    # Changes are often notified several times in a row, the index is only updated once.
+    self.headerIndexPruneTimer = qt.QTimer()
+    self.headerIndexPruneTimer.setSingleShot(True)
+    self.headerIndexPruneTimer.setInterval(1000)
+    self.headerIndexPruneTimer.connect('timeout()', self.pruneHeaderIndex)
+    slicer.dicomDatabase.connect('databaseChanged()', self.headerIndexPruneTimer.start)
 
     settings = qt.QSettings()
     if settings.contains('DICOM/RunListenerAtStart') and not slicer.app.commandOptions().testingEnabled:
@@ -145,6 +152,10 @@ This work is supported by NA-MIC, NAC, BIRN, NCIGT, and the Slicer Community. Se
 
 
 
+  def pruneHeaderIndex(self):
+    if 'DICOMScalarVolumePlugin' in slicer.modules.dicomPlugins:
+      slicer.modules.dicomPlugins['DICOMScalarVolumePlugin'].pruneHeaderIndex(slicer.dicomDatabase)
+
   def startListener(self):
 
     if not slicer.dicomDatabase.isOpen:
@@ -55,6 +55,27 @@ class DICOMScalarVolumePluginClass(DICOMPlugin):
     """
     return ["GDCM with DCMTK fallback", "DCMTK", "GDCM", "Archetype"]
 
+  @staticmethod
+  def headerIndexFileName(dicomDatabase):
+    """Index of the DICOM tags used by the archetype reader to sort the files.
+    It is kept next to the database, so that loading a series again does not
+    parse all the headers.
+    """
+    return os.path.join(os.path.dirname(dicomDatabase.databaseFilename), "ArchetypeHeaderIndex.sql")
+
+  @staticmethod
+  def pruneHeaderIndex(dicomDatabase):
+    """Remove the instances that are not in the DICOM database anymore from the header index.
+    """
+    if not dicomDatabase or not dicomDatabase.isOpen:
+      return
+    fileNamesToKeep = vtk.vtkStringArray()
+    for fileName in dicomDatabase.allFiles():
+      fileNamesToKeep.InsertNextValue(fileName)
+    headerIndexFileName = DICOMScalarVolumePluginClass.headerIndexFileName(dicomDatabase)
+    if vtkITK.vtkITKArchetypeImageSeriesReader.PruneHeaderIndex(headerIndexFileName, fileNamesToKeep) < 0:
+      logging.warning('Failed to remove deleted instances from the DICOM header index ' + headerIndexFileName)
+
   @staticmethod
   def settingsPanelEntry(panel, parent):
     """Create a settings panel entry for this plugin class.
@@ -315,6 +336,8 @@ class DICOMScalarVolumePluginClass(DICOMPlugin):
       reader.SetDICOMImageIOApproachToDCMTK()
     else:
       raise Exception("Invalid imageIOName of %s" % imageIOName)
+    if slicer.dicomDatabase and slicer.dicomDatabase.isOpen:
+      reader.SetHeaderIndexFileName(DICOMScalarVolumePluginClass.headerIndexFileName(slicer.dicomDatabase))
     logging.info("Loading with imageIOName: %s" % imageIOName)
     reader.Update()
 
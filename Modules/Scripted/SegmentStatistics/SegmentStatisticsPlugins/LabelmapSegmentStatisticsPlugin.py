@@ -39,6 +39,10 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
       "principal_axis_y" : "PrincipalAxisY",
       "principal_axis_z" : "PrincipalAxisZ",
       }
+    # Shape statistics of all segments of a shared labelmap are computed at once,
+    # cached tables are keyed by the address of the shared labelmap
+    self.shapeStatisticsCache = {}
+    self.shapeStatisticsCacheSegmentationNodeID = None
     #... developer may add extra options to configure other parameters
 
   def computeStatistics(self, segmentID):
@@ -103,9 +107,6 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         break
 
     if calculateShapeStats:
-      directions = vtk.vtkMatrix4x4()
-      segmentLabelmap.GetDirectionMatrix(directions)
-
       # Remove oriented bounding box from requested keys and replace with individual keys
       requestedOptions = requestedKeys
       statFilterOptions = self.shapeKeys
@@ -153,18 +154,15 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         requestedOptions.append("principal_axes")
         requestedOptions.append("centroid_ras")
 
-      shapeStat = vtkITK.vtkITKLabelShapeStatistics()
-      shapeStat.SetInputData(thresh.GetOutput())
-      shapeStat.SetDirections(directions)
-      for shapeKey in statFilterOptions:
-        shapeStat.SetComputeShapeStatistic(self.keyToShapeStatisticNames[shapeKey], shapeKey in requestedOptions)
-      shapeStat.Update()
+      statTable, rowIndex = self.getShapeStatistics(segmentationNode, segmentID, statFilterOptions, requestedOptions)
+      if rowIndex is None:
+        # Empty segment
+        return stats
 
       # If segmentation node is transformed, apply that transform to get RAS coordinates
       transformSegmentToRas = vtk.vtkGeneralTransform()
       slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(segmentationNode.GetParentTransformNode(), None, transformSegmentToRas)
 
-      statTable = shapeStat.GetOutput()
       if "centroid_ras" in requestedKeys:
         centroidRAS = [0,0,0]
         centroidTuple = None
@@ -172,7 +170,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if centroidArray is None:
           logging.error("Could not calculate centroid_ras!")
         else:
-          centroidTuple = centroidArray.GetTuple(0)
+          centroidTuple = centroidArray.GetTuple(rowIndex)
         if centroidTuple is not None:
           transformSegmentToRas.TransformPoint(centroidTuple, centroidRAS)
           stats["centroid_ras"] = centroidRAS
@@ -183,7 +181,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if roundnessArray is None:
           logging.error("Could not calculate roundness!")
         else:
-          roundnessTuple = roundnessArray.GetTuple(0)
+          roundnessTuple = roundnessArray.GetTuple(rowIndex)
         if roundnessTuple is not None:
           roundness = roundnessTuple[0]
           stats["roundness"] = roundness
@@ -194,7 +192,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if flatnessArray is None:
           logging.error("Could not calculate flatness!")
         else:
-          flatnessTuple = flatnessArray.GetTuple(0)
+          flatnessTuple = flatnessArray.GetTuple(rowIndex)
         if flatnessTuple is not None:
           flatness = flatnessTuple[0]
           stats["flatness"] = flatness
@@ -205,7 +203,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if elongationArray is None:
           logging.error("Could not calculate elongation!")
         else:
-          elongationTuple = elongationArray.GetTuple(0)
+          elongationTuple = elongationArray.GetTuple(rowIndex)
         if elongationTuple is not None:
           elongation = elongationTuple[0]
           stats["elongation"] = elongation
@@ -216,7 +214,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if feretDiameterArray is None:
           logging.error("Could not calculate feret_diameter_mm!")
         else:
-          feretDiameterTuple = feretDiameterArray.GetTuple(0)
+          feretDiameterTuple = feretDiameterArray.GetTuple(rowIndex)
         if feretDiameterTuple is not None:
           feretDiameter = feretDiameterTuple[0]
           stats["feret_diameter_mm"] = feretDiameter
@@ -227,7 +225,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if perimeterArray is None:
           logging.error("Could not calculate surface_area_mm2!")
         else:
-          perimeterTuple = perimeterArray.GetTuple(0)
+          perimeterTuple = perimeterArray.GetTuple(rowIndex)
         if perimeterTuple is not None:
           perimeter = perimeterTuple[0]
           stats["surface_area_mm2"] = perimeter
@@ -239,7 +237,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if obbOriginArray is None:
           logging.error("Could not calculate obb_origin_ras!")
         else:
-          obbOriginTuple = obbOriginArray.GetTuple(0)
+          obbOriginTuple = obbOriginArray.GetTuple(rowIndex)
         if obbOriginTuple is not None:
           transformSegmentToRas.TransformPoint(obbOriginTuple, obbOriginRAS)
           stats["obb_origin_ras"] = obbOriginRAS
@@ -250,7 +248,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if obbDiameterArray is None:
           logging.error("Could not calculate obb_diameter_mm!")
         else:
-          obbDiameterMMTuple = obbDiameterArray.GetTuple(0)
+          obbDiameterMMTuple = obbDiameterArray.GetTuple(rowIndex)
         if obbDiameterMMTuple is not None:
           obbDiameterMM = list(obbDiameterMMTuple)
           stats["obb_diameter_mm"] = obbDiameterMM
@@ -261,14 +259,14 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if obbOriginArray is None:
           logging.error("Could not calculate obb_direction_ras_x!")
         else:
-          obbOriginTuple = obbOriginArray.GetTuple(0)
+          obbOriginTuple = obbOriginArray.GetTuple(rowIndex)
 
         obbDirectionXTuple = None
         obbDirectionXArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["obb_direction_ras_x"])
         if obbDirectionXArray is None:
           logging.error("Could not calculate obb_direction_ras_x!")
         else:
-          obbDirectionXTuple = obbDirectionXArray.GetTuple(0)
+          obbDirectionXTuple = obbDirectionXArray.GetTuple(rowIndex)
 
         if obbOriginTuple is not None and obbDirectionXTuple is not None:
           obbDirectionX = list(obbDirectionXTuple)
@@ -281,14 +279,14 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if obbOriginArray is None:
           logging.error("Could not calculate obb_direction_ras_y!")
         else:
-          obbOriginTuple = obbOriginArray.GetTuple(0)
+          obbOriginTuple = obbOriginArray.GetTuple(rowIndex)
 
         obbDirectionYTuple = None
         obbDirectionYArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["obb_direction_ras_y"])
         if obbDirectionYArray is None:
           logging.error("Could not calculate obb_direction_ras_y!")
         else:
-          obbDirectionYTuple = obbDirectionYArray.GetTuple(0)
+          obbDirectionYTuple = obbDirectionYArray.GetTuple(rowIndex)
 
         if obbOriginTuple is not None and obbDirectionYTuple is not None:
           obbDirectionY = list(obbDirectionYTuple)
@@ -301,14 +299,14 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if obbOriginArray is None:
           logging.error("Could not calculate obb_direction_ras_z!")
         else:
-          obbOriginTuple = obbOriginArray.GetTuple(0)
+          obbOriginTuple = obbOriginArray.GetTuple(rowIndex)
 
         obbDirectionZTuple = None
         obbDirectionZArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["obb_direction_ras_z"])
         if obbDirectionZArray is None:
           logging.error("Could not calculate obb_direction_ras_z!")
         else:
-          obbDirectionZTuple = obbDirectionZArray.GetTuple(0)
+          obbDirectionZTuple = obbDirectionZArray.GetTuple(rowIndex)
 
         if obbOriginTuple is not None and obbDirectionZTuple is not None:
           obbDirectionZ = list(obbDirectionZTuple)
@@ -321,7 +319,7 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if principalMomentsArray is None:
           logging.error("Could not calculate principal_moments!")
         else:    
-          principalMomentsTuple = principalMomentsArray.GetTuple(0)
+          principalMomentsTuple = principalMomentsArray.GetTuple(rowIndex)
         if principalMomentsTuple is not None:
           principalMoments = list(principalMomentsTuple)
           stats["principal_moments"] = principalMoments
@@ -332,14 +330,14 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if centroidRASArray is None:
           logging.error("Could not calculate principal_axis_x!")
         else:
-          centroidRASTuple = centroidRASArray.GetTuple(0)
+          centroidRASTuple = centroidRASArray.GetTuple(rowIndex)
 
         principalAxisXTuple = None
         principalAxisXArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["principal_axis_x"])
         if principalAxisXArray is None:
           logging.error("Could not calculate principal_axis_x!")
         else:
-          principalAxisXTuple = principalAxisXArray.GetTuple(0)
+          principalAxisXTuple = principalAxisXArray.GetTuple(rowIndex)
 
         if centroidRASTuple is not None and principalAxisXTuple is not None:
           principalAxisX = list(principalAxisXTuple)
@@ -352,14 +350,14 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if centroidRASArray is None:
           logging.error("Could not calculate principal_axis_y!")
         else:
-          centroidRASTuple = centroidRASArray.GetTuple(0)
+          centroidRASTuple = centroidRASArray.GetTuple(rowIndex)
 
         principalAxisYTuple = None
         principalAxisYArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["principal_axis_y"])
         if principalAxisYArray is None:
           logging.error("Could not calculate principal_axis_y!")
         else:
-          principalAxisYTuple = principalAxisYArray.GetTuple(0)
+          principalAxisYTuple = principalAxisYArray.GetTuple(rowIndex)
 
         if centroidRASTuple is not None and principalAxisYTuple is not None:
           principalAxisY = list(principalAxisYTuple)
@@ -372,14 +370,14 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
         if centroidRASArray is None:
           logging.error("Could not calculate principal_axis_z!")
         else:
-          centroidRASTuple = centroidRASArray.GetTuple(0)
+          centroidRASTuple = centroidRASArray.GetTuple(rowIndex)
 
         principalAxisZTuple = None
         principalAxisZArray = statTable.GetColumnByName(self.keyToShapeStatisticNames["principal_axis_z"])
         if principalAxisZArray is None:
           logging.error("Could not calculate principal_axis_z!")
         else:
-          principalAxisZTuple = principalAxisZArray.GetTuple(0)
+          principalAxisZTuple = principalAxisZArray.GetTuple(rowIndex)
 
         if centroidRASTuple is not None and principalAxisZTuple is not None:
           principalAxisZ = list(principalAxisZTuple)
@@ -389,6 +387,44 @@ class LabelmapSegmentStatisticsPlugin(SegmentStatisticsPluginBase):
 
     return stats
 
+  def getShapeStatistics(self, segmentationNode, segmentID, statFilterOptions, requestedOptions):
+    """Get the shape statistics table of the shared labelmap that contains the segment
+    and the row of the segment in the table. Statistics of all segments of the shared labelmap
+    are computed in one multi-threaded pass and reused for the other segments of the labelmap.
+    Returns (None, None) if the segment is empty.
+    """
+    sharedLabelmap = segmentationNode.GetBinaryLabelmapInternalRepresentation(segmentID)
+    segment = segmentationNode.GetSegmentation().GetSegment(segmentID)
+    if sharedLabelmap is None or segment is None:
+      return None, None
+
+    if self.shapeStatisticsCacheSegmentationNodeID != segmentationNode.GetID():
+      self.shapeStatisticsCache = {}
+      self.shapeStatisticsCacheSegmentationNodeID = segmentationNode.GetID()
+    computedStatistics = [self.keyToShapeStatisticNames[shapeKey] for shapeKey in statFilterOptions if shapeKey in requestedOptions]
+    cacheKey = sharedLabelmap.GetAddressAsString("vtkOrientedImageData")
+    cachedMTime, cachedStatistics, statTable = self.shapeStatisticsCache.get(cacheKey, (None, None, None))
+    if cachedMTime != sharedLabelmap.GetMTime() or cachedStatistics != computedStatistics:
+      directions = vtk.vtkMatrix4x4()
+      sharedLabelmap.GetDirectionMatrix(directions)
+      shapeStat = vtkITK.vtkITKLabelShapeStatistics()
+      shapeStat.SetInputData(sharedLabelmap)
+      shapeStat.SetDirections(directions)
+      shapeStat.MultiThreadedOn()
+      for shapeKey in statFilterOptions:
+        shapeStat.SetComputeShapeStatistic(self.keyToShapeStatisticNames[shapeKey], shapeKey in requestedOptions)
+      shapeStat.Update()
+      statTable = shapeStat.GetOutput()
+      self.shapeStatisticsCache[cacheKey] = (sharedLabelmap.GetMTime(), computedStatistics, statTable)
+
+    labelValueArray = statTable.GetColumnByName("LabelValue")
+    if labelValueArray is None:
+      return None, None
+    rowIndex = labelValueArray.LookupValue(segment.GetLabelValue())
+    if rowIndex < 0:
+      return None, None
+    return statTable, rowIndex
+
   def getMeasurementInfo(self, key):
     """Get information (name, description, units, ...) about the measurement for the given key"""
     info = {}